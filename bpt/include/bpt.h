@@ -2,6 +2,7 @@
 #define __BPT_H__
 
 #include "common_config.h"
+#include "leaf_page.h"
 #include "page.h"
 
 // Uncomment the line below if you are compiling on Windows.
@@ -26,7 +27,40 @@
 #endif
 #define CANNOT_ROOT -2
 #define MAX_RANGE_SIZE 10000  // for finding range
+#ifndef SCAN_PREFETCH_DEPTH
+#define SCAN_PREFETCH_DEPTH 16  // sibling leaves find_range reads ahead
+#endif
+#ifndef FIND_BATCH_PREFETCH_DEPTH
+#define FIND_BATCH_PREFETCH_DEPTH 32  // leaves find_batch maps before reading
+#endif
+#ifndef REVERSE_SCAN_PREFETCH_DEPTH
+// left sibling leaves a reverse cursor reads ahead, deeper because
+// sequential read-ahead only follows increasing page numbers
+#define REVERSE_SCAN_PREFETCH_DEPTH (SCAN_PREFETCH_DEPTH * 4)
+#endif
+#ifndef APPEND_SPLIT_PERCENT
+// 가장 오른쪽 page의 끝에 넣다 나뉠 때 왼쪽에 남기는 비율(%)
+// key가 계속 커지면 왼쪽 page는 다시 채워지지 않음, 50이면 항상 반씩
+#define APPEND_SPLIT_PERCENT 100
+#endif
+#ifndef OPTIMISTIC_MAX_RESTARTS
+// version conflicts before find_leaf falls back to shared latch crabbing
+#define OPTIMISTIC_MAX_RESTARTS 8
+#endif
+#ifndef OVERFLOW_READ_BATCH
+#define OVERFLOW_READ_BATCH 16  // overflow pages read with one preadv
+#endif
+#ifndef BULK_LOAD_WRITE_BATCH
+#define BULK_LOAD_WRITE_BATCH 128  // pages bulk_load writes with one pwritev
+#endif
+#ifndef BULK_LOAD_FILL_PERCENT
+#define BULK_LOAD_FILL_PERCENT 90  // default page fill of bulk_load
+#endif
 #define MIN_KEYS 1            // for delayed merge
+#define MAX_TREE_HEIGHT 32    // pages a descent path can hold
+#ifndef SEARCH_SIMD_WINDOW
+#define SEARCH_SIMD_WINDOW 4  // entries compared at once by SEARCH_AVX2
+#endif
 
 // Constants for printing part or all of the GPL license.
 #define LICENSE_FILE "LICENSE.txt"
@@ -39,6 +73,13 @@
 
 // TYPES.
 struct tcb_t;
+
+// internal page search kernel
+// SEARCH_LINEAR: scan entries in order (old behavior, for comparison)
+// SEARCH_BINARY: branch free binary search (default)
+// SEARCH_AVX2: binary search down to SEARCH_SIMD_WINDOW entries, then one
+//   vector compare pass; only if the CPU supports AVX2
+enum SearchKernel { SEARCH_LINEAR = 0, SEARCH_BINARY = 1, SEARCH_AVX2 = 2 };
 // GLOBALS.
 
 /* The queue is used to print the tree in
@@ -52,6 +93,30 @@ typedef struct queue {
   struct queue* next;
 } queue;
 
+/* Range scan cursor, db_cursor_open부터 db_cursor_close까지
+ * leaf_num이 PAGE_NULL이 아니면 그 leaf 하나를 pin하고 있음
+ */
+struct cursor_t {
+  int fd;
+  tableid_t table_id;
+  pagenum_t leaf_num;
+  leaf_page_t* leaf_page;  // leaf_num의 frame
+  int index;               // 다음에 줄 record
+  int64_t key_end;         // reverse면 아래쪽 끝
+  bool reverse;            // key 내림차순, left sibling으로
+  int leaves_ahead;  // 요청해둔 read-ahead leaf 중 아직 지나가지 않은 수
+};
+
+/* root에서 leaf까지 내려온 page들, pages[0]이 root, pages[depth - 1]이 leaf
+ * insert와 delete는 parent_page_num 대신 여기서 부모를 찾음
+ * tree_mode가 TREE_MODE_PATH면 split/merge가 child의 parent_page_num을 쓰지 않음
+ */
+typedef struct {
+  pagenum_t pages[MAX_TREE_HEIGHT];
+  int depth;
+  uint32_t tree_mode;  // header의 tree_mode
+} tree_path_t;
+
 // FUNCTION PROTOTYPES.
 
 // Output and utility.
@@ -70,34 +135,125 @@ int find_and_print_range(int fd, tableid_t table_id, int64_t key_start,
 int find_range(int fd, tableid_t table_id, int64_t key_start, int64_t key_end,
                int64_t returned_keys[], pagenum_t returned_pages[],
                int returned_indices[]);
+int collect_child_pages(internal_page_t* internal_page, int from,
+                        int64_t key_end, pagenum_t pages[], int count,
+                        bool* reached_end);
+int prefetch_next_leaves(int fd, tableid_t table_id, pagenum_t leaf_num,
+                         const leaf_page_t* leaf_page, int64_t key_end);
+int collect_child_pages_reverse(internal_page_t* internal_page, int from,
+                                int64_t key_start, pagenum_t pages[],
+                                int count, bool* reached_end);
+int prefetch_prev_leaves(int fd, tableid_t table_id, pagenum_t leaf_num,
+                         const leaf_page_t* leaf_page, int64_t key_start);
 pagenum_t find_leaf(int fd, tableid_t table_id, int64_t key);
 pagenum_t find_leaf(int fd, tableid_t table_id, int64_t key, void** out_bcb);
+pagenum_t find_leaf(int fd, tableid_t table_id, int64_t key, void** out_bcb,
+                    bool leaf_exclusive);
+pagenum_t find_leaf_with_path(int fd, tableid_t table_id, int64_t key,
+                              tree_path_t* path);
+pagenum_t find_leaf_with_path(int fd, tableid_t table_id, int64_t key,
+                              tree_path_t* path, int64_t* fence,
+                              bool* has_fence);
+pagenum_t path_parent(const tree_path_t* path, pagenum_t node);
+pagenum_t find_leaf_with_fence(int fd, tableid_t table_id, int64_t key,
+                               int64_t* fence, bool* has_fence);
+pagenum_t find_leaf_parent_with_fence(int fd, tableid_t table_id, int64_t key,
+                                      int leaf_height, int64_t* fence,
+                                      bool* has_fence);
 int find(int fd, tableid_t table_id, int64_t key, char* result_buf);
+int find(int fd, tableid_t table_id, int64_t key, char* result_buf,
+         uint16_t* length);
+int find_batch(int fd, tableid_t table_id, const int64_t keys[], int n,
+               char* out_values[], int out_status[]);
+int find_batch(int fd, tableid_t table_id, const int64_t keys[], int n,
+               char* out_values[], uint16_t lengths[], int out_status[]);
+int find_key(int fd, tableid_t table_id, int64_t key);
+int find_prefix(int fd, tableid_t table_id, int64_t key, char* result_buf,
+                uint16_t prefix_length, uint16_t* value_length);
 int cut(int length);
 void copy_value(char* dest, const char* src, size_t size);
 int find_with_txn(int fd, tableid_t table_id, int64_t key, char* ret_val,
                   int txn_id, tcb_t* tcb);
+int find_concurrent(int fd, tableid_t table_id, int64_t key, char* result_buf,
+                    uint16_t* length);
+
+// Cursor
+cursor_t* cursor_open(int fd, tableid_t table_id);
+int cursor_seek(cursor_t* cursor, int64_t key_start);
+int cursor_seek(cursor_t* cursor, int64_t key_start, int64_t key_end);
+int cursor_seek_reverse(cursor_t* cursor, int64_t key_start);
+int cursor_seek_reverse(cursor_t* cursor, int64_t key_start, int64_t key_end);
+bool cursor_settle(cursor_t* cursor);
+int cursor_next(cursor_t* cursor, int64_t* key, char* value);
+int cursor_next(cursor_t* cursor, int64_t* key, char* value, uint16_t* length);
+void cursor_close(cursor_t* cursor);
+
+// Search
+int set_search_kernel(SearchKernel kernel);
+SearchKernel get_search_kernel(void);
+int internal_child_index(const internal_page_t* internal_page, int64_t key);
+int internal_child_index(const internal_page_t* internal_page,
+                         int num_of_keys, int64_t key);
+pagenum_t internal_find_child(const internal_page_t* internal_page,
+                              int64_t key);
+int leaf_lower_bound(const leaf_page_t* leaf_page, int64_t key);
+int leaf_find_index(const leaf_page_t* leaf_page, int64_t key);
+
+// Overflow
+int write_overflow_chain(int fd, tableid_t table_id, const char* value,
+                         uint16_t length, overflow_ref_t* ref);
+void read_overflow_value(int fd, tableid_t table_id, const overflow_ref_t* ref,
+                         char* dest, uint16_t length);
+void free_overflow_chain(int fd, tableid_t table_id, const overflow_ref_t* ref);
+void free_leaf_overflow_chains(int fd, tableid_t table_id,
+                               const leaf_page_t* leaf);
 
 // Insertion
+void init_leaf_page(page_t* page, uint32_t format);
+void init_internal_page(page_t* page);
 pagenum_t make_node(int fd, tableid_t table_id, uint32_t isleaf);
 int get_index_after_left_child(page_t* parent_buffer, pagenum_t left_num);
 int insert_into_leaf(int fd, tableid_t table_id, pagenum_t leaf_num,
-                     leaf_page_t* leaf_page, int64_t key, char* value);
+                     leaf_page_t* leaf_page, int64_t key, const char* value,
+                     uint16_t length, uint32_t flags);
 int insert_into_leaf_after_splitting(int fd, tableid_t table_id, pagenum_t leaf,
-                                     int64_t key, char* value);
+                                     int64_t key, const char* value,
+                                     uint16_t length, uint32_t flags,
+                                     const tree_path_t* path);
 int insert_into_node(int fd, tableid_t table_id, pagenum_t parent,
                      int64_t left_index, int64_t key, pagenum_t right);
 int insert_into_node_after_splitting(int fd, tableid_t table_id,
                                      pagenum_t parent, int64_t left_index,
-                                     int64_t key, pagenum_t right);
+                                     int64_t key, pagenum_t right,
+                                     const tree_path_t* path);
 int insert_into_parent(int fd, tableid_t table_id, pagenum_t left, int64_t key,
-                       pagenum_t right);
+                       pagenum_t right, const tree_path_t* path);
 int insert_into_new_root(int fd, tableid_t table_id, pagenum_t left,
-                         int64_t key, pagenum_t right);
+                         int64_t key, pagenum_t right,
+                         const tree_path_t* path);
 int start_new_tree(int fd, tableid_t table_id, int64_t key, char* value);
+int start_new_tree(int fd, tableid_t table_id, int64_t key, const char* value,
+                   uint16_t length, uint32_t flags);
 void init_header_page(int fd, tableid_t table_id);
+uint32_t get_leaf_format(int fd, tableid_t table_id);
+int set_leaf_format(int fd, tableid_t table_id, uint32_t format);
+uint32_t get_tree_mode(int fd, tableid_t table_id);
+int set_tree_mode(int fd, tableid_t table_id, uint32_t mode);
 void link_header_page(int fd, tableid_t table_id, pagenum_t root);
+void forget_rightmost_leaf(tableid_t table_id);
 int bpt_insert(int fd, tableid_t table_id, int64_t key, char* value);
+int bpt_insert(int fd, tableid_t table_id, int64_t key, const char* value,
+               uint16_t length);
+
+int bpt_insert_batch(int fd, tableid_t table_id, const int64_t keys[],
+                     char* values[], int n);
+int bpt_insert_batch(int fd, tableid_t table_id, const int64_t keys[],
+                     const char* const values[], const uint16_t lengths[],
+                     int n);
+
+// Bulk load.
+int bulk_load(int fd, tableid_t table_id, bulk_load_next_t next, void* ctx,
+              int fill_percent);
 
 // Deletion.
 int get_kprime_index(int fd, tableid_t table_id, pagenum_t target_node,
@@ -105,22 +261,32 @@ int get_kprime_index(int fd, tableid_t table_id, pagenum_t target_node,
 int remove_record_from_node(leaf_page_t* target_page, int64_t key,
                             const char* value);
 int remove_entry_from_node(internal_page_t* target_page, int64_t key);
-pagenum_t adjust_root(int fd, tableid_t table_id, pagenum_t root);
+pagenum_t adjust_root(int fd, tableid_t table_id, pagenum_t root,
+                      const tree_path_t* path);
 int coalesce_nodes(int fd, tableid_t table_id, pagenum_t target_num,
                    pagenum_t neighbor_num, int kprime_index_from_get,
-                   int64_t k_prime);
+                   int64_t k_prime, const tree_path_t* path);
 int redistribute_nodes(int fd, tableid_t table_id, pagenum_t target_num,
                        pagenum_t neighbor_num, int kprime_index_from_get,
-                       int k_prime_index, int k_prime);
+                       int k_prime_index, int k_prime,
+                       const tree_path_t* path);
 int delete_entry(int fd, tableid_t table_id, pagenum_t target_node, int64_t key,
-                 const char* value);
+                 const char* value, const tree_path_t* path);
 int bpt_delete(int fd, tableid_t table_id, int64_t key);
 
+// Concurrent insertion and deletion.
+int bpt_insert_concurrent(int fd, tableid_t table_id, int64_t key,
+                          const char* value, uint16_t length);
+int bpt_delete_concurrent(int fd, tableid_t table_id, int64_t key);
+uint64_t merge_epoch(tableid_t table_id);
+
 void destroy_tree_nodes(int fd, tableid_t table_id, pagenum_t root);
 void destroy_tree(int fd, tableid_t table_id);
 
 // Update
 int bpt_update(int fd, tableid_t table_id, int64_t key, char* new_value);
+int bpt_update(int fd, tableid_t table_id, int64_t key, const char* new_value,
+               uint16_t length);
 int update_with_txn(int fd, tableid_t table_id, int64_t key, char* new_value,
                     int txn_id, tcb_t* tcb);
 #endif /* __BPT_H__*/
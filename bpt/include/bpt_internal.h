@@ -4,49 +4,78 @@
 #include "common_config.h"
 #include "page.h"
 
+// record gathered while splitting a leaf
+// value points into a copy of the old leaf or to the new value
+typedef struct {
+  int64_t key;
+  uint16_t length;
+  uint32_t flags;  // slot flags, SLOT_OVERFLOW
+  const char* value;
+} leaf_record_t;
+
 /**
  * Declaration of helper functions used only bpt
  */
-record_t* prepare_records_for_split(leaf_page_t* leaf_page, int64_t key,
-                                    const char* value);
-int64_t distribute_records_to_leaves(leaf_page_t* leaf_page,
+leaf_record_t* prepare_records_for_split(leaf_page_t* leaf_page,
+                                         page_t* leaf_copy, int64_t key,
+                                         const char* value, uint16_t length,
+                                         uint32_t flags);
+int64_t distribute_records_to_leaves(pagenum_t leaf_num,
+                                     leaf_page_t* leaf_page,
                                      leaf_page_t* new_leaf_page,
-                                     record_t* temp_records,
+                                     leaf_record_t* temp_records, int count,
                                      pagenum_t new_leaf_num);
+int split_leaf(int fd, tableid_t table_id, pagenum_t leaf_num, int64_t key,
+               const char* value, uint16_t length, uint32_t flags,
+               int64_t* new_key, pagenum_t* new_leaf_num);
+void remember_rightmost_leaf(tableid_t table_id, pagenum_t leaf_num);
+pagenum_t find_append_leaf(int fd, tableid_t table_id, int64_t key);
+void set_leaf_left_sibling(int fd, tableid_t table_id, pagenum_t leaf_num,
+                           pagenum_t left_num);
+int insert_run_into_leaf(int fd, tableid_t table_id, pagenum_t leaf_num,
+                         leaf_record_t* run, int run_count,
+                         const tree_path_t* path);
 entry_t* prepare_entries_for_split(internal_page_t* old_node_page,
                                    int64_t left_index, int64_t key,
                                    pagenum_t right);
+pagenum_t split_node(int fd, tableid_t table_id, pagenum_t old_node,
+                     int64_t left_index, int64_t key, pagenum_t right,
+                     const tree_path_t* path, int64_t* k_prime);
 int64_t distribute_entries_and_update_children(int fd, tableid_t table_id,
                                                pagenum_t old_node_num,
                                                internal_page_t* old_node_page,
                                                pagenum_t new_node_num,
                                                internal_page_t* new_node_page,
-                                               entry_t* temp_entries);
+                                               entry_t* temp_entries,
+                                               const tree_path_t* path,
+                                               bool append_split);
 void coalesce_internal_nodes(int fd, tableid_t table_id, page_t* neighbor_buf,
                              page_t* target_buf, int neighbor_num,
-                             int64_t k_prime);
+                             int64_t k_prime, const tree_path_t* path);
 void coalesce_leaf_nodes(page_t* neighbor_buf, page_t* target_buf);
 void redistribute_from_left(int fd, tableid_t table_id, pagenum_t target_num,
                             page_t* target_buf, page_t* neighbor_buf,
                             internal_page_t* parent_page, int k_prime_index,
-                            int k_prime);
+                            int k_prime, const tree_path_t* path);
 void redistribute_internal_from_left(int fd, tableid_t table_id,
                                      pagenum_t target_num, page_t* target_buf,
                                      page_t* neighbor_buf,
                                      internal_page_t* parent_page,
-                                     int k_prime_index, int k_prime);
+                                     int k_prime_index, int k_prime,
+                                     const tree_path_t* path);
 void redistribute_leaf_from_left(page_t* target_buf, page_t* neighbor_buf,
                                  internal_page_t* parent_page,
                                  int k_prime_index);
 void redistribute_from_right(int fd, tableid_t table_id, pagenum_t target_num,
                              page_t* target_buf, page_t* neighbor_buf,
                              internal_page_t* parent_page, int k_prime_index,
-                             int k_prime);
+                             int k_prime, const tree_path_t* path);
 void redistribute_internal_from_right(int fd, tableid_t table_id,
                                       pagenum_t target_num, page_t* target_buf,
                                       page_t* neighbor_buf,
                                       internal_page_t* parent_page,
-                                      int k_prime_index, int k_prime);
+                                      int k_prime_index, int k_prime,
+                                      const tree_path_t* path);
 void redistribute_leaf_from_right(page_t* target_buf, page_t* neighbor_buf,
                                   internal_page_t* parent_page,
                                   int k_prime_index);
@@ -55,6 +84,8 @@ int find_neighbor_and_kprime(int fd, tableid_t table_id, pagenum_t target_node,
                              page_header_t* target_header,
                              pagenum_t* neighbor_num_out,
                              int* k_prime_key_index_out);
-int handle_underflow(int fd, tableid_t table_id, pagenum_t target_node);
+int handle_underflow(int fd, tableid_t table_id, pagenum_t target_node,
+                     const tree_path_t* path);
+bool path_keeps_parents(const tree_path_t* path);
 
 #endif
\ No newline at end of file
@@ -3,14 +3,41 @@
 
 #include <pthread.h>
 
+#include <atomic>
 #include <unordered_map>
 
 #include "common_config.h"
+#include "file.h"
 #include "page.h"
+#include "page_table.h"
 
-#define PREFETCH_SIZE 3
-#define INVALID_FRAME -1
+#define MAX_FLUSH_BATCH 64  // max pages per pwritev on flush
 #define INVALID_TABLE_ID -1
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+#ifndef BUF_PARTITION_COUNT
+#define BUF_PARTITION_COUNT 16  // max page table partitions
+#endif
+#define MIN_FRAMES_PER_PARTITION 64  // smaller pools use fewer partitions
+#define PIN_EVICTING -1  // pin_count of a frame claimed by the clock
+#define DEFAULT_CLEANER_INTERVAL_MS 10
+
+#define READAHEAD_MIN_RUN 1       // stream accesses before read-ahead starts
+#define READAHEAD_INIT_WINDOW 4   // first read-ahead of a stream, pages
+#define READAHEAD_MAX_WINDOW 64   // largest read-ahead window, pages
+
+#ifndef LRU_K
+#define LRU_K 2  // references remembered per frame by REPLACE_LRU_K
+#endif
+#define LRU_K_CORRELATED_PERIOD 4  // partition accesses counted as one reference
+#define TWO_Q_A1IN_PERCENT 25      // 2Q A1in share of a partition's frames
+#define TWO_Q_A1OUT_PERCENT 50     // 2Q ghost keys kept, share of frames
+
+// 2Q queue of a frame
+enum ReplQueue { REPL_QUEUE_NONE = 0, REPL_QUEUE_A1IN = 1, REPL_QUEUE_AM = 2 };
+
+// page latch mode, readers share a page and a writer holds it alone
+enum LatchMode { LATCH_SHARED = 0, LATCH_EXCLUSIVE = 1 };
 
 /**
  * dto for make_and_pin_page
@@ -20,70 +47,279 @@ typedef struct {
   pagenum_t page_num;
 } allocated_page_info_t;
 
+/**
+ * pin_count and ref_bit are atomics so a hit can pin without any latch
+ * pin_count == PIN_EVICTING means the clock owns the frame and is replacing
+ * its page; table_id and page_num change only in that state, so a pinner
+ * that won the CAS from a non negative count sees a stable identity
+ * version lets readers skip the page latch (read_buffer_optimistic):
+ * it is odd while an exclusive latch is held and moves by 2 whenever the
+ * clock claims the frame, so an unchanged even version means the frame
+ * still held the same page contents for the whole read
+ */
 typedef struct {
   void* frame;
   tableid_t table_id;
   pagenum_t page_num;
-  bool is_dirty;
-  int pin_count;
-  bool ref_bit;
-  pthread_mutex_t page_latch;
+  std::atomic<bool> is_dirty;
+  std::atomic<int> pin_count;
+  std::atomic<bool> ref_bit;
+  pthread_rwlock_t page_latch;  // LatchMode
+  std::atomic<uint64_t> version;  // see latch_page
+  std::atomic<bool> io_pending;  // frame is still being read from disk
+  std::atomic<bool> prefetch_unused;  // read ahead, not demanded yet
+
+  // replacement policy state
+  uint8_t repl_queue;  // 2Q, ReplQueue
+  uint64_t load_seq;   // 2Q, matches the frame's A1in ring entry
+  std::atomic<uint64_t> access_history[LRU_K];  // LRU-K, newest first, 0 = none
 } buf_ctl_block_t;
 
+// 2Q A1in FIFO entry, stale once the frame leaves A1in or is reloaded
+typedef struct {
+  frame_idx_t frame_idx;
+  uint64_t load_seq;
+} a1in_entry_t;
+
+/**
+ * one shard of the page table
+ * a page always hashes to the same partition and is cached only in
+ * that partition's slice of frames [frame_begin, frame_end),
+ * so lookup and eviction need only the partition latch
+ */
+typedef struct {
+  pthread_mutex_t latch;
+  page_table_t page_table;
+  frame_idx_t frame_begin;
+  frame_idx_t frame_end;
+  frame_idx_t clock_hand;
+
+  std::atomic<uint64_t> hit_count;
+  std::atomic<uint64_t> miss_count;
+
+  // LRU-K logical time
+  std::atomic<uint64_t> access_clock;
+
+  // 2Q, changed only under the partition latch
+  uint64_t load_seq;
+  a1in_entry_t* a1in;  // ring, may hold stale entries
+  int a1in_capacity;
+  int a1in_head;
+  int a1in_len;   // entries in the ring including stale ones
+  int a1in_size;  // frames currently in A1in
+  page_key_t* a1out;  // ring of ghost keys evicted from A1in
+  int a1out_capacity;
+  int a1out_head;
+  int a1out_len;
+  page_table_t a1out_table;  // ghost key -> ring position
+} buf_partition_t;
+
+/**
+ * what find_free_frame_index asks a replacement policy to skip
+ */
+typedef struct {
+  bool skip_dirty;                // leave dirty frames to the page cleaner
+  bool skipped_dirty;             // set if a dirty frame was passed over
+  buf_ctl_block_t* reading_bcb;   // set to a frame passed over for its read
+} victim_scan_t;
+
+/**
+ * replacement policy interface, one instance per ReplacementPolicy
+ * on_load, on_evict and pick_victim run under the partition latch on the
+ * txn path; on_access runs on buffer hits without it
+ * pick_victim returns a frame it claimed with try_claim_for_eviction,
+ * or INVALID_FRAME after one bounded scan
+ */
+typedef struct {
+  const char* name;
+  int (*init)(buf_partition_t* partition);
+  void (*destroy)(buf_partition_t* partition);
+  void (*on_load)(buf_partition_t* partition, buf_ctl_block_t* bcb,
+                  bool prefetched);
+  void (*on_access)(buf_partition_t* partition, buf_ctl_block_t* bcb);
+  void (*on_evict)(buf_partition_t* partition, buf_ctl_block_t* bcb);
+  frame_idx_t (*pick_victim)(buf_partition_t* partition, victim_scan_t* scan);
+} replacement_ops_t;
+
+/**
+ * per table access pattern for read-ahead, only demand misses and first
+ * uses of read-ahead pages are recorded
+ * an access continues the stream if it is the next page number or the
+ * right sibling of the last leaf; anything else ends it and turns
+ * read-ahead off until a new stream shows up
+ */
+typedef struct {
+  pthread_mutex_t latch;
+  pagenum_t last_page;
+  pagenum_t next_sibling;  // right sibling of last_page if it is a leaf
+  int run_length;          // stream accesses in a row
+  int window;              // read-ahead pages, 0 = off
+  pagenum_t ahead_end;     // one past the last page number read ahead
+} readahead_t;
+
 typedef struct {
   buf_ctl_block_t* frames;
   int frames_size;
-  int clock_hand;
-  std::unordered_map<pagenum_t, frame_idx_t> page_table[MAX_TABLE_COUNT + 1];
+  void* frame_arena;  // PAGE_SIZE aligned memory of every frame
+  size_t frame_arena_size;
+  buf_partition_t partitions[BUF_PARTITION_COUNT];
+  int partition_count;
+  const replacement_ops_t* replacer;
+  readahead_t readahead[MAX_TABLE_COUNT + 1];
+  std::atomic<uint64_t> prefetch_issued;
+  std::atomic<uint64_t> prefetch_hits;    // read-ahead pages demanded later
+  std::atomic<uint64_t> prefetch_wasted;  // evicted before any demand
+  // evicted dirty pages whose async write has not completed yet
+  std::unordered_map<pagenum_t, int> pending_writes[MAX_TABLE_COUNT + 1];
 } buffer_manager_t;
 
+/**
+ * staging copy of an evicted dirty page
+ * the frame can be reused as soon as the copy is made
+ * page comes first so a PAGE_SIZE aligned allocation keeps it O_DIRECT safe
+ */
+typedef struct {
+  page_t page;
+  aio_req_t req;
+  tableid_t table_id;
+} write_back_t;
+
+/**
+ * background page cleaner
+ * keeps clean_percent of each partition's frames ahead of its clock hand
+ * clean and unpinned, so foreground evictions rarely write a dirty victim
+ */
+typedef struct {
+  pthread_mutex_t latch;
+  pthread_cond_t cond;
+  pthread_t thread;
+  std::atomic<bool> running;
+  int clean_percent;
+  int interval_ms;
+  std::atomic<uint64_t> pages_written;
+  std::atomic<uint64_t> stalls;
+} page_cleaner_t;
+
 extern buffer_manager_t buf_mgr;
-extern pthread_mutex_t buffer_manager_latch;
+extern page_cleaner_t page_cleaner;
+extern pthread_mutex_t buf_io_latch;
+extern pthread_cond_t buf_io_cond;
+
+// page table partitions
+int init_buf_partitions(int frames_size);
+int init_buf_partitions(int frames_size, ReplacementPolicy policy);
+void clear_buf_partitions(void);
+page_key_t make_page_key(tableid_t table_id, pagenum_t page_num);
+buf_partition_t* get_partition(tableid_t table_id, pagenum_t page_num);
+void insert_page_mapping(tableid_t table_id, pagenum_t page_num,
+                         frame_idx_t frame_idx);
+void erase_page_mapping(tableid_t table_id, pagenum_t page_num);
 
 // flush buffer
 void flush_table_buffer(int fd, tableid_t table_id);
 void flush_all_buffers(void);
 void flush_frame(int fd, tableid_t table_id, frame_idx_t frame_idx);
+void flush_frame_run(int fd, buf_ctl_block_t* bcbs[], int count,
+                     page_t* staging);
 
 // read/write buffer
 header_page_t* read_header_page(int fd, tableid_t table_id);
 buf_ctl_block_t* read_header_page_with_txn(int fd, tableid_t table_id);
-page_t* get_page_from_buffer(
-    pagenum_t page_num,
-    std::unordered_map<pagenum_t, frame_idx_t>& frame_mapper);
+buf_ctl_block_t* read_header_page_with_txn(int fd, tableid_t table_id,
+                                           LatchMode mode);
+page_t* get_page_from_buffer(frame_idx_t frame_idx);
 page_t* read_buffer(int fd, tableid_t table_id, pagenum_t page_num);
 buf_ctl_block_t* read_buffer_with_txn(int fd, tableid_t table_id,
                                       pagenum_t page_num);
+buf_ctl_block_t* read_buffer_with_txn(int fd, tableid_t table_id,
+                                      pagenum_t page_num, LatchMode mode);
+void unlatch_and_unpin(buf_ctl_block_t* bcb, tableid_t table_id,
+                       pagenum_t page_num);
+void latch_page(buf_ctl_block_t* bcb, LatchMode mode);
+void unlatch_page(buf_ctl_block_t* bcb);
+buf_ctl_block_t* read_buffer_optimistic(int fd, tableid_t table_id,
+                                        pagenum_t page_num, uint64_t* version);
+bool validate_page_version(const buf_ctl_block_t* bcb, uint64_t version);
 frame_idx_t load_page_into_buffer(int fd, tableid_t table_id,
                                   pagenum_t page_num);
+void assign_frame(tableid_t table_id, pagenum_t page_num, frame_idx_t frame_idx,
+                  page_t* page_buf, int pin_count, bool prefetched);
 void set_new_bcb(tableid_t table_id, pagenum_t page_num, frame_idx_t frame_idx,
                  page_t* page_buf);
 void set_new_prefetched_bcb(tableid_t table_id, pagenum_t page_num,
                             frame_idx_t frame_idx, page_t* page_buf);
-void prefetch(int fd, pagenum_t page_num, tableid_t table_id,
-              frame_idx_t frame_idx,
-              std::unordered_map<pagenum_t, frame_idx_t>& frame_mapper);
-void prefetch_with_txn(int fd, pagenum_t page_num, tableid_t table_id,
-                       frame_idx_t frame_idx,
-                       std::unordered_map<pagenum_t, frame_idx_t>& frame_mapper,
-                       header_page_t* header_page_ptr);
+void prefetch_pages(int fd, tableid_t table_id, const pagenum_t pages[],
+                    int count, bool with_latch);
+frame_idx_t reserve_frame_for_read(int fd, tableid_t table_id,
+                                   pagenum_t page_num, bool prefetched);
 void write_buffer(tableid_t table_id, pagenum_t page_num, page_t* page);
 allocated_page_info_t make_and_pin_page(int fd, tableid_t table_id);
 frame_idx_t get_frame_index_by_page(tableid_t table_id, pagenum_t page_num);
+frame_idx_t find_pinned_frame(tableid_t table_id, pagenum_t page_num);
 void clear_frame_and_page_table(tableid_t table_id, pagenum_t page_num,
                                 frame_idx_t frame_idx);
 void free_page_in_buffer(int fd, tableid_t table_id, pagenum_t page_num);
 
+// async frame I/O
+void finish_frame_io(buf_ctl_block_t* bcb);
+void wait_for_frame_io(buf_ctl_block_t* bcb);
+void on_frame_read_complete(aio_req_t* req);
+void write_back_async(int fd, tableid_t table_id, pagenum_t page_num,
+                      const page_t* frame);
+void on_write_back_complete(aio_req_t* req);
+bool is_write_back_pending(tableid_t table_id, pagenum_t page_num);
+void wait_for_page_write_back(tableid_t table_id, pagenum_t page_num);
+void wait_for_table_write_backs(tableid_t table_id);
+write_back_t* stage_write_back(tableid_t table_id, pagenum_t page_num,
+                               const page_t* frame);
+void release_write_back(write_back_t* write_back, pagenum_t page_num);
+
+// page cleaner
+int start_page_cleaner(int clean_percent, int interval_ms);
+void stop_page_cleaner(void);
+void* page_cleaner_func(void* arg);
+void wake_page_cleaner(void);
+void clean_buffer_pass(void);
+int clean_partition(buf_partition_t* partition, int clean_percent);
+void write_clean_frames(buf_ctl_block_t* bcbs[], int count);
+bool try_claim_for_cleaning(buf_ctl_block_t* bcb);
+void get_page_cleaner_stats(page_cleaner_stats_t* stats);
+void reset_page_cleaner_stats(void);
+
 // set pin count
 void pin(tableid_t table_id, pagenum_t page_num);
 void pin_frame(frame_idx_t frame_idx);
+bool try_pin_bcb(buf_ctl_block_t* bcb);
+buf_ctl_block_t* pin_resident_page(tableid_t table_id, pagenum_t page_num);
 void unpin(tableid_t table_id, pagenum_t page_num);
 void unpin_bcb(buf_ctl_block_t* bcb);
 void mark_dirty(tableid_t table_id, pagenum_t page_num);
 
-// clock algorithm
-void update_clock_hand(void);
+// eviction
+void update_clock_hand(buf_partition_t* partition);
+bool try_claim_for_eviction(buf_ctl_block_t* bcb);
 frame_idx_t find_free_frame_index(int fd, tableid_t table_id,
                                   pagenum_t page_num);
+void evict_frame(buf_partition_t* partition, frame_idx_t frame_idx);
+void report_no_victim(buf_partition_t* partition);
+void get_buffer_stats(buffer_stats_t* stats);
+void reset_buffer_stats(void);
+
+// read-ahead (buf_readahead.cpp)
+void init_readahead(void);
+void clear_readahead(void);
+void readahead_on_access(int fd, tableid_t table_id, pagenum_t page_num,
+                         pagenum_t right_sibling, bool with_latch);
+pagenum_t leaf_right_sibling(const page_t* page);
+pagenum_t get_table_page_count(tableid_t table_id);
+bool consume_prefetch_hit(buf_ctl_block_t* bcb);
+void note_prefetch_dropped(buf_ctl_block_t* bcb);
+
+// replacement policies (buf_replacement.cpp)
+const replacement_ops_t* get_replacement_ops(ReplacementPolicy policy);
+bool is_victim_candidate(buf_ctl_block_t* bcb, victim_scan_t* scan);
+void note_frame_access(buf_partition_t* partition, buf_ctl_block_t* bcb);
+frame_idx_t clock_pick_victim(buf_partition_t* partition, victim_scan_t* scan,
+                              bool skip_a1in);
 
 #endif
\ No newline at end of file
@@ -20,5 +20,35 @@ typedef int txnid_t;
 
 enum LockMode { S_LOCK = 0, X_LOCK = 1 };
 enum LockState { ACQUIRED = 0, NEED_TO_WAIT = 1, DEADLOCK = 2 };
+// SYNC_EVERY_WRITE: fsync after every page write
+// SYNC_DEFERRED: page cache only, fsync at sync points (db_sync, close, ...)
+enum SyncMode { SYNC_EVERY_WRITE = 0, SYNC_DEFERRED = 1 };
+
+// buffer pool replacement policy, chosen at init_db
+// REPLACE_CLOCK: second chance clock
+// REPLACE_2Q: new pages wait in a FIFO (A1in) and only pages referenced again
+//   after leaving it reach the main queue (Am), so one-time scans stay in A1in
+// REPLACE_LRU_K: evict the page whose K-th most recent reference is oldest
+enum ReplacementPolicy { REPLACE_CLOCK = 0, REPLACE_2Q = 1, REPLACE_LRU_K = 2 };
+
+// buffer pool lookups
+typedef struct {
+  uint64_t hits;
+  uint64_t misses;  // demand reads, prefetched pages are not counted
+  uint64_t prefetched;       // pages read ahead
+  uint64_t prefetch_hits;    // read-ahead pages that were used
+  uint64_t prefetch_wasted;  // read-ahead pages evicted unused
+} buffer_stats_t;
+
+// background page cleaner counters
+typedef struct {
+  uint64_t pages_written;  // dirty pages written by the cleaner
+  uint64_t stalls;         // foreground evictions that found no clean frame
+} page_cleaner_stats_t;
+
+// db_bulk_load input, key 오름차순으로 record를 하나씩 넘겨줌
+// record를 채웠으면 0, 더 없으면 -1
+typedef int (*bulk_load_next_t)(void* ctx, int64_t* key, const char** value,
+                                uint16_t* length);
 
 #endif
\ No newline at end of file
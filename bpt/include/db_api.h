@@ -2,6 +2,7 @@
 #define DB_API_H
 
 #include <fcntl.h>
+#include <pthread.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -13,22 +14,75 @@
 
 #define PATH_NAME_MAX_LENGTH 20
 
+/**
+ * how open_table opens the data file
+ * OPEN_DIRECT bypasses the kernel page cache (O_DIRECT),
+ * pages are cached only once, in the buffer pool
+ */
+enum TableOpenMode { OPEN_BUFFERED = 0, OPEN_DIRECT = 1 };
+
 typedef struct {
   char path[PATH_NAME_MAX_LENGTH + 1];
   int fd;
+  TableOpenMode open_mode;
 } table_info_t;
 
+// range scan cursor (bpt.h)
+struct cursor_t;
+
 extern table_info_t table_infos[MAX_TABLE_COUNT + 1];
 extern std::unordered_map<std::string, tableid_t> path_table_mapper;
+extern pthread_mutex_t table_sync_latch;
 
 int init_db(int buf_num);
+int init_db(int buf_num, ReplacementPolicy policy);
 int open_table(char* pathname);
+int open_table(char* pathname, TableOpenMode open_mode);
 int db_insert(tableid_t table_id, int64_t key, char* value);
+int db_insert(tableid_t table_id, int64_t key, const char* value,
+              uint16_t length);
+int db_insert_batch(tableid_t table_id, const int64_t keys[], char* values[],
+                    int n);
+int db_insert_batch(tableid_t table_id, const int64_t keys[],
+                    const char* const values[], const uint16_t lengths[],
+                    int n);
 int db_find(int table_id, int64_t key, char* ret_val);
+int db_find(tableid_t table_id, int64_t key, char* ret_val, uint16_t* length);
+int db_find_prefix(tableid_t table_id, int64_t key, char* ret_val,
+                   uint16_t prefix_length, uint16_t* value_length);
+int db_find_batch(tableid_t table_id, const int64_t keys[], int n,
+                  char* out_values[], int out_status[]);
+int db_find_batch(tableid_t table_id, const int64_t keys[], int n,
+                  char* out_values[], uint16_t lengths[], int out_status[]);
 int db_find(tableid_t table_id, int64_t key, char* ret_val, int txn_id);
+cursor_t* db_cursor_open(tableid_t table_id);
+int db_cursor_seek(cursor_t* cursor, int64_t key_start);
+int db_cursor_seek(cursor_t* cursor, int64_t key_start, int64_t key_end);
+int db_cursor_seek_reverse(cursor_t* cursor, int64_t key_start);
+int db_cursor_seek_reverse(cursor_t* cursor, int64_t key_start,
+                           int64_t key_end);
+int db_cursor_next(cursor_t* cursor, int64_t* key, char* value);
+int db_cursor_next(cursor_t* cursor, int64_t* key, char* value,
+                   uint16_t* length);
+void db_cursor_close(cursor_t* cursor);
 int db_update(int table_id, int64_t key, char* values, int txn_id);
 int db_delete(tableid_t table_id, int64_t key);
+int db_insert_concurrent(tableid_t table_id, int64_t key, const char* value,
+                         uint16_t length);
+int db_delete_concurrent(tableid_t table_id, int64_t key);
+int db_find_concurrent(tableid_t table_id, int64_t key, char* ret_val,
+                       uint16_t* length);
+int db_bulk_load(tableid_t table_id, bulk_load_next_t next, void* ctx);
+int db_bulk_load(tableid_t table_id, bulk_load_next_t next, void* ctx,
+                 int fill_percent);
+int db_set_leaf_format(tableid_t table_id, uint32_t format);
+int db_set_tree_mode(tableid_t table_id, uint32_t mode);
 int close_table(tableid_t table_id);
+int db_sync(tableid_t table_id);
+int db_set_durability(SyncMode mode, int sync_interval_ms);
+int db_set_page_cleaner(int clean_percent, int interval_ms);
+void db_get_page_cleaner_stats(page_cleaner_stats_t* stats);
+void db_get_buffer_stats(buffer_stats_t* stats);
 int shutdown_db(void);
 void db_print_tree(tableid_t table_id);
 void db_print_leaves(tableid_t table_id);
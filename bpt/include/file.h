@@ -1,12 +1,88 @@
 #ifndef FILE_H
 #define FILE_H
 
+#include <pthread.h>
+
 #include "common_config.h"
 #include "page.h"
 
+#define AIO_QUEUE_DEPTH 64  // max async requests in flight
+#define AIO_WORKER_COUNT 4  // thread pool backend workers
+
+enum AioBackend { AIO_SYNC = 0, AIO_IO_URING = 1, AIO_THREAD_POOL = 2 };
+
+struct aio_req_t;
+typedef void (*aio_callback_t)(struct aio_req_t* req);
+
+/**
+ * one async page read/write
+ * if on_complete is set it owns req after completion,
+ * otherwise the submitter waits with file_aio_wait
+ */
+typedef struct aio_req_t {
+  int fd;
+  pagenum_t pagenum;
+  page_t* buf;
+  bool is_write;
+  aio_callback_t on_complete;
+  void* ctx;
+  bool done;
+} aio_req_t;
+
+/**
+ * fill req for an async read of one page into dest
+ * on_complete(req) runs on an I/O thread once dest is filled
+ */
+inline void file_aio_prep_read(aio_req_t* req, int fd, pagenum_t pagenum,
+                               page_t* dest, aio_callback_t on_complete,
+                               void* ctx) {
+  req->fd = fd;
+  req->pagenum = pagenum;
+  req->buf = dest;
+  req->is_write = false;
+  req->on_complete = on_complete;
+  req->ctx = ctx;
+  req->done = false;
+}
+
+/**
+ * fill req for an async write of src to one page
+ * src must stay valid until completion, follows the sync mode
+ */
+inline void file_aio_prep_write(aio_req_t* req, int fd, pagenum_t pagenum,
+                                const page_t* src, aio_callback_t on_complete,
+                                void* ctx) {
+  req->fd = fd;
+  req->pagenum = pagenum;
+  req->buf = (page_t*)src;
+  req->is_write = true;
+  req->on_complete = on_complete;
+  req->ctx = ctx;
+  req->done = false;
+}
+
 pagenum_t file_alloc_page(int fd);
 void file_free_page(int fd, pagenum_t pagenum);
 void file_read_page(int fd, pagenum_t pagenum, page_t* dest);
 void file_write_page(int fd, pagenum_t pagenum, const page_t* src);
 
-#endif
\ No newline at end of file
+// vectored I/O for runs of adjacent pages
+void file_read_pages(int fd, pagenum_t start_pagenum, page_t* dests[],
+                     int count);
+void file_write_pages(int fd, pagenum_t start_pagenum,
+                      const page_t* const srcs[], int count);
+
+// durability
+void file_set_sync_mode(SyncMode mode);
+SyncMode file_get_sync_mode(void);
+void file_sync(int fd);
+
+// async I/O engine (io_uring, falls back to a pread/pwrite thread pool)
+int file_aio_init(void);
+void file_aio_shutdown(void);
+AioBackend file_aio_backend(void);
+void file_aio_submit(aio_req_t* reqs[], int count);
+void file_aio_submit_nowait(aio_req_t* reqs[], int count);
+void file_aio_wait(aio_req_t* req);
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef LEAF_PAGE_H
+#define LEAF_PAGE_H
+
+#include <stddef.h>
+#include <string.h>
+
+#include "page.h"
+
+/**
+ * leaf record 접근
+ * leaf는 format에 따라 {key, value} record 배열(LEAF_FORMAT_RECORDS),
+ * key 배열 + value 배열(LEAF_FORMAT_KEY_ARRAY), slot + 가변길이
+ * value(LEAF_FORMAT_SLOTTED)이므로 records[]를 직접 쓰지 말고 아래 함수들을
+ * 사용
+ */
+
+static_assert(sizeof(leaf_page_t) == PAGE_SIZE, "leaf page size");
+static_assert(sizeof(key_array_leaf_page_t) == PAGE_SIZE,
+              "key array leaf page size");
+static_assert(sizeof(slotted_leaf_page_t) == PAGE_SIZE,
+              "slotted leaf page size");
+static_assert(offsetof(key_array_leaf_page_t, left_sibling_page_num) ==
+                      offsetof(leaf_page_t, left_sibling_page_num) &&
+                  offsetof(slotted_leaf_page_t, left_sibling_page_num) ==
+                      offsetof(leaf_page_t, left_sibling_page_num),
+              "leaf sibling links at the same place in every format");
+static_assert(offsetof(key_array_leaf_page_t, high_key) ==
+                      offsetof(leaf_page_t, high_key) &&
+                  offsetof(slotted_leaf_page_t, high_key) ==
+                      offsetof(leaf_page_t, high_key) &&
+                  offsetof(internal_page_t, high_key) ==
+                      offsetof(leaf_page_t, high_key),
+              "high key at the same place in every page");
+static_assert(sizeof(overflow_page_t) == PAGE_SIZE, "overflow page size");
+static_assert(sizeof(overflow_ref_t) <= SLOTTED_MAX_VALUE_SIZE,
+              "overflow ref must fit in a slotted leaf");
+
+inline bool leaf_has_key_array(const leaf_page_t* leaf) {
+  return leaf->format == LEAF_FORMAT_KEY_ARRAY;
+}
+
+inline bool leaf_is_slotted(const leaf_page_t* leaf) {
+  return leaf->format == LEAF_FORMAT_SLOTTED;
+}
+
+inline key_array_leaf_page_t* as_key_array(leaf_page_t* leaf) {
+  return (key_array_leaf_page_t*)leaf;
+}
+
+inline const key_array_leaf_page_t* as_key_array(const leaf_page_t* leaf) {
+  return (const key_array_leaf_page_t*)leaf;
+}
+
+inline slotted_leaf_page_t* as_slotted(leaf_page_t* leaf) {
+  return (slotted_leaf_page_t*)leaf;
+}
+
+inline const slotted_leaf_page_t* as_slotted(const leaf_page_t* leaf) {
+  return (const slotted_leaf_page_t*)leaf;
+}
+
+inline int64_t leaf_key(const leaf_page_t* leaf, int index) {
+  if (leaf_has_key_array(leaf)) {
+    return as_key_array(leaf)->keys[index];
+  }
+  if (leaf_is_slotted(leaf)) {
+    return as_slotted(leaf)->slots[index].key;
+  }
+  return leaf->records[index].key;
+}
+
+inline char* leaf_value(leaf_page_t* leaf, int index) {
+  if (leaf_has_key_array(leaf)) {
+    return as_key_array(leaf)->values[index];
+  }
+  if (leaf_is_slotted(leaf)) {
+    slotted_leaf_page_t* sleaf = as_slotted(leaf);
+    return sleaf->body + sleaf->slots[index].offset;
+  }
+  return leaf->records[index].value;
+}
+
+inline const char* leaf_value(const leaf_page_t* leaf, int index) {
+  return leaf_value((leaf_page_t*)leaf, index);
+}
+
+/**
+ * value 길이, 고정 길이 format은 항상 VALUE_SIZE
+ */
+inline uint16_t leaf_value_length(const leaf_page_t* leaf, int index) {
+  if (leaf_is_slotted(leaf)) {
+    return as_slotted(leaf)->slots[index].length;
+  }
+  return VALUE_SIZE;
+}
+
+/**
+ * SLOT_OVERFLOW 등 slot flag, 고정 길이 format은 항상 0
+ */
+inline uint32_t leaf_value_flags(const leaf_page_t* leaf, int index) {
+  if (leaf_is_slotted(leaf)) {
+    return as_slotted(leaf)->slots[index].flags;
+  }
+  return 0;
+}
+
+/**
+ * value가 overflow page chain에 있으면 true
+ */
+inline bool leaf_is_overflow(const leaf_page_t* leaf, int index) {
+  return (leaf_value_flags(leaf, index) & SLOT_OVERFLOW) != 0;
+}
+
+/**
+ * overflow slot의 overflow_ref_t 복사, body 안의 위치는 정렬되어 있지 않음
+ */
+inline void leaf_overflow_ref(const leaf_page_t* leaf, int index,
+                              overflow_ref_t* ref) {
+  memcpy(ref, leaf_value(leaf, index), sizeof(overflow_ref_t));
+}
+
+inline void leaf_set_key(leaf_page_t* leaf, int index, int64_t key) {
+  if (leaf_has_key_array(leaf)) {
+    as_key_array(leaf)->keys[index] = key;
+  } else if (leaf_is_slotted(leaf)) {
+    as_slotted(leaf)->slots[index].key = key;
+  } else {
+    leaf->records[index].key = key;
+  }
+}
+
+// bptree_leaf.cpp
+void leaf_reset(leaf_page_t* leaf);
+uint16_t leaf_max_value_size(const leaf_page_t* leaf);
+int leaf_record_size(const leaf_page_t* leaf, uint16_t length);
+bool leaf_has_room(const leaf_page_t* leaf, uint16_t length);
+bool leaf_can_merge(const leaf_page_t* dest, const leaf_page_t* src);
+int leaf_insert_record(leaf_page_t* leaf, int index, int64_t key,
+                       const char* value, uint16_t length, uint32_t flags);
+void leaf_remove_record(leaf_page_t* leaf, int index);
+int leaf_update_value(leaf_page_t* leaf, int index, const char* value,
+                      uint16_t length);
+uint16_t prepare_fixed_value(char* dest, const char* value);
+void copy_leaf_value(char* dest, const leaf_page_t* leaf, int index);
+
+#endif
@@ -5,7 +5,7 @@
 #include "stdint.h"
 
 #define PAGE_SIZE 4096
-#define HEADER_PAGE_RESERVED 4072
+#define HEADER_PAGE_RESERVED 4048
 #ifndef NON_HEADER_PAGE_RESERVED
 #define NON_HEADER_PAGE_RESERVED 104
 #endif
@@ -19,8 +19,36 @@
 #define ENTRY_CNT 248
 #endif
 #define UNUSED_SIZE 4088
+// leaf에서 page header(parent ~ right sibling) 뒤의 크기
+#define LEAF_BODY_SIZE (PAGE_SIZE - 24 - NON_HEADER_PAGE_RESERVED)
+// slotted leaf value 최대 길이, split한 두 leaf에 항상 들어가도록 body의 1/4
+#define SLOTTED_MAX_VALUE_SIZE (LEAF_BODY_SIZE / 4 - 16)
 #define LEAF 1
 #define INTERNAL 0
+#define OVERFLOW 2  // overflow_page_t::is_leaf
+// leaf record layout, leaf_page_t::format
+#define LEAF_FORMAT_RECORDS 0    // {key, value} records (files before format)
+#define LEAF_FORMAT_KEY_ARRAY 1  // keys[] first, values[] after
+#define LEAF_FORMAT_SLOTTED 2    // slot directory + variable length values
+#ifndef DEFAULT_LEAF_FORMAT
+#define DEFAULT_LEAF_FORMAT LEAF_FORMAT_KEY_ARRAY  // for new files
+#endif
+// how insert/delete find parents, header_page_t::tree_mode
+#define TREE_MODE_PARENT_POINTERS 0  // every page keeps parent_page_num
+#define TREE_MODE_PATH 1  // no parent_page_num, parents from the descent path
+#ifndef DEFAULT_TREE_MODE
+#define DEFAULT_TREE_MODE TREE_MODE_PARENT_POINTERS  // for new files
+#endif
+// slot_t::flags
+#define SLOT_OVERFLOW 0x1  // value가 overflow page chain에, body에는 overflow_ref_t
+// overflow page 하나에 담는 value byte
+#define OVERFLOW_DATA_SIZE (PAGE_SIZE - 16)
+// overflow value 중 leaf에 남기는 앞부분, prefix만 읽을때는 chain을 읽지 않음
+#ifndef OVERFLOW_PREFIX_SIZE
+#define OVERFLOW_PREFIX_SIZE \
+  (SLOTTED_MAX_VALUE_SIZE >= 80 ? 64 : SLOTTED_MAX_VALUE_SIZE - 16)
+#endif
+#define OVERFLOW_MAX_VALUE_SIZE UINT16_MAX
 #define PAGE_NULL 0
 #define HEADER_PAGE_POS 0
 
@@ -28,6 +56,9 @@ typedef struct {
   pagenum_t free_page_num;
   pagenum_t root_page_num;
   pagenum_t num_of_pages;
+  uint64_t leaf_format;  // format of new leaves, 0 in old files
+  uint64_t tree_mode;    // TREE_MODE_*, 0 in old files
+  uint64_t high_keys;    // 1이면 page마다 high_key가 있음, 0 in old files
   char reserved[HEADER_PAGE_RESERVED];  // not used
 } header_page_t;
 
@@ -50,24 +81,97 @@ typedef struct {
 } entry_t;
 
 // leaf page
+// records는 format이 LEAF_FORMAT_RECORDS일때만 유효, 접근은 leaf_page.h로
 typedef struct {
   // header
   pagenum_t parent_page_num;
   uint32_t is_leaf;  // 1
   uint32_t num_of_keys;
-  char reserved[NON_HEADER_PAGE_RESERVED];  // not used
-  pagenum_t right_sibling_page_num;         // if rihgtmost, 0
+  uint32_t format;  // LEAF_FORMAT_*, 예전 파일은 0
+  char reserved[NON_HEADER_PAGE_RESERVED - 20];  // not used
+  // right sibling부터의 key, right_sibling_page_num이 0이면 의미 없음
+  int64_t high_key;
+  pagenum_t left_sibling_page_num;  // if leftmost or written before, 0
+  pagenum_t right_sibling_page_num;  // if rihgtmost, 0
 
   record_t records[RECORD_CNT];
 } leaf_page_t;
 
+// leaf page, LEAF_FORMAT_KEY_ARRAY
+// key들이 연속이라 탐색은 key 배열만 읽음 (31개 기준 cache line 4개)
+typedef struct {
+  // header, leaf_page_t와 같음
+  pagenum_t parent_page_num;
+  uint32_t is_leaf;  // 1
+  uint32_t num_of_keys;
+  uint32_t format;  // LEAF_FORMAT_KEY_ARRAY
+  char reserved[NON_HEADER_PAGE_RESERVED - 20];  // not used
+  int64_t high_key;
+  pagenum_t left_sibling_page_num;
+  pagenum_t right_sibling_page_num;
+
+  int64_t keys[RECORD_CNT];
+  char values[RECORD_CNT][VALUE_SIZE];
+} key_array_leaf_page_t;
+
+// slotted leaf의 slot, key 순서로 정렬
+typedef struct {
+  int64_t key;
+  uint16_t offset;  // value 위치, body 시작 기준
+  uint16_t length;  // value 길이, overflow면 overflow_ref_t 크기
+  uint32_t flags;   // SLOT_OVERFLOW
+} slot_t;
+
+// SLOT_OVERFLOW slot의 value, 긴 value의 앞부분과 나머지가 있는 chain
+typedef struct {
+  pagenum_t first_page_num;  // chain 첫 overflow page
+  uint32_t value_length;     // prefix를 포함한 전체 길이
+  uint32_t page_count;       // chain의 page 수
+  char prefix[OVERFLOW_PREFIX_SIZE];
+} overflow_ref_t;
+
+// leaf page, LEAF_FORMAT_SLOTTED
+// slot은 body 앞에서부터, value는 body 끝에서부터 채움
+// 지운 value 자리는 공간이 모자랄때 compact로 회수
+typedef struct {
+  // header, leaf_page_t와 같음
+  pagenum_t parent_page_num;
+  uint32_t is_leaf;  // 1
+  uint32_t num_of_keys;
+  uint32_t format;         // LEAF_FORMAT_SLOTTED
+  uint16_t heap_start;     // 가장 앞 value의 offset, 비어있으면 LEAF_BODY_SIZE
+  uint16_t payload_bytes;  // 살아있는 value 길이 합
+  char reserved[NON_HEADER_PAGE_RESERVED - 24];  // not used
+  int64_t high_key;
+  pagenum_t left_sibling_page_num;
+  pagenum_t right_sibling_page_num;
+
+  union {
+    slot_t slots[LEAF_BODY_SIZE / sizeof(slot_t)];
+    char body[LEAF_BODY_SIZE];
+  };
+} slotted_leaf_page_t;
+
+// overflow page, 긴 value에서 prefix 뒤의 byte를 순서대로 나눠 담음
+// is_leaf 자리에 OVERFLOW를 두어 leaf나 internal로 읽히지 않게 함
+typedef struct {
+  pagenum_t next_page_num;  // 마지막 page면 PAGE_NULL
+  uint32_t is_leaf;         // OVERFLOW
+  uint32_t data_length;     // data에 담긴 byte
+  char data[OVERFLOW_DATA_SIZE];
+} overflow_page_t;
+
 // internal page
 typedef struct {
   // header
   pagenum_t parent_page_num;
   int32_t is_leaf;  // 0
   int32_t num_of_keys;
-  char reserved[NON_HEADER_PAGE_RESERVED];  // not used
+  char reserved[NON_HEADER_PAGE_RESERVED - 16];  // not used
+  // leaf처럼 같은 level의 오른쪽 page와 그 page부터의 key (B-link)
+  // split이 부모보다 먼저 여기에 보이므로 reader는 오른쪽으로 따라감
+  int64_t high_key;
+  pagenum_t right_sibling_page_num;  // if rightmost or written before, 0
   pagenum_t one_more_page_num;  // leftmost page num to know key ranges
 
   entry_t entries[ENTRY_CNT];
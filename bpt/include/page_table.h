@@ -0,0 +1,42 @@
+#ifndef PAGE_TABLE_H
+#define PAGE_TABLE_H
+
+#include "common_config.h"
+
+#define INVALID_FRAME -1
+#define PAGE_KEY_EMPTY UINT64_MAX  // marks an unused slot
+
+typedef uint64_t page_key_t;  // (table_id, page_num)
+
+typedef struct {
+  page_key_t key;
+  frame_idx_t frame_idx;
+} page_table_slot_t;
+
+/**
+ * fixed capacity open addressing hash table: page key -> frame index
+ * slots hold the key and frame index inline, linear probing,
+ * capacity is a power of two at least twice max_entries
+ * so a hit is normally found in the first slot probed
+ * writers hold the partition latch; slot fields are stored with relaxed
+ * atomics so page_table_find_unlatched may probe concurrently
+ */
+typedef struct {
+  page_table_slot_t* slots;
+  uint64_t mask;  // capacity - 1
+  int shift;      // 64 - log2(capacity), hash의 상위 비트로 slot 선택
+  int size;
+} page_table_t;
+
+int page_table_init(page_table_t* table, int max_entries);
+void page_table_destroy(page_table_t* table);
+void page_table_clear(page_table_t* table);
+frame_idx_t page_table_find(const page_table_t* table, page_key_t key);
+frame_idx_t page_table_find_unlatched(const page_table_t* table,
+                                      page_key_t key);
+void page_table_insert(page_table_t* table, page_key_t key,
+                       frame_idx_t frame_idx);
+bool page_table_erase(page_table_t* table, page_key_t key);
+uint64_t hash_page_key(page_key_t key);
+
+#endif
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <vector>
+
 #include "bpt.h"
 #include "bpt_internal.h"
 #include "buf_mgr.h"
@@ -16,16 +19,21 @@ int find(int fd, tableid_t table_id, int64_t key, char* result_buf) {
   // leaf_page 에서 키에 해당하는 값 찾기
   leaf_page_t* leaf_page = (leaf_page_t*)read_buffer(fd, table_id, leaf_num);
 
-  int index = 0;
+  int index = leaf_find_index(leaf_page, key);
 
-  for (index = 0; index < leaf_page->num_of_keys; index++) {
-    if (leaf_page->records[index].key == key) {
-      break;
-    }
-  }
   // 해당하는 키를 찾았으면
-  if (index != leaf_page->num_of_keys) {
-    copy_value(result_buf, leaf_page->records[index].value, VALUE_SIZE);
+  if (index != -1 && leaf_is_overflow(leaf_page, index)) {
+    // 문자열로 돌려줄 VALUE_SIZE - 1 byte까지만 chain에서 읽음
+    overflow_ref_t ref;
+    leaf_overflow_ref(leaf_page, index, &ref);
+    unpin(table_id, leaf_num);
+
+    memset(result_buf, 0, VALUE_SIZE);
+    read_overflow_value(fd, table_id, &ref, result_buf, VALUE_SIZE - 1);
+    return SUCCESS;
+  }
+  if (index != -1) {
+    copy_leaf_value(result_buf, leaf_page, index);
 
     unpin(table_id, leaf_num);
     return SUCCESS;
@@ -35,6 +43,278 @@ int find(int fd, tableid_t table_id, int64_t key, char* result_buf) {
   return FAILURE;
 }
 
+/**
+ * 길이를 아는 find, length는 들어올때 result_buf 크기, 나갈때 value 길이
+ * 고정 길이 leaf의 value는 항상 VALUE_SIZE
+ * 버퍼가 작으면 length에 필요한 크기를 넣고 -1
+ */
+int find(int fd, tableid_t table_id, int64_t key, char* result_buf,
+         uint16_t* length) {
+  pagenum_t leaf_num = find_leaf(fd, table_id, key);
+  if (leaf_num == PAGE_NULL) {
+    return FAILURE;
+  }
+
+  leaf_page_t* leaf_page = (leaf_page_t*)read_buffer(fd, table_id, leaf_num);
+
+  int index = leaf_find_index(leaf_page, key);
+  int result = FAILURE;
+  if (index != -1 && leaf_is_overflow(leaf_page, index)) {
+    overflow_ref_t ref;
+    leaf_overflow_ref(leaf_page, index, &ref);
+    unpin(table_id, leaf_num);
+
+    if (ref.value_length <= *length) {
+      read_overflow_value(fd, table_id, &ref, result_buf, ref.value_length);
+      result = SUCCESS;
+    }
+    *length = ref.value_length;
+    return result;
+  }
+  if (index != -1) {
+    uint16_t value_length = leaf_value_length(leaf_page, index);
+    if (value_length <= *length) {
+      memcpy(result_buf, leaf_value(leaf_page, index), value_length);
+      result = SUCCESS;
+    }
+    *length = value_length;
+  }
+
+  unpin(table_id, leaf_num);
+  return result;
+}
+
+/**
+ * key가 있는지만 확인, value는 읽지 않음
+ * If found, return 0. Otherwise, return -1
+ */
+int find_key(int fd, tableid_t table_id, int64_t key) {
+  pagenum_t leaf_num = find_leaf(fd, table_id, key);
+  if (leaf_num == PAGE_NULL) {
+    return FAILURE;
+  }
+
+  leaf_page_t* leaf_page = (leaf_page_t*)read_buffer(fd, table_id, leaf_num);
+  int index = leaf_find_index(leaf_page, key);
+  unpin(table_id, leaf_num);
+  return index == -1 ? FAILURE : SUCCESS;
+}
+
+/**
+ * value의 앞 prefix_length byte만 읽는 find, value_length에 전체 길이
+ * overflow value라도 OVERFLOW_PREFIX_SIZE 이하는 leaf에서 끝나고
+ * 더 길면 필요한 overflow page까지만 읽음
+ * 읽은 byte는 min(prefix_length, value_length)
+ */
+int find_prefix(int fd, tableid_t table_id, int64_t key, char* result_buf,
+                uint16_t prefix_length, uint16_t* value_length) {
+  pagenum_t leaf_num = find_leaf(fd, table_id, key);
+  if (leaf_num == PAGE_NULL) {
+    return FAILURE;
+  }
+
+  leaf_page_t* leaf_page = (leaf_page_t*)read_buffer(fd, table_id, leaf_num);
+  int index = leaf_find_index(leaf_page, key);
+  if (index == -1) {
+    unpin(table_id, leaf_num);
+    return FAILURE;
+  }
+
+  if (leaf_is_overflow(leaf_page, index)) {
+    overflow_ref_t ref;
+    leaf_overflow_ref(leaf_page, index, &ref);
+    unpin(table_id, leaf_num);
+
+    read_overflow_value(fd, table_id, &ref, result_buf, prefix_length);
+    *value_length = ref.value_length;
+    return SUCCESS;
+  }
+
+  uint16_t length = leaf_value_length(leaf_page, index);
+  memcpy(result_buf, leaf_value(leaf_page, index),
+         prefix_length < length ? prefix_length : length);
+  *value_length = length;
+  unpin(table_id, leaf_num);
+  return SUCCESS;
+}
+
+// find_batch에서 같은 leaf로 가는 key들, order[begin, end)
+typedef struct {
+  pagenum_t leaf_num;
+  int begin;
+  int end;
+} find_batch_group_t;
+
+/**
+ * helper function for find_batch
+ * leaf를 한번 읽어 group의 key들에 답하고, 찾은 개수를 돌려줌
+ * lengths가 NULL이면 find(result_buf)처럼 VALUE_SIZE 버퍼에 씀
+ * overflow value는 find처럼 leaf를 unpin한 뒤에 읽음
+ */
+static int answer_leaf_group(int fd, tableid_t table_id,
+                             const find_batch_group_t* group,
+                             const int64_t keys[], const int order[],
+                             char* out_values[], uint16_t lengths[],
+                             int out_status[]) {
+  leaf_page_t* leaf_page =
+      (leaf_page_t*)read_buffer(fd, table_id, group->leaf_num);
+  std::vector<std::pair<int, overflow_ref_t>> overflows;
+  int found = 0;
+  for (int pos = group->begin; pos < group->end; pos++) {
+    int i = order[pos];
+    out_status[i] = FAILURE;
+    int index = leaf_find_index(leaf_page, keys[i]);
+    if (index == -1) {
+      continue;
+    }
+    if (leaf_is_overflow(leaf_page, index)) {
+      overflow_ref_t ref;
+      leaf_overflow_ref(leaf_page, index, &ref);
+      overflows.push_back(std::make_pair(i, ref));
+      continue;
+    }
+    if (lengths == NULL) {
+      copy_leaf_value(out_values[i], leaf_page, index);
+      out_status[i] = SUCCESS;
+    } else {
+      uint16_t value_length = leaf_value_length(leaf_page, index);
+      if (value_length <= lengths[i]) {
+        memcpy(out_values[i], leaf_value(leaf_page, index), value_length);
+        out_status[i] = SUCCESS;
+      }
+      lengths[i] = value_length;
+    }
+    if (out_status[i] == SUCCESS) {
+      found++;
+    }
+  }
+  unpin(table_id, group->leaf_num);
+
+  for (const std::pair<int, overflow_ref_t>& overflow : overflows) {
+    int i = overflow.first;
+    const overflow_ref_t* ref = &overflow.second;
+    if (lengths == NULL) {
+      memset(out_values[i], 0, VALUE_SIZE);
+      read_overflow_value(fd, table_id, ref, out_values[i], VALUE_SIZE - 1);
+      out_status[i] = SUCCESS;
+    } else {
+      if (ref->value_length <= lengths[i]) {
+        read_overflow_value(fd, table_id, ref, out_values[i],
+                            ref->value_length);
+        out_status[i] = SUCCESS;
+      }
+      lengths[i] = ref->value_length;
+    }
+    if (out_status[i] == SUCCESS) {
+      found++;
+    }
+  }
+  return found;
+}
+
+/**
+ * helper function for find_batch
+ * key를 정렬해 leaf 부모에서 다음 key들의 leaf를 FIND_BATCH_PREFETCH_DEPTH개
+ * 까지 정하고, 그 leaf들을 prefetch한 뒤 leaf마다 한번씩 읽어 답함
+ * 부모는 fence 밖의 key가 나올때만 다시 내려가서 찾음
+ */
+static int find_batch_sorted(int fd, tableid_t table_id, const int64_t keys[],
+                             int n, char* out_values[], uint16_t lengths[],
+                             int out_status[]) {
+  if (n <= 0) {
+    return 0;
+  }
+  std::vector<int> order(n);
+  for (int i = 0; i < n; i++) {
+    order[i] = i;
+    out_status[i] = FAILURE;
+  }
+  std::sort(order.begin(), order.end(),
+            [keys](int a, int b) { return keys[a] < keys[b]; });
+
+  header_page_t* header_page = read_header_page(fd, table_id);
+  pagenum_t root_num = header_page->root_page_num;
+  unpin(table_id, HEADER_PAGE_POS);
+  if (root_num == PAGE_NULL) {
+    return 0;
+  }
+
+  find_batch_group_t group;
+  int leaf_height = height(fd, table_id, HEADER_PAGE_POS);
+  if (leaf_height == 0) {
+    // root가 leaf
+    group.leaf_num = root_num;
+    group.begin = 0;
+    group.end = n;
+    return answer_leaf_group(fd, table_id, &group, keys, order.data(),
+                             out_values, lengths, out_status);
+  }
+
+  std::vector<find_batch_group_t> groups;
+  pagenum_t leaves[FIND_BATCH_PREFETCH_DEPTH];
+  int found = 0;
+  int pos = 0;
+  while (pos < n) {
+    groups.clear();
+    while (pos < n && (int)groups.size() < FIND_BATCH_PREFETCH_DEPTH) {
+      int64_t fence;
+      bool has_fence;
+      pagenum_t parent_num = find_leaf_parent_with_fence(
+          fd, table_id, keys[order[pos]], leaf_height, &fence, &has_fence);
+      internal_page_t* parent_page =
+          (internal_page_t*)read_buffer(fd, table_id, parent_num);
+      while (pos < n && (!has_fence || keys[order[pos]] < fence)) {
+        pagenum_t leaf_num = internal_find_child(parent_page, keys[order[pos]]);
+        if (groups.empty() || groups.back().leaf_num != leaf_num) {
+          if ((int)groups.size() == FIND_BATCH_PREFETCH_DEPTH) {
+            break;
+          }
+          group.leaf_num = leaf_num;
+          group.begin = pos;
+          groups.push_back(group);
+        }
+        pos++;
+        groups.back().end = pos;
+      }
+      unpin(table_id, parent_num);
+    }
+
+    if (groups.size() > 1) {
+      for (int g = 0; g < (int)groups.size(); g++) {
+        leaves[g] = groups[g].leaf_num;
+      }
+      prefetch_pages(fd, table_id, leaves, (int)groups.size(), false);
+    }
+    for (const find_batch_group_t& leaf_group : groups) {
+      found += answer_leaf_group(fd, table_id, &leaf_group, keys, order.data(),
+                                 out_values, lengths, out_status);
+    }
+  }
+  return found;
+}
+
+/**
+ * 여러 key를 한번에 찾음, out_values[i]는 VALUE_SIZE 버퍼
+ * key 순서로 leaf를 한번씩만 읽고 다음 leaf들은 미리 읽어둠
+ * out_status[i]는 keys[i]를 찾았으면 0, 아니면 -1
+ * 같은 key가 여러번 있으면 모두 답함. Return the number of found keys
+ */
+int find_batch(int fd, tableid_t table_id, const int64_t keys[], int n,
+               char* out_values[], int out_status[]) {
+  return find_batch_sorted(fd, table_id, keys, n, out_values, NULL,
+                           out_status);
+}
+
+/**
+ * 길이를 아는 find_batch, lengths[i]는 find의 length처럼
+ * 들어올때 out_values[i] 크기, 나갈때 value 길이
+ */
+int find_batch(int fd, tableid_t table_id, const int64_t keys[], int n,
+               char* out_values[], uint16_t lengths[], int out_status[]) {
+  return find_batch_sorted(fd, table_id, keys, n, out_values, lengths,
+                           out_status);
+}
+
 /**
  * @brief init header page
  * Case: there is no header page in disk
@@ -52,10 +332,76 @@ void init_header_page(int fd, tableid_t table_id) {
 
   header_page_t* header_page = (header_page_t*)frame_ptr;
   header_page->num_of_pages = HEADER_PAGE_POS + 1;
+  header_page->leaf_format = DEFAULT_LEAF_FORMAT;
+  header_page->tree_mode = DEFAULT_TREE_MODE;
+  header_page->high_keys = 1;
+
+  insert_page_mapping(table_id, HEADER_PAGE_POS, header_frame_idx);
+  set_new_bcb(table_id, HEADER_PAGE_POS, header_frame_idx, frame_ptr);
+  bcb->pin_count = 0;
+  write_buffer(table_id, HEADER_PAGE_POS, (page_t*)header_page);
+}
+
+/**
+ * 이 table에 새로 만드는 leaf의 format
+ * header에 format이 없던 예전 파일은 0 (LEAF_FORMAT_RECORDS)
+ */
+uint32_t get_leaf_format(int fd, tableid_t table_id) {
+  header_page_t* header_page = read_header_page(fd, table_id);
+  uint32_t format = (uint32_t)header_page->leaf_format;
+  unpin(table_id, HEADER_PAGE_POS);
+  return format;
+}
 
-  buf_mgr.page_table[table_id].insert(
-      std::make_pair(HEADER_PAGE_POS, header_frame_idx));
+/**
+ * 새 leaf의 format 변경, 이미 있는 leaf는 그대로 두므로 빈 tree에서만 가능
+ * If success, return 0. Otherwise, return -1
+ */
+int set_leaf_format(int fd, tableid_t table_id, uint32_t format) {
+  if (format != LEAF_FORMAT_RECORDS && format != LEAF_FORMAT_KEY_ARRAY &&
+      format != LEAF_FORMAT_SLOTTED) {
+    return FAILURE;
+  }
+  header_page_t* header_page = read_header_page(fd, table_id);
+  if (header_page->root_page_num != PAGE_NULL) {
+    unpin(table_id, HEADER_PAGE_POS);
+    return FAILURE;
+  }
+  header_page->leaf_format = format;
   write_buffer(table_id, HEADER_PAGE_POS, (page_t*)header_page);
+  unpin(table_id, HEADER_PAGE_POS);
+  return SUCCESS;
+}
+
+/**
+ * split/merge가 부모를 찾는 방법, TREE_MODE_PARENT_POINTERS나 TREE_MODE_PATH
+ * header에 mode가 없던 예전 파일은 0 (TREE_MODE_PARENT_POINTERS)
+ */
+uint32_t get_tree_mode(int fd, tableid_t table_id) {
+  header_page_t* header_page = read_header_page(fd, table_id);
+  uint32_t mode = (uint32_t)header_page->tree_mode;
+  unpin(table_id, HEADER_PAGE_POS);
+  return mode;
+}
+
+/**
+ * tree mode 변경, 이미 있는 page의 parent_page_num을 고치지 않으므로
+ * leaf format처럼 빈 tree에서만 가능
+ * If success, return 0. Otherwise, return -1
+ */
+int set_tree_mode(int fd, tableid_t table_id, uint32_t mode) {
+  if (mode != TREE_MODE_PARENT_POINTERS && mode != TREE_MODE_PATH) {
+    return FAILURE;
+  }
+  header_page_t* header_page = read_header_page(fd, table_id);
+  if (header_page->root_page_num != PAGE_NULL) {
+    unpin(table_id, HEADER_PAGE_POS);
+    return FAILURE;
+  }
+  header_page->tree_mode = mode;
+  write_buffer(table_id, HEADER_PAGE_POS, (page_t*)header_page);
+  unpin(table_id, HEADER_PAGE_POS);
+  return SUCCESS;
 }
 
 /* Master insertion function.
@@ -65,11 +411,30 @@ void init_header_page(int fd, tableid_t table_id) {
  * properties.
  */
 int bpt_insert(int fd, tableid_t table_id, int64_t key, char* value) {
+  char fixed_value[VALUE_SIZE];
+  uint16_t length = prepare_fixed_value(fixed_value, value);
+  return bpt_insert(fd, table_id, key, fixed_value, length);
+}
+
+/**
+ * helper function for bpt_insert
+ * leaf에 record 하나를 넣음, 자리가 없으면 split
+ * append_leaf는 find_append_leaf로 찾은 가장 오른쪽 leaf, 자리가 있으면
+ * 내려가지 않고 바로 넣음 (split은 path가 필요하므로 다시 내려감)
+ */
+static int insert_record(int fd, tableid_t table_id, int64_t key,
+                         const char* value, uint16_t length, uint32_t flags,
+                         pagenum_t append_leaf) {
   pagenum_t leaf;
 
-  char result_buf[VALUE_SIZE];
-  if (find(fd, table_id, key, result_buf) == SUCCESS) {
-    return FAILURE;
+  if (append_leaf != PAGE_NULL) {
+    leaf_page_t* leaf_page =
+        (leaf_page_t*)read_buffer(fd, table_id, append_leaf);
+    if (leaf_has_room(leaf_page, length)) {
+      return insert_into_leaf(fd, table_id, append_leaf, leaf_page, key, value,
+                              length, flags);
+    }
+    unpin(table_id, append_leaf);
   }
 
   // Case: the tree does not exist yet. Start a new tree.
@@ -78,47 +443,216 @@ int bpt_insert(int fd, tableid_t table_id, int64_t key, char* value) {
   pagenum_t root_num = header_page->root_page_num;
   unpin(table_id, HEADER_PAGE_POS);
   if (root_num == PAGE_NULL) {
-    return start_new_tree(fd, table_id, key, value);
+    return start_new_tree(fd, table_id, key, value, length, flags);
   }
 
   // Case: the tree already exists.(Rest of function body.)
-  leaf = find_leaf(fd, table_id, key);
+  // split하면 path에서 부모를 찾음
+  tree_path_t path;
+  leaf = find_leaf_with_path(fd, table_id, key, &path);
 
   // Case: leaf has room for key and pointer.
   leaf_page_t* leaf_page = (leaf_page_t*)read_buffer(fd, table_id, leaf);
+  if (leaf_page->right_sibling_page_num == PAGE_NULL) {
+    remember_rightmost_leaf(table_id, leaf);
+  }
 
-  if (leaf_page->num_of_keys < RECORD_CNT) {
-    return insert_into_leaf(fd, table_id, leaf, leaf_page, key, value);
+  if (leaf_has_room(leaf_page, length)) {
+    return insert_into_leaf(fd, table_id, leaf, leaf_page, key, value, length,
+                            flags);
   }
 
   unpin(table_id, leaf);
   // Case:  leaf must be split.
-  return insert_into_leaf_after_splitting(fd, table_id, leaf, key, value);
+  return insert_into_leaf_after_splitting(fd, table_id, leaf, key, value,
+                                          length, flags, &path);
+}
+
+/**
+ * 길이를 아는 insert, value는 문자열이 아니어도 됨
+ * slotted leaf에 들어가지 않는 value는 overflow page chain에 두고
+ * leaf에는 overflow_ref_t만 넣음, 고정 길이 format은 VALUE_SIZE보다 길면 실패
+ */
+int bpt_insert(int fd, tableid_t table_id, int64_t key, const char* value,
+               uint16_t length) {
+  // key가 계속 커지는 insert는 가장 오른쪽 leaf에 바로 넣음
+  pagenum_t append_leaf = find_append_leaf(fd, table_id, key);
+  if (append_leaf == PAGE_NULL && find_key(fd, table_id, key) == SUCCESS) {
+    return FAILURE;
+  }
+
+  if (length > SLOTTED_MAX_VALUE_SIZE &&
+      get_leaf_format(fd, table_id) == LEAF_FORMAT_SLOTTED) {
+    overflow_ref_t ref;
+    if (write_overflow_chain(fd, table_id, value, length, &ref) != SUCCESS) {
+      return FAILURE;
+    }
+    if (insert_record(fd, table_id, key, (const char*)&ref, sizeof(ref),
+                      SLOT_OVERFLOW, append_leaf) != SUCCESS) {
+      free_overflow_chain(fd, table_id, &ref);
+      return FAILURE;
+    }
+    return SUCCESS;
+  }
+  return insert_record(fd, table_id, key, value, length, 0, append_leaf);
+}
+
+/**
+ * 문자열 value batch insert, value는 bpt_insert처럼 고정 길이로
+ */
+int bpt_insert_batch(int fd, tableid_t table_id, const int64_t keys[],
+                     char* values[], int n) {
+  if (n <= 0) {
+    return 0;
+  }
+  char* fixed_values = (char*)malloc((size_t)n * VALUE_SIZE);
+  const char** value_ptrs = (const char**)malloc(n * sizeof(char*));
+  uint16_t* lengths = (uint16_t*)malloc(n * sizeof(uint16_t));
+  if (fixed_values == NULL || value_ptrs == NULL || lengths == NULL) {
+    perror("bpt_insert_batch: malloc");
+    exit(EXIT_FAILURE);
+  }
+  for (int i = 0; i < n; i++) {
+    value_ptrs[i] = fixed_values + (size_t)i * VALUE_SIZE;
+    lengths[i] = prepare_fixed_value(fixed_values + (size_t)i * VALUE_SIZE,
+                                     values[i]);
+  }
+  int inserted =
+      bpt_insert_batch(fd, table_id, keys, value_ptrs, lengths, n);
+  free(lengths);
+  free(value_ptrs);
+  free(fixed_values);
+  return inserted;
+}
+
+/**
+ * helper function for bpt_insert_batch
+ * overflow page가 필요한 value는 bpt_insert로 하나씩
+ */
+static bool needs_overflow(uint32_t format, uint16_t length) {
+  return format == LEAF_FORMAT_SLOTTED && length > SLOTTED_MAX_VALUE_SIZE;
+}
+
+/**
+ * 여러 key를 한번에 insert
+ * key 순서로 정렬한 뒤 같은 leaf에 들어가는 key들(run)은
+ * find_leaf 한번, write_buffer/unpin 한번으로 넣고, 넘치면 split도 한번
+ * 이미 있는 key, batch 안에서 반복된 key(처음 것만), 너무 긴 value는 건너뜀
+ * return 넣은 record 수
+ */
+int bpt_insert_batch(int fd, tableid_t table_id, const int64_t keys[],
+                     const char* const values[], const uint16_t lengths[],
+                     int n) {
+  if (n <= 0) {
+    return 0;
+  }
+  std::vector<int> order(n);
+  for (int i = 0; i < n; i++) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [keys](int a, int b) { return keys[a] < keys[b]; });
+
+  uint32_t format = get_leaf_format(fd, table_id);
+  std::vector<leaf_record_t> run;
+  run.reserve(n);
+  int inserted = 0;
+  int pos = 0;
+  while (pos < n) {
+    int first = order[pos];
+    if (pos > 0 && keys[order[pos - 1]] == keys[first]) {
+      pos++;
+      continue;
+    }
+
+    int64_t fence;
+    bool has_fence;
+    tree_path_t path;
+    pagenum_t leaf = find_leaf_with_path(fd, table_id, keys[first], &path,
+                                         &fence, &has_fence);
+    if (leaf == PAGE_NULL || needs_overflow(format, lengths[first])) {
+      // 빈 tree는 첫 key로 시작
+      if (bpt_insert(fd, table_id, keys[first], values[first],
+                     lengths[first]) == SUCCESS) {
+        inserted++;
+      }
+      pos++;
+      continue;
+    }
+
+    run.clear();
+    while (pos < n) {
+      int index = order[pos];
+      if (has_fence && keys[index] >= fence) {
+        break;
+      }
+      if (needs_overflow(format, lengths[index])) {
+        break;
+      }
+      if (run.empty() || run.back().key != keys[index]) {
+        leaf_record_t record;
+        record.key = keys[index];
+        record.value = values[index];
+        record.length = lengths[index];
+        record.flags = 0;
+        run.push_back(record);
+      }
+      pos++;
+    }
+    inserted += insert_run_into_leaf(fd, table_id, leaf, run.data(),
+                                     (int)run.size(), &path);
+  }
+  return inserted;
 }
 
 /* Master deletion function.
  */
 int bpt_delete(int fd, tableid_t table_id, int64_t key) {
-  pagenum_t leaf;
+  // merge하면 path에서 부모를 찾음
+  tree_path_t path;
+  pagenum_t leaf = find_leaf_with_path(fd, table_id, key, &path);
+  if (leaf == PAGE_NULL) {
+    return FAILURE;
+  }
 
-  char value_buf[VALUE_SIZE];
   // if not exists fail
-  if (find(fd, table_id, key, value_buf) != SUCCESS) {
+  leaf_page_t* leaf_page = (leaf_page_t*)read_buffer(fd, table_id, leaf);
+  int index = leaf_find_index(leaf_page, key);
+  if (index == -1) {
+    unpin(table_id, leaf);
     return FAILURE;
   }
 
-  leaf = find_leaf(fd, table_id, key);
-
-  if (leaf != PAGE_NULL) {
-    return delete_entry(fd, table_id, leaf, key, value_buf);
+  // overflow value면 chain부터 free, value는 읽지 않음
+  bool has_overflow = leaf_is_overflow(leaf_page, index);
+  overflow_ref_t ref;
+  if (has_overflow) {
+    leaf_overflow_ref(leaf_page, index, &ref);
   }
-  return FAILURE;
+  unpin(table_id, leaf);
+  if (has_overflow) {
+    free_overflow_chain(fd, table_id, &ref);
+  }
+
+  return delete_entry(fd, table_id, leaf, key, NULL, &path);
 }
 
 /**
  * update bptree value to input value
  */
 int bpt_update(int fd, tableid_t table_id, int64_t key, char* new_value) {
+  char fixed_value[VALUE_SIZE];
+  uint16_t length = prepare_fixed_value(fixed_value, new_value);
+  return bpt_update(fd, table_id, key, fixed_value, length);
+}
+
+/**
+ * 길이를 아는 update
+ * slotted leaf에서 길어진 value가 그 leaf에 들어가지 않거나
+ * 예전이나 새 value가 overflow value면 지우고 다시 넣음
+ */
+int bpt_update(int fd, tableid_t table_id, int64_t key, const char* new_value,
+               uint16_t length) {
   pagenum_t leaf = find_leaf(fd, table_id, key);
   if (leaf == PAGE_NULL) {
     return FAILURE;
@@ -126,17 +660,25 @@ int bpt_update(int fd, tableid_t table_id, int64_t key, char* new_value) {
 
   leaf_page_t* leaf_page = (leaf_page_t*)read_buffer(fd, table_id, leaf);
 
-  for (int i = 0; i < leaf_page->num_of_keys; i++) {
-    if (leaf_page->records[i].key == key) {
-      copy_value(leaf_page->records[i].value, new_value, VALUE_SIZE);
-      mark_dirty(table_id, leaf);
-      unpin(table_id, leaf);
-      return SUCCESS;
-    }
+  int index = leaf_find_index(leaf_page, key);
+  if (index == -1 || (length > leaf_max_value_size(leaf_page) &&
+                      !leaf_is_slotted(leaf_page))) {
+    unpin(table_id, leaf);
+    return FAILURE;
+  }
+  if (length <= leaf_max_value_size(leaf_page) &&
+      !leaf_is_overflow(leaf_page, index) &&
+      leaf_update_value(leaf_page, index, new_value, length) == SUCCESS) {
+    mark_dirty(table_id, leaf);
+    unpin(table_id, leaf);
+    return SUCCESS;
   }
-
   unpin(table_id, leaf);
-  return FAILURE;
+
+  if (bpt_delete(fd, table_id, key) != SUCCESS) {
+    return FAILURE;
+  }
+  return bpt_insert(fd, table_id, key, new_value, length);
 }
 
 /**
@@ -154,7 +696,7 @@ int find_with_txn(int fd, tableid_t table_id, int64_t key, char* ret_val,
     }
 
     buf_ctl_block_t* leaf_bcb;
-    pagenum_t leaf = find_leaf(fd, table_id, key, (void**)&leaf_bcb);
+    pagenum_t leaf = find_leaf(fd, table_id, key, (void**)&leaf_bcb, false);
 
     if (leaf == PAGE_NULL) {
       return FAILURE;
@@ -163,17 +705,10 @@ int find_with_txn(int fd, tableid_t table_id, int64_t key, char* ret_val,
     leaf_page_t* leaf_page = (leaf_page_t*)leaf_bcb->frame;
 
     // Find record index
-    int found_idx = -1;
-    for (int i = 0; i < leaf_page->num_of_keys; i++) {
-      if (leaf_page->records[i].key == key) {
-        found_idx = i;
-        break;
-      }
-    }
+    int found_idx = leaf_find_index(leaf_page, key);
 
     if (found_idx == -1) {
-      unpin_bcb(leaf_bcb);
-      pthread_mutex_unlock(&leaf_bcb->page_latch);
+      unlatch_and_unpin(leaf_bcb, table_id, leaf);
       return FAILURE;
     }
 
@@ -182,17 +717,15 @@ int find_with_txn(int fd, tableid_t table_id, int64_t key, char* ret_val,
         lock_acquire(table_id, key, txn_id, tcb, S_LOCK, &lock);
 
     if (lock_result == ACQUIRED) {
-      copy_value(ret_val, leaf_page->records[found_idx].value, VALUE_SIZE);
+      copy_leaf_value(ret_val, leaf_page, found_idx);
 
-      unpin_bcb(leaf_bcb);
-      pthread_mutex_unlock(&leaf_bcb->page_latch);
+      unlatch_and_unpin(leaf_bcb, table_id, leaf);
 
       return SUCCESS;
     }
 
     if (lock_result == NEED_TO_WAIT) {
-      unpin_bcb(leaf_bcb);
-      pthread_mutex_unlock(&leaf_bcb->page_latch);
+      unlatch_and_unpin(leaf_bcb, table_id, leaf);
 
       bool wait_success = lock_wait(lock);
       if (!wait_success) {  // deadlock or abort
@@ -204,14 +737,12 @@ int find_with_txn(int fd, tableid_t table_id, int64_t key, char* ret_val,
     }
 
     if (lock_result == DEADLOCK) {
-      unpin_bcb(leaf_bcb);
-      pthread_mutex_unlock(&leaf_bcb->page_latch);
+      unlatch_and_unpin(leaf_bcb, table_id, leaf);
 
       return FAILURE;
     }
 
-    unpin_bcb(leaf_bcb);
-    pthread_mutex_unlock(&leaf_bcb->page_latch);
+    unlatch_and_unpin(leaf_bcb, table_id, leaf);
     return FAILURE;
   }
 }
@@ -228,36 +759,29 @@ int update_with_txn(int fd, tableid_t table_id, int64_t key, char* new_value,
     }
 
     buf_ctl_block_t* leaf_bcb;
-    if (find_leaf(fd, table_id, key, (void**)&leaf_bcb) == PAGE_NULL) {
+    pagenum_t leaf_num = find_leaf(fd, table_id, key, (void**)&leaf_bcb);
+    if (leaf_num == PAGE_NULL) {
       return FAILURE;
     }
 
     leaf_page_t* leaf = (leaf_page_t*)leaf_bcb->frame;
 
-    int idx = -1;
-    for (int i = 0; i < leaf->num_of_keys; i++) {
-      if (leaf->records[i].key == key) {
-        idx = i;
-        break;
-      }
-    }
+    int idx = leaf_find_index(leaf, key);
 
     if (idx == -1) {
-      unpin_bcb(leaf_bcb);
-      pthread_mutex_unlock(&leaf_bcb->page_latch);
+      unlatch_and_unpin(leaf_bcb, table_id, leaf_num);
       return FAILURE;
     }
 
     char old_value[VALUE_SIZE];
-    memcpy(old_value, leaf->records[idx].value, VALUE_SIZE);
+    copy_leaf_value(old_value, leaf, idx);
 
     lock_t* lock;
     LockState lock_result =
         lock_acquire(table_id, key, txn_id, tcb, X_LOCK, &lock);
 
     if (lock_result == ACQUIRED) {
-      unpin_bcb(leaf_bcb);
-      pthread_mutex_unlock(&leaf_bcb->page_latch);
+      unlatch_and_unpin(leaf_bcb, table_id, leaf_num);
 
       undo_log_t* log = (undo_log_t*)malloc(sizeof(undo_log_t));
       log->fd = fd;
@@ -271,8 +795,7 @@ int update_with_txn(int fd, tableid_t table_id, int64_t key, char* new_value,
     }
 
     if (lock_result == NEED_TO_WAIT) {
-      unpin_bcb(leaf_bcb);
-      pthread_mutex_unlock(&leaf_bcb->page_latch);
+      unlatch_and_unpin(leaf_bcb, table_id, leaf_num);
 
       bool wait_success = lock_wait(lock);
       if (!wait_success) {  // deadlock or abort
@@ -284,14 +807,12 @@ int update_with_txn(int fd, tableid_t table_id, int64_t key, char* new_value,
     }
 
     if (lock_result == DEADLOCK) {
-      unpin_bcb(leaf_bcb);
-      pthread_mutex_unlock(&leaf_bcb->page_latch);
+      unlatch_and_unpin(leaf_bcb, table_id, leaf_num);
 
       return FAILURE;
     }
 
-    unpin_bcb(leaf_bcb);
-    pthread_mutex_unlock(&leaf_bcb->page_latch);
+    unlatch_and_unpin(leaf_bcb, table_id, leaf_num);
     return FAILURE;
   }
 }
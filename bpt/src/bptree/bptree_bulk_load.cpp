@@ -0,0 +1,304 @@
+#include <algorithm>
+#include <vector>
+
+#include "bpt.h"
+#include "buf_mgr.h"
+#include "file.h"
+
+// BULK LOAD
+
+/**
+ * key 오름차순 입력으로 빈 table의 tree를 leaf부터 위로 만듦
+ * 각 level마다 채우는 중인 page 하나만 메모리에 두고,
+ * 다 찬 page는 부모를 정한 뒤 write batch에 모아 이어진 번호끼리
+ * file_write_pages로 씀 (버퍼와 clock eviction을 거치지 않음)
+ * page 번호는 header의 num_of_pages 뒤로 차례로 받고 free list는 쓰지 않음
+ */
+
+// level마다 채우는 중인 page
+typedef struct {
+  page_t* page;
+  pagenum_t page_num;
+  int64_t first_key;  // 부모에 구분 key로 들어감
+  int count;  // leaf는 record 수, internal은 child 수
+  int bytes;  // slotted leaf의 slot + value byte
+} bulk_node_t;
+
+typedef struct {
+  int fd;
+  uint32_t leaf_format;
+  bool parent_pointers;  // TREE_MODE_PATH면 parent_page_num을 쓰지 않음
+  int fill_percent;
+  int internal_target;  // internal page가 받는 child 수
+  pagenum_t next_page_num;
+  std::vector<bulk_node_t> levels;  // levels[0]이 leaf
+  page_t* batch;
+  pagenum_t batch_page_nums[BULK_LOAD_WRITE_BATCH];
+  int batch_count;
+} bulk_loader_t;
+
+/**
+ * helper function for bulk_load
+ * PAGE_SIZE 정렬된 page 메모리, O_DIRECT fd에도 그대로 쓸 수 있음
+ */
+static page_t* alloc_aligned_pages(int count) {
+  page_t* pages = NULL;
+  if (posix_memalign((void**)&pages, PAGE_SIZE, count * PAGE_SIZE) != 0) {
+    perror("bulk_load: posix_memalign");
+    exit(EXIT_FAILURE);
+  }
+  memset(pages, 0, count * PAGE_SIZE);
+  return pages;
+}
+
+/**
+ * helper function for bulk_load
+ * batch를 page 번호순으로 정렬해 이어진 번호끼리 한번에 씀
+ * leaf는 번호순으로 들어오고 internal page만 늦게 들어오므로 대부분 한번
+ */
+static void flush_bulk_batch(bulk_loader_t* loader) {
+  int order[BULK_LOAD_WRITE_BATCH];
+  for (int i = 0; i < loader->batch_count; i++) {
+    order[i] = i;
+  }
+  std::sort(order, order + loader->batch_count, [loader](int a, int b) {
+    return loader->batch_page_nums[a] < loader->batch_page_nums[b];
+  });
+
+  const page_t* srcs[BULK_LOAD_WRITE_BATCH];
+  int i = 0;
+  while (i < loader->batch_count) {
+    pagenum_t run_start = loader->batch_page_nums[order[i]];
+    int run = 0;
+    while (i + run < loader->batch_count &&
+           loader->batch_page_nums[order[i + run]] == run_start + run) {
+      srcs[run] = &loader->batch[order[i + run]];
+      run++;
+    }
+    file_write_pages(loader->fd, run_start, srcs, run);
+    i += run;
+  }
+  loader->batch_count = 0;
+}
+
+/**
+ * helper function for bulk_load
+ * 완성된 page를 write batch로 옮김
+ */
+static void emit_bulk_page(bulk_loader_t* loader, const bulk_node_t* node) {
+  if (loader->batch_count == BULK_LOAD_WRITE_BATCH) {
+    flush_bulk_batch(loader);
+  }
+  memcpy(&loader->batch[loader->batch_count], node->page, PAGE_SIZE);
+  loader->batch_page_nums[loader->batch_count] = node->page_num;
+  loader->batch_count++;
+}
+
+/**
+ * helper function for bulk_load
+ * level의 page를 새 번호의 빈 page로 다시 시작
+ */
+static void reset_bulk_node(bulk_node_t* node, pagenum_t page_num,
+                            uint32_t is_leaf, uint32_t format) {
+  memset(node->page, 0, PAGE_SIZE);
+  if (is_leaf == LEAF) {
+    init_leaf_page(node->page, format);
+  } else {
+    init_internal_page(node->page);
+  }
+  node->page_num = page_num;
+  node->first_key = 0;
+  node->count = 0;
+  node->bytes = 0;
+}
+
+/**
+ * helper function for bulk_load
+ * internal page에 child를 뒤에 붙임, 첫 child는 one_more_page_num
+ */
+static void add_bulk_child(bulk_node_t* parent, int64_t key,
+                           pagenum_t child_num) {
+  internal_page_t* page = (internal_page_t*)parent->page;
+  if (parent->count == 0) {
+    page->one_more_page_num = child_num;
+  } else {
+    page->entries[page->num_of_keys].key = key;
+    page->entries[page->num_of_keys].page_num = child_num;
+    page->num_of_keys++;
+  }
+  parent->count++;
+}
+
+/**
+ * helper function for bulk_load
+ * levels[level]의 page를 부모에 붙이고 batch로 보냄
+ * 부모가 목표만큼 찼으면 부모도 닫고 새 부모를 시작,
+ * finishing이면 부모를 새로 시작하지 않고 남은 자리에 붙임
+ * (internal_target을 ENTRY_CNT 이하로 두어 한자리는 항상 남음)
+ * 그래서 새 부모는 닫히는 page 뒤에 적어도 하나의 child를 더 받고
+ * key가 0개인 internal page는 생기지 않음
+ * 닫히는 부모는 새 부모로 right link를 잇고 첫 key를 high key로 가짐
+ */
+static void close_bulk_node(bulk_loader_t* loader, int level,
+                            bool finishing) {
+  int64_t first_key = loader->levels[level].first_key;
+
+  if (level + 1 == (int)loader->levels.size()) {
+    if (finishing) {
+      // 가장 위 level의 page 하나가 root
+      page_header_t* root = (page_header_t*)loader->levels[level].page;
+      root->parent_page_num = PAGE_NULL;
+      emit_bulk_page(loader, &loader->levels[level]);
+      return;
+    }
+    bulk_node_t parent;
+    parent.page = alloc_aligned_pages(1);
+    reset_bulk_node(&parent, loader->next_page_num++, INTERNAL, 0);
+    parent.first_key = first_key;
+    loader->levels.push_back(parent);
+  } else if (!finishing &&
+             loader->levels[level + 1].count >= loader->internal_target) {
+    pagenum_t next_parent_num = loader->next_page_num++;
+    internal_page_t* full_parent =
+        (internal_page_t*)loader->levels[level + 1].page;
+    full_parent->high_key = first_key;
+    full_parent->right_sibling_page_num = next_parent_num;
+    close_bulk_node(loader, level + 1, false);
+    reset_bulk_node(&loader->levels[level + 1], next_parent_num, INTERNAL, 0);
+    loader->levels[level + 1].first_key = first_key;
+  }
+
+  bulk_node_t* node = &loader->levels[level];
+  bulk_node_t* parent = &loader->levels[level + 1];
+  if (loader->parent_pointers) {
+    ((page_header_t*)node->page)->parent_page_num = parent->page_num;
+  }
+  add_bulk_child(parent, first_key, node->page_num);
+  emit_bulk_page(loader, node);
+}
+
+/**
+ * helper function for bulk_load
+ * fill_percent 안에서 leaf에 record를 더 넣을 수 있으면 true
+ * 빈 leaf에는 항상 하나는 들어감
+ */
+static bool bulk_leaf_has_room(const bulk_loader_t* loader,
+                               const bulk_node_t* leaf, int record_size) {
+  if (leaf->count == 0) {
+    return true;
+  }
+  if (loader->leaf_format == LEAF_FORMAT_SLOTTED) {
+    return leaf->bytes + record_size <=
+           LEAF_BODY_SIZE * loader->fill_percent / 100;
+  }
+  int target = RECORD_CNT * loader->fill_percent / 100;
+  return leaf->count < std::max(target, 1);
+}
+
+/**
+ * helper function for bulk_load
+ */
+static void free_bulk_loader(bulk_loader_t* loader) {
+  for (bulk_node_t& node : loader->levels) {
+    free(node.page);
+  }
+  free(loader->batch);
+}
+
+/**
+ * key 오름차순(중복 없음)의 record를 next로 받아 빈 table에 tree를 만듦
+ * leaf와 internal page를 fill_percent(1~100)까지 채우고,
+ * page는 버퍼를 거치지 않고 번호순으로 모아서 씀
+ * value는 leaf에 들어가는 길이까지만 (overflow page는 만들지 않음)
+ * If success, return 0. table이 비어있지 않거나 key 순서가 틀리거나
+ * value가 너무 길면 -1, 이때 header는 그대로라 tree도 그대로
+ */
+int bulk_load(int fd, tableid_t table_id, bulk_load_next_t next, void* ctx,
+              int fill_percent) {
+  if (next == NULL || fill_percent < 1 || fill_percent > 100) {
+    return FAILURE;
+  }
+  header_page_t* header = read_header_page(fd, table_id);
+  pagenum_t root_page_num = header->root_page_num;
+  pagenum_t first_page_num = header->num_of_pages;
+  unpin(table_id, HEADER_PAGE_POS);
+  if (root_page_num != PAGE_NULL) {
+    return FAILURE;
+  }
+
+  bulk_loader_t loader;
+  loader.fd = fd;
+  loader.leaf_format = get_leaf_format(fd, table_id);
+  loader.parent_pointers =
+      get_tree_mode(fd, table_id) == TREE_MODE_PARENT_POINTERS;
+  loader.fill_percent = fill_percent;
+  loader.internal_target =
+      std::min(ENTRY_CNT, std::max(2, (ENTRY_CNT + 1) * fill_percent / 100));
+  loader.next_page_num = first_page_num;
+  loader.batch = alloc_aligned_pages(BULK_LOAD_WRITE_BATCH);
+  loader.batch_count = 0;
+
+  bulk_node_t leaf_node;
+  leaf_node.page = alloc_aligned_pages(1);
+  reset_bulk_node(&leaf_node, PAGE_NULL, LEAF, loader.leaf_format);
+  loader.levels.push_back(leaf_node);
+
+  int64_t key;
+  const char* value;
+  uint16_t length;
+  int64_t last_key = 0;
+  bool has_record = false;
+  while (next(ctx, &key, &value, &length) == SUCCESS) {
+    bulk_node_t* leaf = &loader.levels[0];
+    leaf_page_t* leaf_page = (leaf_page_t*)leaf->page;
+    if ((has_record && key <= last_key) ||
+        length > leaf_max_value_size(leaf_page)) {
+      free_bulk_loader(&loader);
+      return FAILURE;
+    }
+
+    int record_size = leaf_record_size(leaf_page, length);
+    if (!has_record) {
+      leaf->page_num = loader.next_page_num++;
+      leaf->first_key = key;
+    } else if (!bulk_leaf_has_room(&loader, leaf, record_size)) {
+      pagenum_t prev_leaf_num = leaf->page_num;
+      pagenum_t next_leaf_num = loader.next_page_num++;
+      leaf_page->high_key = key;
+      leaf_page->right_sibling_page_num = next_leaf_num;
+      close_bulk_node(&loader, 0, false);
+      leaf = &loader.levels[0];
+      reset_bulk_node(leaf, next_leaf_num, LEAF, loader.leaf_format);
+      leaf_page = (leaf_page_t*)leaf->page;
+      leaf_page->left_sibling_page_num = prev_leaf_num;
+      leaf->first_key = key;
+    }
+
+    leaf_insert_record(leaf_page, leaf->count, key, value, length, 0);
+    leaf->count++;
+    leaf->bytes += record_size;
+    last_key = key;
+    has_record = true;
+  }
+
+  if (!has_record) {
+    free_bulk_loader(&loader);
+    return SUCCESS;
+  }
+
+  // 아래 level부터 닫으면 가장 위 level의 page가 root가 됨
+  for (int level = 0; level < (int)loader.levels.size(); level++) {
+    close_bulk_node(&loader, level, true);
+  }
+  flush_bulk_batch(&loader);
+  pagenum_t root = loader.levels.back().page_num;
+  pagenum_t num_of_pages = loader.next_page_num;
+  free_bulk_loader(&loader);
+
+  header = read_header_page(fd, table_id);
+  header->root_page_num = root;
+  header->num_of_pages = num_of_pages;
+  write_buffer(table_id, HEADER_PAGE_POS, (page_t*)header);
+  unpin(table_id, HEADER_PAGE_POS);
+  return SUCCESS;
+}
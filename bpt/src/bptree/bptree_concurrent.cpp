@@ -0,0 +1,463 @@
+#include <pthread.h>
+
+#include <atomic>
+
+#include "bpt.h"
+#include "bpt_internal.h"
+#include "buf_mgr.h"
+
+// CONCURRENT INSERTION AND DELETION.
+
+/**
+ * 여러 스레드가 같은 table에 find_concurrent, bpt_insert_concurrent,
+ * bpt_delete_concurrent, find_with_txn을 같이 부를 수 있음
+ * (bpt_insert, bpt_delete, cursor 등 latch를 잡지 않는 함수와는 섞지 않음)
+ *
+ * optimistic: find_leaf로 internal page는 latch 없이 내려가 leaf만 exclusive로
+ * 잡고, leaf 안에서 끝나면 (split/merge 없음) 그대로 고침
+ * pessimistic insert: split이 필요하면 leaf를 놓고 table의 smo latch를 잡은 뒤
+ * leaf만 exclusive로 다시 잡아 나눔, 새 page는 right link와 high key로
+ * 먼저 이어지므로 (B-link) leaf latch를 놓은 뒤에 부모를 잡고 key를 넣음
+ * 부모가 나뉘어도 같은 방법으로 한 level씩 올라감
+ * pessimistic delete: smo latch를 잡고 header부터 exclusive latch로 다시
+ * 내려감, 안전한 page를 만나면 그 위의 latch를 놓고 남은 page들을 기존
+ * merge 함수로 고침, 고치는 동안 merge epoch는 홀수
+ *
+ * split/merge가 latch를 잡지 않은 child의 parent_page_num을 고치지 않도록
+ * TREE_MODE_PATH이고 page마다 high key가 있는 table만 받음
+ * latch 순서는 위에서 아래, 같은 level에서는 왼쪽에서 오른쪽 (move right는
+ * 오른쪽을 잡고 왼쪽을 놓음), smo latch는 page latch 없이만 기다림
+ * tree에 이어진 page는 exclusive latch를 잡고만 고쳐야 latch 없이 읽는 쪽이
+ * version으로 바뀐 것을 알아챔
+ */
+
+// table마다 split/merge와 page 할당은 한번에 하나씩
+static pthread_mutex_t smo_latches[MAX_TABLE_COUNT + 1];
+static pthread_once_t smo_latches_once = PTHREAD_ONCE_INIT;
+
+static void init_smo_latches() {
+  for (int table_id = 0; table_id <= MAX_TABLE_COUNT; table_id++) {
+    pthread_mutex_init(&smo_latches[table_id], NULL);
+  }
+}
+
+static pthread_mutex_t* get_smo_latch(tableid_t table_id) {
+  pthread_once(&smo_latches_once, init_smo_latches);
+  return &smo_latches[table_id];
+}
+
+// table마다 merge/redistribute의 시작과 끝에 1씩 더함, 진행 중이면 홀수
+// split은 page의 범위를 오른쪽으로만 줄이므로 reader가 right link로 따라가지만
+// merge는 page를 free하거나 범위를 왼쪽으로 옮기므로 reader가 다시 내려가야 함
+static std::atomic<uint64_t> merge_epochs[MAX_TABLE_COUNT + 1];
+
+/**
+ * find_leaf가 내려가기 전과 leaf를 잡은 뒤에 읽음, 같으면 그 사이 merge 없음
+ */
+uint64_t merge_epoch(tableid_t table_id) {
+  return merge_epochs[table_id].load();
+}
+
+/**
+ * helper function for the concurrent API
+ * B-link로 split을 따라가려면 page마다 high key가 있어야 함
+ */
+static bool has_high_keys(int fd, tableid_t table_id) {
+  header_page_t* header_page = read_header_page(fd, table_id);
+  bool high_keys = header_page->high_keys != 0;
+  unpin(table_id, HEADER_PAGE_POS);
+  return high_keys;
+}
+
+/**
+ * pessimistic pass에서 exclusive latch로 잡고 있는 page들, 위에서부터
+ */
+typedef struct {
+  buf_ctl_block_t* bcbs[MAX_TREE_HEIGHT + 1];
+  pagenum_t pages[MAX_TREE_HEIGHT + 1];
+  int count;
+} latched_pages_t;
+
+/**
+ * helper function for latch_path_exclusive
+ * 마지막 keep개를 남기고 위에서부터 latch와 pin을 놓음
+ */
+static void release_latched_pages(latched_pages_t* latched, tableid_t table_id,
+                                  int keep) {
+  int release_count = latched->count - keep;
+  for (int i = 0; i < release_count; i++) {
+    unlatch_and_unpin(latched->bcbs[i], table_id, latched->pages[i]);
+  }
+  for (int i = 0; i < keep; i++) {
+    latched->bcbs[i] = latched->bcbs[release_count + i];
+    latched->pages[i] = latched->pages[release_count + i];
+  }
+  latched->count = keep;
+}
+
+/**
+ * helper function for latch_path_exclusive
+ * record나 entry 하나를 빼도 underflow가 아닌 page
+ * root는 비면 adjust_root가 header를 고치므로 같은 조건
+ */
+static bool safe_for_delete(const page_t* page) {
+  return ((const page_header_t*)page)->num_of_keys > MIN_KEYS;
+}
+
+/**
+ * helper function for delete_pessimistic
+ * header부터 exclusive latch crabbing으로 key의 leaf까지 내려감
+ * merge가 닿지 않는 (안전한 page의 위) page의 latch는 바로 놓고,
+ * 남은 page들은 latched에, root부터 leaf까지 전부는 path에 남김
+ * @return leaf page number, tree가 비었으면 PAGE_NULL (header는 잡은 채)
+ */
+static pagenum_t latch_path_exclusive(int fd, tableid_t table_id, int64_t key,
+                                      latched_pages_t* latched,
+                                      tree_path_t* path) {
+  buf_ctl_block_t* header_bcb =
+      read_header_page_with_txn(fd, table_id, LATCH_EXCLUSIVE);
+  header_page_t* header_page = (header_page_t*)header_bcb->frame;
+  latched->bcbs[0] = header_bcb;
+  latched->pages[0] = HEADER_PAGE_POS;
+  latched->count = 1;
+  path->depth = 0;
+  path->tree_mode = (uint32_t)header_page->tree_mode;
+
+  pagenum_t cur_num = header_page->root_page_num;
+  if (cur_num == PAGE_NULL) {
+    return PAGE_NULL;
+  }
+
+  while (true) {
+    if (path->depth == MAX_TREE_HEIGHT) {
+      perror("latch_path_exclusive: tree is higher than MAX_TREE_HEIGHT");
+      exit(EXIT_FAILURE);
+    }
+    buf_ctl_block_t* cur_bcb =
+        read_buffer_with_txn(fd, table_id, cur_num, LATCH_EXCLUSIVE);
+    latched->bcbs[latched->count] = cur_bcb;
+    latched->pages[latched->count] = cur_num;
+    latched->count++;
+    path->pages[path->depth++] = cur_num;
+
+    page_t* cur_page = (page_t*)cur_bcb->frame;
+    if (safe_for_delete(cur_page)) {
+      release_latched_pages(latched, table_id, 1);
+    }
+
+    if (((page_header_t*)cur_page)->is_leaf == LEAF) {
+      return cur_num;
+    }
+    cur_num = internal_find_child((internal_page_t*)cur_page, key);
+  }
+}
+
+/**
+ * helper function for insert_record_concurrent
+ * exclusive latch로 잡은 leaf의 frame에 바로 record를 넣음
+ */
+static int insert_into_latched_leaf(buf_ctl_block_t* leaf_bcb, int64_t key,
+                                    const char* value, uint16_t length,
+                                    uint32_t flags) {
+  leaf_page_t* leaf_page = (leaf_page_t*)leaf_bcb->frame;
+  int result = leaf_insert_record(leaf_page, leaf_lower_bound(leaf_page, key),
+                                  key, value, length, flags);
+  if (result == SUCCESS) {
+    leaf_bcb->is_dirty = true;
+  }
+  return result;
+}
+
+/**
+ * helper function for insert_pessimistic
+ * split된 left 옆에 right가 이어진 뒤 부모에 key를 넣음
+ * 부모 하나만 exclusive latch로 잡고, 부모도 나뉘면 latch를 놓고 그 위로
+ * 그 사이 reader는 나뉜 page의 high key를 보고 right link로 따라감
+ * smo latch를 잡고 있으므로 path의 부모는 다른 스레드가 바꾸지 않음
+ */
+static int insert_into_parent_latched(int fd, tableid_t table_id,
+                                      pagenum_t left, int64_t key,
+                                      pagenum_t right,
+                                      const tree_path_t* path) {
+  while (true) {
+    pagenum_t parent = path_parent(path, left);
+    if (parent == PAGE_NULL) {
+      buf_ctl_block_t* header_bcb =
+          read_header_page_with_txn(fd, table_id, LATCH_EXCLUSIVE);
+      int result = insert_into_new_root(fd, table_id, left, key, right, path);
+      unlatch_and_unpin(header_bcb, table_id, HEADER_PAGE_POS);
+      return result;
+    }
+
+    buf_ctl_block_t* parent_bcb =
+        read_buffer_with_txn(fd, table_id, parent, LATCH_EXCLUSIVE);
+    page_t* parent_page = (page_t*)parent_bcb->frame;
+    int left_index = get_index_after_left_child(parent_page, left);
+    if (((page_header_t*)parent_page)->num_of_keys < INTERNAL_ORDER - 1) {
+      int result =
+          insert_into_node(fd, table_id, parent, left_index, key, right);
+      unlatch_and_unpin(parent_bcb, table_id, parent);
+      return result;
+    }
+
+    int64_t k_prime;
+    pagenum_t new_node =
+        split_node(fd, table_id, parent, left_index, key, right, path,
+                   &k_prime);
+    unlatch_and_unpin(parent_bcb, table_id, parent);
+    left = parent;
+    key = k_prime;
+    right = new_node;
+  }
+}
+
+/**
+ * helper function for insert_record_concurrent
+ * smo latch를 잡고 leaf를 exclusive latch로 다시 잡아서 split까지 함
+ * split과 merge는 smo latch 안에서만 하므로 internal page는 latch 없이 읽음
+ */
+static int insert_pessimistic(int fd, tableid_t table_id, int64_t key,
+                              const char* value, uint16_t length,
+                              uint32_t flags) {
+  pthread_mutex_t* smo_latch = get_smo_latch(table_id);
+  pthread_mutex_lock(smo_latch);
+
+  tree_path_t path;
+  pagenum_t leaf = find_leaf_with_path(fd, table_id, key, &path);
+
+  int result;
+  if (leaf == PAGE_NULL) {
+    // root를 만드는 것도 smo latch 안이라 다른 스레드가 먼저 만들 수 없음
+    buf_ctl_block_t* header_bcb =
+        read_header_page_with_txn(fd, table_id, LATCH_EXCLUSIVE);
+    result = start_new_tree(fd, table_id, key, value, length, flags);
+    unlatch_and_unpin(header_bcb, table_id, HEADER_PAGE_POS);
+    pthread_mutex_unlock(smo_latch);
+    return result;
+  }
+
+  buf_ctl_block_t* leaf_bcb =
+      read_buffer_with_txn(fd, table_id, leaf, LATCH_EXCLUSIVE);
+  leaf_page_t* leaf_page = (leaf_page_t*)leaf_bcb->frame;
+  int64_t new_key;
+  pagenum_t new_leaf = PAGE_NULL;
+  if (leaf_find_index(leaf_page, key) != -1) {
+    result = FAILURE;
+  } else if (leaf_has_room(leaf_page, length)) {
+    // optimistic pass 뒤에 다른 스레드가 이미 split함
+    result = insert_into_latched_leaf(leaf_bcb, key, value, length, flags);
+  } else {
+    result = split_leaf(fd, table_id, leaf, key, value, length, flags,
+                        &new_key, &new_leaf);
+  }
+  unlatch_and_unpin(leaf_bcb, table_id, leaf);
+
+  if (new_leaf != PAGE_NULL) {
+    result =
+        insert_into_parent_latched(fd, table_id, leaf, new_key, new_leaf, &path);
+  }
+  pthread_mutex_unlock(smo_latch);
+  return result;
+}
+
+/**
+ * helper function for bpt_insert_concurrent
+ * 같은 key가 있으면 실패, 중복 확인과 insert는 같은 leaf latch 안에서
+ */
+static int insert_record_concurrent(int fd, tableid_t table_id, int64_t key,
+                                    const char* value, uint16_t length,
+                                    uint32_t flags) {
+  buf_ctl_block_t* leaf_bcb;
+  pagenum_t leaf = find_leaf(fd, table_id, key, (void**)&leaf_bcb, true);
+  if (leaf != PAGE_NULL) {
+    leaf_page_t* leaf_page = (leaf_page_t*)leaf_bcb->frame;
+    if (leaf_find_index(leaf_page, key) != -1) {
+      unlatch_and_unpin(leaf_bcb, table_id, leaf);
+      return FAILURE;
+    }
+    if (leaf_has_room(leaf_page, length)) {
+      int result = insert_into_latched_leaf(leaf_bcb, key, value, length, flags);
+      unlatch_and_unpin(leaf_bcb, table_id, leaf);
+      return result;
+    }
+    unlatch_and_unpin(leaf_bcb, table_id, leaf);
+  }
+
+  // Case: leaf must be split, or the tree does not exist yet.
+  return insert_pessimistic(fd, table_id, key, value, length, flags);
+}
+
+/**
+ * 다른 스레드와 같이 부를 수 있는 bpt_insert
+ * overflow chain은 page를 할당하므로 smo latch 안에서 씀
+ * If success, return 0. 같은 key가 있거나 TREE_MODE_PATH가 아니거나
+ * high key가 없는 예전 파일이면 -1
+ */
+int bpt_insert_concurrent(int fd, tableid_t table_id, int64_t key,
+                          const char* value, uint16_t length) {
+  if (get_tree_mode(fd, table_id) != TREE_MODE_PATH ||
+      !has_high_keys(fd, table_id)) {
+    return FAILURE;
+  }
+
+  if (length > SLOTTED_MAX_VALUE_SIZE &&
+      get_leaf_format(fd, table_id) == LEAF_FORMAT_SLOTTED) {
+    pthread_mutex_t* smo_latch = get_smo_latch(table_id);
+    overflow_ref_t ref;
+    pthread_mutex_lock(smo_latch);
+    int result = write_overflow_chain(fd, table_id, value, length, &ref);
+    pthread_mutex_unlock(smo_latch);
+    if (result != SUCCESS) {
+      return FAILURE;
+    }
+    if (insert_record_concurrent(fd, table_id, key, (const char*)&ref,
+                                 sizeof(ref), SLOT_OVERFLOW) != SUCCESS) {
+      pthread_mutex_lock(smo_latch);
+      free_overflow_chain(fd, table_id, &ref);
+      pthread_mutex_unlock(smo_latch);
+      return FAILURE;
+    }
+    return SUCCESS;
+  }
+  return insert_record_concurrent(fd, table_id, key, value, length, 0);
+}
+
+/**
+ * helper function for bpt_delete_concurrent
+ * exclusive latch로 잡은 leaf에서 index번째 record를 지움
+ * overflow value면 chain의 위치를 ref에 남기고 true
+ */
+static bool remove_from_latched_leaf(buf_ctl_block_t* leaf_bcb, int index,
+                                     overflow_ref_t* ref) {
+  leaf_page_t* leaf_page = (leaf_page_t*)leaf_bcb->frame;
+  bool has_overflow = leaf_is_overflow(leaf_page, index);
+  if (has_overflow) {
+    leaf_overflow_ref(leaf_page, index, ref);
+  }
+  leaf_remove_record(leaf_page, index);
+  leaf_bcb->is_dirty = true;
+  return has_overflow;
+}
+
+/**
+ * helper function for bpt_delete_concurrent
+ * smo latch를 잡고 exclusive latch로 다시 내려가서 merge/redistribute까지 함
+ */
+static int delete_pessimistic(int fd, tableid_t table_id, int64_t key) {
+  pthread_mutex_t* smo_latch = get_smo_latch(table_id);
+  pthread_mutex_lock(smo_latch);
+
+  latched_pages_t latched;
+  tree_path_t path;
+  pagenum_t leaf = latch_path_exclusive(fd, table_id, key, &latched, &path);
+
+  int result = FAILURE;
+  if (leaf != PAGE_NULL) {
+    buf_ctl_block_t* leaf_bcb = latched.bcbs[latched.count - 1];
+    leaf_page_t* leaf_page = (leaf_page_t*)leaf_bcb->frame;
+    int index = leaf_find_index(leaf_page, key);
+    if (index != -1) {
+      overflow_ref_t ref;
+      bool has_overflow = leaf_is_overflow(leaf_page, index);
+      if (has_overflow) {
+        leaf_overflow_ref(leaf_page, index, &ref);
+        free_overflow_chain(fd, table_id, &ref);
+      }
+      if (safe_for_delete((page_t*)leaf_page)) {
+        // optimistic pass 뒤에 다른 스레드가 이미 채움
+        leaf_remove_record(leaf_page, index);
+        leaf_bcb->is_dirty = true;
+        result = SUCCESS;
+      } else {
+        merge_epochs[table_id].fetch_add(1);
+        result = delete_entry(fd, table_id, leaf, key, NULL, &path);
+        merge_epochs[table_id].fetch_add(1);
+      }
+    }
+  }
+
+  // merge로 free된 page는 latch만 놓음
+  release_latched_pages(&latched, table_id, 0);
+  pthread_mutex_unlock(smo_latch);
+  return result;
+}
+
+/**
+ * 다른 스레드와 같이 부를 수 있는 bpt_delete
+ * If success, return 0. key가 없거나 TREE_MODE_PATH가 아니거나
+ * high key가 없는 예전 파일이면 -1
+ */
+int bpt_delete_concurrent(int fd, tableid_t table_id, int64_t key) {
+  if (get_tree_mode(fd, table_id) != TREE_MODE_PATH ||
+      !has_high_keys(fd, table_id)) {
+    return FAILURE;
+  }
+
+  buf_ctl_block_t* leaf_bcb;
+  pagenum_t leaf = find_leaf(fd, table_id, key, (void**)&leaf_bcb, true);
+  if (leaf == PAGE_NULL) {
+    return FAILURE;
+  }
+  leaf_page_t* leaf_page = (leaf_page_t*)leaf_bcb->frame;
+  int index = leaf_find_index(leaf_page, key);
+  if (index == -1) {
+    unlatch_and_unpin(leaf_bcb, table_id, leaf);
+    return FAILURE;
+  }
+
+  if (safe_for_delete((page_t*)leaf_page)) {
+    overflow_ref_t ref;
+    bool has_overflow = remove_from_latched_leaf(leaf_bcb, index, &ref);
+    unlatch_and_unpin(leaf_bcb, table_id, leaf);
+    // record를 지운 뒤라 다른 스레드는 더이상 chain을 찾지 못함
+    if (has_overflow) {
+      pthread_mutex_t* smo_latch = get_smo_latch(table_id);
+      pthread_mutex_lock(smo_latch);
+      free_overflow_chain(fd, table_id, &ref);
+      pthread_mutex_unlock(smo_latch);
+    }
+    return SUCCESS;
+  }
+  unlatch_and_unpin(leaf_bcb, table_id, leaf);
+
+  // Case: leaf would underflow.
+  return delete_pessimistic(fd, table_id, key);
+}
+
+/**
+ * 다른 스레드와 같이 부를 수 있는 find, leaf는 shared latch로 읽음
+ * overflow value도 leaf latch를 잡은 채로 읽어서 delete가 chain을 먼저
+ * free하지 못하게 함
+ * length는 find처럼 들어올때 result_buf 크기, 나갈때 value 길이
+ */
+int find_concurrent(int fd, tableid_t table_id, int64_t key, char* result_buf,
+                    uint16_t* length) {
+  buf_ctl_block_t* leaf_bcb;
+  pagenum_t leaf = find_leaf(fd, table_id, key, (void**)&leaf_bcb, false);
+  if (leaf == PAGE_NULL) {
+    return FAILURE;
+  }
+  leaf_page_t* leaf_page = (leaf_page_t*)leaf_bcb->frame;
+
+  int index = leaf_find_index(leaf_page, key);
+  int result = FAILURE;
+  if (index != -1 && leaf_is_overflow(leaf_page, index)) {
+    overflow_ref_t ref;
+    leaf_overflow_ref(leaf_page, index, &ref);
+    if (ref.value_length <= *length) {
+      read_overflow_value(fd, table_id, &ref, result_buf, ref.value_length);
+      result = SUCCESS;
+    }
+    *length = ref.value_length;
+  } else if (index != -1) {
+    uint16_t value_length = leaf_value_length(leaf_page, index);
+    if (value_length <= *length) {
+      memcpy(result_buf, leaf_value(leaf_page, index), value_length);
+      result = SUCCESS;
+    }
+    *length = value_length;
+  }
+
+  unlatch_and_unpin(leaf_bcb, table_id, leaf);
+  return result;
+}
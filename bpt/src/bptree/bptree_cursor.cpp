@@ -0,0 +1,262 @@
+#include "bpt.h"
+#include "buf_mgr.h"
+
+// CURSOR
+
+/**
+ * find_range와 달리 결과를 배열에 모으지 않고 pin한 leaf frame에서
+ * 바로 하나씩 꺼내줌, pin은 항상 leaf 하나까지라 범위 크기와 상관없이
+ * 메모리가 일정함
+ */
+
+/**
+ * helper function for cursor_seek and cursor_settle
+ * pin한 leaf를 놓음
+ */
+static void cursor_release(cursor_t* cursor) {
+  if (cursor->leaf_num != PAGE_NULL) {
+    unpin(cursor->table_id, cursor->leaf_num);
+    cursor->leaf_num = PAGE_NULL;
+    cursor->leaf_page = NULL;
+  }
+}
+
+/**
+ * helper function for cursor_seek and cursor_settle
+ * leaf_num을 pin하고 진행 방향의 첫 record에 둠
+ * find_range처럼 앞으로 읽을 leaf가 절반 이하로 남았으면 진행 방향의
+ * leaf들을 parent의 child 목록에서 찾아 미리 읽어둠
+ */
+static void cursor_enter_leaf(cursor_t* cursor, pagenum_t leaf_num) {
+  cursor->leaf_num = leaf_num;
+  cursor->leaf_page =
+      (leaf_page_t*)read_buffer(cursor->fd, cursor->table_id, leaf_num);
+  leaf_page_t* leaf_page = cursor->leaf_page;
+  cursor->index = cursor->reverse ? (int)leaf_page->num_of_keys - 1 : 0;
+
+  int depth =
+      cursor->reverse ? REVERSE_SCAN_PREFETCH_DEPTH : SCAN_PREFETCH_DEPTH;
+  if (cursor->leaves_ahead > depth / 2) {
+    return;
+  }
+  if (cursor->reverse) {
+    if (leaf_page->num_of_keys == 0 ||
+        leaf_key(leaf_page, 0) > cursor->key_end) {
+      cursor->leaves_ahead =
+          prefetch_prev_leaves(cursor->fd, cursor->table_id, leaf_num,
+                               leaf_page, cursor->key_end);
+    }
+  } else if (leaf_page->right_sibling_page_num != PAGE_NULL &&
+             (leaf_page->num_of_keys == 0 ||
+              leaf_key(leaf_page, leaf_page->num_of_keys - 1) <=
+                  cursor->key_end)) {
+    cursor->leaves_ahead =
+        prefetch_next_leaves(cursor->fd, cursor->table_id, leaf_num,
+                             leaf_page, cursor->key_end);
+  }
+}
+
+/**
+ * helper function for cursor_settle
+ * 왼쪽 leaf 번호, left_sibling_page_num이 없는 예전 leaf면 첫 key 바로
+ * 아래 key로 다시 내려가서 찾음 (가장 왼쪽 leaf면 자기 자신이 나옴)
+ */
+static pagenum_t cursor_left_leaf(cursor_t* cursor) {
+  leaf_page_t* leaf_page = cursor->leaf_page;
+  if (leaf_page->left_sibling_page_num != PAGE_NULL) {
+    return leaf_page->left_sibling_page_num;
+  }
+  if (leaf_page->num_of_keys == 0 || leaf_key(leaf_page, 0) == INT64_MIN) {
+    return PAGE_NULL;
+  }
+  pagenum_t left_num =
+      find_leaf(cursor->fd, cursor->table_id, leaf_key(leaf_page, 0) - 1);
+  return left_num == cursor->leaf_num ? PAGE_NULL : left_num;
+}
+
+/**
+ * table의 cursor를 만듦, cursor_seek 전에는 가리키는 record가 없음
+ */
+cursor_t* cursor_open(int fd, tableid_t table_id) {
+  cursor_t* cursor = (cursor_t*)malloc(sizeof(cursor_t));
+  if (cursor == NULL) {
+    perror("cursor_open: malloc");
+    exit(EXIT_FAILURE);
+  }
+  cursor->fd = fd;
+  cursor->table_id = table_id;
+  cursor->leaf_num = PAGE_NULL;
+  cursor->leaf_page = NULL;
+  cursor->index = 0;
+  cursor->key_end = INT64_MAX;
+  cursor->reverse = false;
+  cursor->leaves_ahead = 0;
+  return cursor;
+}
+
+/**
+ * key_start 이상 key_end 이하의 첫 record로 cursor를 옮김
+ * If there is such a record, return 0. Otherwise, return -1
+ */
+int cursor_seek(cursor_t* cursor, int64_t key_start, int64_t key_end) {
+  cursor_release(cursor);
+  cursor->key_end = key_end;
+  cursor->reverse = false;
+  cursor->leaves_ahead = 0;
+
+  pagenum_t leaf_num = find_leaf(cursor->fd, cursor->table_id, key_start);
+  if (leaf_num == PAGE_NULL) {
+    return FAILURE;
+  }
+  cursor_enter_leaf(cursor, leaf_num);
+  cursor->index = leaf_lower_bound(cursor->leaf_page, key_start);
+  return cursor_settle(cursor) ? SUCCESS : FAILURE;
+}
+
+/**
+ * key_start 이상의 첫 record로 cursor를 옮김, 끝은 table의 끝
+ */
+int cursor_seek(cursor_t* cursor, int64_t key_start) {
+  return cursor_seek(cursor, key_start, INT64_MAX);
+}
+
+/**
+ * key_start 이하 key_end 이상의 마지막 record로 cursor를 옮김
+ * 이후 cursor_next는 key 내림차순으로 left sibling을 따라감
+ * If there is such a record, return 0. Otherwise, return -1
+ */
+int cursor_seek_reverse(cursor_t* cursor, int64_t key_start, int64_t key_end) {
+  cursor_release(cursor);
+  cursor->key_end = key_end;
+  cursor->reverse = true;
+  cursor->leaves_ahead = 0;
+
+  pagenum_t leaf_num = find_leaf(cursor->fd, cursor->table_id, key_start);
+  if (leaf_num == PAGE_NULL) {
+    return FAILURE;
+  }
+  cursor_enter_leaf(cursor, leaf_num);
+  int index = leaf_lower_bound(cursor->leaf_page, key_start);
+  if (index == (int)cursor->leaf_page->num_of_keys ||
+      leaf_key(cursor->leaf_page, index) != key_start) {
+    index--;
+  }
+  cursor->index = index;
+  return cursor_settle(cursor) ? SUCCESS : FAILURE;
+}
+
+/**
+ * key_start 이하의 마지막 record로 cursor를 옮김, 끝은 table의 처음
+ */
+int cursor_seek_reverse(cursor_t* cursor, int64_t key_start) {
+  return cursor_seek_reverse(cursor, key_start, INT64_MIN);
+}
+
+/**
+ * cursor가 record를 가리키도록 맞춤
+ * leaf의 끝이면 오른쪽 leaf로 (reverse면 왼쪽 leaf로) 넘어가고
+ * (앞 leaf는 unpin), table 끝이거나 key_end를 넘으면 leaf를 놓고 false
+ * true이면 cursor->leaf_page의 cursor->index번째가 현재 record
+ */
+bool cursor_settle(cursor_t* cursor) {
+  while (cursor->leaf_num != PAGE_NULL &&
+         (cursor->index < 0 ||
+          cursor->index >= (int)cursor->leaf_page->num_of_keys)) {
+    pagenum_t next_leaf_num = cursor->reverse
+                                  ? cursor_left_leaf(cursor)
+                                  : cursor->leaf_page->right_sibling_page_num;
+    cursor_release(cursor);
+    if (next_leaf_num == PAGE_NULL) {
+      return false;
+    }
+    if (cursor->leaves_ahead > 0) {
+      cursor->leaves_ahead--;
+    }
+    cursor_enter_leaf(cursor, next_leaf_num);
+  }
+  if (cursor->leaf_num == PAGE_NULL) {
+    return false;
+  }
+  int64_t key = leaf_key(cursor->leaf_page, cursor->index);
+  if (cursor->reverse ? key < cursor->key_end : key > cursor->key_end) {
+    cursor_release(cursor);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * helper function for cursor_next
+ */
+static void cursor_advance(cursor_t* cursor) {
+  if (cursor->reverse) {
+    cursor->index--;
+  } else {
+    cursor->index++;
+  }
+}
+
+/**
+ * 현재 record를 key, value에 주고 다음 record로 넘어감
+ * value는 find처럼 VALUE_SIZE 버퍼, overflow value는 VALUE_SIZE - 1 byte까지
+ * If there was a record, return 0. 범위 끝이면 -1
+ */
+int cursor_next(cursor_t* cursor, int64_t* key, char* value) {
+  if (!cursor_settle(cursor)) {
+    return FAILURE;
+  }
+  leaf_page_t* leaf_page = cursor->leaf_page;
+  int index = cursor->index;
+  *key = leaf_key(leaf_page, index);
+  if (leaf_is_overflow(leaf_page, index)) {
+    overflow_ref_t ref;
+    leaf_overflow_ref(leaf_page, index, &ref);
+    memset(value, 0, VALUE_SIZE);
+    read_overflow_value(cursor->fd, cursor->table_id, &ref, value,
+                        VALUE_SIZE - 1);
+  } else {
+    copy_leaf_value(value, leaf_page, index);
+  }
+  cursor_advance(cursor);
+  return SUCCESS;
+}
+
+/**
+ * 길이를 아는 cursor_next, length는 들어올때 value 크기, 나갈때 value 길이
+ * find_prefix처럼 value가 더 길면 앞의 length byte만 줌
+ */
+int cursor_next(cursor_t* cursor, int64_t* key, char* value,
+                uint16_t* length) {
+  if (!cursor_settle(cursor)) {
+    return FAILURE;
+  }
+  leaf_page_t* leaf_page = cursor->leaf_page;
+  int index = cursor->index;
+  *key = leaf_key(leaf_page, index);
+  if (leaf_is_overflow(leaf_page, index)) {
+    overflow_ref_t ref;
+    leaf_overflow_ref(leaf_page, index, &ref);
+    read_overflow_value(cursor->fd, cursor->table_id, &ref, value,
+                        *length < ref.value_length ? *length
+                                                   : ref.value_length);
+    *length = ref.value_length;
+  } else {
+    uint16_t value_length = leaf_value_length(leaf_page, index);
+    memcpy(value, leaf_value(leaf_page, index),
+           *length < value_length ? *length : value_length);
+    *length = value_length;
+  }
+  cursor_advance(cursor);
+  return SUCCESS;
+}
+
+/**
+ * pin한 leaf를 놓고 cursor를 free
+ */
+void cursor_close(cursor_t* cursor) {
+  if (cursor == NULL) {
+    return;
+  }
+  cursor_release(cursor);
+  free(cursor);
+}
@@ -29,7 +29,8 @@ int get_kprime_index(int fd, tableid_t table_id, pagenum_t target_node,
   exit(EXIT_FAILURE);
 }
 
-pagenum_t adjust_root(int fd, tableid_t table_id, pagenum_t root) {
+pagenum_t adjust_root(int fd, tableid_t table_id, pagenum_t root,
+                      const tree_path_t* path) {
   page_t* root_buf = read_buffer(fd, table_id, root);
   page_header_t* root_header = (page_header_t*)root_buf;
 
@@ -53,7 +54,7 @@ pagenum_t adjust_root(int fd, tableid_t table_id, pagenum_t root) {
   if (root_header->is_leaf == INTERNAL) {
     new_root = root_internal->one_more_page_num;
 
-    if (new_root != PAGE_NULL) {
+    if (new_root != PAGE_NULL && path_keeps_parents(path)) {
       page_t* new_root_buf = read_buffer(fd, table_id, new_root);
       page_header_t* new_root_header = (page_header_t*)new_root_buf;
       new_root_header->parent_page_num = PAGE_NULL;
@@ -71,7 +72,9 @@ pagenum_t adjust_root(int fd, tableid_t table_id, pagenum_t root) {
   header_page->root_page_num = new_root;
   write_buffer(table_id, HEADER_PAGE_POS, (page_t*)header_page);
   unpin(table_id, HEADER_PAGE_POS);
-  unpin(table_id, new_root);
+  if (new_root != PAGE_NULL && path_keeps_parents(path)) {
+    unpin(table_id, new_root);
+  }
 
   return SUCCESS;
 }
@@ -83,7 +86,7 @@ pagenum_t adjust_root(int fd, tableid_t table_id, pagenum_t root) {
  */
 void coalesce_internal_nodes(int fd, tableid_t table_id, page_t* neighbor_buf,
                              page_t* target_buf, int neighbor_num,
-                             int64_t k_prime) {
+                             int64_t k_prime, const tree_path_t* path) {
   page_header_t* neighbor_header = (page_header_t*)neighbor_buf;
   internal_page_t* neighbor_internal = (internal_page_t*)neighbor_buf;
   internal_page_t* target_internal = (internal_page_t*)target_buf;
@@ -105,7 +108,15 @@ void coalesce_internal_nodes(int fd, tableid_t table_id, page_t* neighbor_buf,
   }
   target_internal->num_of_keys = 0;
 
+  // target이 맡던 범위와 right link도 neighbor가 받음
+  neighbor_internal->high_key = target_internal->high_key;
+  neighbor_internal->right_sibling_page_num =
+      target_internal->right_sibling_page_num;
+
   // Update parent pointers for all children copied from target
+  if (!path_keeps_parents(path)) {
+    return;
+  }
   pagenum_t child_num =
       neighbor_internal->entries[neighbor_insertion_index].page_num;
   if (child_num != PAGE_NULL) {
@@ -130,22 +141,23 @@ void coalesce_internal_nodes(int fd, tableid_t table_id, page_t* neighbor_buf,
  * helper function for coalesce nodes
  * @brief Handles the merging logic of leaf nodes
  * Copy records from target and update right_sibling_page_num
+ * (the right leaf's left_sibling_page_num is updated by coalesce_nodes)
  */
 void coalesce_leaf_nodes(page_t* neighbor_buf, page_t* target_buf) {
   page_header_t* neighbor_header = (page_header_t*)neighbor_buf;
   leaf_page_t* neighbor_leaf = (leaf_page_t*)neighbor_buf;
   leaf_page_t* target_leaf = (leaf_page_t*)target_buf;
 
-  int neighbor_insertion_index = neighbor_header->num_of_keys;
-
   // Append all records from target to neighbor
-  for (int i = neighbor_insertion_index, j = 0; j < target_leaf->num_of_keys;
-       i++, j++) {
-    neighbor_leaf->records[i] = target_leaf->records[j];
-    neighbor_header->num_of_keys++;
+  for (int j = 0; j < target_leaf->num_of_keys; j++) {
+    leaf_insert_record(neighbor_leaf, neighbor_header->num_of_keys,
+                       leaf_key(target_leaf, j), leaf_value(target_leaf, j),
+                       leaf_value_length(target_leaf, j),
+                       leaf_value_flags(target_leaf, j));
   }
 
-  // Update neighbor's right sibling pointer
+  // Update neighbor's right sibling pointer and high key
+  neighbor_leaf->high_key = target_leaf->high_key;
   neighbor_leaf->right_sibling_page_num = target_leaf->right_sibling_page_num;
 }
 
@@ -157,7 +169,10 @@ void coalesce_leaf_nodes(page_t* neighbor_buf, page_t* target_buf) {
  */
 int coalesce_nodes(int fd, tableid_t table_id, pagenum_t target_num,
                    pagenum_t neighbor_num, int kprime_index_from_get,
-                   int64_t k_prime) {
+                   int64_t k_prime, const tree_path_t* path) {
+  // target과 neighbor는 같은 부모, path에는 처음 target만 있음
+  pagenum_t parent_num = path_parent(path, target_num);
+
   // Swap neighbor with target if target is on the extreme left
   if (kprime_index_from_get == -1) {
     pagenum_t tmp_num = target_num;
@@ -168,26 +183,29 @@ int coalesce_nodes(int fd, tableid_t table_id, pagenum_t target_num,
   page_t* neighbor_buf = read_buffer(fd, table_id, neighbor_num);
   page_t* target_buf = read_buffer(fd, table_id, target_num);
 
-  page_header_t* neighbor_header = (page_header_t*)neighbor_buf;
   page_header_t* target_header = (page_header_t*)target_buf;
 
-  pagenum_t parent_num = target_header->parent_page_num;
-
   if (target_header->is_leaf == INTERNAL) {
     coalesce_internal_nodes(fd, table_id, neighbor_buf, target_buf,
-                            neighbor_num, k_prime);
+                            neighbor_num, k_prime, path);
   } else {
     coalesce_leaf_nodes(neighbor_buf, target_buf);
   }
+  pagenum_t right_leaf_num =
+      target_header->is_leaf == LEAF
+          ? ((leaf_page_t*)target_buf)->right_sibling_page_num
+          : PAGE_NULL;
 
   write_buffer(table_id, neighbor_num, neighbor_buf);
   unpin(table_id, neighbor_num);
+  // 지운 leaf의 오른쪽 leaf는 이제 neighbor가 왼쪽
+  set_leaf_left_sibling(fd, table_id, right_leaf_num, neighbor_num);
 
   unpin(table_id, target_num);
   free_page_in_buffer(fd, table_id, target_num);
 
   // Remove the separator key from the parent
-  return delete_entry(fd, table_id, parent_num, k_prime, NULL);
+  return delete_entry(fd, table_id, parent_num, k_prime, NULL, path);
 }
 
 /**
@@ -197,13 +215,13 @@ int coalesce_nodes(int fd, tableid_t table_id, pagenum_t target_num,
 void redistribute_from_left(int fd, tableid_t table_id, pagenum_t target_num,
                             page_t* target_buf, page_t* neighbor_buf,
                             internal_page_t* parent_page, int k_prime_index,
-                            int k_prime) {
+                            int k_prime, const tree_path_t* path) {
   page_header_t* target_header = (page_header_t*)target_buf;
 
   if (target_header->is_leaf == INTERNAL) {
     redistribute_internal_from_left(fd, table_id, target_num, target_buf,
                                     neighbor_buf, parent_page, k_prime_index,
-                                    k_prime);
+                                    k_prime, path);
   } else {
     redistribute_leaf_from_left(target_buf, neighbor_buf, parent_page,
                                 k_prime_index);
@@ -219,7 +237,8 @@ void redistribute_internal_from_left(int fd, tableid_t table_id,
                                      pagenum_t target_num, page_t* target_buf,
                                      page_t* neighbor_buf,
                                      internal_page_t* parent_page,
-                                     int k_prime_index, int k_prime) {
+                                     int k_prime_index, int k_prime,
+                                     const tree_path_t* path) {
   page_header_t* target_header = (page_header_t*)target_buf;
   internal_page_t* target_internal = (internal_page_t*)target_buf;
   internal_page_t* neighbor_internal = (internal_page_t*)neighbor_buf;
@@ -236,7 +255,7 @@ void redistribute_internal_from_left(int fd, tableid_t table_id,
       neighbor_internal->entries[neighbor_header->num_of_keys - 1].page_num;
   target_internal->one_more_page_num = last_num_neighbor;
 
-  if (last_num_neighbor != PAGE_NULL) {
+  if (last_num_neighbor != PAGE_NULL && path_keeps_parents(path)) {
     page_t* child_buf = read_buffer(fd, table_id, last_num_neighbor);
     ((page_header_t*)child_buf)->parent_page_num = target_num;
     write_buffer(table_id, last_num_neighbor, child_buf);
@@ -245,6 +264,7 @@ void redistribute_internal_from_left(int fd, tableid_t table_id,
 
   parent_page->entries[k_prime_index].key =
       neighbor_internal->entries[neighbor_header->num_of_keys - 1].key;
+  neighbor_internal->high_key = parent_page->entries[k_prime_index].key;
 
   memset(&neighbor_internal->entries[neighbor_header->num_of_keys - 1], 0,
          sizeof(entry_t));
@@ -258,22 +278,20 @@ void redistribute_internal_from_left(int fd, tableid_t table_id,
 void redistribute_leaf_from_left(page_t* target_buf, page_t* neighbor_buf,
                                  internal_page_t* parent_page,
                                  int k_prime_index) {
-  page_header_t* target_header = (page_header_t*)target_buf;
   leaf_page_t* target_leaf = (leaf_page_t*)target_buf;
   leaf_page_t* neighbor_leaf = (leaf_page_t*)neighbor_buf;
   page_header_t* neighbor_header = (page_header_t*)neighbor_buf;
 
-  for (int i = target_header->num_of_keys; i > 0; i--) {
-    target_leaf->records[i] = target_leaf->records[i - 1];
-  }
-
-  target_leaf->records[0] =
-      neighbor_leaf->records[neighbor_header->num_of_keys - 1];
+  int last = neighbor_header->num_of_keys - 1;
+  leaf_insert_record(target_leaf, 0, leaf_key(neighbor_leaf, last),
+                     leaf_value(neighbor_leaf, last),
+                     leaf_value_length(neighbor_leaf, last),
+                     leaf_value_flags(neighbor_leaf, last));
 
-  parent_page->entries[k_prime_index].key = target_leaf->records[0].key;
+  parent_page->entries[k_prime_index].key = leaf_key(target_leaf, 0);
+  neighbor_leaf->high_key = leaf_key(target_leaf, 0);
 
-  memset(&neighbor_leaf->records[neighbor_header->num_of_keys - 1], 0,
-         sizeof(record_t));
+  leaf_remove_record(neighbor_leaf, last);
 }
 
 /**
@@ -283,13 +301,13 @@ void redistribute_leaf_from_left(page_t* target_buf, page_t* neighbor_buf,
 void redistribute_from_right(int fd, tableid_t table_id, pagenum_t target_num,
                              page_t* target_buf, page_t* neighbor_buf,
                              internal_page_t* parent_page, int k_prime_index,
-                             int k_prime) {
+                             int k_prime, const tree_path_t* path) {
   page_header_t* target_header = (page_header_t*)target_buf;
 
   if (target_header->is_leaf == INTERNAL) {
     redistribute_internal_from_right(fd, table_id, target_num, target_buf,
                                      neighbor_buf, parent_page, k_prime_index,
-                                     k_prime);
+                                     k_prime, path);
   } else {
     redistribute_leaf_from_right(target_buf, neighbor_buf, parent_page,
                                  k_prime_index);
@@ -305,7 +323,8 @@ void redistribute_internal_from_right(int fd, tableid_t table_id,
                                       pagenum_t target_num, page_t* target_buf,
                                       page_t* neighbor_buf,
                                       internal_page_t* parent_page,
-                                      int k_prime_index, int k_prime) {
+                                      int k_prime_index, int k_prime,
+                                      const tree_path_t* path) {
   page_header_t* target_header = (page_header_t*)target_buf;
   internal_page_t* target_internal = (internal_page_t*)target_buf;
   internal_page_t* neighbor_internal = (internal_page_t*)neighbor_buf;
@@ -317,7 +336,7 @@ void redistribute_internal_from_right(int fd, tableid_t table_id,
   target_internal->entries[target_header->num_of_keys].page_num =
       num_from_neighbor;
 
-  if (num_from_neighbor != PAGE_NULL) {
+  if (num_from_neighbor != PAGE_NULL && path_keeps_parents(path)) {
     page_t* child_buf = read_buffer(fd, table_id, num_from_neighbor);
     ((page_header_t*)child_buf)->parent_page_num = target_num;
     write_buffer(table_id, num_from_neighbor, child_buf);
@@ -325,6 +344,7 @@ void redistribute_internal_from_right(int fd, tableid_t table_id,
   }
 
   parent_page->entries[k_prime_index].key = neighbor_internal->entries[0].key;
+  target_internal->high_key = neighbor_internal->entries[0].key;
 
   neighbor_internal->one_more_page_num = neighbor_internal->entries[0].page_num;
   for (int i = 0; i < neighbor_header->num_of_keys - 1; i++) {
@@ -348,16 +368,15 @@ void redistribute_leaf_from_right(page_t* target_buf, page_t* neighbor_buf,
   leaf_page_t* neighbor_leaf = (leaf_page_t*)neighbor_buf;
   page_header_t* neighbor_header = (page_header_t*)neighbor_buf;
 
-  target_leaf->records[target_header->num_of_keys] = neighbor_leaf->records[0];
-
-  parent_page->entries[k_prime_index].key = neighbor_leaf->records[1].key;
+  leaf_insert_record(target_leaf, target_header->num_of_keys,
+                     leaf_key(neighbor_leaf, 0), leaf_value(neighbor_leaf, 0),
+                     leaf_value_length(neighbor_leaf, 0),
+                     leaf_value_flags(neighbor_leaf, 0));
 
-  for (int i = 0; i < neighbor_header->num_of_keys - 1; i++) {
-    neighbor_leaf->records[i] = neighbor_leaf->records[i + 1];
-  }
+  parent_page->entries[k_prime_index].key = leaf_key(neighbor_leaf, 1);
+  target_leaf->high_key = leaf_key(neighbor_leaf, 1);
 
-  memset(&neighbor_leaf->records[neighbor_header->num_of_keys - 1], 0,
-         sizeof(record_t));
+  leaf_remove_record(neighbor_leaf, 0);
 }
 
 /* Redistributes entries between two nodes when
@@ -368,13 +387,14 @@ void redistribute_leaf_from_right(page_t* target_buf, page_t* neighbor_buf,
  */
 int redistribute_nodes(int fd, tableid_t table_id, pagenum_t target_num,
                        pagenum_t neighbor_num, int kprime_index_from_get,
-                       int k_prime_index, int k_prime) {
+                       int k_prime_index, int k_prime,
+                       const tree_path_t* path) {
   page_t* target_buf = read_buffer(fd, table_id, target_num);
   page_t* neighbor_buf = read_buffer(fd, table_id, neighbor_num);
 
   page_header_t* target_header = (page_header_t*)target_buf;
   page_header_t* neighbor_header = (page_header_t*)neighbor_buf;
-  pagenum_t parent_num = target_header->parent_page_num;
+  pagenum_t parent_num = path_parent(path, target_num);
 
   internal_page_t* parent_page =
       (internal_page_t*)read_buffer(fd, table_id, parent_num);
@@ -382,17 +402,20 @@ int redistribute_nodes(int fd, tableid_t table_id, pagenum_t target_num,
   /// target is not leftmost, so neighbor is to the left
   if (kprime_index_from_get != -1) {
     redistribute_from_left(fd, table_id, target_num, target_buf, neighbor_buf,
-                           parent_page, k_prime_index, k_prime);
+                           parent_page, k_prime_index, k_prime, path);
   }
   // target is leftmost, so neighbor is to the right
   else {
     redistribute_from_right(fd, table_id, target_num, target_buf, neighbor_buf,
-                            parent_page, k_prime_index, k_prime);
+                            parent_page, k_prime_index, k_prime, path);
   }
 
   // Update key counts and write back pages
-  target_header->num_of_keys++;
-  neighbor_header->num_of_keys--;
+  // (leaf records keep their own counts)
+  if (target_header->is_leaf == INTERNAL) {
+    target_header->num_of_keys++;
+    neighbor_header->num_of_keys--;
+  }
 
   write_buffer(table_id, target_num, target_buf);
   write_buffer(table_id, neighbor_num, neighbor_buf);
@@ -412,21 +435,13 @@ int redistribute_nodes(int fd, tableid_t table_id, pagenum_t target_num,
 int remove_record_from_node(leaf_page_t* target_page, int64_t key,
                             const char* value) {
   // Remove the record and shift other records accordingly.
-  int index = 0;
-  while (target_page->records[index].key != key) {
-    index++;
-  }
-  if (index == target_page->num_of_keys) {
+  int index = leaf_find_index(target_page, key);
+  if (index == -1) {
     return FAILURE;
   }
 
-  for (++index; index < target_page->num_of_keys; index++) {
-    target_page->records[index - 1] = target_page->records[index];
-  }
   // One key fewer.
-  target_page->num_of_keys--;
-
-  memset(&target_page->records[target_page->num_of_keys], 0, sizeof(record_t));
+  leaf_remove_record(target_page, index);
 
   return SUCCESS;
 }
@@ -498,11 +513,12 @@ int find_neighbor_and_kprime(int fd, tableid_t table_id, pagenum_t target_node,
  * Finds neighboring nodes and decides whether to merge or redistribute them and
  * call
  */
-int handle_underflow(int fd, tableid_t table_id, pagenum_t target_node) {
+int handle_underflow(int fd, tableid_t table_id, pagenum_t target_node,
+                     const tree_path_t* path) {
   page_header_t* node_header =
       (page_header_t*)read_buffer(fd, table_id, target_node);
 
-  pagenum_t parent_num = node_header->parent_page_num;
+  pagenum_t parent_num = path_parent(path, target_node);
   internal_page_t* parent_page =
       (internal_page_t*)read_buffer(fd, table_id, parent_num);
 
@@ -515,22 +531,34 @@ int handle_underflow(int fd, tableid_t table_id, pagenum_t target_node) {
 
   int64_t k_prime = parent_page->entries[k_prime_key_index].key;
 
-  page_header_t* neighbor_header =
-      (page_header_t*)read_buffer(fd, table_id, neighbor_num);
-  int capacity = node_header->is_leaf ? RECORD_CNT : ENTRY_CNT - 1;
+  // parent를 고치는 쪽만 neighbor에 오지만 먼저 내려와 있던 reader나
+  // bpt_insert_concurrent의 in-place 수정이 끝날때까지 기다림
+  buf_ctl_block_t* neighbor_bcb =
+      read_buffer_with_txn(fd, table_id, neighbor_num, LATCH_EXCLUSIVE);
+  page_header_t* neighbor_header = (page_header_t*)neighbor_bcb->frame;
+  bool can_merge;
+  if (node_header->is_leaf) {
+    can_merge = leaf_can_merge((leaf_page_t*)neighbor_header,
+                               (leaf_page_t*)node_header);
+  } else {
+    can_merge =
+        neighbor_header->num_of_keys + node_header->num_of_keys < ENTRY_CNT - 1;
+  }
 
   unpin(table_id, target_node);
   unpin(table_id, parent_num);
-  if (neighbor_header->num_of_keys + node_header->num_of_keys < capacity) {
-    unpin(table_id, neighbor_num);
-    return coalesce_nodes(fd, table_id, target_node, neighbor_num,
-                          kprime_index_from_get, k_prime);
+  int result;
+  if (can_merge) {
+    result = coalesce_nodes(fd, table_id, target_node, neighbor_num,
+                            kprime_index_from_get, k_prime, path);
   } else {
-    unpin(table_id, neighbor_num);
-    return redistribute_nodes(fd, table_id, target_node, neighbor_num,
-                              kprime_index_from_get, k_prime_key_index,
-                              k_prime);
+    result = redistribute_nodes(fd, table_id, target_node, neighbor_num,
+                                kprime_index_from_get, k_prime_key_index,
+                                k_prime, path);
   }
+  // coalesce에서 neighbor가 free됐으면 latch만 놓음
+  unlatch_and_unpin(neighbor_bcb, table_id, neighbor_num);
+  return result;
 }
 
 /* Deletes an entry from the B+ tree.
@@ -539,7 +567,7 @@ int handle_underflow(int fd, tableid_t table_id, pagenum_t target_node) {
  * changes to preserve the B+ tree properties.
  */
 int delete_entry(int fd, tableid_t table_id, pagenum_t target_node, int64_t key,
-                 const char* value) {
+                 const char* value, const tree_path_t* path) {
   page_t* node_buf = read_buffer(fd, table_id, target_node);
   page_header_t* node_header = (page_header_t*)node_buf;
 
@@ -558,6 +586,7 @@ int delete_entry(int fd, tableid_t table_id, pagenum_t target_node, int64_t key,
       return FAILURE;
   }
   if (remove_result != SUCCESS) {
+    unpin(table_id, target_node);
     return FAILURE;
   }
   write_buffer(table_id, target_node, node_buf);
@@ -565,9 +594,11 @@ int delete_entry(int fd, tableid_t table_id, pagenum_t target_node, int64_t key,
 
   // Case: Deletion from the root
   header_page_t* header_page = (header_page_t*)read_header_page(fd, table_id);
+  pagenum_t root_num = header_page->root_page_num;
+  unpin(table_id, HEADER_PAGE_POS);
 
-  if (target_node == header_page->root_page_num) {
-    return adjust_root(fd, table_id, header_page->root_page_num);
+  if (target_node == root_num) {
+    return adjust_root(fd, table_id, root_num, path);
   }
 
   // Case: Node stays at or above minimum. (The simple case)
@@ -576,7 +607,7 @@ int delete_entry(int fd, tableid_t table_id, pagenum_t target_node, int64_t key,
   }
 
   // Case: Node falls below minimum (underflow)
-  return handle_underflow(fd, table_id, target_node);
+  return handle_underflow(fd, table_id, target_node, path);
 }
 
 void destroy_tree_nodes(int fd, tableid_t table_id, pagenum_t root_num) {
@@ -595,6 +626,8 @@ void destroy_tree_nodes(int fd, tableid_t table_id, pagenum_t root_num) {
     for (int index = 0; index < internal_page->num_of_keys; index++) {
       destroy_tree_nodes(fd, table_id, internal_page->entries[index].page_num);
     }
+  } else {
+    free_leaf_overflow_chains(fd, table_id, (leaf_page_t*)page_buf);
   }
   unpin(table_id, root_num);
   free_page_in_buffer(fd, table_id, root_num);
@@ -52,7 +52,7 @@ void print_leaves_in_sequence(int fd, tableid_t table_id,
     page_header_t* header = (page_header_t*)current_buf;
 
     for (int i = 0; i < header->num_of_keys; i++) {
-      printf("%" PRId64 " ", leaf_page->records[i].key);
+      printf("%" PRId64 " ", leaf_key(leaf_page, i));
     }
 
     pagenum_t next_page_num = leaf_page->right_sibling_page_num;
@@ -93,9 +93,10 @@ void print_leaves(int fd, tableid_t table_id) {
   print_leaves_in_sequence(fd, table_id, leftmost_leaf_num);
 }
 
-/* Utility function to give the height - not used
+/* Utility function to give the height
  * of the tree, which length in number of edges
  * of the path from the root to any leaf.
+ * 가장 왼쪽 경로를 내려가며 page마다 unpin
  */
 int height(int fd, tableid_t table_id, pagenum_t header_page_num) {
   int h = 0;
@@ -113,11 +114,14 @@ int height(int fd, tableid_t table_id, pagenum_t header_page_num) {
     page_header_t* page_header = (page_header_t*)cur_page;
 
     if (page_header->is_leaf == LEAF) {
+      unpin(table_id, current_page_num);
       break;
     }
 
     internal_page_t* internal_page = (internal_page_t*)cur_page;
-    current_page_num = internal_page->one_more_page_num;
+    pagenum_t child_page_num = internal_page->one_more_page_num;
+    unpin(table_id, current_page_num);
+    current_page_num = child_page_num;
     h++;
 
     if (current_page_num == PAGE_NULL) {
@@ -138,12 +142,12 @@ void print_tree(int fd, tableid_t table_id) {
   printf("table_info[%d].path: %s\n", table_id, table_infos[table_id].path);
 
   // page_table 내용 출력
-  printf("page_table[%d] size: %lu\n", table_id,
-         buf_mgr.page_table[table_id].size());
-  for (auto& p : buf_mgr.page_table[table_id]) {
-    printf("pagenum=%lu -> frame_idx=%d (bcb.table_id=%d, bcb.page_num=%lu)\n",
-           p.first, p.second, buf_mgr.frames[p.second].table_id,
-           buf_mgr.frames[p.second].page_num);
+  for (int i = 0; i < buf_mgr.frames_size; i++) {
+    buf_ctl_block_t* bcb = &buf_mgr.frames[i];
+    if (bcb->table_id == table_id &&
+        get_frame_index_by_page(table_id, bcb->page_num) == i) {
+      printf("pagenum=%lu -> frame_idx=%d\n", bcb->page_num, i);
+    }
   }
   printf("========================\n");
 #endif
@@ -185,7 +189,7 @@ void print_tree(int fd, tableid_t table_id) {
 
       // Leaf Node: 키 출력
       for (i = 0; i < leaf_page->num_of_keys; i++) {
-        printf("%" PRId64 " ", leaf_page->records[i].key);
+        printf("%" PRId64 " ", leaf_key(leaf_page, i));
       }
     } else {
       internal_page_t* internal_page = (internal_page_t*)now_buf;
@@ -231,43 +235,230 @@ void find_and_print(int fd, tableid_t table_id, int64_t key) {
 
 /* Finds and prints the keys, pointers, and values within a range
  * of keys between key_start and key_end, including both bounds.
+ * 범위 크기 제한 없이 cursor가 pin한 leaf에서 바로 출력
  */
 int find_and_print_range(int fd, tableid_t table_id, int64_t key_start,
                          int64_t key_end) {
-  int i;
-  int64_t returned_keys[MAX_RANGE_SIZE];
-  pagenum_t returned_pages[MAX_RANGE_SIZE];
-  int returned_indices[MAX_RANGE_SIZE];
+  int num_found = 0;
+  cursor_t* cursor = cursor_open(fd, table_id);
+
+  cursor_seek(cursor, key_start, key_end);
+  while (cursor_settle(cursor)) {
+    leaf_page_t* leaf_page = cursor->leaf_page;
+    int index = cursor->index;
+
+    const char* value_ptr = leaf_value(leaf_page, index);
+    int value_length = leaf_value_length(leaf_page, index);
+    overflow_ref_t ref;
+    if (leaf_is_overflow(leaf_page, index)) {
+      // overflow value는 leaf에 있는 앞부분만 출력
+      leaf_overflow_ref(leaf_page, index, &ref);
+      value_ptr = ref.prefix;
+      value_length = OVERFLOW_PREFIX_SIZE;
+    }
 
-  if (key_end - key_start > MAX_RANGE_SIZE) {
-    return FAILURE;
+    printf("Key: %" PRId64 "  Location: page %" PRId64
+           ", index %d  Value: %.*s\n",
+           leaf_key(leaf_page, index), cursor->leaf_num, index, value_length,
+           value_ptr);
+    num_found++;
+    cursor->index++;
   }
-
-  int num_found = find_range(fd, table_id, key_start, key_end, returned_keys,
-                             returned_pages, returned_indices);
+  cursor_close(cursor);
 
   if (!num_found) {
     printf("not found.\n");
   } else {
-    printf("found %d records in range [%" PRId64 ", %" PRId64 "]:\n", num_found,
-           key_start, key_end);
+    printf("found %d records in range [%" PRId64 ", %" PRId64 "]\n",
+           num_found, key_start, key_end);
+  }
+  return SUCCESS;
+}
+
+/**
+ * helper function for prefetch_next_leaves
+ * internal page의 from번째 child부터 key_end 이하에서 시작하는 child를
+ * pages[count..SCAN_PREFETCH_DEPTH)에 모음
+ * @return 모은 뒤의 count, key_end를 넘는 child를 만나면 *reached_end = true
+ */
+int collect_child_pages(internal_page_t* internal_page, int from,
+                        int64_t key_end, pagenum_t pages[], int count,
+                        bool* reached_end) {
+  for (int child = from;
+       child <= internal_page->num_of_keys && count < SCAN_PREFETCH_DEPTH;
+       child++) {
+    if (child == 0) {
+      pages[count++] = internal_page->one_more_page_num;
+      continue;
+    }
+    if (internal_page->entries[child - 1].key > key_end) {
+      *reached_end = true;
+      break;
+    }
+    pages[count++] = internal_page->entries[child - 1].page_num;
+  }
+  return count;
+}
+
+/**
+ * helper function for prefetch_next_leaves and prefetch_prev_leaves
+ * leaf의 parent와 grandparent, parent_page_num이 없으면 (TREE_MODE_PATH)
+ * leaf의 첫 key로 root부터 다시 내려가 찾음
+ * leaf가 root면 parent는 PAGE_NULL
+ */
+static void find_leaf_ancestors(int fd, tableid_t table_id, pagenum_t leaf_num,
+                                const leaf_page_t* leaf_page,
+                                pagenum_t* parent_num, pagenum_t* grand_num) {
+  *parent_num = leaf_page->parent_page_num;
+  *grand_num = PAGE_NULL;
+  if (*parent_num != PAGE_NULL) {
+    internal_page_t* parent_page =
+        (internal_page_t*)read_buffer(fd, table_id, *parent_num);
+    *grand_num = parent_page->parent_page_num;
+    unpin(table_id, *parent_num);
+    return;
+  }
+  if (leaf_page->num_of_keys == 0) {
+    return;
+  }
 
-    for (i = 0; i < num_found; i++) {
-      leaf_page_t* temp_leaf =
-          (leaf_page_t*)read_buffer(fd, table_id, returned_pages[i]);
+  tree_path_t path;
+  if (find_leaf_with_path(fd, table_id, leaf_key(leaf_page, 0), &path) !=
+          leaf_num ||
+      path.depth < 2) {
+    return;
+  }
+  *parent_num = path.pages[path.depth - 2];
+  if (path.depth >= 3) {
+    *grand_num = path.pages[path.depth - 3];
+  }
+}
 
-      int64_t key = returned_keys[i];
-      int index = returned_indices[i];
+/**
+ * helper function for find_range
+ * leaf의 오른쪽 leaf들은 디스크상 인접하지 않으므로 parent의 child 목록에서
+ * 최대 SCAN_PREFETCH_DEPTH개를 찾아 버퍼 매니저가 비동기로 읽어두게 함
+ * parent의 마지막 child를 넘어가면 parent의 오른쪽 internal page까지 봄
+ * @return read-ahead를 요청한 leaf 수
+ */
+int prefetch_next_leaves(int fd, tableid_t table_id, pagenum_t leaf_num,
+                         const leaf_page_t* leaf_page, int64_t key_end) {
+  pagenum_t pages[SCAN_PREFETCH_DEPTH];
+  int count = 0;
+  bool reached_end = false;
+
+  pagenum_t parent_num, grand_num;
+  find_leaf_ancestors(fd, table_id, leaf_num, leaf_page, &parent_num,
+                      &grand_num);
+  if (parent_num == PAGE_NULL) {
+    return 0;
+  }
 
-      char* value_ptr = temp_leaf->records[index].value;
+  page_t* parent_buf = read_buffer(fd, table_id, parent_num);
+  internal_page_t* parent_page = (internal_page_t*)parent_buf;
+  int leaf_index = get_index_after_left_child(parent_buf, leaf_num);
+  count = collect_child_pages(parent_page, leaf_index + 1, key_end, pages,
+                              count, &reached_end);
+  unpin(table_id, parent_num);
+
+  if (!reached_end && count < SCAN_PREFETCH_DEPTH && grand_num != PAGE_NULL) {
+    page_t* grand_buf = read_buffer(fd, table_id, grand_num);
+    internal_page_t* grand_page = (internal_page_t*)grand_buf;
+    int next_index = get_index_after_left_child(grand_buf, parent_num) + 1;
+    pagenum_t next_parent_num = PAGE_NULL;
+    if (next_index <= grand_page->num_of_keys &&
+        grand_page->entries[next_index - 1].key <= key_end) {
+      next_parent_num = grand_page->entries[next_index - 1].page_num;
+    }
+    unpin(table_id, grand_num);
 
-      printf("Key: %" PRId64 "  Location: page %" PRId64
-             ", index %d  Value: %s\n",
-             key, returned_pages[i], index, value_ptr);
-      unpin(table_id, returned_pages[i]);
+    if (next_parent_num != PAGE_NULL) {
+      page_t* next_parent_buf = read_buffer(fd, table_id, next_parent_num);
+      count = collect_child_pages((internal_page_t*)next_parent_buf, 0,
+                                  key_end, pages, count, &reached_end);
+      unpin(table_id, next_parent_num);
     }
   }
-  return SUCCESS;
+
+  prefetch_pages(fd, table_id, pages, count, false);
+  return count;
+}
+
+/**
+ * helper function for prefetch_prev_leaves
+ * collect_child_pages를 거꾸로, from번째 child부터 왼쪽으로 key_start
+ * 이상의 key가 있을 수 있는 child를
+ * pages[count..REVERSE_SCAN_PREFETCH_DEPTH)에 모음
+ * @return 모은 뒤의 count, key_start 아래만 맡는 child를 만나면
+ * *reached_end = true
+ */
+int collect_child_pages_reverse(internal_page_t* internal_page, int from,
+                                int64_t key_start, pagenum_t pages[],
+                                int count, bool* reached_end) {
+  for (int child = from; child >= 0 && count < REVERSE_SCAN_PREFETCH_DEPTH;
+       child--) {
+    // child의 key는 entries[child].key보다 작음
+    if (child < internal_page->num_of_keys &&
+        internal_page->entries[child].key <= key_start) {
+      *reached_end = true;
+      break;
+    }
+    pages[count++] = child == 0 ? internal_page->one_more_page_num
+                                : internal_page->entries[child - 1].page_num;
+  }
+  return count;
+}
+
+/**
+ * prefetch_next_leaves의 역방향, 거꾸로 읽는 cursor가 지나갈 왼쪽 leaf들을
+ * parent(와 parent의 왼쪽 internal page)의 child 목록에서 찾아 읽어둠
+ * @return read-ahead를 요청한 leaf 수
+ */
+int prefetch_prev_leaves(int fd, tableid_t table_id, pagenum_t leaf_num,
+                         const leaf_page_t* leaf_page, int64_t key_start) {
+  pagenum_t pages[REVERSE_SCAN_PREFETCH_DEPTH];
+  int count = 0;
+  bool reached_end = false;
+
+  pagenum_t parent_num, grand_num;
+  find_leaf_ancestors(fd, table_id, leaf_num, leaf_page, &parent_num,
+                      &grand_num);
+  if (parent_num == PAGE_NULL) {
+    return 0;
+  }
+
+  page_t* parent_buf = read_buffer(fd, table_id, parent_num);
+  internal_page_t* parent_page = (internal_page_t*)parent_buf;
+  int leaf_index = get_index_after_left_child(parent_buf, leaf_num);
+  count = collect_child_pages_reverse(parent_page, leaf_index - 1, key_start,
+                                      pages, count, &reached_end);
+  unpin(table_id, parent_num);
+
+  if (!reached_end && count < REVERSE_SCAN_PREFETCH_DEPTH &&
+      grand_num != PAGE_NULL) {
+    page_t* grand_buf = read_buffer(fd, table_id, grand_num);
+    internal_page_t* grand_page = (internal_page_t*)grand_buf;
+    int prev_index = get_index_after_left_child(grand_buf, parent_num) - 1;
+    pagenum_t prev_parent_num = PAGE_NULL;
+    if (prev_index >= 0 && grand_page->entries[prev_index].key > key_start) {
+      prev_parent_num = prev_index == 0
+                            ? grand_page->one_more_page_num
+                            : grand_page->entries[prev_index - 1].page_num;
+    }
+    unpin(table_id, grand_num);
+
+    if (prev_parent_num != PAGE_NULL) {
+      page_t* prev_parent_buf = read_buffer(fd, table_id, prev_parent_num);
+      internal_page_t* prev_parent = (internal_page_t*)prev_parent_buf;
+      count = collect_child_pages_reverse(prev_parent, prev_parent->num_of_keys,
+                                          key_start, pages, count,
+                                          &reached_end);
+      unpin(table_id, prev_parent_num);
+    }
+  }
+
+  prefetch_pages(fd, table_id, pages, count, false);
+  return count;
 }
 
 /* Finds keys and their pointers, if present, in the range specified
@@ -290,17 +481,23 @@ int find_range(int fd, tableid_t table_id, int64_t key_start, int64_t key_end,
 
   page_t* current_buf = read_buffer(fd, table_id, current_leaf_num);
   leaf_page_t* leaf_page = (leaf_page_t*)current_buf;
+  // 요청해둔 leaf 중 아직 지나가지 않은 수, 절반 이하로 남으면 다시 요청
+  int leaves_ahead = 0;
 
-  for (i = 0; i < leaf_page->num_of_keys; i++) {
-    if (leaf_page->records[i].key >= key_start) {
-      break;
-    }
-  }
+  i = leaf_lower_bound(leaf_page, key_start);
 
   // traverse to end leaf
   while (current_leaf_num != PAGE_NULL) {
+    if (leaves_ahead <= SCAN_PREFETCH_DEPTH / 2 &&
+        leaf_page->right_sibling_page_num != PAGE_NULL &&
+        (leaf_page->num_of_keys == 0 ||
+         leaf_key(leaf_page, leaf_page->num_of_keys - 1) <= key_end)) {
+      leaves_ahead = prefetch_next_leaves(fd, table_id, current_leaf_num,
+                                          leaf_page, key_end);
+    }
+
     for (; i < leaf_page->num_of_keys; i++) {
-      int64_t current_key = leaf_page->records[i].key;
+      int64_t current_key = leaf_key(leaf_page, i);
 
       if (current_key > key_end) {
         return num_found;
@@ -317,6 +514,9 @@ int find_range(int fd, tableid_t table_id, int64_t key_start, int64_t key_end,
 
     current_leaf_num = next_leaf_num;
     i = 0;
+    if (leaves_ahead > 0) {
+      leaves_ahead--;
+    }
 
     if (current_leaf_num != PAGE_NULL) {
       current_buf = read_buffer(fd, table_id, current_leaf_num);
@@ -359,18 +559,8 @@ pagenum_t find_leaf(int fd, tableid_t table_id, int64_t key) {
       return cur_num;
     }
 
-    int index = 0;
     internal_page_t* internal_page = (internal_page_t*)page_buf;
-    while (index < internal_page->num_of_keys &&
-           key >= internal_page->entries[index].key) {
-      index++;
-    }
-
-    if (index == 0) {
-      cur_num = internal_page->one_more_page_num;
-    } else {
-      cur_num = internal_page->entries[index - 1].page_num;
-    }
+    cur_num = internal_find_child(internal_page, key);
     if (cur_num == PAGE_NULL) {
       // 이거는 실행 안되어야 함
       // perror("find_leaf");
@@ -382,52 +572,367 @@ pagenum_t find_leaf(int fd, tableid_t table_id, int64_t key) {
 }
 
 /**
- * find leaf with concurrency control
- * page latch를 유지하고 bcb 포인터 반환
+ * find_leaf와 같은 탐색, 지나온 page를 path에 남김
+ * insert와 delete는 이 path로 split/merge할 부모를 찾음
+ * 빈 tree면 path->depth는 0, return PAGE_NULL
  */
-pagenum_t find_leaf(int fd, tableid_t table_id, int64_t key, void** out_bcb) {
-  buf_ctl_block_t* header_bcb = read_header_page_with_txn(fd, table_id);
+pagenum_t find_leaf_with_path(int fd, tableid_t table_id, int64_t key,
+                              tree_path_t* path) {
+  int64_t fence;
+  bool has_fence;
+  return find_leaf_with_path(fd, table_id, key, path, &fence, &has_fence);
+}
+
+/**
+ * find_leaf_with_path에 find_leaf_with_fence처럼 leaf 범위의 끝도 줌
+ */
+pagenum_t find_leaf_with_path(int fd, tableid_t table_id, int64_t key,
+                              tree_path_t* path, int64_t* fence,
+                              bool* has_fence) {
+  *has_fence = false;
+  header_page_t* header_page = read_header_page(fd, table_id);
+  pagenum_t cur_num = header_page->root_page_num;
+  path->depth = 0;
+  path->tree_mode = (uint32_t)header_page->tree_mode;
+  if (cur_num == PAGE_NULL || header_page->num_of_pages == 1) {
+    unpin(table_id, HEADER_PAGE_POS);
+    return PAGE_NULL;
+  }
+  unpin(table_id, HEADER_PAGE_POS);
+
+  while (true) {
+    if (path->depth == MAX_TREE_HEIGHT) {
+      perror("find_leaf_with_path: tree too high");
+      exit(EXIT_FAILURE);
+    }
+    path->pages[path->depth++] = cur_num;
+    page_t* page_buf = read_buffer(fd, table_id, cur_num);
+    if (((page_header_t*)page_buf)->is_leaf == LEAF) {
+      unpin(table_id, cur_num);
+      return cur_num;
+    }
+
+    internal_page_t* internal_page = (internal_page_t*)page_buf;
+    int index = internal_child_index(internal_page, key);
+    if (index < internal_page->num_of_keys) {
+      *fence = internal_page->entries[index].key;
+      *has_fence = true;
+    }
+    pagenum_t next_num = index == 0
+                             ? internal_page->one_more_page_num
+                             : internal_page->entries[index - 1].page_num;
+    unpin(table_id, cur_num);
+    cur_num = next_num;
+  }
+}
+
+/**
+ * path에서 node 바로 위 page, node가 root면 PAGE_NULL
+ * split으로 새로 생긴 page는 path에 없으므로 path에 있던 page만 넣음
+ */
+pagenum_t path_parent(const tree_path_t* path, pagenum_t node) {
+  for (int level = path->depth - 1; level > 0; level--) {
+    if (path->pages[level] == node) {
+      return path->pages[level - 1];
+    }
+  }
+  if (path->depth > 0 && path->pages[0] == node) {
+    return PAGE_NULL;
+  }
+  printf("Search for nonexistent node in descent path.\n");
+  printf("Node:  %#lx\n", (unsigned long)node);
+  exit(EXIT_FAILURE);
+}
+
+/**
+ * TREE_MODE_PARENT_POINTERS면 true, split/merge가 옮긴 child의
+ * parent_page_num도 고쳐야 함
+ */
+bool path_keeps_parents(const tree_path_t* path) {
+  return path->tree_mode == TREE_MODE_PARENT_POINTERS;
+}
+
+/**
+ * find_leaf와 같은 탐색, leaf가 맡는 key 범위의 끝도 함께 줌
+ * fence는 내려오며 지난 가장 가까운 오른쪽 구분 key, 그 key부터는 다음 leaf
+ * 가장 오른쪽 leaf면 has_fence는 false
+ */
+pagenum_t find_leaf_with_fence(int fd, tableid_t table_id, int64_t key,
+                               int64_t* fence, bool* has_fence) {
+  *has_fence = false;
+  header_page_t* header_page = read_header_page(fd, table_id);
+  pagenum_t cur_num = header_page->root_page_num;
+  unpin(table_id, HEADER_PAGE_POS);
+  if (cur_num == PAGE_NULL) {
+    return PAGE_NULL;
+  }
+
+  while (true) {
+    page_t* page_buf = read_buffer(fd, table_id, cur_num);
+    if (((page_header_t*)page_buf)->is_leaf == LEAF) {
+      unpin(table_id, cur_num);
+      return cur_num;
+    }
+
+    internal_page_t* internal_page = (internal_page_t*)page_buf;
+    int index = internal_child_index(internal_page, key);
+    if (index < internal_page->num_of_keys) {
+      *fence = internal_page->entries[index].key;
+      *has_fence = true;
+    }
+    pagenum_t next_num = index == 0
+                             ? internal_page->one_more_page_num
+                             : internal_page->entries[index - 1].page_num;
+    unpin(table_id, cur_num);
+    cur_num = next_num;
+  }
+}
+
+/**
+ * find_leaf_with_fence와 같은 탐색, leaf 바로 위 internal page에서 멈춤
+ * leaf_height는 root에서 leaf까지의 간선 수 (height), 1 이상
+ * fence는 돌려준 page가 맡는 key 범위의 끝
+ */
+pagenum_t find_leaf_parent_with_fence(int fd, tableid_t table_id, int64_t key,
+                                      int leaf_height, int64_t* fence,
+                                      bool* has_fence) {
+  *has_fence = false;
+  header_page_t* header_page = read_header_page(fd, table_id);
+  pagenum_t cur_num = header_page->root_page_num;
+  unpin(table_id, HEADER_PAGE_POS);
+  if (cur_num == PAGE_NULL) {
+    return PAGE_NULL;
+  }
+
+  for (int level = 1; level < leaf_height; level++) {
+    internal_page_t* internal_page =
+        (internal_page_t*)read_buffer(fd, table_id, cur_num);
+    int index = internal_child_index(internal_page, key);
+    if (index < internal_page->num_of_keys) {
+      *fence = internal_page->entries[index].key;
+      *has_fence = true;
+    }
+    pagenum_t next_num = index == 0
+                             ? internal_page->one_more_page_num
+                             : internal_page->entries[index - 1].page_num;
+    unpin(table_id, cur_num);
+    cur_num = next_num;
+  }
+  return cur_num;
+}
+
+/**
+ * helper function for find_leaf
+ * page가 key를 맡지 않고 split으로 오른쪽 page에 넘겼으면 그 page (B-link)
+ * key가 high key 이상이면 오른쪽, 가장 오른쪽 page거나 key가 작으면 PAGE_NULL
+ * latch 없이 읽는 중이면 호출한 쪽이 version으로 확인
+ */
+static pagenum_t move_right_page(const page_t* page, int64_t key) {
+  pagenum_t right =
+      ((const page_header_t*)page)->is_leaf == LEAF
+          ? ((const leaf_page_t*)page)->right_sibling_page_num
+          : ((const internal_page_t*)page)->right_sibling_page_num;
+  if (right == PAGE_NULL || key < ((const leaf_page_t*)page)->high_key) {
+    return PAGE_NULL;
+  }
+  return right;
+}
+
+/**
+ * helper function for find_leaf
+ * internal page를 shared latch로 crabbing, leaf는 leaf_exclusive면
+ * exclusive latch로 잡아 page latch를 유지하고 bcb 포인터 반환
+ * version이 계속 바뀌어 find_leaf_optimistic이 진행하지 못할 때 사용
+ */
+static pagenum_t find_leaf_crabbing(int fd, tableid_t table_id, int64_t key,
+                                    void** out_bcb, bool leaf_exclusive) {
+  buf_ctl_block_t* header_bcb =
+      read_header_page_with_txn(fd, table_id, LATCH_SHARED);
   header_page_t* header_page = (header_page_t*)(header_bcb->frame);
+  // num_of_pages는 header latch 없이 page를 할당하는 쪽이 고치므로 보지 않음
   pagenum_t cur_num = header_page->root_page_num;
-  pagenum_t num_of_pages = header_page->num_of_pages;
+  bool blink = header_page->high_keys != 0;
 
-  if (cur_num == PAGE_NULL || num_of_pages == 1) {
+  if (cur_num == PAGE_NULL) {
+    unlatch_and_unpin(header_bcb, table_id, HEADER_PAGE_POS);
     return PAGE_NULL;
   }
 
   // Latch crabbing
-  buf_ctl_block_t* cur_bcb = read_buffer_with_txn(fd, table_id, cur_num);
-  unpin_bcb(header_bcb);
-  pthread_mutex_unlock(&header_bcb->page_latch);
-
-  page_t* cur_page = (page_t*)(cur_bcb->frame);
+  buf_ctl_block_t* parent_bcb = header_bcb;
+  pagenum_t parent_num = HEADER_PAGE_POS;
+  buf_ctl_block_t* cur_bcb =
+      read_buffer_with_txn(fd, table_id, cur_num, LATCH_SHARED);
+  bool leaf_latched = false;  // leaf를 exclusive로 잡았는지
 
   while (true) {
-    page_header_t* hdr = (page_header_t*)cur_page;
+    page_header_t* hdr = (page_header_t*)(cur_bcb->frame);
+
+    // 부모에 key를 넣기 전의 split, 오른쪽으로 (같은 level은 왼쪽부터 잡음)
+    pagenum_t right = blink ? move_right_page((page_t*)hdr, key) : PAGE_NULL;
+    if (right != PAGE_NULL) {
+      // leaf에서 오른쪽으로 가면 처음부터 필요한 mode로 잡음
+      leaf_latched = leaf_exclusive && hdr->is_leaf == LEAF;
+      buf_ctl_block_t* right_bcb = read_buffer_with_txn(
+          fd, table_id, right, leaf_latched ? LATCH_EXCLUSIVE : LATCH_SHARED);
+      unlatch_and_unpin(cur_bcb, table_id, cur_num);
+      cur_num = right;
+      cur_bcb = right_bcb;
+      continue;
+    }
 
     if (hdr->is_leaf == LEAF) {
+      if (leaf_exclusive && !leaf_latched) {
+        // parent latch를 들고 있으므로 다시 잡는 사이 merge되지 않음
+        // split은 leaf만 잡고 하므로 high key를 다시 확인
+        unlatch_page(cur_bcb);
+        latch_page(cur_bcb, LATCH_EXCLUSIVE);
+        leaf_latched = true;
+        if (blink) {
+          continue;
+        }
+      }
+      unlatch_and_unpin(parent_bcb, table_id, parent_num);
       *out_bcb = cur_bcb;
       return cur_num;  // leaf latch 유지
     }
 
-    internal_page_t* ip = (internal_page_t*)cur_page;
-    pagenum_t next;
-    int i = 0;
-    while (i < ip->num_of_keys && key >= ip->entries[i].key) {
-      i++;
-    }
-
-    next = (i == 0) ? ip->one_more_page_num : ip->entries[i - 1].page_num;
-
     // parent page_latch를 들고 있는 상태에서 child 획득
-    buf_ctl_block_t* child_bcb = read_buffer_with_txn(fd, table_id, next);
+    pagenum_t next = internal_find_child((internal_page_t*)hdr, key);
+    buf_ctl_block_t* child_bcb =
+        read_buffer_with_txn(fd, table_id, next, LATCH_SHARED);
 
     // child latch 획득 후 parent 해제
-    unpin_bcb(cur_bcb);
-    pthread_mutex_unlock(&cur_bcb->page_latch);
+    unlatch_and_unpin(parent_bcb, table_id, parent_num);
 
+    parent_bcb = cur_bcb;
+    parent_num = cur_num;
     cur_num = next;
     cur_bcb = child_bcb;
-    cur_page = (page_t*)(child_bcb->frame);
   }
 }
+
+/**
+ * helper function for find_leaf_optimistic
+ * latch 없이 읽는 internal page에서 key가 속하는 child
+ * 읽는 중 다른 page로 바뀌었으면 num_of_keys가 엉뚱할 수 있으므로
+ * 범위를 넘으면 page 밖을 읽지 않고 PAGE_NULL
+ */
+static pagenum_t optimistic_find_child(const internal_page_t* internal_page,
+                                       int64_t key) {
+  int num_of_keys = internal_page->num_of_keys;
+  if (num_of_keys < 0 || num_of_keys > ENTRY_CNT) {
+    return PAGE_NULL;
+  }
+  int index = internal_child_index(internal_page, num_of_keys, key);
+  if (index == 0) {
+    return internal_page->one_more_page_num;
+  }
+  return internal_page->entries[index - 1].page_num;
+}
+
+/**
+ * helper function for find_leaf
+ * header와 internal page는 latch 없이 version만 확인하며 내려가고
+ * (optimistic lock coupling) leaf만 latch를 잡음
+ * page마다 high key가 있으면 (B-link) 부모를 다시 확인하지 않음
+ * 읽은 page가 그 사이 split됐어도 key가 high key 이상이면 right link로
+ * 따라가면 되므로, 내려가는 동안 merge epoch가 그대로인지만 봄
+ * high key가 없는 예전 파일은 child를 고른 page의 version이 child를 읽은
+ * 뒤에도 그대로인지 확인, split/merge는 parent를 exclusive로 잡고 하므로
+ * leaf latch를 잡은 뒤 parent version까지 확인하면 leaf가 맞음
+ * @return false면 지나온 page가 바뀐 것, 잡은 latch는 없고 다시 내려가야 함
+ */
+static bool find_leaf_optimistic(int fd, tableid_t table_id, int64_t key,
+                                 void** out_bcb, bool leaf_exclusive,
+                                 pagenum_t* leaf_num) {
+  uint64_t epoch = merge_epoch(table_id);
+  if (epoch & 1) {
+    return false;
+  }
+  uint64_t parent_version;
+  buf_ctl_block_t* parent_bcb =
+      read_buffer_optimistic(fd, table_id, HEADER_PAGE_POS, &parent_version);
+  header_page_t* header_page = (header_page_t*)parent_bcb->frame;
+  pagenum_t cur_num = header_page->root_page_num;
+  bool blink = header_page->high_keys != 0;
+  if (!validate_page_version(parent_bcb, parent_version)) {
+    return false;
+  }
+  if (cur_num == PAGE_NULL) {
+    *leaf_num = PAGE_NULL;
+    return true;
+  }
+
+  while (true) {
+    uint64_t version;
+    buf_ctl_block_t* bcb =
+        read_buffer_optimistic(fd, table_id, cur_num, &version);
+    if (!blink && !validate_page_version(parent_bcb, parent_version)) {
+      return false;
+    }
+
+    if (((page_header_t*)bcb->frame)->is_leaf == LEAF) {
+      LatchMode mode = leaf_exclusive ? LATCH_EXCLUSIVE : LATCH_SHARED;
+      buf_ctl_block_t* leaf_bcb =
+          read_buffer_with_txn(fd, table_id, cur_num, mode);
+      // 오른쪽 leaf는 이 leaf를 놓고 잡음, 그 사이 바뀌면 epoch로 알 수 있음
+      pagenum_t right;
+      while (blink && ((page_header_t*)leaf_bcb->frame)->is_leaf == LEAF &&
+             (right = move_right_page((page_t*)leaf_bcb->frame, key)) !=
+                 PAGE_NULL) {
+        unlatch_and_unpin(leaf_bcb, table_id, cur_num);
+        cur_num = right;
+        leaf_bcb = read_buffer_with_txn(fd, table_id, cur_num, mode);
+      }
+      bool valid = blink ? merge_epoch(table_id) == epoch
+                         : validate_page_version(parent_bcb, parent_version);
+      if (((page_header_t*)leaf_bcb->frame)->is_leaf != LEAF || !valid) {
+        unlatch_and_unpin(leaf_bcb, table_id, cur_num);
+        return false;
+      }
+      *out_bcb = leaf_bcb;
+      *leaf_num = cur_num;
+      return true;  // leaf latch 유지
+    }
+
+    pagenum_t next = blink ? move_right_page((page_t*)bcb->frame, key)
+                           : PAGE_NULL;
+    if (next == PAGE_NULL) {
+      next = optimistic_find_child((internal_page_t*)bcb->frame, key);
+    }
+    if (!validate_page_version(bcb, version) || next == PAGE_NULL ||
+        (blink && merge_epoch(table_id) != epoch)) {
+      return false;
+    }
+    parent_bcb = bcb;
+    parent_version = version;
+    cur_num = next;
+  }
+}
+
+/**
+ * find leaf with concurrency control
+ * leaf만 page latch를 잡고 (leaf_exclusive면 exclusive, 아니면 shared)
+ * 유지한 채 bcb 포인터 반환
+ * internal page는 latch 없이 읽고 version이 바뀌었으면 다시 내려감,
+ * OPTIMISTIC_MAX_RESTARTS번 실패하면 shared latch crabbing으로 내려감
+ */
+pagenum_t find_leaf(int fd, tableid_t table_id, int64_t key, void** out_bcb,
+                    bool leaf_exclusive) {
+  for (int restart = 0; restart < OPTIMISTIC_MAX_RESTARTS; restart++) {
+    pagenum_t leaf_num;
+    if (find_leaf_optimistic(fd, table_id, key, out_bcb, leaf_exclusive,
+                             &leaf_num)) {
+      return leaf_num;
+    }
+  }
+  return find_leaf_crabbing(fd, table_id, key, out_bcb, leaf_exclusive);
+}
+
+/**
+ * leaf를 exclusive latch로 잡는 find_leaf
+ */
+pagenum_t find_leaf(int fd, tableid_t table_id, int64_t key, void** out_bcb) {
+  return find_leaf(fd, table_id, key, out_bcb, true);
+}
@@ -1,3 +1,5 @@
+#include <atomic>
+
 #include "bpt.h"
 #include "bpt_internal.h"
 #include "buf_mgr.h"
@@ -5,17 +7,79 @@
 
 // INSERTION
 
+// table마다 마지막으로 본 가장 오른쪽 leaf, 쓸 때마다 page를 읽어 확인
+// merge로 free된 page는 next_free_page_num 말고는 비어 있어 is_leaf가 0
+// table을 닫으면 지움 (forget_rightmost_leaf)
+static std::atomic<pagenum_t> rightmost_leaves[MAX_TABLE_COUNT + 1];
+
+/**
+ * split이나 find_leaf로 가장 오른쪽 leaf를 알게 되면 기억해 둠
+ */
+void remember_rightmost_leaf(tableid_t table_id, pagenum_t leaf_num) {
+  rightmost_leaves[table_id].store(leaf_num);
+}
+
+/**
+ * close_table, shutdown_db에서 호출, table id가 다른 파일에 다시 쓰일 수 있음
+ */
+void forget_rightmost_leaf(tableid_t table_id) {
+  rightmost_leaves[table_id].store(PAGE_NULL);
+}
+
+/**
+ * key가 tree의 모든 key보다 크면 (append) 넣을 leaf, 아니면 PAGE_NULL
+ * 기억해 둔 leaf가 아직 가장 오른쪽 leaf이고 마지막 key가 key보다 작으면
+ * find_leaf로 내려가지 않고 그 leaf, key가 없는 것도 확인한 셈
+ */
+pagenum_t find_append_leaf(int fd, tableid_t table_id, int64_t key) {
+  pagenum_t leaf_num = rightmost_leaves[table_id].load();
+  if (leaf_num == PAGE_NULL) {
+    return PAGE_NULL;
+  }
+
+  leaf_page_t* leaf_page = (leaf_page_t*)read_buffer(fd, table_id, leaf_num);
+  bool append = leaf_page->is_leaf == LEAF &&
+                leaf_page->right_sibling_page_num == PAGE_NULL &&
+                leaf_page->num_of_keys > 0 &&
+                leaf_key(leaf_page, leaf_page->num_of_keys - 1) < key;
+  unpin(table_id, leaf_num);
+  return append ? leaf_num : PAGE_NULL;
+}
+
 void copy_value(char* dest, const char* src, size_t size) {
   strncpy(dest, src, size - 1);
   dest[size - 1] = '\0';
 }
 
-void init_leaf_page(page_t* page) {
+void init_leaf_page(page_t* page, uint32_t format) {
   leaf_page_t* leaf_page = (leaf_page_t*)page;
   leaf_page->parent_page_num = PAGE_NULL;
   leaf_page->is_leaf = LEAF;
   leaf_page->num_of_keys = 0;
+  leaf_page->format = format;
+  leaf_page->high_key = 0;
+  leaf_page->left_sibling_page_num = PAGE_NULL;
   leaf_page->right_sibling_page_num = PAGE_NULL;
+  if (leaf_is_slotted(leaf_page)) {
+    as_slotted(leaf_page)->heap_start = LEAF_BODY_SIZE;
+  }
+}
+
+/**
+ * leaf_num의 left_sibling_page_num을 left_num으로 바꿈
+ * split이나 merge로 왼쪽 leaf가 바뀐 오른쪽 leaf에 씀, PAGE_NULL이면 무시
+ */
+void set_leaf_left_sibling(int fd, tableid_t table_id, pagenum_t leaf_num,
+                           pagenum_t left_num) {
+  if (leaf_num == PAGE_NULL) {
+    return;
+  }
+  // split/merge한 leaf의 parent 밖에 있을 수 있으므로 latch를 잡음
+  buf_ctl_block_t* bcb =
+      read_buffer_with_txn(fd, table_id, leaf_num, LATCH_EXCLUSIVE);
+  ((leaf_page_t*)bcb->frame)->left_sibling_page_num = left_num;
+  bcb->is_dirty = true;
+  unlatch_and_unpin(bcb, table_id, leaf_num);
 }
 
 void init_internal_page(page_t* page) {
@@ -23,6 +87,8 @@ void init_internal_page(page_t* page) {
   internal_page->parent_page_num = PAGE_NULL;
   internal_page->is_leaf = INTERNAL;
   internal_page->num_of_keys = 0;
+  internal_page->high_key = 0;
+  internal_page->right_sibling_page_num = PAGE_NULL;
   internal_page->one_more_page_num = PAGE_NULL;
 }
 
@@ -43,7 +109,7 @@ pagenum_t make_node(int fd, tableid_t table_id, uint32_t isleaf) {
 
   switch (isleaf) {
     case LEAF:
-      init_leaf_page(page);
+      init_leaf_page(page, get_leaf_format(fd, table_id));
       break;
     case INTERNAL:
       init_internal_page(page);
@@ -88,101 +154,186 @@ int get_index_after_left_child(page_t* parent_buffer, pagenum_t left_num) {
  * key into a leaf.
  */
 int insert_into_leaf(int fd, tableid_t table_id, pagenum_t leaf_num,
-                     leaf_page_t* leaf_page, int64_t key, char* value) {
-  int index, insertion_point;
-
-  insertion_point = 0;
-  while (insertion_point < leaf_page->num_of_keys &&
-         leaf_page->records[insertion_point].key < key) {
-    insertion_point++;
-  }
-  for (index = leaf_page->num_of_keys; index > insertion_point; index--) {
-    leaf_page->records[index] = leaf_page->records[index - 1];
+                     leaf_page_t* leaf_page, int64_t key, const char* value,
+                     uint16_t length, uint32_t flags) {
+  int insertion_point = leaf_lower_bound(leaf_page, key);
+  int result = leaf_insert_record(leaf_page, insertion_point, key, value,
+                                  length, flags);
+
+  if (result == SUCCESS) {
+    write_buffer(table_id, leaf_num, (page_t*)leaf_page);
   }
-
-  leaf_page->records[insertion_point].key = key;
-  copy_value(leaf_page->records[insertion_point].value, value, VALUE_SIZE);
-  leaf_page->num_of_keys++;
-
-  write_buffer(table_id, leaf_num, (page_t*)leaf_page);
   unpin(table_id, leaf_num);
-  return SUCCESS;
+  return result;
 }
 
 /**
  * helper function for insert_into_leaf_after_splitting
  * Create a temporary array by combining the existing record and the new record
  * and return it
+ * 기존 record의 value는 leaf_copy에 복사해둔 leaf를 가리킴
  */
-record_t* prepare_records_for_split(leaf_page_t* leaf_page, int64_t key,
-                                    const char* value) {
-  record_t* temp_records =
-      (record_t*)malloc((RECORD_CNT + 1) * sizeof(record_t));
+leaf_record_t* prepare_records_for_split(leaf_page_t* leaf_page,
+                                         page_t* leaf_copy, int64_t key,
+                                         const char* value, uint16_t length,
+                                         uint32_t flags) {
+  leaf_record_t* temp_records = (leaf_record_t*)malloc(
+      (leaf_page->num_of_keys + 1) * sizeof(leaf_record_t));
   if (temp_records == NULL) {
     perror("Memory allocation for temporary records failed.");
     exit(EXIT_FAILURE);
   }
+  memcpy(leaf_copy, leaf_page, PAGE_SIZE);
+  const leaf_page_t* old_leaf = (const leaf_page_t*)leaf_copy;
 
-  int insertion_index = 0;
-  while (insertion_index < RECORD_CNT &&
-         leaf_page->records[insertion_index].key < key) {
-    insertion_index++;
-  }
+  int insertion_index = leaf_lower_bound(old_leaf, key);
 
   int i, j;
-  for (i = 0, j = 0; i < leaf_page->num_of_keys; i++, j++) {
+  for (i = 0, j = 0; i < old_leaf->num_of_keys; i++, j++) {
     if (j == insertion_index) {
       j++;
     }
-    temp_records[j] = leaf_page->records[i];
+    temp_records[j].key = leaf_key(old_leaf, i);
+    temp_records[j].value = leaf_value(old_leaf, i);
+    temp_records[j].length = leaf_value_length(old_leaf, i);
+    temp_records[j].flags = leaf_value_flags(old_leaf, i);
   }
 
   // insert new record
   temp_records[insertion_index].key = key;
-  copy_value(temp_records[insertion_index].value, value, VALUE_SIZE);
+  temp_records[insertion_index].value = value;
+  temp_records[insertion_index].length = length;
+  temp_records[insertion_index].flags = flags;
 
   return temp_records;
 }
 
+/**
+ * helper function for distribute_records_to_leaves
+ * 왼쪽 leaf에 남길 record 수
+ * 고정 길이 leaf는 개수로 반씩, slotted leaf는 byte로 반씩 나눔
+ * 가장 오른쪽 leaf의 끝에 넣는 중이면 (append) APPEND_SPLIT_PERCENT만큼
+ * 왼쪽에 남김, 오른쪽 leaf에는 적어도 넣는 record 하나
+ */
+static int leaf_split_point(const leaf_page_t* leaf_page,
+                            const leaf_record_t* temp_records, int count) {
+  // leaf_page는 아직 나누기 전, temp_records는 넣는 record까지 key 순서
+  bool append = leaf_page->right_sibling_page_num == PAGE_NULL &&
+                leaf_key(leaf_page, leaf_page->num_of_keys - 1) <
+                    temp_records[count - 1].key;
+  int percent = append ? APPEND_SPLIT_PERCENT : 50;
+  if (!leaf_is_slotted(leaf_page)) {
+    int split = cut(RECORD_CNT);
+    if (append && count * percent / 100 > split) {
+      split = count * percent / 100;
+    }
+    return split < count ? split : count - 1;
+  }
+  int total_bytes = 0;
+  for (int i = 0; i < count; i++) {
+    total_bytes += leaf_record_size(leaf_page, temp_records[i].length);
+  }
+  int split = 0;
+  int left_bytes = 0;
+  while (split < count - 1 && left_bytes < total_bytes * percent / 100) {
+    left_bytes += leaf_record_size(leaf_page, temp_records[split].length);
+    split++;
+  }
+  return split == 0 ? 1 : split;
+}
+
+/**
+ * helper function for distribute_records_to_leaves
+ */
+static void append_records(leaf_page_t* leaf_page,
+                           const leaf_record_t* records, int count) {
+  for (int i = 0; i < count; i++) {
+    if (leaf_insert_record(leaf_page, i, records[i].key, records[i].value,
+                           records[i].length, records[i].flags) != SUCCESS) {
+      perror("distribute_records_to_leaves: leaf overflow");
+      exit(EXIT_FAILURE);
+    }
+  }
+}
+
 /**
  * helper function for insert_into_leaf_after_splitting
  * Distributes records in the temporary array to old_leaf and new_leaf and
  * returns k_prime
  */
-int64_t distribute_records_to_leaves(leaf_page_t* leaf_page,
+int64_t distribute_records_to_leaves(pagenum_t leaf_num,
+                                     leaf_page_t* leaf_page,
                                      leaf_page_t* new_leaf_page,
-                                     record_t* temp_records,
+                                     leaf_record_t* temp_records, int count,
                                      pagenum_t new_leaf_num) {
-  const int split = cut(RECORD_CNT);
-
-  int i, j;
+  const int split = leaf_split_point(leaf_page, temp_records, count);
 
   // Allocate to old_leaf_page until split point
-  leaf_page->num_of_keys = 0;
-  for (i = 0; i < split; i++) {
-    leaf_page->records[i] = temp_records[i];
-    leaf_page->num_of_keys++;
-  }
-  for (int k = split; k < RECORD_CNT; k++) {
-    memset(&(leaf_page->records[k]), 0, sizeof(record_t));
-  }
+  leaf_reset(leaf_page);
+  append_records(leaf_page, temp_records, split);
 
   // Records after the split point are allocated to new_leaf_page
-  new_leaf_page->num_of_keys = 0;
-  for (j = 0; i < LEAF_ORDER; i++, j++) {
-    new_leaf_page->records[j] = temp_records[i];
-    new_leaf_page->num_of_keys++;
-  }
-  for (int k = new_leaf_page->num_of_keys; k < RECORD_CNT; k++) {
-    memset(&(new_leaf_page->records[k]), 0, sizeof(record_t));
-  }
+  leaf_reset(new_leaf_page);
+  append_records(new_leaf_page, temp_records + split, count - split);
 
   // Connect sibling nodes and set parent nodes
+  // (오른쪽 leaf의 left_sibling_page_num은 호출하는 쪽에서)
+  // new leaf는 leaf의 high key를 받고 leaf는 new leaf의 첫 key까지
+  const int64_t k_prime = leaf_key(new_leaf_page, 0);
+  new_leaf_page->high_key = leaf_page->high_key;
   new_leaf_page->right_sibling_page_num = leaf_page->right_sibling_page_num;
+  new_leaf_page->left_sibling_page_num = leaf_num;
+  leaf_page->high_key = k_prime;
   leaf_page->right_sibling_page_num = new_leaf_num;
   new_leaf_page->parent_page_num = leaf_page->parent_page_num;
 
-  return new_leaf_page->records[0].key;
+  return k_prime;
+}
+
+/**
+ * helper function for insert_into_leaf_after_splitting
+ * leaf에 record를 넣으며 둘로 나누고 부모에는 넣지 않음
+ * 새 leaf는 leaf의 right link로 이어지므로 부모에 넣기 전에도 찾을 수 있음
+ * new_key와 new_leaf_num에 부모에 넣을 key와 새 leaf
+ * If success, return 0. value가 leaf에 못 들어가는 길이면 -1
+ */
+int split_leaf(int fd, tableid_t table_id, pagenum_t leaf_num, int64_t key,
+               const char* value, uint16_t length, uint32_t flags,
+               int64_t* new_key, pagenum_t* new_leaf_num) {
+  leaf_record_t* temp_records;
+  page_t leaf_copy;
+
+  leaf_page_t* leaf_page = (leaf_page_t*)read_buffer(fd, table_id, leaf_num);
+  if (length > leaf_max_value_size(leaf_page)) {
+    unpin(table_id, leaf_num);
+    return FAILURE;
+  }
+  int count = leaf_page->num_of_keys + 1;
+
+  temp_records = prepare_records_for_split(leaf_page, &leaf_copy, key, value,
+                                           length, flags);
+
+  *new_leaf_num = make_node(fd, table_id, LEAF);
+  leaf_page_t* new_leaf_page =
+      (leaf_page_t*)read_buffer(fd, table_id, *new_leaf_num);
+  // 새 leaf는 나뉘는 leaf와 같은 format
+  new_leaf_page->format = leaf_page->format;
+
+  *new_key = distribute_records_to_leaves(leaf_num, leaf_page, new_leaf_page,
+                                          temp_records, count, *new_leaf_num);
+  pagenum_t right_num = new_leaf_page->right_sibling_page_num;
+  if (right_num == PAGE_NULL) {
+    remember_rightmost_leaf(table_id, *new_leaf_num);
+  }
+
+  free(temp_records);
+
+  write_buffer(table_id, leaf_num, (page_t*)leaf_page);
+  write_buffer(table_id, *new_leaf_num, (page_t*)new_leaf_page);
+  unpin(table_id, leaf_num);
+  unpin(table_id, *new_leaf_num);
+  set_leaf_left_sibling(fd, table_id, right_num, *new_leaf_num);
+  return SUCCESS;
 }
 
 /**
@@ -191,30 +342,205 @@ int64_t distribute_records_to_leaves(leaf_page_t* leaf_page,
  */
 int insert_into_leaf_after_splitting(int fd, tableid_t table_id,
                                      pagenum_t leaf_num, int64_t key,
-                                     char* value) {
-  pagenum_t new_leaf_num;
+                                     const char* value, uint16_t length,
+                                     uint32_t flags, const tree_path_t* path) {
   int64_t new_key;
-  record_t* temp_records;
+  pagenum_t new_leaf_num;
+  if (split_leaf(fd, table_id, leaf_num, key, value, length, flags, &new_key,
+                 &new_leaf_num) != SUCCESS) {
+    return FAILURE;
+  }
+  return insert_into_parent(fd, table_id, leaf_num, new_key, new_leaf_num,
+                            path);
+}
 
-  leaf_page_t* leaf_page = (leaf_page_t*)read_buffer(fd, table_id, leaf_num);
+/**
+ * helper function for insert_run_after_splitting
+ * leaf의 record와 run(key 순서, 겹치는 key 없음)을 key 순서로 합침
+ * 기존 record의 value는 old_leaf를 가리킴
+ */
+static int merge_leaf_records(const leaf_page_t* old_leaf,
+                              const leaf_record_t* run, int run_count,
+                              leaf_record_t* merged) {
+  int i = 0, j = 0, count = 0;
+  while (i < (int)old_leaf->num_of_keys || j < run_count) {
+    if (j == run_count ||
+        (i < (int)old_leaf->num_of_keys && leaf_key(old_leaf, i) < run[j].key)) {
+      merged[count].key = leaf_key(old_leaf, i);
+      merged[count].value = leaf_value(old_leaf, i);
+      merged[count].length = leaf_value_length(old_leaf, i);
+      merged[count].flags = leaf_value_flags(old_leaf, i);
+      i++;
+    } else {
+      merged[count] = run[j];
+      j++;
+    }
+    count++;
+  }
+  return count;
+}
 
-  temp_records = prepare_records_for_split(leaf_page, key, value);
+/**
+ * helper function for insert_run_after_splitting
+ * 합친 record를 leaf 몇개에 고르게 나눌지, leaf마다 시작 index를 starts에
+ * 한 leaf에 들어가는 양(고정 길이는 RECORD_CNT개, slotted는 body byte)으로
+ * 필요한 leaf 수를 정하고 그 수로 나눈 양씩 채움
+ * return leaf 수
+ */
+static int plan_run_split(const leaf_page_t* leaf_page,
+                          const leaf_record_t* merged, int count,
+                          int* starts) {
+  int capacity = leaf_is_slotted(leaf_page)
+                     ? LEAF_BODY_SIZE
+                     : RECORD_CNT * leaf_record_size(leaf_page, 0);
+  int total = 0;
+  for (int i = 0; i < count; i++) {
+    total += leaf_record_size(leaf_page, merged[i].length);
+  }
+  int leaves = (total + capacity - 1) / capacity;
+  int target = (total + leaves - 1) / leaves;
+
+  int num_leaves = 0;
+  int used = 0;
+  for (int i = 0; i < count; i++) {
+    int size = leaf_record_size(leaf_page, merged[i].length);
+    if (i == 0 || used + size > target) {
+      starts[num_leaves++] = i;
+      used = 0;
+    }
+    used += size;
+  }
+  return num_leaves;
+}
 
-  new_leaf_num = make_node(fd, table_id, LEAF);
-  leaf_page_t* new_leaf_page =
-      (leaf_page_t*)read_buffer(fd, table_id, new_leaf_num);
+/**
+ * helper function for insert_run_into_leaf
+ * run이 leaf에 다 들어가지 않으면 leaf를 한번만 나눔
+ * 합친 record를 필요한 만큼의 leaf에 고르게 나누고
+ * 새 leaf를 차례로 부모에 넣음
+ */
+static void insert_run_after_splitting(int fd, tableid_t table_id,
+                                       pagenum_t leaf_num,
+                                       leaf_page_t* leaf_page,
+                                       const leaf_record_t* run,
+                                       int run_count,
+                                       const tree_path_t* path) {
+  page_t leaf_copy;
+  memcpy(&leaf_copy, leaf_page, PAGE_SIZE);
+  const leaf_page_t* old_leaf = (const leaf_page_t*)&leaf_copy;
+
+  int count = old_leaf->num_of_keys + run_count;
+  leaf_record_t* merged = (leaf_record_t*)malloc(count * sizeof(leaf_record_t));
+  int* starts = (int*)malloc((count + 1) * sizeof(int));
+  if (merged == NULL || starts == NULL) {
+    perror("Memory allocation for batch split failed.");
+    exit(EXIT_FAILURE);
+  }
+  merge_leaf_records(old_leaf, run, run_count, merged);
+  int num_leaves = plan_run_split(old_leaf, merged, count, starts);
+  starts[num_leaves] = count;
 
-  new_key = distribute_records_to_leaves(leaf_page, new_leaf_page, temp_records,
-                                         new_leaf_num);
+  pagenum_t* leaf_nums = (pagenum_t*)malloc(num_leaves * sizeof(pagenum_t));
+  if (leaf_nums == NULL) {
+    perror("Memory allocation for batch split failed.");
+    exit(EXIT_FAILURE);
+  }
+  leaf_nums[0] = leaf_num;
+  for (int i = 1; i < num_leaves; i++) {
+    leaf_nums[i] = make_node(fd, table_id, LEAF);
+  }
 
-  free(temp_records);
+  // 새 leaf는 나뉘는 leaf와 같은 format, 같은 부모, sibling은 차례로
+  pagenum_t last_sibling = old_leaf->right_sibling_page_num;
+  for (int i = 0; i < num_leaves; i++) {
+    leaf_page_t* page =
+        i == 0 ? leaf_page
+               : (leaf_page_t*)read_buffer(fd, table_id, leaf_nums[i]);
+    page->format = old_leaf->format;
+    page->parent_page_num = old_leaf->parent_page_num;
+    leaf_reset(page);
+    append_records(page, merged + starts[i], starts[i + 1] - starts[i]);
+    page->left_sibling_page_num =
+        i == 0 ? old_leaf->left_sibling_page_num : leaf_nums[i - 1];
+    page->right_sibling_page_num =
+        i + 1 < num_leaves ? leaf_nums[i + 1] : last_sibling;
+    page->high_key = i + 1 < num_leaves ? merged[starts[i + 1]].key
+                                        : old_leaf->high_key;
+    write_buffer(table_id, leaf_nums[i], (page_t*)page);
+    unpin(table_id, leaf_nums[i]);
+  }
+  set_leaf_left_sibling(fd, table_id, last_sibling,
+                        leaf_nums[num_leaves - 1]);
+
+  // 앞 leaf의 부모가 split으로 바뀌었을 수 있으므로 두번째부터는
+  // 앞 leaf의 첫 key로 다시 내려가 path를 새로 받음
+  tree_path_t leaf_path = *path;
+  for (int i = 1; i < num_leaves; i++) {
+    if (i > 1) {
+      find_leaf_with_path(fd, table_id, merged[starts[i - 1]].key,
+                          &leaf_path);
+    }
+    if (path_keeps_parents(&leaf_path)) {
+      page_header_t* right =
+          (page_header_t*)read_buffer(fd, table_id, leaf_nums[i]);
+      right->parent_page_num = path_parent(&leaf_path, leaf_nums[i - 1]);
+      mark_dirty(table_id, leaf_nums[i]);
+      unpin(table_id, leaf_nums[i]);
+    }
 
-  write_buffer(table_id, leaf_num, (page_t*)leaf_page);
-  write_buffer(table_id, new_leaf_num, (page_t*)new_leaf_page);
-  unpin(table_id, leaf_num);
-  unpin(table_id, new_leaf_num);
+    insert_into_parent(fd, table_id, leaf_nums[i - 1],
+                       merged[starts[i]].key, leaf_nums[i], &leaf_path);
+  }
 
-  return insert_into_parent(fd, table_id, leaf_num, new_key, new_leaf_num);
+  free(leaf_nums);
+  free(starts);
+  free(merged);
+}
+
+/**
+ * key 오름차순 run을 leaf 하나에 넣음 (run은 모두 이 leaf의 key 범위)
+ * leaf에 이미 있는 key와 leaf에 못 넣는 길이의 value는 건너뜀
+ * 다 들어가면 write_buffer/unpin 한번, 아니면 split 한번으로 나눔
+ * run은 넣은 record만 남도록 앞으로 당겨짐
+ * return 넣은 record 수
+ */
+int insert_run_into_leaf(int fd, tableid_t table_id, pagenum_t leaf_num,
+                         leaf_record_t* run, int run_count,
+                         const tree_path_t* path) {
+  leaf_page_t* leaf_page = (leaf_page_t*)read_buffer(fd, table_id, leaf_num);
+
+  int kept = 0;
+  for (int i = 0; i < run_count; i++) {
+    if (run[i].length > leaf_max_value_size(leaf_page) ||
+        leaf_find_index(leaf_page, run[i].key) != -1) {
+      continue;
+    }
+    run[kept++] = run[i];
+  }
+  if (kept == 0) {
+    unpin(table_id, leaf_num);
+    return 0;
+  }
+
+  // 복사본에 넣어보고 다 들어가면 그대로 씀
+  page_t merged_page;
+  memcpy(&merged_page, leaf_page, PAGE_SIZE);
+  leaf_page_t* merged_leaf = (leaf_page_t*)&merged_page;
+  bool fits = true;
+  for (int i = 0; i < kept && fits; i++) {
+    int index = leaf_lower_bound(merged_leaf, run[i].key);
+    fits = leaf_insert_record(merged_leaf, index, run[i].key, run[i].value,
+                              run[i].length, run[i].flags) == SUCCESS;
+  }
+  if (fits) {
+    write_buffer(table_id, leaf_num, &merged_page);
+    unpin(table_id, leaf_num);
+    return kept;
+  }
+
+  insert_run_after_splitting(fd, table_id, leaf_num, leaf_page, run, kept,
+                             path);
+  return kept;
 }
 
 /* Inserts a new key and pointer to a node
@@ -277,8 +603,22 @@ int64_t distribute_entries_and_update_children(int fd, tableid_t table_id,
                                                internal_page_t* old_node_page,
                                                pagenum_t new_node_num,
                                                internal_page_t* new_node_page,
-                                               entry_t* temp_entries) {
-  const int split = cut(INTERNAL_ORDER);
+                                               entry_t* temp_entries,
+                                               const tree_path_t* path,
+                                               bool append_split) {
+  // 가장 오른쪽 node의 끝에 넣는 중이면 leaf처럼 왼쪽에 더 남김
+  // new node에는 적어도 entry 하나 (child 둘)
+  // high key가 없던 예전 파일은 right_sibling_page_num이 항상 0이라 반씩
+  int split = cut(INTERNAL_ORDER);
+  if (append_split && old_node_page->right_sibling_page_num == PAGE_NULL &&
+      old_node_page->entries[old_node_page->num_of_keys - 1].key <
+          temp_entries[INTERNAL_ORDER - 1].key &&
+      INTERNAL_ORDER * APPEND_SPLIT_PERCENT / 100 > split) {
+    split = INTERNAL_ORDER * APPEND_SPLIT_PERCENT / 100;
+    if (split > INTERNAL_ORDER - 1) {
+      split = INTERNAL_ORDER - 1;
+    }
+  }
   int i, j;
 
   // key to send to parents
@@ -310,7 +650,17 @@ int64_t distribute_entries_and_update_children(int fd, tableid_t table_id,
 
   new_node_page->parent_page_num = old_node_page->parent_page_num;
 
+  // new node는 old node의 오른쪽에 이어지고 high key를 받음
+  new_node_page->high_key = old_node_page->high_key;
+  new_node_page->right_sibling_page_num = old_node_page->right_sibling_page_num;
+  old_node_page->high_key = k_prime;
+  old_node_page->right_sibling_page_num = new_node_num;
+
   // Update the parent of a child node
+  // (TREE_MODE_PATH에는 parent_page_num이 없으므로 child는 읽지도 않음)
+  if (!path_keeps_parents(path)) {
+    return k_prime;
+  }
   pagenum_t child = new_node_page->one_more_page_num;
   if (child != PAGE_NULL) {
     page_t* child_page = read_buffer(fd, table_id, child);
@@ -334,16 +684,20 @@ int64_t distribute_entries_and_update_children(int fd, tableid_t table_id,
 }
 
 /**
- * Splits a node into two by inserting a new key and pointer into the internal
- * node and passes the split information to the parent
+ * helper function for insert_into_node_after_splitting
+ * internal node에 entry를 넣으며 둘로 나누고 부모에는 넣지 않음
+ * k_prime에 부모에 넣을 key, return 새 node
  */
-int insert_into_node_after_splitting(int fd, tableid_t table_id,
-                                     pagenum_t old_node, int64_t left_index,
-                                     int64_t key, pagenum_t right) {
+pagenum_t split_node(int fd, tableid_t table_id, pagenum_t old_node,
+                     int64_t left_index, int64_t key, pagenum_t right,
+                     const tree_path_t* path, int64_t* k_prime) {
   pagenum_t new_node_num;
-  int64_t k_prime;
   entry_t* temp_entries;
 
+  header_page_t* header_page = read_header_page(fd, table_id);
+  bool has_links = header_page->high_keys != 0;
+  unpin(table_id, HEADER_PAGE_POS);
+
   internal_page_t* old_node_page =
       (internal_page_t*)read_buffer(fd, table_id, old_node);
 
@@ -354,9 +708,9 @@ int insert_into_node_after_splitting(int fd, tableid_t table_id,
   internal_page_t* new_node_page =
       (internal_page_t*)read_buffer(fd, table_id, new_node_num);
 
-  k_prime = distribute_entries_and_update_children(fd, table_id, old_node,
-                                                   old_node_page, new_node_num,
-                                                   new_node_page, temp_entries);
+  *k_prime = distribute_entries_and_update_children(
+      fd, table_id, old_node, old_node_page, new_node_num, new_node_page,
+      temp_entries, path, has_links);
 
   free(temp_entries);
 
@@ -364,27 +718,36 @@ int insert_into_node_after_splitting(int fd, tableid_t table_id,
   write_buffer(table_id, new_node_num, (page_t*)new_node_page);
   unpin(table_id, old_node);
   unpin(table_id, new_node_num);
+  return new_node_num;
+}
 
-  return insert_into_parent(fd, table_id, old_node, k_prime, new_node_num);
+/**
+ * Splits a node into two by inserting a new key and pointer into the internal
+ * node and passes the split information to the parent
+ */
+int insert_into_node_after_splitting(int fd, tableid_t table_id,
+                                     pagenum_t old_node, int64_t left_index,
+                                     int64_t key, pagenum_t right,
+                                     const tree_path_t* path) {
+  int64_t k_prime;
+  pagenum_t new_node_num = split_node(fd, table_id, old_node, left_index, key,
+                                      right, path, &k_prime);
+  return insert_into_parent(fd, table_id, old_node, k_prime, new_node_num,
+                            path);
 }
 
 /* Inserts a new node (leaf or internal node) into the B+ tree.
  * Returns the root of the tree after insertion.
  */
 int insert_into_parent(int fd, tableid_t table_id, pagenum_t left, int64_t key,
-                       pagenum_t right) {
+                       pagenum_t right, const tree_path_t* path) {
   int left_index;
-  pagenum_t parent;
-
-  page_header_t* left_page_header =
-      (page_header_t*)read_buffer(fd, table_id, left);
-
-  parent = left_page_header->parent_page_num;
-  unpin(table_id, left);
+  // left는 split 전부터 있던 page라 path에 있음
+  pagenum_t parent = path_parent(path, left);
 
   /* Case: new root. */
   if (parent == PAGE_NULL) {
-    return insert_into_new_root(fd, table_id, left, key, right);
+    return insert_into_new_root(fd, table_id, left, key, right, path);
   }
 
   /* Case: leaf or node. (Remainder of
@@ -410,7 +773,7 @@ int insert_into_parent(int fd, tableid_t table_id, pagenum_t left, int64_t key,
    */
   unpin(table_id, parent);
   return insert_into_node_after_splitting(fd, table_id, parent, left_index, key,
-                                          right);
+                                          right, path);
 }
 
 /* Creates a new root for two subtrees
@@ -418,7 +781,8 @@ int insert_into_parent(int fd, tableid_t table_id, pagenum_t left, int64_t key,
  * the new root.
  */
 int insert_into_new_root(int fd, tableid_t table_id, pagenum_t left,
-                         int64_t key, pagenum_t right) {
+                         int64_t key, pagenum_t right,
+                         const tree_path_t* path) {
   pagenum_t root = make_node(fd, table_id, INTERNAL);
 
   // root 처리
@@ -435,17 +799,19 @@ int insert_into_new_root(int fd, tableid_t table_id, pagenum_t left,
   unpin(table_id, root);
 
   // left right 처리
-  page_t* left_page = read_buffer(fd, table_id, left);
-  page_header_t* left_header = (page_header_t*)left_page;
-  left_header->parent_page_num = root;
-  write_buffer(table_id, left, left_page);
-  unpin(table_id, left);
-
-  page_t* right_page = read_buffer(fd, table_id, right);
-  page_header_t* right_header = (page_header_t*)right_page;
-  right_header->parent_page_num = root;
-  write_buffer(table_id, right, right_page);
-  unpin(table_id, right);
+  if (path_keeps_parents(path)) {
+    page_t* left_page = read_buffer(fd, table_id, left);
+    page_header_t* left_header = (page_header_t*)left_page;
+    left_header->parent_page_num = root;
+    write_buffer(table_id, left, left_page);
+    unpin(table_id, left);
+
+    page_t* right_page = read_buffer(fd, table_id, right);
+    page_header_t* right_header = (page_header_t*)right_page;
+    right_header->parent_page_num = root;
+    write_buffer(table_id, right, right_page);
+    unpin(table_id, right);
+  }
 
   // 헤더 페이지 갱신
   header_page_t* header_page = read_header_page(fd, table_id);
@@ -460,18 +826,29 @@ int insert_into_new_root(int fd, tableid_t table_id, pagenum_t left,
  * start a new tree.
  */
 int start_new_tree(int fd, tableid_t table_id, int64_t key, char* value) {
+  char fixed_value[VALUE_SIZE];
+  uint16_t length = prepare_fixed_value(fixed_value, value);
+  return start_new_tree(fd, table_id, key, fixed_value, length, 0);
+}
+
+int start_new_tree(int fd, tableid_t table_id, int64_t key, const char* value,
+                   uint16_t length, uint32_t flags) {
   // make root page
   pagenum_t root = make_node(fd, table_id, LEAF);
   leaf_page_t* root_page = (leaf_page_t*)read_buffer(fd, table_id, root);
 
   root_page->parent_page_num = PAGE_NULL;
   root_page->is_leaf = LEAF;
-  root_page->num_of_keys = 1;
   root_page->right_sibling_page_num = PAGE_NULL;
-  root_page->records[0].key = key;
-  copy_value(root_page->records[0].value, value, VALUE_SIZE);
+  if (leaf_insert_record(root_page, 0, key, value, length, flags) !=
+      SUCCESS) {
+    unpin(table_id, root);
+    free_page_in_buffer(fd, table_id, root);
+    return FAILURE;
+  }
 
   link_header_page(fd, table_id, root);
+  remember_rightmost_leaf(table_id, root);
 
   write_buffer(table_id, root, (page_t*)root_page);
   unpin(table_id, root);
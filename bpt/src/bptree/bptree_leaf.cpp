@@ -0,0 +1,257 @@
+#include "bpt.h"
+
+// LEAF RECORDS
+
+/**
+ * record를 모두 지우고 빈 leaf로, header의 나머지는 그대로
+ */
+void leaf_reset(leaf_page_t* leaf) {
+  leaf->num_of_keys = 0;
+  if (leaf_is_slotted(leaf)) {
+    slotted_leaf_page_t* sleaf = as_slotted(leaf);
+    sleaf->heap_start = LEAF_BODY_SIZE;
+    sleaf->payload_bytes = 0;
+    memset(sleaf->body, 0, LEAF_BODY_SIZE);
+  } else {
+    memset(leaf->records, 0, sizeof(leaf->records));
+  }
+}
+
+uint16_t leaf_max_value_size(const leaf_page_t* leaf) {
+  return leaf_is_slotted(leaf) ? SLOTTED_MAX_VALUE_SIZE : VALUE_SIZE;
+}
+
+/**
+ * record 하나가 leaf에서 차지하는 byte
+ */
+int leaf_record_size(const leaf_page_t* leaf, uint16_t length) {
+  if (leaf_is_slotted(leaf)) {
+    return sizeof(slot_t) + length;
+  }
+  return sizeof(record_t);
+}
+
+/**
+ * helper function for slotted leaf
+ * slot과 살아있는 value가 차지하는 byte
+ */
+static int slotted_used_bytes(const slotted_leaf_page_t* sleaf) {
+  return sleaf->num_of_keys * sizeof(slot_t) + sleaf->payload_bytes;
+}
+
+/**
+ * length 길이의 value를 하나 더 넣을 수 있으면 true
+ */
+bool leaf_has_room(const leaf_page_t* leaf, uint16_t length) {
+  if (leaf_is_slotted(leaf)) {
+    return slotted_used_bytes(as_slotted(leaf)) + sizeof(slot_t) + length <=
+           LEAF_BODY_SIZE;
+  }
+  return leaf->num_of_keys < RECORD_CNT;
+}
+
+/**
+ * src의 record를 모두 dest 뒤에 붙일 수 있으면 true
+ */
+bool leaf_can_merge(const leaf_page_t* dest, const leaf_page_t* src) {
+  if (leaf_is_slotted(dest)) {
+    int src_bytes = 0;
+    for (int i = 0; i < (int)src->num_of_keys; i++) {
+      src_bytes += leaf_record_size(dest, leaf_value_length(src, i));
+    }
+    return slotted_used_bytes(as_slotted(dest)) + src_bytes <= LEAF_BODY_SIZE;
+  }
+  return dest->num_of_keys + src->num_of_keys < RECORD_CNT;
+}
+
+/**
+ * helper function for slotted leaf
+ * 지워진 value 자리를 없애고 value들을 body 끝으로 모음
+ */
+static void slotted_compact(slotted_leaf_page_t* sleaf) {
+  char temp_body[LEAF_BODY_SIZE];
+  memcpy(temp_body, sleaf->body, LEAF_BODY_SIZE);
+
+  uint16_t heap_start = LEAF_BODY_SIZE;
+  for (int i = 0; i < (int)sleaf->num_of_keys; i++) {
+    slot_t* slot = &sleaf->slots[i];
+    heap_start -= slot->length;
+    memcpy(sleaf->body + heap_start, temp_body + slot->offset, slot->length);
+    slot->offset = heap_start;
+  }
+  int slot_end = sleaf->num_of_keys * sizeof(slot_t);
+  memset(sleaf->body + slot_end, 0, heap_start - slot_end);
+  sleaf->heap_start = heap_start;
+}
+
+/**
+ * helper function for slotted leaf
+ * slot 하나를 더 두고 length byte를 받을 자리, 연속된 공간이 모자라면 compact
+ * 먼저 leaf_has_room으로 확인해야 함
+ */
+static uint16_t slotted_alloc(slotted_leaf_page_t* sleaf, uint16_t length) {
+  int slot_end = (sleaf->num_of_keys + 1) * sizeof(slot_t);
+  if (sleaf->heap_start - slot_end < length) {
+    slotted_compact(sleaf);
+  }
+  sleaf->heap_start -= length;
+  sleaf->payload_bytes += length;
+  return sleaf->heap_start;
+}
+
+/**
+ * helper function for fixed length leaf
+ * value를 length byte 쓰고 나머지 칸은 0
+ */
+static void store_fixed_value(char* dest, const char* value,
+                              uint16_t length) {
+  memcpy(dest, value, length);
+  memset(dest + length, 0, VALUE_SIZE - length);
+}
+
+/**
+ * index 자리에 record를 넣고 뒤의 record를 한칸씩 밀어냄
+ * flags는 slotted leaf의 slot에만 남음 (SLOT_OVERFLOW면 value는 overflow_ref_t)
+ * If success, return 0. 자리가 없거나 value가 너무 길면 -1
+ */
+int leaf_insert_record(leaf_page_t* leaf, int index, int64_t key,
+                       const char* value, uint16_t length, uint32_t flags) {
+  if (length > leaf_max_value_size(leaf) || !leaf_has_room(leaf, length)) {
+    return FAILURE;
+  }
+  int n = leaf->num_of_keys;
+
+  if (leaf_is_slotted(leaf)) {
+    slotted_leaf_page_t* sleaf = as_slotted(leaf);
+    uint16_t offset = slotted_alloc(sleaf, length);
+    memmove(&sleaf->slots[index + 1], &sleaf->slots[index],
+            (n - index) * sizeof(slot_t));
+    sleaf->slots[index].key = key;
+    sleaf->slots[index].offset = offset;
+    sleaf->slots[index].length = length;
+    sleaf->slots[index].flags = flags;
+    memcpy(sleaf->body + offset, value, length);
+  } else if (leaf_has_key_array(leaf)) {
+    key_array_leaf_page_t* kleaf = as_key_array(leaf);
+    memmove(&kleaf->keys[index + 1], &kleaf->keys[index],
+            (n - index) * sizeof(int64_t));
+    memmove(kleaf->values[index + 1], kleaf->values[index],
+            (n - index) * VALUE_SIZE);
+    kleaf->keys[index] = key;
+    store_fixed_value(kleaf->values[index], value, length);
+  } else {
+    memmove(&leaf->records[index + 1], &leaf->records[index],
+            (n - index) * sizeof(record_t));
+    leaf->records[index].key = key;
+    store_fixed_value(leaf->records[index].value, value, length);
+  }
+  leaf->num_of_keys++;
+  return SUCCESS;
+}
+
+/**
+ * index의 record를 지우고 뒤의 record를 한칸씩 당김
+ */
+void leaf_remove_record(leaf_page_t* leaf, int index) {
+  int n = leaf->num_of_keys;
+
+  if (leaf_is_slotted(leaf)) {
+    slotted_leaf_page_t* sleaf = as_slotted(leaf);
+    slot_t* slot = &sleaf->slots[index];
+    if (slot->offset == sleaf->heap_start) {
+      sleaf->heap_start += slot->length;
+    }
+    sleaf->payload_bytes -= slot->length;
+    memmove(&sleaf->slots[index], &sleaf->slots[index + 1],
+            (n - index - 1) * sizeof(slot_t));
+    memset(&sleaf->slots[n - 1], 0, sizeof(slot_t));
+  } else if (leaf_has_key_array(leaf)) {
+    key_array_leaf_page_t* kleaf = as_key_array(leaf);
+    memmove(&kleaf->keys[index], &kleaf->keys[index + 1],
+            (n - index - 1) * sizeof(int64_t));
+    memmove(kleaf->values[index], kleaf->values[index + 1],
+            (n - index - 1) * VALUE_SIZE);
+    kleaf->keys[n - 1] = 0;
+    memset(kleaf->values[n - 1], 0, VALUE_SIZE);
+  } else {
+    memmove(&leaf->records[index], &leaf->records[index + 1],
+            (n - index - 1) * sizeof(record_t));
+    memset(&leaf->records[n - 1], 0, sizeof(record_t));
+  }
+  leaf->num_of_keys--;
+}
+
+/**
+ * index의 value를 바꿈, slotted leaf에서 길어진 value가 들어갈 자리가 없으면
+ * 그대로 두고 -1
+ */
+int leaf_update_value(leaf_page_t* leaf, int index, const char* value,
+                      uint16_t length) {
+  if (length > leaf_max_value_size(leaf)) {
+    return FAILURE;
+  }
+  if (!leaf_is_slotted(leaf)) {
+    store_fixed_value(leaf_value(leaf, index), value, length);
+    return SUCCESS;
+  }
+
+  slotted_leaf_page_t* sleaf = as_slotted(leaf);
+  slot_t* slot = &sleaf->slots[index];
+  if (length <= slot->length) {
+    memcpy(sleaf->body + slot->offset, value, length);
+    sleaf->payload_bytes -= slot->length - length;
+    slot->length = length;
+    return SUCCESS;
+  }
+  if (slotted_used_bytes(sleaf) - slot->length + length > LEAF_BODY_SIZE) {
+    return FAILURE;
+  }
+
+  // 예전 value를 지운 셈 치고 새 자리를 받음, compact에서 예전 자리는
+  // 길이 0이라 회수됨
+  sleaf->payload_bytes -= slot->length;
+  slot->length = 0;
+  int slot_end = sleaf->num_of_keys * sizeof(slot_t);
+  if (sleaf->heap_start - slot_end < length) {
+    slotted_compact(sleaf);
+  }
+  sleaf->heap_start -= length;
+  sleaf->payload_bytes += length;
+  slot->offset = sleaf->heap_start;
+  slot->length = length;
+  memcpy(sleaf->body + slot->offset, value, length);
+  return SUCCESS;
+}
+
+/**
+ * 고정 길이 API(db_insert 등)의 value를 VALUE_SIZE 문자열로 잘라 dest에
+ * @return 끝의 '\0'까지 포함한 길이
+ */
+uint16_t prepare_fixed_value(char* dest, const char* value) {
+  copy_value(dest, value, VALUE_SIZE);
+  return (uint16_t)(strlen(dest) + 1);
+}
+
+/**
+ * 고정 길이 API(db_find 등)용 value 복사, VALUE_SIZE 버퍼에 문자열로
+ * overflow value는 leaf에 남은 앞부분까지만 (chain을 읽지 않음)
+ */
+void copy_leaf_value(char* dest, const leaf_page_t* leaf, int index) {
+  if (leaf_is_overflow(leaf, index)) {
+    // chain은 읽지 않고 leaf에 있는 앞부분만
+    overflow_ref_t ref;
+    leaf_overflow_ref(leaf, index, &ref);
+    int length = OVERFLOW_PREFIX_SIZE < VALUE_SIZE - 1 ? OVERFLOW_PREFIX_SIZE
+                                                       : VALUE_SIZE - 1;
+    memcpy(dest, ref.prefix, length);
+    memset(dest + length, 0, VALUE_SIZE - length);
+    return;
+  }
+  uint16_t length = leaf_value_length(leaf, index);
+  if (length >= VALUE_SIZE) {
+    copy_value(dest, leaf_value(leaf, index), VALUE_SIZE);
+    return;
+  }
+  memcpy(dest, leaf_value(leaf, index), length);
+  memset(dest + length, 0, VALUE_SIZE - length);
+}
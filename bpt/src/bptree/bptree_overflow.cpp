@@ -0,0 +1,230 @@
+#include "bpt.h"
+#include "buf_mgr.h"
+#include "file.h"
+
+// OVERFLOW
+
+/**
+ * slotted leaf에 들어가지 않는 긴 value는 앞 OVERFLOW_PREFIX_SIZE byte만
+ * leaf에 두고(overflow_ref_t) 나머지를 overflow page chain에 나눠 담음
+ * chain은 make_and_pin_page로 받아 버퍼를 거쳐 쓰고,
+ * 읽을때는 버퍼에 없는 page를 버퍼에 올리지 않고 preadv로 한번에 읽음
+ */
+
+typedef void (*overflow_visit_t)(const overflow_page_t* page, void* ctx);
+
+/**
+ * helper function for write_overflow_chain
+ * 새 overflow page를 data로 채움, next_page_num은 다음 page를 받은 뒤에
+ */
+static void fill_overflow_page(overflow_page_t* page, const char* data,
+                               uint32_t length) {
+  memset(page, 0, PAGE_SIZE);
+  page->next_page_num = PAGE_NULL;
+  page->is_leaf = OVERFLOW;
+  page->data_length = length;
+  memcpy(page->data, data, length);
+}
+
+/**
+ * value의 prefix 뒤를 overflow page chain에 쓰고 leaf에 넣을 ref를 채움
+ * page는 한번에 두개까지만 pin, free page가 없으면 이어진 page를 받게 됨
+ * If success, return 0. leaf에 넣어야 할 만큼 짧으면 -1
+ */
+int write_overflow_chain(int fd, tableid_t table_id, const char* value,
+                         uint16_t length, overflow_ref_t* ref) {
+  if (length <= OVERFLOW_PREFIX_SIZE) {
+    return FAILURE;
+  }
+  memset(ref, 0, sizeof(overflow_ref_t));
+  memcpy(ref->prefix, value, OVERFLOW_PREFIX_SIZE);
+  ref->value_length = length;
+
+  const char* data = value + OVERFLOW_PREFIX_SIZE;
+  uint32_t remaining = length - OVERFLOW_PREFIX_SIZE;
+
+  allocated_page_info_t prev = {NULL, PAGE_NULL};
+  while (remaining > 0) {
+    uint32_t chunk =
+        remaining < OVERFLOW_DATA_SIZE ? remaining : OVERFLOW_DATA_SIZE;
+    allocated_page_info_t current = make_and_pin_page(fd, table_id);
+    fill_overflow_page((overflow_page_t*)current.page_ptr, data, chunk);
+
+    if (prev.page_num == PAGE_NULL) {
+      ref->first_page_num = current.page_num;
+    } else {
+      ((overflow_page_t*)prev.page_ptr)->next_page_num = current.page_num;
+      write_buffer(table_id, prev.page_num, prev.page_ptr);
+      unpin(table_id, prev.page_num);
+    }
+    ref->page_count++;
+    prev = current;
+    data += chunk;
+    remaining -= chunk;
+  }
+  write_buffer(table_id, prev.page_num, prev.page_ptr);
+  unpin(table_id, prev.page_num);
+  return SUCCESS;
+}
+
+/**
+ * helper function for overflow chain
+ * chain 앞에서부터 page_count개 page를 순서대로 visit
+ * 버퍼에 있는 page는 버퍼에서 (dirty일 수 있음),
+ * 없는 page는 버퍼에 올리지 않고 이어진 번호의 page를 최대
+ * OVERFLOW_READ_BATCH개 file_read_pages로 한번에 읽음
+ * 이어진 번호는 추측이므로 앞 page의 next_page_num이 맞을때만 씀
+ */
+static void walk_overflow_chain(int fd, tableid_t table_id,
+                                pagenum_t first_page_num, uint32_t page_count,
+                                overflow_visit_t visit, void* ctx) {
+  header_page_t* header = read_header_page(fd, table_id);
+  pagenum_t num_of_pages = header->num_of_pages;
+  unpin(table_id, HEADER_PAGE_POS);
+
+  page_t* batch = NULL;
+  page_t* dests[OVERFLOW_READ_BATCH];
+
+  pagenum_t page_num = first_page_num;
+  while (page_count > 0 && page_num != PAGE_NULL) {
+    if (get_frame_index_by_page(table_id, page_num) != INVALID_FRAME) {
+      overflow_page_t* page =
+          (overflow_page_t*)read_buffer(fd, table_id, page_num);
+      visit(page, ctx);
+      pagenum_t next_page_num = page->next_page_num;
+      unpin(table_id, page_num);
+      page_num = next_page_num;
+      page_count--;
+      continue;
+    }
+
+    // O_DIRECT로 열린 fd에도 읽을 수 있도록 PAGE_SIZE 정렬
+    if (batch == NULL &&
+        posix_memalign((void**)&batch, PAGE_SIZE,
+                       OVERFLOW_READ_BATCH * PAGE_SIZE) != 0) {
+      perror("walk_overflow_chain: posix_memalign");
+      exit(EXIT_FAILURE);
+    }
+    int run = 0;
+    while (run < OVERFLOW_READ_BATCH && run < (int)page_count &&
+           page_num + run < num_of_pages &&
+           (run == 0 || get_frame_index_by_page(table_id, page_num + run) ==
+                            INVALID_FRAME)) {
+      wait_for_page_write_back(table_id, page_num + run);
+      dests[run] = &batch[run];
+      run++;
+    }
+    pagenum_t run_start = page_num;
+    file_read_pages(fd, run_start, dests, run);
+
+    for (int i = 0; i < run && page_count > 0; i++) {
+      const overflow_page_t* page = (const overflow_page_t*)dests[i];
+      visit(page, ctx);
+      page_count--;
+      page_num = page->next_page_num;
+      if (page_num != run_start + i + 1) {
+        // 다음 page가 이어진 번호가 아니면 읽어둔 나머지는 버림
+        break;
+      }
+    }
+  }
+  free(batch);
+}
+
+typedef struct {
+  char* dest;
+  uint32_t remaining;
+} overflow_read_ctx_t;
+
+/**
+ * helper function for read_overflow_value
+ */
+static void copy_overflow_data(const overflow_page_t* page, void* ctx) {
+  overflow_read_ctx_t* read_ctx = (overflow_read_ctx_t*)ctx;
+  uint32_t length = page->data_length < read_ctx->remaining
+                        ? page->data_length
+                        : read_ctx->remaining;
+  memcpy(read_ctx->dest, page->data, length);
+  read_ctx->dest += length;
+  read_ctx->remaining -= length;
+}
+
+/**
+ * overflow value의 앞 length byte를 dest에
+ * OVERFLOW_PREFIX_SIZE 이하면 leaf의 prefix만 쓰고 chain은 읽지 않음,
+ * 더 길어도 필요한 page까지만 읽음
+ */
+void read_overflow_value(int fd, tableid_t table_id, const overflow_ref_t* ref,
+                         char* dest, uint16_t length) {
+  if (length > ref->value_length) {
+    length = ref->value_length;
+  }
+  if (length <= OVERFLOW_PREFIX_SIZE) {
+    memcpy(dest, ref->prefix, length);
+    return;
+  }
+  memcpy(dest, ref->prefix, OVERFLOW_PREFIX_SIZE);
+
+  overflow_read_ctx_t read_ctx;
+  read_ctx.dest = dest + OVERFLOW_PREFIX_SIZE;
+  read_ctx.remaining = length - OVERFLOW_PREFIX_SIZE;
+  uint32_t page_count =
+      (read_ctx.remaining + OVERFLOW_DATA_SIZE - 1) / OVERFLOW_DATA_SIZE;
+  walk_overflow_chain(fd, table_id, ref->first_page_num, page_count,
+                      copy_overflow_data, &read_ctx);
+}
+
+typedef struct {
+  pagenum_t* pages;
+  uint32_t count;
+} overflow_pages_ctx_t;
+
+/**
+ * helper function for free_overflow_chain
+ * 다음 page 번호를 모음, 마지막 page는 읽을 필요가 없음
+ */
+static void collect_next_page(const overflow_page_t* page, void* ctx) {
+  overflow_pages_ctx_t* pages_ctx = (overflow_pages_ctx_t*)ctx;
+  pages_ctx->pages[pages_ctx->count++] = page->next_page_num;
+}
+
+/**
+ * chain의 page를 모두 free page로 돌려줌
+ * 뒤에서부터 free해서 free list가 chain 순서가 되고,
+ * 다음 chain이 같은 page를 같은 순서로 받아 이어서 읽을 수 있음
+ */
+void free_overflow_chain(int fd, tableid_t table_id,
+                         const overflow_ref_t* ref) {
+  if (ref->page_count == 0) {
+    return;
+  }
+  overflow_pages_ctx_t pages_ctx;
+  pages_ctx.pages = (pagenum_t*)malloc(ref->page_count * sizeof(pagenum_t));
+  if (pages_ctx.pages == NULL) {
+    perror("free_overflow_chain: malloc");
+    exit(EXIT_FAILURE);
+  }
+  pages_ctx.pages[0] = ref->first_page_num;
+  pages_ctx.count = 1;
+  walk_overflow_chain(fd, table_id, ref->first_page_num, ref->page_count - 1,
+                      collect_next_page, &pages_ctx);
+
+  for (int i = (int)pages_ctx.count - 1; i >= 0; i--) {
+    free_page_in_buffer(fd, table_id, pages_ctx.pages[i]);
+  }
+  free(pages_ctx.pages);
+}
+
+/**
+ * leaf의 overflow record가 가진 chain을 모두 free, leaf를 지우기 전에
+ */
+void free_leaf_overflow_chains(int fd, tableid_t table_id,
+                               const leaf_page_t* leaf) {
+  for (int i = 0; i < (int)leaf->num_of_keys; i++) {
+    if (leaf_is_overflow(leaf, i)) {
+      overflow_ref_t ref;
+      leaf_overflow_ref(leaf, i, &ref);
+      free_overflow_chain(fd, table_id, &ref);
+    }
+  }
+}
@@ -0,0 +1,247 @@
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define HAVE_AVX2_KERNEL 1
+#endif
+
+#include "bpt.h"
+
+// SEARCH
+
+/**
+ * 페이지 안에서 key 위치를 찾는 kernel
+ * internal page: key 이하인 entry 수 (= 내려갈 child 번호)
+ * leaf page: key보다 작은 record 수 (= key가 있거나 들어갈 자리)
+ * 둘 다 정렬되어 있다고 가정
+ */
+
+/**
+ * helper function for search kernels
+ * 분기 없는 binary search, 비교 결과로 base만 옮기므로 예측 실패가 없음
+ * 끝나면 답은 [base, base + len] 안에 있음
+ */
+static inline const entry_t* narrow_entries(const entry_t* base, int* len,
+                                            int64_t key, int stop_len) {
+  int n = *len;
+  while (n > stop_len) {
+    int half = n / 2;
+    base = (base[half].key <= key) ? base + half : base;
+    n -= half;
+  }
+  *len = n;
+  return base;
+}
+
+static int upper_bound_entries_linear(const entry_t* entries, int n,
+                                      int64_t key) {
+  int index = 0;
+  while (index < n && key >= entries[index].key) {
+    index++;
+  }
+  return index;
+}
+
+static int upper_bound_entries_binary(const entry_t* entries, int n,
+                                      int64_t key) {
+  if (n == 0) {
+    return 0;
+  }
+  int len = n;
+  const entry_t* base = narrow_entries(entries, &len, key, 1);
+  return (int)(base - entries) + (base->key <= key);
+}
+
+#ifdef HAVE_AVX2_KERNEL
+/**
+ * binary search로 SEARCH_SIMD_WINDOW개까지 좁힌 뒤 한번에 비교
+ * entry는 {key, page_num} 쌍이라 256bit에 두 entry가 들어가고
+ * key lane(0, 2)의 비교 결과만 셈
+ */
+__attribute__((target("avx2,popcnt"))) static int upper_bound_entries_avx2(
+    const entry_t* entries, int n, int64_t key) {
+  int len = n;
+  const entry_t* base = narrow_entries(entries, &len, key, SEARCH_SIMD_WINDOW);
+
+  __m256i keys = _mm256_set1_epi64x(key);
+  int greater = 0;
+  int i = 0;
+  for (; i + 2 <= len; i += 2) {
+    __m256i pair = _mm256_loadu_si256((const __m256i*)&base[i]);
+    int mask =
+        _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(pair, keys)));
+    greater += __builtin_popcount(mask & 0x5);
+  }
+  for (; i < len; i++) {
+    greater += base[i].key > key;
+  }
+  return (int)(base - entries) + len - greater;
+}
+#endif
+
+/**
+ * LEAF_FORMAT_KEY_ARRAY leaf의 key 배열에서 key보다 작은 key 수
+ */
+static int lower_bound_keys_linear(const int64_t* keys, int n, int64_t key) {
+  int index = 0;
+  while (index < n && keys[index] < key) {
+    index++;
+  }
+  return index;
+}
+
+static int lower_bound_keys_binary(const int64_t* keys, int n, int64_t key) {
+  if (n == 0) {
+    return 0;
+  }
+  const int64_t* base = keys;
+  while (n > 1) {
+    int half = n / 2;
+    base = (base[half] < key) ? base + half : base;
+    n -= half;
+  }
+  return (int)(base - keys) + (*base < key);
+}
+
+#ifdef HAVE_AVX2_KERNEL
+/**
+ * key 배열은 256bit에 key 4개라 SEARCH_SIMD_WINDOW개까지 좁힌 뒤 비교
+ */
+__attribute__((target("avx2,popcnt"))) static int lower_bound_keys_avx2(
+    const int64_t* keys, int n, int64_t key) {
+  const int64_t* base = keys;
+  while (n > SEARCH_SIMD_WINDOW) {
+    int half = n / 2;
+    base = (base[half] < key) ? base + half : base;
+    n -= half;
+  }
+
+  __m256i target = _mm256_set1_epi64x(key);
+  int less = 0;
+  int i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i quad = _mm256_loadu_si256((const __m256i*)&base[i]);
+    int mask = _mm256_movemask_pd(
+        _mm256_castsi256_pd(_mm256_cmpgt_epi64(target, quad)));
+    less += __builtin_popcount(mask);
+  }
+  for (; i < n; i++) {
+    less += base[i] < key;
+  }
+  return (int)(base - keys) + less;
+}
+#endif
+
+static int (*entry_search)(const entry_t*, int, int64_t) =
+    upper_bound_entries_binary;
+static int (*key_search)(const int64_t*, int, int64_t) =
+    lower_bound_keys_binary;
+static SearchKernel entry_search_kernel = SEARCH_BINARY;
+
+/**
+ * internal page와 key 배열 leaf 탐색 kernel 선택, 기본은 SEARCH_BINARY
+ * (bench_descent에서 AVX2가 binary와 차이가 없어서 기본으로 두지 않음)
+ * If success, return 0. 이 CPU에서 쓸 수 없으면 -1
+ */
+int set_search_kernel(SearchKernel kernel) {
+  switch (kernel) {
+    case SEARCH_LINEAR:
+      entry_search = upper_bound_entries_linear;
+      key_search = lower_bound_keys_linear;
+      break;
+    case SEARCH_BINARY:
+      entry_search = upper_bound_entries_binary;
+      key_search = lower_bound_keys_binary;
+      break;
+    case SEARCH_AVX2:
+#ifdef HAVE_AVX2_KERNEL
+      __builtin_cpu_init();
+      if (!__builtin_cpu_supports("avx2")) {
+        return FAILURE;
+      }
+      entry_search = upper_bound_entries_avx2;
+      key_search = lower_bound_keys_avx2;
+      break;
+#else
+      return FAILURE;
+#endif
+    default:
+      return FAILURE;
+  }
+  entry_search_kernel = kernel;
+  return SUCCESS;
+}
+
+SearchKernel get_search_kernel(void) { return entry_search_kernel; }
+
+/**
+ * key 이하인 entry 수, find_leaf에서 내려갈 child 번호
+ */
+int internal_child_index(const internal_page_t* internal_page, int64_t key) {
+  return entry_search(internal_page->entries, internal_page->num_of_keys, key);
+}
+
+/**
+ * latch 없이 읽는 page용, 한번 읽어서 확인한 num_of_keys로 찾음
+ */
+int internal_child_index(const internal_page_t* internal_page,
+                         int num_of_keys, int64_t key) {
+  return entry_search(internal_page->entries, num_of_keys, key);
+}
+
+/**
+ * key가 속하는 child의 page number
+ */
+pagenum_t internal_find_child(const internal_page_t* internal_page,
+                              int64_t key) {
+  int index = internal_child_index(internal_page, key);
+  if (index == 0) {
+    return internal_page->one_more_page_num;
+  }
+  return internal_page->entries[index - 1].page_num;
+}
+
+/**
+ * helper function for leaf_lower_bound
+ * key를 첫 field로 가진 record(record_t, slot_t) 배열의 분기 없는 binary search
+ */
+template <typename Record>
+static int lower_bound_records(const Record* records, int n, int64_t key) {
+  if (n == 0) {
+    return 0;
+  }
+  const Record* base = records;
+  while (n > 1) {
+    int half = n / 2;
+    base = (base[half].key < key) ? base + half : base;
+    n -= half;
+  }
+  return (int)(base - records) + (base->key < key);
+}
+
+/**
+ * key보다 작은 record 수
+ * key 배열 leaf는 선택된 kernel로 key 배열만 읽음
+ * 예전 record leaf(128byte 간격)와 slotted leaf(16byte 간격)는 SIMD 없이
+ * 분기 없는 binary search만 사용
+ */
+int leaf_lower_bound(const leaf_page_t* leaf_page, int64_t key) {
+  int n = leaf_page->num_of_keys;
+  if (leaf_has_key_array(leaf_page)) {
+    return key_search(as_key_array(leaf_page)->keys, n, key);
+  }
+  if (leaf_is_slotted(leaf_page)) {
+    return lower_bound_records(as_slotted(leaf_page)->slots, n, key);
+  }
+  return lower_bound_records(leaf_page->records, n, key);
+}
+
+/**
+ * key가 있는 record index, 없으면 -1
+ */
+int leaf_find_index(const leaf_page_t* leaf_page, int64_t key) {
+  int index = leaf_lower_bound(leaf_page, key);
+  if (index < (int)leaf_page->num_of_keys &&
+      leaf_key(leaf_page, index) == key) {
+    return index;
+  }
+  return -1;
+}
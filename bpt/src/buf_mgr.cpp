@@ -4,36 +4,214 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <algorithm>
 #include <cstring>
+#include <ctime>
 #include <unordered_map>
+#include <vector>
 
 #include "file.h"
 
 buffer_manager_t buf_mgr = {0};  // temp buffer manager
 
-pthread_mutex_t buffer_manager_latch = PTHREAD_MUTEX_INITIALIZER;
+// io_pending, pending_writes 변경을 알리는 용도 (partition latch와 독립)
+pthread_mutex_t buf_io_latch = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t buf_io_cond = PTHREAD_COND_INITIALIZER;
+
+page_cleaner_t page_cleaner = {PTHREAD_MUTEX_INITIALIZER,
+                               PTHREAD_COND_INITIALIZER};
+
+/**
+ * page table partitions-----------------------------------------------
+ */
+
+int init_buf_partitions(int frames_size) {
+  return init_buf_partitions(frames_size, REPLACE_CLOCK);
+}
+
+/**
+ * 프레임 배열을 partition 수만큼 나눠서 각 partition에 배정
+ * 작은 버퍼는 partition당 MIN_FRAMES_PER_PARTITION 이상이 되도록 수를 줄임
+ * page table은 partition의 프레임 수에 맞춰 고정 크기로 할당
+ * If success, return 0. Otherwise, return non-zero value
+ */
+int init_buf_partitions(int frames_size, ReplacementPolicy policy) {
+  int partition_count = frames_size / MIN_FRAMES_PER_PARTITION;
+  if (partition_count < 1) {
+    partition_count = 1;
+  }
+  if (partition_count > BUF_PARTITION_COUNT) {
+    partition_count = BUF_PARTITION_COUNT;
+  }
+  buf_mgr.partition_count = partition_count;
+  buf_mgr.replacer = get_replacement_ops(policy);
+  init_readahead();
+
+  for (int index = 0; index < partition_count; index++) {
+    buf_partition_t* partition = &buf_mgr.partitions[index];
+    pthread_mutex_init(&partition->latch, NULL);
+    partition->frame_begin =
+        (frame_idx_t)((long)frames_size * index / partition_count);
+    partition->frame_end =
+        (frame_idx_t)((long)frames_size * (index + 1) / partition_count);
+    partition->clock_hand = partition->frame_begin;
+    partition->hit_count = 0;
+    partition->miss_count = 0;
+
+    if (page_table_init(&partition->page_table,
+                        partition->frame_end - partition->frame_begin) !=
+        SUCCESS) {
+      buf_mgr.partition_count = index;
+      clear_buf_partitions();
+      return FAILURE;
+    }
+    if (buf_mgr.replacer->init(partition) != SUCCESS) {
+      page_table_destroy(&partition->page_table);
+      buf_mgr.partition_count = index;
+      clear_buf_partitions();
+      return FAILURE;
+    }
+  }
+  return SUCCESS;
+}
+
+void clear_buf_partitions() {
+  for (int index = 0; index < buf_mgr.partition_count; index++) {
+    page_table_destroy(&buf_mgr.partitions[index].page_table);
+    buf_mgr.replacer->destroy(&buf_mgr.partitions[index]);
+  }
+  buf_mgr.partition_count = 0;
+  clear_readahead();
+}
+
+page_key_t make_page_key(tableid_t table_id, pagenum_t page_num) {
+  return ((page_key_t)table_id << 56) | page_num;
+}
+
+/**
+ * (table_id, page_num)이 속한 partition
+ * 인접한 페이지들이 여러 partition에 흩어지도록 곱셈 해시 사용
+ */
+buf_partition_t* get_partition(tableid_t table_id, pagenum_t page_num) {
+  uint64_t hash = hash_page_key(make_page_key(table_id, page_num));
+  return &buf_mgr.partitions[(hash >> 32) % buf_mgr.partition_count];
+}
+
+/**
+ * partition의 page table에 등록, txn 경로에서는 partition latch를 잡고 호출
+ */
+void insert_page_mapping(tableid_t table_id, pagenum_t page_num,
+                         frame_idx_t frame_idx) {
+  page_table_insert(&get_partition(table_id, page_num)->page_table,
+                    make_page_key(table_id, page_num), frame_idx);
+}
+
+void erase_page_mapping(tableid_t table_id, pagenum_t page_num) {
+  page_table_erase(&get_partition(table_id, page_num)->page_table,
+                   make_page_key(table_id, page_num));
+}
 
 /**
  * flush buffer-----------------------------------------------------
  */
 
+/**
+ * table의 dirty 프레임을 디스크에 씀, 인접한 페이지끼리는 한번의 pwritev로
+ * concurrent insert/delete와 같이 불려도 되도록 page cleaner처럼
+ * 아무도 쓰지 않는 프레임만 pin 0 -> 1로 잡고 (try_claim_for_cleaning)
+ * 한번에 MAX_FLUSH_BATCH개까지만 잡아 eviction할 프레임을 남겨둠
+ * 쓰던 중이라 잡지 못한 프레임은 dirty로 남고 다음 flush나 eviction이 씀
+ */
 void flush_table_buffer(int fd, tableid_t table_id) {
-  std::unordered_map<pagenum_t, frame_idx_t>& frame_mapper =
-      buf_mgr.page_table[table_id];
+  // 후보만 페이지 번호 순으로 모음, 잡은 뒤에 다시 확인
+  std::vector<buf_ctl_block_t*> dirty_bcbs;
+  for (int index = 0; index < buf_mgr.frames_size; index++) {
+    buf_ctl_block_t* bcb = &buf_mgr.frames[index];
+    if (bcb->table_id == table_id && bcb->is_dirty) {
+      dirty_bcbs.push_back(bcb);
+    }
+  }
+  std::sort(dirty_bcbs.begin(), dirty_bcbs.end(),
+            [](const buf_ctl_block_t* a, const buf_ctl_block_t* b) {
+              return a->page_num < b->page_num;
+            });
+
+  page_t* staging = NULL;
+  if (!dirty_bcbs.empty() &&
+      posix_memalign((void**)&staging, PAGE_SIZE,
+                     MAX_FLUSH_BATCH * sizeof(page_t)) != 0) {
+    perror("Failed to allocate flush buffer.");
+    exit(EXIT_FAILURE);
+  }
+
+  buf_ctl_block_t* run[MAX_FLUSH_BATCH];
+  int run_count = 0;
+  for (buf_ctl_block_t* bcb : dirty_bcbs) {
+    if (!try_claim_for_cleaning(bcb)) {
+      continue;
+    }
+    // pin을 잡았으니 (table_id, page_num)은 고정됨, 모은 뒤 바뀌었을 수 있음
+    if (bcb->table_id != table_id || !bcb->is_dirty) {
+      unpin_bcb(bcb);
+      continue;
+    }
+    if (run_count > 0 &&
+        (run_count == MAX_FLUSH_BATCH ||
+         bcb->page_num != run[run_count - 1]->page_num + 1)) {
+      flush_frame_run(fd, run, run_count, staging);
+      run_count = 0;
+    }
+    run[run_count++] = bcb;
+  }
+  if (run_count > 0) {
+    flush_frame_run(fd, run, run_count, staging);
+  }
+  free(staging);
 
-  for (auto it = frame_mapper.begin(); it != frame_mapper.end(); it++) {
-    frame_idx_t fidx = it->second;
-    flush_frame(fd, table_id, fidx);
+  // eviction으로 비동기 write 중인 페이지도 끝나야 flush 완료
+  wait_for_table_write_backs(table_id);
+}
+
+/**
+ * helper function for flush_table_buffer
+ * page_num이 연속이고 try_claim_for_cleaning으로 잡은 dirty 프레임들을
+ * staging에 복사해서 한번에 디스크에 쓰고 pin을 놓음
+ * dirty를 먼저 지운 뒤 복사하므로 복사 전에 끝난 수정은 들어가고,
+ * 복사하는 동안 다른 스레드가 pin을 잡았으면 dirty를 되돌려 다시 쓰게 함
+ */
+void flush_frame_run(int fd, buf_ctl_block_t* bcbs[], int count,
+                     page_t* staging) {
+  const page_t* srcs[MAX_FLUSH_BATCH];
+
+  for (int i = 0; i < count; i++) {
+    // cleaner가 쓰던 이전 내용이 나중에 도착해서 덮어쓰지 않도록
+    wait_for_page_write_back(bcbs[i]->table_id, bcbs[i]->page_num);
+    bcbs[i]->is_dirty = false;
+    memcpy(&staging[i], bcbs[i]->frame, PAGE_SIZE);
+    if (bcbs[i]->pin_count.load() != 1) {
+      bcbs[i]->is_dirty = true;
+    }
+    srcs[i] = &staging[i];
+  }
+  file_write_pages(fd, bcbs[0]->page_num, srcs, count);
+
+  for (int i = 0; i < count; i++) {
+    unpin_bcb(bcbs[i]);
   }
 }
 
 void flush_frame(int fd, tableid_t table_id, frame_idx_t frame_idx) {
   buf_ctl_block_t* bcb = &buf_mgr.frames[frame_idx];
 
-  if (bcb->is_dirty && bcb->pin_count == 0) {
-    file_write_page(fd, bcb->page_num, (page_t*)bcb->frame);
-    bcb->is_dirty = false;
+  if (!bcb->is_dirty || !try_claim_for_cleaning(bcb)) {
+    return;
+  }
+  if (bcb->table_id != table_id || !bcb->is_dirty) {
+    unpin_bcb(bcb);
+    return;
   }
+  alignas(PAGE_SIZE) page_t staging;
+  flush_frame_run(fd, &bcb, 1, &staging);
 }
 
 /**
@@ -44,81 +222,197 @@ void flush_frame(int fd, tableid_t table_id, frame_idx_t frame_idx) {
  * helper function for read_buffer
  * @brief Get the page from buffer object
  */
-page_t* get_page_from_buffer(
-    pagenum_t page_num,
-    std::unordered_map<pagenum_t, frame_idx_t>& frame_mapper) {
-  frame_idx_t frame_idx = frame_mapper[page_num];
+page_t* get_page_from_buffer(frame_idx_t frame_idx) {
   buf_ctl_block_t* bcb = &buf_mgr.frames[frame_idx];
 
   pin_frame(frame_idx);
+  wait_for_frame_io(bcb);  // prefetch read still in flight
 
   return (page_t*)bcb->frame;
 }
 
 /**
- * 버퍼에서 페이지를 읽기
+ * helper function for read_buffer, read_buffer_with_txn and make_and_pin_page
+ * 페이지를 pin만 하고 page latch는 잡지 않음
+ * hit은 latch 없이 pin_resident_page로 pin, 실패하거나 miss일 때만
+ * 페이지가 속한 partition의 latch를 잡으므로 여러 스레드가 같이 불러도 됨
+ * with_readahead가 false면 read-ahead를 건너뜀
  */
-page_t* read_buffer(int fd, tableid_t table_id, pagenum_t page_num) {
-  // test
-  static int read_buffer_call_count = 0;
-  read_buffer_call_count++;
+static buf_ctl_block_t* fix_page(int fd, tableid_t table_id,
+                                 pagenum_t page_num, bool with_readahead) {
+  buf_partition_t* partition = get_partition(table_id, page_num);
+  buf_ctl_block_t* bcb = pin_resident_page(table_id, page_num);
+  if (bcb != nullptr) {
+    partition->hit_count.fetch_add(1, std::memory_order_relaxed);
+    if (consume_prefetch_hit(bcb) && with_readahead) {
+      wait_for_frame_io(bcb);
+      readahead_on_access(fd, table_id, page_num,
+                          leaf_right_sibling((page_t*)bcb->frame), true);
+    }
+    wait_for_frame_io(bcb);  // prefetch read still in flight
+    return bcb;
+  }
+
+  frame_idx_t frame_idx = INVALID_FRAME;
+  bool needs_read = false;
+  bool prefetch_hit = false;
 
-  std::unordered_map<pagenum_t, frame_idx_t>& frame_mapper =
-      buf_mgr.page_table[table_id];
+  // 그 사이 clock이 프레임을 가져가는 중이었거나 miss
+  pthread_mutex_lock(&partition->latch);
 
-  // Case: if page exists in buffer
-  if (frame_mapper.count(page_num)) {
-    return get_page_from_buffer(page_num, frame_mapper);
+  frame_idx = page_table_find(&partition->page_table,
+                              make_page_key(table_id, page_num));
+  if (frame_idx != INVALID_FRAME) {
+    // latch를 잡고 있으면 매핑된 프레임은 eviction 중일 수 없음
+    bcb = &buf_mgr.frames[frame_idx];
+    pin_frame(frame_idx);
+    partition->hit_count.fetch_add(1, std::memory_order_relaxed);
+    prefetch_hit = consume_prefetch_hit(bcb);
+  } else {
+    // 프레임만 예약하고 디스크 읽기는 latch 밖에서
+    partition->miss_count.fetch_add(1, std::memory_order_relaxed);
+    frame_idx = reserve_frame_for_read(fd, table_id, page_num, false);
+    bcb = &buf_mgr.frames[frame_idx];
+    needs_read = true;
+  }
+
+  pthread_mutex_unlock(&partition->latch);  // end fix phase
+
+  // read-ahead는 다른 partition의 latch를 하나씩 잡으므로 latch를 놓은 뒤에
+  // leaf의 right sibling은 다른 스레드가 보기 전(io_pending)에 읽어둠
+  if (needs_read) {
+    wait_for_page_write_back(table_id, page_num);
+    file_read_page(fd, page_num, (page_t*)bcb->frame);
+    pagenum_t right_sibling = leaf_right_sibling((page_t*)bcb->frame);
+    finish_frame_io(bcb);
+    if (with_readahead) {
+      readahead_on_access(fd, table_id, page_num, right_sibling, true);
+    }
+  } else if (prefetch_hit && with_readahead) {
+    wait_for_frame_io(bcb);
+    readahead_on_access(fd, table_id, page_num,
+                        leaf_right_sibling((page_t*)bcb->frame), true);
   }
 
-  // Case: not exsits, read page from disk and write buffer
-  frame_idx_t frame_idx = load_page_into_buffer(fd, table_id, page_num);
+  wait_for_frame_io(bcb);  // another thread's read of this page
+  return bcb;
+}
 
-  prefetch(fd, page_num, table_id, frame_idx, frame_mapper);
+/**
+ * 버퍼에서 페이지를 읽기
+ * page latch는 잡지 않음, 내용을 같이 고치는 스레드가 있으면
+ * read_buffer_with_txn으로 latch를 잡아야 함
+ */
+page_t* read_buffer(int fd, tableid_t table_id, pagenum_t page_num) {
+  return (page_t*)fix_page(fd, table_id, page_num, true)->frame;
+}
 
-  return (page_t*)buf_mgr.frames[frame_idx].frame;
+/**
+ * 버퍼에서 페이지를 읽기 with page latch
+ * return hold page latch in mode
+ */
+buf_ctl_block_t* read_buffer_with_txn(int fd, tableid_t table_id,
+                                      pagenum_t page_num, LatchMode mode) {
+  buf_ctl_block_t* bcb = fix_page(fd, table_id, page_num, true);
+  latch_page(bcb, mode);
+  return bcb;
 }
 
 /**
- * 버퍼에서 페이지를 읽기 with buffer manager latch
- * return hold page latch
+ * exclusive page latch로 읽기
  */
 buf_ctl_block_t* read_buffer_with_txn(int fd, tableid_t table_id,
                                       pagenum_t page_num) {
-  buf_ctl_block_t* bcb = nullptr;
-
-  // buffer_manager_latch로 보호하면서 pin_count 증가
-  pthread_mutex_lock(&buffer_manager_latch);
+  return read_buffer_with_txn(fd, table_id, page_num, LATCH_EXCLUSIVE);
+}
 
-  std::unordered_map<pagenum_t, frame_idx_t>& frame_mapper =
-      buf_mgr.page_table[table_id];
+/**
+ * read_buffer_with_txn으로 잡은 page latch와 pin을 놓음
+ * 잡고 있는 동안 free_page_in_buffer로 버퍼에서 지워진 페이지면
+ * pin은 이미 없어졌으므로 latch만 놓음
+ */
+void unlatch_and_unpin(buf_ctl_block_t* bcb, tableid_t table_id,
+                       pagenum_t page_num) {
+  bool resident = bcb->table_id == table_id && bcb->page_num == page_num;
+  unlatch_page(bcb);
+  if (resident) {
+    unpin_bcb(bcb);
+  }
+}
 
-  if (frame_mapper.count(page_num)) {
-    frame_idx_t fidx = frame_mapper[page_num];
-    bcb = &buf_mgr.frames[fidx];
-    bcb->pin_count++;  // eviction 방지
+/**
+ * pin된 프레임의 page latch를 잡음
+ * exclusive면 version을 홀수로 만들어 latch 없이 읽던 쪽이 다시 읽게 함
+ */
+void latch_page(buf_ctl_block_t* bcb, LatchMode mode) {
+  if (mode == LATCH_SHARED) {
+    pthread_rwlock_rdlock(&bcb->page_latch);
   } else {
-    frame_idx_t frame_idx = load_page_into_buffer(fd, table_id, page_num);
-    prefetch_with_txn(
-        fd, page_num, table_id, frame_idx, frame_mapper,
-        (header_page_t*)buf_mgr.frames[frame_mapper[HEADER_PAGE_POS]].frame);
+    pthread_rwlock_wrlock(&bcb->page_latch);
+    bcb->version.fetch_add(1);
+  }
+}
 
-    frame_idx_t fidx = frame_mapper[page_num];
-    bcb = &buf_mgr.frames[fidx];
-    bcb->pin_count++;  // eviction 방지
+/**
+ * latch_page로 잡은 latch를 놓음
+ * version이 홀수면 이 스레드가 exclusive로 잡은 것이므로 짝수로 되돌림
+ * (latch를 잡은 동안 clock이 프레임을 가져가도 2씩 더하므로 홀짝은 유지)
+ */
+void unlatch_page(buf_ctl_block_t* bcb) {
+  if (bcb->version.load(std::memory_order_relaxed) & 1) {
+    bcb->version.fetch_add(1, std::memory_order_release);
   }
+  pthread_rwlock_unlock(&bcb->page_latch);
+}
 
-  pthread_mutex_unlock(&buffer_manager_latch);  // end fix phase
-  pthread_mutex_lock(&bcb->page_latch);         // start latch bcb
+/**
+ * page latch도 pin도 잡지 않고 페이지 읽기를 시작 (optimistic lock coupling)
+ * 공유 메모리에 쓰지 않으므로 root처럼 모두가 지나가는 page에서
+ * cache line이 코어 사이를 오가지 않음
+ * 프레임 내용을 읽은 뒤 validate_page_version이 true일 때만 읽은 값을 믿을 수
+ * 있고, 읽는 중 내용이 바뀌어도 프레임 밖을 읽지 않도록 호출한 쪽이 확인해야 함
+ * 버퍼에 없거나, 읽는 중이거나, exclusive latch가 잡혀있으면 shared latch로
+ * 한번 fix해서 올려두고 그때의 version을 줌
+ * @return 페이지를 담은 bcb, version에 읽기 시작한 version
+ */
+buf_ctl_block_t* read_buffer_optimistic(int fd, tableid_t table_id,
+                                        pagenum_t page_num, uint64_t* version) {
+  buf_partition_t* partition = get_partition(table_id, page_num);
+  frame_idx_t frame_idx = page_table_find_unlatched(
+      &partition->page_table, make_page_key(table_id, page_num));
+  if (frame_idx != INVALID_FRAME) {
+    buf_ctl_block_t* bcb = &buf_mgr.frames[frame_idx];
+    // version을 먼저 읽어야 뒤의 확인이 그 version의 프레임에 대한 것이 됨
+    uint64_t begin = bcb->version.load(std::memory_order_acquire);
+    if ((begin & 1) == 0 && bcb->pin_count.load() != PIN_EVICTING &&
+        !bcb->io_pending && bcb->table_id == table_id &&
+        bcb->page_num == page_num) {
+      note_frame_access(partition, bcb);  // clock은 ref_bit가 서있으면 안 씀
+      *version = begin;
+      return bcb;
+    }
+  }
 
+  buf_ctl_block_t* bcb = read_buffer_with_txn(fd, table_id, page_num,
+                                              LATCH_SHARED);
+  *version = bcb->version.load(std::memory_order_acquire);
+  unlatch_and_unpin(bcb, table_id, page_num);
   return bcb;
 }
 
+/**
+ * read_buffer_optimistic 이후 읽은 프레임 내용이 그 version 그대로인지
+ */
+bool validate_page_version(const buf_ctl_block_t* bcb, uint64_t version) {
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return bcb->version.load(std::memory_order_relaxed) == version;
+}
+
 /**
  * 버퍼에 페이지를 작성한다
  */
 void write_buffer(tableid_t table_id, pagenum_t page_num, page_t* page) {
-  frame_idx_t frame_idx = get_frame_index_by_page(table_id, page_num);
+  frame_idx_t frame_idx = find_pinned_frame(table_id, page_num);
   if (frame_idx == INVALID_FRAME) {
     fprintf(stderr,
             "ERROR: write_buffer called on non-resident page %lu (table %d). ",
@@ -126,7 +420,10 @@ void write_buffer(tableid_t table_id, pagenum_t page_num, page_t* page) {
     return;
   }
   buf_ctl_block_t* bcb = &buf_mgr.frames[frame_idx];
-  memcpy(bcb->frame, page, PAGE_SIZE);
+  // read_buffer로 받은 frame을 그대로 고쳐서 넘기면 복사할 필요가 없음
+  if (page != bcb->frame) {
+    memcpy(bcb->frame, page, PAGE_SIZE);
+  }
   bcb->is_dirty = true;
   bcb->ref_bit = true;
 }
@@ -139,81 +436,130 @@ header_page_t* read_header_page(int fd, tableid_t table_id) {
 }
 
 buf_ctl_block_t* read_header_page_with_txn(int fd, tableid_t table_id) {
+  return read_header_page_with_txn(fd, table_id, LATCH_EXCLUSIVE);
+}
+
+buf_ctl_block_t* read_header_page_with_txn(int fd, tableid_t table_id,
+                                           LatchMode mode) {
   buf_ctl_block_t* header_page_buff =
-      read_buffer_with_txn(fd, table_id, HEADER_PAGE_POS);
+      read_buffer_with_txn(fd, table_id, HEADER_PAGE_POS, mode);
 
   return header_page_buff;
 }
 
 /**
- * PREFETCH_SIZE만큼 더 페이지를 미리 버퍼에 가져오는 함수
+ * helper function for readahead_on_access
+ * pages 중 버퍼에 없는 페이지들을 비동기 read로 한번에 제출
+ * 읽기가 끝날때까지 프레임은 io_pending, 접근하는 쪽은 wait_for_frame_io
+ * with_latch면 페이지마다 그 페이지의 partition latch를 잡음 (중첩하지 않음)
  */
-void prefetch(int fd, pagenum_t page_num, tableid_t table_id,
-              frame_idx_t frame_idx,
-              std::unordered_map<pagenum_t, frame_idx_t>& frame_mapper) {
-  header_page_t* header_page_ptr = read_header_page(fd, table_id);
-  int total_pages = header_page_ptr->num_of_pages;
-  unpin(table_id, HEADER_PAGE_POS);
+void prefetch_pages(int fd, tableid_t table_id, const pagenum_t pages[],
+                    int count, bool with_latch) {
+  aio_req_t* reqs[READAHEAD_MAX_WINDOW];
+  int req_count = 0;
+  // 제출 전까지 프레임을 pin하므로 작은 버퍼에서 partition의 프레임을 모두
+  // 잡지 않도록 한번에 partition 프레임의 절반까지만
+  int max_count = buf_mgr.frames_size / buf_mgr.partition_count / 2;
+  if (count > max_count) {
+    count = max_count;
+  }
 
-  for (int index = 1; index <= PREFETCH_SIZE; index++) {
-    pagenum_t prefetched_page_num = page_num + index;
+  for (int index = 0; index < count && index < READAHEAD_MAX_WINDOW; index++) {
+    pagenum_t prefetched_page_num = pages[index];
 
-    // invalid
-    if (prefetched_page_num >= total_pages) {
-      break;
+    buf_partition_t* partition = get_partition(table_id, prefetched_page_num);
+    if (with_latch) {
+      pthread_mutex_lock(&partition->latch);
     }
 
-    // if already exists in buffer
-    if (frame_mapper.count(prefetched_page_num)) {
+    // already in buffer, or on its way to disk
+    if (page_table_find(&partition->page_table,
+                        make_page_key(table_id, prefetched_page_num)) !=
+            INVALID_FRAME ||
+        is_write_back_pending(table_id, prefetched_page_num)) {
+      if (with_latch) {
+        pthread_mutex_unlock(&partition->latch);
+      }
       continue;
     }
 
     // valid case
+    // 제출 전까지 pin을 잡아 다음 페이지의 프레임 탐색이 이 프레임의
+    // 읽기 완료를 기다리지 않도록 함
     frame_idx_t prefetched_index =
-        find_free_frame_index(fd, table_id, page_num);
+        reserve_frame_for_read(fd, table_id, prefetched_page_num, true);
+    if (with_latch) {
+      pthread_mutex_unlock(&partition->latch);
+    }
+
+    aio_req_t* req = (aio_req_t*)malloc(sizeof(aio_req_t));
+    if (req == NULL) {
+      perror("Failed to allocate prefetch request.");
+      exit(EXIT_FAILURE);
+    }
+    file_aio_prep_read(req, fd, prefetched_page_num,
+                       (page_t*)buf_mgr.frames[prefetched_index].frame,
+                       on_frame_read_complete, &buf_mgr.frames[prefetched_index]);
+    reqs[req_count++] = req;
+  }
+
+  if (req_count == 0) {
+    return;
+  }
+  buf_mgr.prefetch_issued.fetch_add(req_count, std::memory_order_relaxed);
 
-    page_t* frame_ptr = (page_t*)buf_mgr.frames[prefetched_index].frame;
-    file_read_page(fd, prefetched_page_num, frame_ptr);
-    buf_mgr.page_table[table_id].insert(
-        std::make_pair(prefetched_page_num, prefetched_index));
-    set_new_prefetched_bcb(table_id, prefetched_page_num, prefetched_index,
-                           frame_ptr);
+  // 제출한 뒤에 pin을 풀어야 clock이 아직 제출 안 된 읽기를 기다리지 않음
+  // (req는 completion에서 free되므로 먼저 프레임을 기억해둠)
+  buf_ctl_block_t* bcbs[READAHEAD_MAX_WINDOW];
+  for (int i = 0; i < req_count; i++) {
+    bcbs[i] = (buf_ctl_block_t*)reqs[i]->ctx;
+  }
+  file_aio_submit(reqs, req_count);
+
+  for (int i = 0; i < req_count; i++) {
+    unpin_bcb(bcbs[i]);
   }
 }
 
 /**
- * PREFETCH_SIZE만큼 더 페이지를 미리 버퍼에 가져오는 함수
+ * helper function for read_buffer_with_txn and prefetch_pages
+ * 빈 프레임을 골라 page_num에 배정하고 pin 1로 page table에 등록
+ * 내용은 호출한 쪽이 읽어서 채우고 finish_frame_io로 알려야 함
+ * prefetched면 replacement policy에 아직 참조되지 않은 페이지로 알림
  */
-void prefetch_with_txn(int fd, pagenum_t page_num, tableid_t table_id,
-                       frame_idx_t frame_idx,
-                       std::unordered_map<pagenum_t, frame_idx_t>& frame_mapper,
-                       header_page_t* header_page_ptr) {
-  int total_pages = header_page_ptr->num_of_pages;
-
-  for (int index = 1; index <= PREFETCH_SIZE; index++) {
-    pagenum_t prefetched_page_num = page_num + index;
+frame_idx_t reserve_frame_for_read(int fd, tableid_t table_id,
+                                   pagenum_t page_num, bool prefetched) {
+  frame_idx_t frame_idx = find_free_frame_index(fd, table_id, page_num);
+  buf_ctl_block_t* bcb = &buf_mgr.frames[frame_idx];
 
-    // invalid
-    if (prefetched_page_num >= total_pages) {
-      break;
-    }
+  // pin_count를 놓기 전에 io_pending부터, unlatched pinner가 빈 내용을 보지 않게
+  bcb->io_pending = true;
+  assign_frame(table_id, page_num, frame_idx, (page_t*)bcb->frame, 1,
+               prefetched);
+  insert_page_mapping(table_id, page_num, frame_idx);
 
-    // if already exists in buffer
-    if (frame_mapper.count(prefetched_page_num)) {
-      continue;
-    }
+  return frame_idx;
+}
 
-    // valid case
-    frame_idx_t prefetched_index =
-        find_free_frame_index(fd, table_id, prefetched_page_num);
+/**
+ * helper function for set_new_bcb, set_new_prefetched_bcb and
+ * reserve_frame_for_read
+ * 프레임에 새 페이지를 배정하고 replacement policy에 알림
+ * pin_count는 마지막에 release로 써서 eviction 상태를 끝냄
+ */
+void assign_frame(tableid_t table_id, pagenum_t page_num, frame_idx_t frame_idx,
+                  page_t* page_buf, int pin_count, bool prefetched) {
+  buf_ctl_block_t* bcb = &buf_mgr.frames[frame_idx];
 
-    page_t* frame_ptr = (page_t*)buf_mgr.frames[prefetched_index].frame;
-    file_read_page(fd, prefetched_page_num, frame_ptr);
-    buf_mgr.page_table[table_id].insert(
-        std::make_pair(prefetched_page_num, prefetched_index));
-    set_new_prefetched_bcb(table_id, prefetched_page_num, prefetched_index,
-                           frame_ptr);
-  }
+  bcb->frame = page_buf;
+  bcb->table_id = table_id;
+  bcb->page_num = page_num;
+  bcb->is_dirty = false;
+  bcb->ref_bit = true;
+  bcb->prefetch_unused = prefetched;
+  buf_mgr.replacer->on_load(get_partition(table_id, page_num), bcb,
+                            prefetched);
+  bcb->pin_count.store(pin_count, std::memory_order_release);
 }
 
 /**
@@ -221,12 +567,7 @@ void prefetch_with_txn(int fd, pagenum_t page_num, tableid_t table_id,
  */
 void set_new_bcb(tableid_t table_id, pagenum_t page_num, frame_idx_t frame_idx,
                  page_t* page_buf) {
-  buf_mgr.frames[frame_idx].frame = page_buf;
-  buf_mgr.frames[frame_idx].table_id = table_id;
-  buf_mgr.frames[frame_idx].page_num = page_num;
-  buf_mgr.frames[frame_idx].is_dirty = false;
-  buf_mgr.frames[frame_idx].pin_count = 1;
-  buf_mgr.frames[frame_idx].ref_bit = true;
+  assign_frame(table_id, page_num, frame_idx, page_buf, 1, false);
 }
 
 /**
@@ -234,12 +575,7 @@ void set_new_bcb(tableid_t table_id, pagenum_t page_num, frame_idx_t frame_idx,
  */
 void set_new_prefetched_bcb(tableid_t table_id, pagenum_t page_num,
                             frame_idx_t frame_idx, page_t* page_buf) {
-  buf_mgr.frames[frame_idx].frame = page_buf;
-  buf_mgr.frames[frame_idx].table_id = table_id;
-  buf_mgr.frames[frame_idx].page_num = page_num;
-  buf_mgr.frames[frame_idx].is_dirty = false;
-  buf_mgr.frames[frame_idx].pin_count = 0;
-  buf_mgr.frames[frame_idx].ref_bit = true;
+  assign_frame(table_id, page_num, frame_idx, page_buf, 0, true);
 }
 
 /**
@@ -251,9 +587,10 @@ frame_idx_t load_page_into_buffer(int fd, tableid_t table_id,
 
   page_t* frame_ptr = (page_t*)buf_mgr.frames[frame_idx].frame;
   memset(frame_ptr, 0, PAGE_SIZE);
+  wait_for_page_write_back(table_id, page_num);
   file_read_page(fd, page_num, frame_ptr);
 
-  buf_mgr.page_table[table_id].insert(std::make_pair(page_num, frame_idx));
+  insert_page_mapping(table_id, page_num, frame_idx);
 
   set_new_bcb(table_id, page_num, frame_idx, frame_ptr);
 
@@ -264,7 +601,7 @@ frame_idx_t load_page_into_buffer(int fd, tableid_t table_id,
  * @brief Mark the page in the buffer as dirty.
  */
 void mark_dirty(tableid_t table_id, pagenum_t page_num) {
-  frame_idx_t frame_idx = get_frame_index_by_page(table_id, page_num);
+  frame_idx_t frame_idx = find_pinned_frame(table_id, page_num);
   if (frame_idx != INVALID_FRAME) {
     buf_mgr.frames[frame_idx].is_dirty = true;
   } else {
@@ -290,36 +627,65 @@ allocated_page_info_t make_and_pin_page(int fd, tableid_t table_id) {
 
   if (header->free_page_num != PAGE_NULL) {
     // use free page list
+    // free page를 읽어 올린 프레임을 pin한 채로 새 페이지로 씀
+    // (다른 프레임에 다시 올리면 같은 페이지가 두 프레임에 매핑됨)
+    // free page를 차례로 받는 것은 scan이 아니므로 read-ahead 없이 읽음
     page_num = header->free_page_num;
-    free_page_t* free_page = (free_page_t*)read_buffer(fd, table_id, page_num);
+    free_page_t* free_page =
+        (free_page_t*)fix_page(fd, table_id, page_num, false)->frame;
     header->free_page_num = free_page->next_free_page_num;
-    unpin(table_id, page_num);
-  } else {
-    // allocate in order
-    page_num = header->num_of_pages;
-    header->num_of_pages += 1;
+
+    mark_dirty(table_id, HEADER_PAGE_POS);
+    unpin(table_id, HEADER_PAGE_POS);
+    return {(page_t*)free_page, page_num};
   }
 
+  // allocate in order
+  page_num = header->num_of_pages;
+  header->num_of_pages += 1;
+
   mark_dirty(table_id, HEADER_PAGE_POS);
   unpin(table_id, HEADER_PAGE_POS);
 
+  // 다른 스레드의 read와 같은 partition을 고칠 수 있으므로 latch를 잡음
+  buf_partition_t* partition = get_partition(table_id, page_num);
+  pthread_mutex_lock(&partition->latch);
   frame_idx_t frame_idx = find_free_frame_index(fd, table_id, page_num);
   page_t* frame_ptr = (page_t*)buf_mgr.frames[frame_idx].frame;
 
-  buf_mgr.page_table[table_id].insert(std::make_pair(page_num, frame_idx));
+  insert_page_mapping(table_id, page_num, frame_idx);
   set_new_bcb(table_id, page_num, frame_idx, frame_ptr);
+  pthread_mutex_unlock(&partition->latch);
 
   return {frame_ptr, page_num};
 }
 
 frame_idx_t get_frame_index_by_page(tableid_t table_id, pagenum_t page_num) {
-  auto& page_map = buf_mgr.page_table[table_id];
-  auto it = page_map.find(page_num);
+  return page_table_find(&get_partition(table_id, page_num)->page_table,
+                         make_page_key(table_id, page_num));
+}
 
-  if (it == page_map.end()) {
-    return INVALID_FRAME;
+/**
+ * helper function for write_buffer, mark_dirty and unpin
+ * pin된 페이지의 프레임 번호
+ * 다른 스레드가 같은 partition의 page table을 고치는 중이면 unlatched로는
+ * 못 찾을 수 있으므로 그때만 partition latch를 잡고 다시 찾음
+ */
+frame_idx_t find_pinned_frame(tableid_t table_id, pagenum_t page_num) {
+  buf_partition_t* partition = get_partition(table_id, page_num);
+  page_key_t key = make_page_key(table_id, page_num);
+  frame_idx_t frame_idx =
+      page_table_find_unlatched(&partition->page_table, key);
+  if (frame_idx != INVALID_FRAME &&
+      buf_mgr.frames[frame_idx].table_id == table_id &&
+      buf_mgr.frames[frame_idx].page_num == page_num) {
+    return frame_idx;
   }
-  return it->second;
+
+  pthread_mutex_lock(&partition->latch);
+  frame_idx = page_table_find(&partition->page_table, key);
+  pthread_mutex_unlock(&partition->latch);
+  return frame_idx;
 }
 
 /**
@@ -328,13 +694,17 @@ frame_idx_t get_frame_index_by_page(tableid_t table_id, pagenum_t page_num) {
  */
 void clear_frame_and_page_table(tableid_t table_id, pagenum_t page_num,
                                 frame_idx_t frame_idx) {
+  buf_mgr.frames[frame_idx].version.fetch_add(2);  // evict_frame과 같은 이유
+  note_prefetch_dropped(&buf_mgr.frames[frame_idx]);
+  buf_mgr.replacer->on_evict(get_partition(table_id, page_num),
+                             &buf_mgr.frames[frame_idx]);
   buf_mgr.frames[frame_idx].table_id = INVALID_TABLE_ID;
   buf_mgr.frames[frame_idx].page_num = PAGE_NULL;
   buf_mgr.frames[frame_idx].is_dirty = false;
   buf_mgr.frames[frame_idx].pin_count = 0;
   buf_mgr.frames[frame_idx].ref_bit = false;
 
-  buf_mgr.page_table[table_id].erase(page_num);
+  erase_page_mapping(table_id, page_num);
 }
 
 /**
@@ -350,7 +720,8 @@ void free_page_in_buffer(int fd, tableid_t table_id, pagenum_t page_num) {
     exit(EXIT_FAILURE);
   }
 
-  free_page_t new_free_page;
+  // O_DIRECT로 열린 fd에도 쓸 수 있도록 PAGE_SIZE 정렬
+  alignas(PAGE_SIZE) free_page_t new_free_page;
   memset(&new_free_page, 0, PAGE_SIZE);
   new_free_page.next_free_page_num = header->free_page_num;
 
@@ -358,26 +729,37 @@ void free_page_in_buffer(int fd, tableid_t table_id, pagenum_t page_num) {
   mark_dirty(table_id, HEADER_PAGE_POS);
   unpin(table_id, HEADER_PAGE_POS);
 
+  buf_partition_t* partition = get_partition(table_id, page_num);
+  pthread_mutex_lock(&partition->latch);
   frame_idx_t frame_idx = get_frame_index_by_page(table_id, page_num);
 
   if (frame_idx != INVALID_FRAME) {
     clear_frame_and_page_table(table_id, page_num, frame_idx);
   }
+  pthread_mutex_unlock(&partition->latch);
 
-  file_free_page(fd, page_num);
+  // 늦게 끝난 write-back이 free page 내용을 덮어쓰지 않도록
+  wait_for_page_write_back(table_id, page_num);
+  // 다음 free page 번호를 남겨야 free list가 이어짐
+  file_write_page(fd, page_num, (page_t*)&new_free_page);
 }
 
 /**
- * clock alogorithm---------------------------------------------------
+ * eviction---------------------------------------------------------
  */
 
-void update_clock_hand() {
-  buf_mgr.clock_hand = (buf_mgr.clock_hand + 1) % buf_mgr.frames_size;
+void update_clock_hand(buf_partition_t* partition) {
+  partition->clock_hand++;
+  if (partition->clock_hand >= partition->frame_end) {
+    partition->clock_hand = partition->frame_begin;
+  }
 }
 
 /**
- * clock algorithm main function
- * frame배열에서 빈 페이지를 가져온다
+ * eviction main function
+ * (table_id, page_num)이 속한 partition의 frame 구간에서 replacement policy가
+ * 고른 victim을 비워서 가져온다
+ * txn 경로에서는 그 partition의 latch를 잡고 호출
  */
 frame_idx_t find_free_frame_index(int fd, tableid_t table_id,
                                   pagenum_t page_num) {
@@ -400,7 +782,7 @@ frame_idx_t find_free_frame_index(int fd, tableid_t table_id,
         pinned_count++;
         fprintf(stderr,
                 "Frame[%d]: PINNED (pin_count=%d, page_num=%lu, table_id=%d)\n",
-                i, buf_mgr.frames[i].pin_count, buf_mgr.frames[i].page_num,
+                i, buf_mgr.frames[i].pin_count.load(), buf_mgr.frames[i].page_num,
                 buf_mgr.frames[i].table_id);
       }
     }
@@ -409,93 +791,508 @@ frame_idx_t find_free_frame_index(int fd, tableid_t table_id,
     exit(EXIT_FAILURE);
   }
 #endif
-  int iterations = 0;
-  const int MAX_ITERATIONS =
-      buf_mgr.frames_size * 3;  // 일단 최대 3바퀴만 나중에 수정할지도?
+  buf_partition_t* partition = get_partition(table_id, page_num);
+  // cleaner가 돌고 있으면 먼저 clean 프레임만 victim으로
+  victim_scan_t scan = {page_cleaner.running, false, nullptr};
 
   while (true) {
-    frame_idx_t current_frame_idx = buf_mgr.clock_hand;
-    buf_ctl_block_t* bcb = &buf_mgr.frames[buf_mgr.clock_hand];
-    // 헤더 페이지는 eviction 대상이 아님
-    if (bcb->page_num == HEADER_PAGE_POS && bcb->ref_bit) {
-      update_clock_hand();
-      continue;
-    }
-    if (iterations >= MAX_ITERATIONS) {
-      fprintf(stderr,
-              "ERROR: find_free_frame_index - all frames are pinned!\n");
-      fprintf(stderr, "Buffer size: %d, Iterations: %d\n", buf_mgr.frames_size,
-              iterations);
-
-      for (int i = 0; i < buf_mgr.frames_size; i++) {
-        fprintf(
-            stderr,
-            "Frame[%d]: pin_count=%d, ref_bit=%d, table_id=%d, page_num=%lu\n",
-            i, buf_mgr.frames[i].pin_count, buf_mgr.frames[i].ref_bit,
-            buf_mgr.frames[i].table_id, buf_mgr.frames[i].page_num);
-      }
+    scan.skipped_dirty = false;
+    scan.reading_bcb = nullptr;
 
-      exit(EXIT_FAILURE);
+    frame_idx_t victim = buf_mgr.replacer->pick_victim(partition, &scan);
+    if (scan.skipped_dirty) {
+      wake_page_cleaner();
+    }
+    if (victim != INVALID_FRAME) {
+      evict_frame(partition, victim);
+      return victim;
     }
-    iterations++;
 
-    // Case: if used, skip
-    if (bcb->pin_count > 0) {
-      update_clock_hand();
-      continue;
+    if (scan.skip_dirty) {
+      scan.skip_dirty = false;
+    } else if (scan.reading_bcb != nullptr) {
+      // 비동기 read가 끝나면 후보가 생기므로 다시 찾음
+      wait_for_frame_io(scan.reading_bcb);
+    } else {
+      report_no_victim(partition);
     }
+  }
+}
 
-    // Case: if not used and not ref, found target
-    if (!bcb->ref_bit) {
-      tableid_t old_table_id = bcb->table_id;
-      pagenum_t old_page_num = bcb->page_num;
+/**
+ * helper function for find_free_frame_index
+ * claim된 victim의 dirty 내용을 내보내고 page table에서 지움
+ */
+void evict_frame(buf_partition_t* partition, frame_idx_t frame_idx) {
+  buf_ctl_block_t* bcb = &buf_mgr.frames[frame_idx];
+  tableid_t old_table_id = bcb->table_id;
+  pagenum_t old_page_num = bcb->page_num;
+  // 내용이 바뀌기 전에, latch 없이 이 프레임을 읽던 쪽의 검증이 실패하도록
+  bcb->version.fetch_add(2);
 
 #ifdef TEST_ENV
-      printf("EVICTION: frame_idx=%d, old_table_id=%d, old_page_num=%lu\n",
-             current_frame_idx, old_table_id, old_page_num);
+  printf("EVICTION: frame_idx=%d, old_table_id=%d, old_page_num=%lu\n",
+         frame_idx, old_table_id, old_page_num);
 #endif
 
-      // write dirty page if needed
-      if (bcb->is_dirty) {
-        if (old_table_id >= 1 && old_table_id <= MAX_TABLE_COUNT &&
-            table_infos[old_table_id].fd > 0) {
+  // write dirty page if needed
+  if (bcb->is_dirty) {
+    page_cleaner.stalls.fetch_add(1, std::memory_order_relaxed);
+    if (old_table_id >= 1 && old_table_id <= MAX_TABLE_COUNT &&
+        table_infos[old_table_id].fd > 0) {
 #ifdef TEST_ENV
-          printf("  -> Writing dirty page to disk\n");
+      printf("  -> Writing dirty page to disk\n");
 #endif
-          file_write_page(table_infos[old_table_id].fd, old_page_num,
-                          (page_t*)bcb->frame);
-        }
-      }
+      write_back_async(table_infos[old_table_id].fd, old_table_id,
+                       old_page_num, (page_t*)bcb->frame);
+    }
+  }
+
+  note_prefetch_dropped(bcb);
+  buf_mgr.replacer->on_evict(partition, bcb);
 
-      // remove old page_table mapping
-      if (old_table_id >= 1 && old_table_id <= MAX_TABLE_COUNT) {
-        auto& page_map = buf_mgr.page_table[old_table_id];
-        auto it = page_map.find(old_page_num);
+  // remove old page_table mapping
+  // (이 구간의 프레임에 있던 페이지는 항상 같은 partition에 등록됨)
+  if (old_table_id >= 1 && old_table_id <= MAX_TABLE_COUNT) {
+    page_key_t old_key = make_page_key(old_table_id, old_page_num);
+    frame_idx_t mapped_idx = page_table_find(&partition->page_table, old_key);
 
-        if (it != page_map.end() && it->second == current_frame_idx) {
+    if (mapped_idx == frame_idx) {
 #ifdef TEST_ENV
-          printf("  -> Removing page_table[%d][%lu] (frame_idx=%d)\n",
-                 old_table_id, old_page_num, current_frame_idx);
+      printf("  -> Removing page_table[%d][%lu] (frame_idx=%d)\n",
+             old_table_id, old_page_num, frame_idx);
 #endif
-          page_map.erase(it);
-        } else if (it != page_map.end()) {
+      page_table_erase(&partition->page_table, old_key);
+    } else if (mapped_idx != INVALID_FRAME) {
 #ifdef TEST_ENV
-          printf(
-              "  -> WARNING: page_table[%d][%lu] points to frame %d, not %d\n",
-              old_table_id, old_page_num, it->second, current_frame_idx);
+      printf("  -> WARNING: page_table[%d][%lu] points to frame %d, not %d\n",
+             old_table_id, old_page_num, mapped_idx, frame_idx);
 #endif
-        }
-      }
+    }
+  }
+}
+
+/**
+ * helper function for find_free_frame_index
+ * 모든 프레임이 pin되어 victim이 없음, 프레임 상태를 출력하고 종료
+ */
+void report_no_victim(buf_partition_t* partition) {
+  fprintf(stderr, "ERROR: find_free_frame_index - all frames are pinned!\n");
+  fprintf(stderr, "Buffer size: %d, Partition frames: [%d, %d), policy: %s\n",
+          buf_mgr.frames_size, partition->frame_begin, partition->frame_end,
+          buf_mgr.replacer->name);
+
+  for (int i = partition->frame_begin; i < partition->frame_end; i++) {
+    fprintf(stderr,
+            "Frame[%d]: pin_count=%d, ref_bit=%d, io_pending=%d, table_id=%d, "
+            "page_num=%lu\n",
+            i, buf_mgr.frames[i].pin_count.load(),
+            (int)buf_mgr.frames[i].ref_bit.load(),
+            (int)buf_mgr.frames[i].io_pending, buf_mgr.frames[i].table_id,
+            buf_mgr.frames[i].page_num);
+  }
+
+  exit(EXIT_FAILURE);
+}
+
+void get_buffer_stats(buffer_stats_t* stats) {
+  stats->hits = 0;
+  stats->misses = 0;
+  for (int index = 0; index < buf_mgr.partition_count; index++) {
+    stats->hits += buf_mgr.partitions[index].hit_count.load();
+    stats->misses += buf_mgr.partitions[index].miss_count.load();
+  }
+  stats->prefetched = buf_mgr.prefetch_issued.load();
+  stats->prefetch_hits = buf_mgr.prefetch_hits.load();
+  stats->prefetch_wasted = buf_mgr.prefetch_wasted.load();
+}
+
+void reset_buffer_stats() {
+  for (int index = 0; index < buf_mgr.partition_count; index++) {
+    buf_mgr.partitions[index].hit_count = 0;
+    buf_mgr.partitions[index].miss_count = 0;
+  }
+  buf_mgr.prefetch_issued = 0;
+  buf_mgr.prefetch_hits = 0;
+  buf_mgr.prefetch_wasted = 0;
+}
+
+/**
+ * helper function for find_free_frame_index
+ * pin_count 0 -> PIN_EVICTING, 성공하면 프레임은 clock 소유이고
+ * set_new_bcb가 새 pin_count를 쓸때까지 아무도 pin하지 못함
+ */
+bool try_claim_for_eviction(buf_ctl_block_t* bcb) {
+  int expected = 0;
+  return bcb->pin_count.compare_exchange_strong(expected, PIN_EVICTING,
+                                                std::memory_order_acquire,
+                                                std::memory_order_relaxed);
+}
+
+/**
+ * async frame I/O---------------------------------------------------
+ */
+
+/**
+ * 프레임 읽기가 끝났음을 기다리는 스레드들에게 알림
+ */
+void finish_frame_io(buf_ctl_block_t* bcb) {
+  pthread_mutex_lock(&buf_io_latch);
+  bcb->io_pending = false;
+  pthread_cond_broadcast(&buf_io_cond);
+  pthread_mutex_unlock(&buf_io_latch);
+}
+
+/**
+ * 프레임 내용이 디스크에서 다 읽힐때까지 대기, pin을 잡은 상태에서 호출
+ */
+void wait_for_frame_io(buf_ctl_block_t* bcb) {
+  if (!bcb->io_pending) {
+    return;
+  }
+
+  pthread_mutex_lock(&buf_io_latch);
+  while (bcb->io_pending) {
+    pthread_cond_wait(&buf_io_cond, &buf_io_latch);
+  }
+  pthread_mutex_unlock(&buf_io_latch);
+}
+
+/**
+ * prefetch read completion, I/O 스레드에서 호출됨
+ */
+void on_frame_read_complete(aio_req_t* req) {
+  finish_frame_io((buf_ctl_block_t*)req->ctx);
+  free(req);
+}
+
+/**
+ * dirty 프레임을 복사해두고 비동기로 디스크에 씀
+ * 복사 후 프레임은 바로 재사용 가능, 같은 페이지를 다시 읽는 쪽은
+ * wait_for_page_write_back으로 write가 끝나길 기다림
+ */
+void write_back_async(int fd, tableid_t table_id, pagenum_t page_num,
+                      const page_t* frame) {
+  // 같은 페이지의 write가 둘 이상 떠 있으면 완료 순서가 보장되지 않음
+  wait_for_page_write_back(table_id, page_num);
+
+  write_back_t* write_back = stage_write_back(table_id, page_num, frame);
+  file_aio_prep_write(&write_back->req, fd, page_num, &write_back->page,
+                      on_write_back_complete, write_back);
+  aio_req_t* reqs[1] = {&write_back->req};
+  // evict_frame은 partition latch를 잡고 부르므로 slot을 기다리지 않음
+  file_aio_submit_nowait(reqs, 1);
+}
+
+/**
+ * helper function for write_back_async and write_clean_frames
+ * 프레임을 복사하고 pending_writes에 등록, 제출은 호출한 쪽에서
+ * completion이 제출보다 먼저 올 수 있으니 등록부터 해둠
+ */
+write_back_t* stage_write_back(tableid_t table_id, pagenum_t page_num,
+                               const page_t* frame) {
+  write_back_t* write_back = NULL;
+  if (posix_memalign((void**)&write_back, PAGE_SIZE, sizeof(write_back_t)) !=
+      0) {
+    perror("Failed to allocate write back buffer.");
+    exit(EXIT_FAILURE);
+  }
+  write_back->table_id = table_id;
+
+  pthread_mutex_lock(&buf_io_latch);
+  buf_mgr.pending_writes[table_id][page_num]++;
+  pthread_mutex_unlock(&buf_io_latch);
+
+  memcpy(&write_back->page, frame, PAGE_SIZE);
+  return write_back;
+}
+
+/**
+ * pending_writes에서 빼고 기다리는 스레드를 깨운 뒤 free
+ * 완료됐거나 제출하지 않기로 한 write_back에 대해 호출
+ */
+void release_write_back(write_back_t* write_back, pagenum_t page_num) {
+  pthread_mutex_lock(&buf_io_latch);
+  auto& pending = buf_mgr.pending_writes[write_back->table_id];
+  auto it = pending.find(page_num);
+  if (it != pending.end() && --it->second == 0) {
+    pending.erase(it);
+  }
+  pthread_cond_broadcast(&buf_io_cond);
+  pthread_mutex_unlock(&buf_io_latch);
+
+  free(write_back);
+}
+
+/**
+ * eviction, cleaner write completion, I/O 스레드에서 호출됨
+ */
+void on_write_back_complete(aio_req_t* req) {
+  release_write_back((write_back_t*)req->ctx, req->pagenum);
+}
+
+bool is_write_back_pending(tableid_t table_id, pagenum_t page_num) {
+  pthread_mutex_lock(&buf_io_latch);
+  bool pending = buf_mgr.pending_writes[table_id].count(page_num) > 0;
+  pthread_mutex_unlock(&buf_io_latch);
+
+  return pending;
+}
+
+void wait_for_page_write_back(tableid_t table_id, pagenum_t page_num) {
+  pthread_mutex_lock(&buf_io_latch);
+  while (buf_mgr.pending_writes[table_id].count(page_num)) {
+    pthread_cond_wait(&buf_io_cond, &buf_io_latch);
+  }
+  pthread_mutex_unlock(&buf_io_latch);
+}
+
+void wait_for_table_write_backs(tableid_t table_id) {
+  pthread_mutex_lock(&buf_io_latch);
+  while (!buf_mgr.pending_writes[table_id].empty()) {
+    pthread_cond_wait(&buf_io_cond, &buf_io_latch);
+  }
+  pthread_mutex_unlock(&buf_io_latch);
+}
+
+/**
+ * page cleaner---------------------------------------------------
+ */
+
+/**
+ * background cleaner 시작, 이미 돌고 있으면 설정만 바꿈
+ * clean_percent: partition마다 clock hand 앞에 유지할 clean 프레임 비율
+ * If success, return 0. Otherwise, return non-zero value
+ */
+int start_page_cleaner(int clean_percent, int interval_ms) {
+  if (clean_percent <= 0 || clean_percent > 100 || interval_ms <= 0) {
+    return FAILURE;
+  }
+
+  pthread_mutex_lock(&page_cleaner.latch);
+  page_cleaner.clean_percent = clean_percent;
+  page_cleaner.interval_ms = interval_ms;
+  if (page_cleaner.running) {
+    pthread_mutex_unlock(&page_cleaner.latch);
+    return SUCCESS;
+  }
+
+  page_cleaner.running = true;
+  if (pthread_create(&page_cleaner.thread, NULL, page_cleaner_func, NULL) !=
+      0) {
+    page_cleaner.running = false;
+    pthread_mutex_unlock(&page_cleaner.latch);
+    return FAILURE;
+  }
+  pthread_mutex_unlock(&page_cleaner.latch);
+
+  return SUCCESS;
+}
+
+void stop_page_cleaner() {
+  pthread_mutex_lock(&page_cleaner.latch);
+  if (!page_cleaner.running) {
+    pthread_mutex_unlock(&page_cleaner.latch);
+    return;
+  }
+  page_cleaner.running = false;
+  pthread_cond_signal(&page_cleaner.cond);
+  pthread_mutex_unlock(&page_cleaner.latch);
+
+  pthread_join(page_cleaner.thread, NULL);
+}
+
+/**
+ * background page cleaner thread
+ * interval_ms마다, 또는 clock이 dirty 프레임을 건너뛰었을때 깨어나서 한번 청소
+ */
+void* page_cleaner_func(void* arg) {
+  pthread_mutex_lock(&page_cleaner.latch);
+
+  while (page_cleaner.running) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += page_cleaner.interval_ms / 1000;
+    deadline.tv_nsec += (long)(page_cleaner.interval_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec += 1;
+      deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_cond_timedwait(&page_cleaner.cond, &page_cleaner.latch, &deadline);
+    if (!page_cleaner.running) {
+      break;
+    }
+
+    pthread_mutex_unlock(&page_cleaner.latch);
+    clean_buffer_pass();
+    pthread_mutex_lock(&page_cleaner.latch);
+  }
+
+  pthread_mutex_unlock(&page_cleaner.latch);
+  return NULL;
+}
+
+/**
+ * clock이 clean victim을 못 찾고 dirty 프레임을 건너뛸때 호출
+ * partition latch를 잡은 채로 불릴 수 있음 (cleaner는 이 latch를 잡고
+ * partition latch를 기다리지 않음)
+ */
+void wake_page_cleaner() {
+  pthread_mutex_lock(&page_cleaner.latch);
+  pthread_cond_signal(&page_cleaner.cond);
+  pthread_mutex_unlock(&page_cleaner.latch);
+}
+
+/**
+ * 모든 partition을 한번씩 청소
+ * close_table/db_sync가 fd를 쓰는 중이면 이번 pass는 건너뜀
+ */
+void clean_buffer_pass() {
+  if (pthread_mutex_trylock(&table_sync_latch) != 0) {
+    return;
+  }
+
+  int clean_percent = page_cleaner.clean_percent;
+  for (int index = 0; index < buf_mgr.partition_count; index++) {
+    clean_partition(&buf_mgr.partitions[index], clean_percent);
+  }
+
+  pthread_mutex_unlock(&table_sync_latch);
+}
+
+/**
+ * helper function for clean_buffer_pass
+ * clock hand부터 앞으로 훑으면서 clean + 청소할 프레임이 목표 수가 될때까지
+ * dirty이고 unpin된 프레임을 모아 페이지 번호 순으로 씀
+ * @return number of pages written
+ */
+int clean_partition(buf_partition_t* partition, int clean_percent) {
+  int slice_size = partition->frame_end - partition->frame_begin;
+  int target = slice_size * clean_percent / 100;
+  if (target < 1) {
+    target = 1;
+  }
+
+  pthread_mutex_lock(&partition->latch);
+  frame_idx_t hand = partition->clock_hand;
+  pthread_mutex_unlock(&partition->latch);
+
+  buf_ctl_block_t* claimed[MAX_FLUSH_BATCH];
+  int claimed_count = 0;
+  int clean_count = 0;
+
+  for (int step = 0; step < slice_size && clean_count + claimed_count < target &&
+                     claimed_count < MAX_FLUSH_BATCH;
+       step++) {
+    frame_idx_t frame_idx =
+        partition->frame_begin +
+        (hand - partition->frame_begin + step) % slice_size;
+    buf_ctl_block_t* bcb = &buf_mgr.frames[frame_idx];
+
+    if (bcb->pin_count.load(std::memory_order_relaxed) != 0 ||
+        bcb->io_pending) {
+      continue;
+    }
+    if (!bcb->is_dirty) {
+      clean_count++;
+      continue;
+    }
+    if (!try_claim_for_cleaning(bcb)) {
+      continue;
+    }
+
+    // pin을 잡았으니 (table_id, page_num)은 고정됨
+    tableid_t table_id = bcb->table_id;
+    if (!bcb->is_dirty || table_id < 1 || table_id > MAX_TABLE_COUNT ||
+        table_infos[table_id].fd <= 0 ||
+        is_write_back_pending(table_id, bcb->page_num)) {
+      unpin_bcb(bcb);
+      continue;
+    }
+    claimed[claimed_count++] = bcb;
+  }
+
+  if (claimed_count == 0) {
+    return 0;
+  }
+
+  std::sort(claimed, claimed + claimed_count,
+            [](const buf_ctl_block_t* a, const buf_ctl_block_t* b) {
+              if (a->table_id != b->table_id) {
+                return a->table_id < b->table_id;
+              }
+              return a->page_num < b->page_num;
+            });
+  write_clean_frames(claimed, claimed_count);
+
+  return claimed_count;
+}
+
+/**
+ * helper function for clean_partition
+ * pin을 잡은 dirty 프레임들을 복사해서 한번에 비동기로 제출
+ * dirty를 먼저 지운 뒤 다른 스레드가 pin을 잡았는지 복사 전후로 확인
+ * 수정하려는 쪽은 항상 pin을 먼저 잡으므로 복사 전 확인 이후에 pin한 쪽의
+ * mark_dirty는 지워지지 않고, 복사 후 확인으로 덜 쓴 내용을 내보내지 않음
+ */
+void write_clean_frames(buf_ctl_block_t* bcbs[], int count) {
+  aio_req_t* reqs[MAX_FLUSH_BATCH];
+  int req_count = 0;
+
+  for (int i = 0; i < count; i++) {
+    buf_ctl_block_t* bcb = bcbs[i];
+
+    bcb->is_dirty = false;
+    if (bcb->pin_count.load() != 1) {
+      bcb->is_dirty = true;
+      continue;
+    }
+    write_back_t* write_back =
+        stage_write_back(bcb->table_id, bcb->page_num, (page_t*)bcb->frame);
 
-      frame_idx_t target_idx = current_frame_idx;
-      update_clock_hand();
-      return target_idx;
+    if (bcb->pin_count.load() != 1) {
+      bcb->is_dirty = true;
+      release_write_back(write_back, bcb->page_num);
+      continue;
     }
 
-    // Case: give chance
-    bcb->ref_bit = false;
-    update_clock_hand();
+    file_aio_prep_write(&write_back->req, table_infos[bcb->table_id].fd,
+                        bcb->page_num, &write_back->page,
+                        on_write_back_complete, write_back);
+    reqs[req_count++] = &write_back->req;
+  }
+
+  if (req_count > 0) {
+    file_aio_submit(reqs, req_count);
+    page_cleaner.pages_written.fetch_add(req_count, std::memory_order_relaxed);
   }
+
+  for (int i = 0; i < count; i++) {
+    unpin_bcb(bcbs[i]);
+  }
+}
+
+/**
+ * helper function for clean_partition
+ * 아무도 쓰고 있지 않은 프레임만 pin_count 0 -> 1
+ * clock의 eviction CAS와 배타적이고 ref_bit는 건드리지 않음
+ */
+bool try_claim_for_cleaning(buf_ctl_block_t* bcb) {
+  int expected = 0;
+  return bcb->pin_count.compare_exchange_strong(expected, 1,
+                                                std::memory_order_acquire,
+                                                std::memory_order_relaxed);
+}
+
+void get_page_cleaner_stats(page_cleaner_stats_t* stats) {
+  stats->pages_written = page_cleaner.pages_written.load();
+  stats->stalls = page_cleaner.stalls.load();
+}
+
+void reset_page_cleaner_stats() {
+  page_cleaner.pages_written = 0;
+  page_cleaner.stalls = 0;
 }
 
 /**
@@ -503,43 +1300,90 @@ frame_idx_t find_free_frame_index(int fd, tableid_t table_id,
  */
 
 void pin(tableid_t table_id, pagenum_t page_num) {
-  auto it = buf_mgr.page_table[table_id].find(page_num);
+  frame_idx_t frame_idx = get_frame_index_by_page(table_id, page_num);
 
-  if (it != buf_mgr.page_table[table_id].end()) {
-    frame_idx_t frame_idx = it->second;
+  if (frame_idx != INVALID_FRAME) {
     pin_frame(frame_idx);
   }
 }
 
+/**
+ * 매핑이 살아있는 프레임을 pin (partition latch를 잡았거나 단일 스레드 경로)
+ */
 void pin_frame(frame_idx_t frame_idx) {
   buf_ctl_block_t* bcb = &buf_mgr.frames[frame_idx];
 
-  bcb->pin_count += 1;
-  bcb->ref_bit = true;
+  bcb->pin_count.fetch_add(1, std::memory_order_acquire);
+  note_frame_access(get_partition(bcb->table_id, bcb->page_num), bcb);
+}
+
+/**
+ * eviction 중(PIN_EVICTING)이 아니면 pin_count를 올림
+ * @return true if pinned
+ */
+bool try_pin_bcb(buf_ctl_block_t* bcb) {
+  int pin_count = bcb->pin_count.load(std::memory_order_relaxed);
+
+  while (pin_count >= 0) {
+    if (bcb->pin_count.compare_exchange_weak(pin_count, pin_count + 1,
+                                             std::memory_order_acquire,
+                                             std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * buffer hit을 latch 없이 pin
+ * page table을 unlatched로 찾고 pin을 잡은 뒤 프레임이 아직 그 페이지인지 확인
+ * (pin을 잡은 동안에는 clock이 프레임을 가져갈 수 없으므로 확인 결과가 유지됨)
+ * @return pinned bcb, nullptr이면 partition latch를 잡고 다시 찾아야 함
+ */
+buf_ctl_block_t* pin_resident_page(tableid_t table_id, pagenum_t page_num) {
+  buf_partition_t* partition = get_partition(table_id, page_num);
+  frame_idx_t frame_idx = page_table_find_unlatched(
+      &partition->page_table, make_page_key(table_id, page_num));
+  if (frame_idx == INVALID_FRAME) {
+    return nullptr;
+  }
+
+  buf_ctl_block_t* bcb = &buf_mgr.frames[frame_idx];
+  if (!try_pin_bcb(bcb)) {
+    return nullptr;
+  }
+  if (bcb->table_id != table_id || bcb->page_num != page_num) {
+    unpin_bcb(bcb);
+    return nullptr;
+  }
+
+  note_frame_access(partition, bcb);
+  return bcb;
 }
 
 /**
  * unpin
  */
 void unpin(tableid_t table_id, pagenum_t page_num) {
-  auto it = buf_mgr.page_table[table_id].find(page_num);
+  frame_idx_t frame_idx = find_pinned_frame(table_id, page_num);
 
-  if (it != buf_mgr.page_table[table_id].end()) {
-    frame_idx_t frame_idx = it->second;
-    buf_ctl_block_t* bcb = &buf_mgr.frames[frame_idx];
-
-    int next_pin_count = bcb->pin_count - 1;
-    if (next_pin_count < 0) {
-      next_pin_count = 0;
-    }
-    bcb->pin_count = next_pin_count;
+  if (frame_idx != INVALID_FRAME) {
+    unpin_bcb(&buf_mgr.frames[frame_idx]);
   }
 }
 
+/**
+ * pin_count를 하나 내림, 0 아래로는 내려가지 않음
+ * release로 내려서 프레임에 쓴 내용이 다음 evictor에게 보이도록 함
+ */
 void unpin_bcb(buf_ctl_block_t* bcb) {
-  int next_pin_count = bcb->pin_count - 1;
-  if (next_pin_count < 0) {
-    next_pin_count = 0;
+  int pin_count = bcb->pin_count.load(std::memory_order_relaxed);
+
+  while (pin_count > 0) {
+    if (bcb->pin_count.compare_exchange_weak(pin_count, pin_count - 1,
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+      return;
+    }
   }
-  bcb->pin_count = next_pin_count;
 }
@@ -0,0 +1,207 @@
+#include "buf_mgr.h"
+
+/**
+ * state------------------------------------------------------------
+ */
+
+void init_readahead() {
+  for (int table_id = 0; table_id <= MAX_TABLE_COUNT; table_id++) {
+    readahead_t* ra = &buf_mgr.readahead[table_id];
+    pthread_mutex_init(&ra->latch, NULL);
+    ra->last_page = PAGE_NULL;
+    ra->next_sibling = PAGE_NULL;
+    ra->run_length = 0;
+    ra->window = 0;
+    ra->ahead_end = PAGE_NULL;
+  }
+  buf_mgr.prefetch_issued = 0;
+  buf_mgr.prefetch_hits = 0;
+  buf_mgr.prefetch_wasted = 0;
+}
+
+void clear_readahead() {
+  for (int table_id = 0; table_id <= MAX_TABLE_COUNT; table_id++) {
+    pthread_mutex_destroy(&buf_mgr.readahead[table_id].latch);
+  }
+}
+
+/**
+ * leaf이면 right sibling, 아니면 PAGE_NULL
+ */
+pagenum_t leaf_right_sibling(const page_t* page) {
+  const leaf_page_t* leaf = (const leaf_page_t*)page;
+  if (leaf->is_leaf != 1) {
+    return PAGE_NULL;
+  }
+  return leaf->right_sibling_page_num;
+}
+
+/**
+ * 버퍼에 있는 header page의 num_of_pages
+ * header가 없거나 아직 읽는 중이면 PAGE_NULL
+ */
+pagenum_t get_table_page_count(tableid_t table_id) {
+  pagenum_t total_pages = PAGE_NULL;
+  buf_partition_t* header_partition = get_partition(table_id, HEADER_PAGE_POS);
+
+  pthread_mutex_lock(&header_partition->latch);
+  frame_idx_t header_idx =
+      page_table_find(&header_partition->page_table,
+                      make_page_key(table_id, HEADER_PAGE_POS));
+  if (header_idx != INVALID_FRAME && !buf_mgr.frames[header_idx].io_pending) {
+    total_pages =
+        ((header_page_t*)buf_mgr.frames[header_idx].frame)->num_of_pages;
+  }
+  pthread_mutex_unlock(&header_partition->latch);
+
+  return total_pages;
+}
+
+/**
+ * read-ahead로 올라온 프레임의 첫 demand 접근이면 true
+ */
+bool consume_prefetch_hit(buf_ctl_block_t* bcb) {
+  if (!bcb->prefetch_unused.load(std::memory_order_relaxed) ||
+      !bcb->prefetch_unused.exchange(false)) {
+    return false;
+  }
+  buf_mgr.prefetch_hits.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+/**
+ * 프레임이 비워질 때 호출, 한번도 쓰이지 않은 read-ahead 페이지는 낭비로 셈
+ */
+void note_prefetch_dropped(buf_ctl_block_t* bcb) {
+  if (bcb->prefetch_unused.load(std::memory_order_relaxed) &&
+      bcb->prefetch_unused.exchange(false)) {
+    buf_mgr.prefetch_wasted.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * read-ahead-------------------------------------------------------
+ */
+
+static void grow_window(readahead_t* ra) {
+  if (ra->window == 0) {
+    ra->window = READAHEAD_INIT_WINDOW;
+  } else if (ra->window < READAHEAD_MAX_WINDOW) {
+    ra->window = ra->window * 2 > READAHEAD_MAX_WINDOW ? READAHEAD_MAX_WINDOW
+                                                       : ra->window * 2;
+  }
+}
+
+/**
+ * helper function for readahead_leaf_chain
+ * 버퍼에 있고 다 읽힌 페이지의 right sibling, replacement policy에는
+ * 접근으로 알리지 않음
+ * @return 버퍼에 없으면 false
+ */
+static bool peek_resident_sibling(tableid_t table_id, pagenum_t page_num,
+                                  pagenum_t* right_sibling) {
+  buf_partition_t* partition = get_partition(table_id, page_num);
+  frame_idx_t frame_idx = page_table_find_unlatched(
+      &partition->page_table, make_page_key(table_id, page_num));
+  if (frame_idx == INVALID_FRAME) {
+    return false;
+  }
+
+  buf_ctl_block_t* bcb = &buf_mgr.frames[frame_idx];
+  if (!try_pin_bcb(bcb)) {
+    return false;
+  }
+  if (bcb->table_id != table_id || bcb->page_num != page_num) {
+    unpin_bcb(bcb);
+    return false;
+  }
+  // 아직 읽는 중이면 다음 leaf를 알 수 없고, 아직 안 쓰인 read-ahead
+  // 페이지면 그 앞은 이미 읽어두는 중이므로 여기서 멈춤
+  *right_sibling = bcb->io_pending || bcb->prefetch_unused
+                       ? PAGE_NULL
+                       : leaf_right_sibling((page_t*)bcb->frame);
+  unpin_bcb(bcb);
+  return true;
+}
+
+/**
+ * helper function for readahead_on_access
+ * leaf chain은 페이지를 읽어야 다음 번호를 알 수 있으므로 이미 올라온
+ * leaf들을 depth만큼 따라가서 처음 만나는 버퍼에 없는 leaf를 읽어둠
+ */
+static void readahead_leaf_chain(int fd, tableid_t table_id,
+                                 pagenum_t sibling, int depth,
+                                 bool with_latch) {
+  pagenum_t page_num = sibling;
+  for (int step = 0; step < depth && page_num != PAGE_NULL; step++) {
+    pagenum_t next = PAGE_NULL;
+    if (!peek_resident_sibling(table_id, page_num, &next)) {
+      prefetch_pages(fd, table_id, &page_num, 1, with_latch);
+      return;
+    }
+    page_num = next;
+  }
+}
+
+/**
+ * demand miss나 read-ahead 페이지의 첫 사용마다 호출
+ * stream이 이어지면 window를 두배씩 키우고 (READAHEAD_MAX_WINDOW까지)
+ * 앞서 읽어둔 페이지가 window의 절반 이하로 남았을 때 다음 구간을 읽음
+ * stream이 끊기면 window를 0으로 돌려서 랜덤 접근에서는 읽지 않음
+ * right_sibling은 page_num이 leaf일때 그 다음 leaf
+ */
+void readahead_on_access(int fd, tableid_t table_id, pagenum_t page_num,
+                         pagenum_t right_sibling, bool with_latch) {
+  if (page_num == HEADER_PAGE_POS || table_id < 1 ||
+      table_id > MAX_TABLE_COUNT) {
+    return;
+  }
+  readahead_t* ra = &buf_mgr.readahead[table_id];
+  pagenum_t pages[READAHEAD_MAX_WINDOW];
+  int count = 0;
+  int chain_depth = 0;
+
+  pthread_mutex_lock(&ra->latch);
+  bool next_page = ra->last_page != PAGE_NULL && page_num == ra->last_page + 1;
+  bool next_leaf =
+      ra->next_sibling != PAGE_NULL && page_num == ra->next_sibling;
+  if (next_page || next_leaf) {
+    ra->run_length++;
+  } else {
+    ra->run_length = 0;
+    ra->window = 0;
+    ra->ahead_end = PAGE_NULL;
+  }
+  ra->last_page = page_num;
+  ra->next_sibling = right_sibling;
+
+  if (ra->run_length >= READAHEAD_MIN_RUN) {
+    if (next_page) {
+      if (ra->ahead_end <= page_num) {
+        ra->ahead_end = page_num + 1;
+      }
+      if (ra->ahead_end - page_num - 1 <= (pagenum_t)ra->window / 2) {
+        grow_window(ra);
+        pagenum_t end = page_num + 1 + ra->window;
+        for (pagenum_t p = ra->ahead_end; p < end; p++) {
+          pages[count++] = p;
+        }
+        ra->ahead_end = end;
+      }
+    } else {
+      grow_window(ra);
+      chain_depth = ra->window;
+    }
+  }
+  pthread_mutex_unlock(&ra->latch);
+
+  if (count > 0) {
+    pagenum_t total_pages = get_table_page_count(table_id);
+    while (count > 0 && pages[count - 1] >= total_pages) {
+      count--;
+    }
+    prefetch_pages(fd, table_id, pages, count, with_latch);
+  } else if (chain_depth > 0) {
+    readahead_leaf_chain(fd, table_id, right_sibling, chain_depth, with_latch);
+  }
+}
@@ -0,0 +1,419 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "buf_mgr.h"
+
+/**
+ * common-----------------------------------------------------------
+ */
+
+/**
+ * victim으로 claim을 시도해도 되는 프레임인지, claim은 하지 않음
+ * 헤더 페이지, pin된 프레임, 읽는 중인 프레임, (scan이 원하면) dirty 프레임 제외
+ */
+bool is_victim_candidate(buf_ctl_block_t* bcb, victim_scan_t* scan) {
+  // 헤더 페이지는 eviction 대상이 아님
+  if (bcb->page_num == HEADER_PAGE_POS && bcb->ref_bit) {
+    return false;
+  }
+  if (bcb->pin_count.load(std::memory_order_relaxed) != 0) {
+    return false;
+  }
+  if (bcb->io_pending) {
+    scan->reading_bcb = bcb;
+    return false;
+  }
+  if (scan->skip_dirty && bcb->is_dirty) {
+    scan->skipped_dirty = true;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * buffer hit을 정책에 알림, latch 없이 불릴 수 있음
+ */
+void note_frame_access(buf_partition_t* partition, buf_ctl_block_t* bcb) {
+  buf_mgr.replacer->on_access(partition, bcb);
+}
+
+/**
+ * helper function for on_access hooks
+ * 이미 세워져 있으면 쓰지 않아서 hit마다 cache line을 더럽히지 않음
+ */
+static inline void set_ref_bit(buf_ctl_block_t* bcb) {
+  if (!bcb->ref_bit.load(std::memory_order_relaxed)) {
+    bcb->ref_bit.store(true, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * clock--------------------------------------------------------------
+ */
+
+static int clock_init(buf_partition_t* partition) { return SUCCESS; }
+
+static void clock_destroy(buf_partition_t* partition) {}
+
+static void clock_on_load(buf_partition_t* partition, buf_ctl_block_t* bcb,
+                          bool prefetched) {
+  bcb->ref_bit.store(true, std::memory_order_relaxed);
+}
+
+static void clock_on_access(buf_partition_t* partition, buf_ctl_block_t* bcb) {
+  set_ref_bit(bcb);
+}
+
+static void clock_on_evict(buf_partition_t* partition, buf_ctl_block_t* bcb) {}
+
+/**
+ * second chance clock, 최대 두 바퀴
+ * skip_a1in이면 2Q의 A1in 프레임은 건너뛰고 나머지(Am, 빈 프레임)만 봄
+ */
+frame_idx_t clock_pick_victim(buf_partition_t* partition, victim_scan_t* scan,
+                              bool skip_a1in) {
+  int slice_size = partition->frame_end - partition->frame_begin;
+
+  for (int step = 0; step < slice_size * 2; step++) {
+    frame_idx_t frame_idx = partition->clock_hand;
+    buf_ctl_block_t* bcb = &buf_mgr.frames[frame_idx];
+    update_clock_hand(partition);
+
+    if (skip_a1in && bcb->repl_queue == REPL_QUEUE_A1IN) {
+      continue;
+    }
+    if (!is_victim_candidate(bcb, scan)) {
+      continue;
+    }
+
+    // Case: give chance
+    if (bcb->ref_bit.load(std::memory_order_relaxed)) {
+      bcb->ref_bit.store(false, std::memory_order_relaxed);
+      continue;
+    }
+
+    // unlatched pinner와 경합할 수 있으므로 CAS에 성공한 프레임만 evict
+    if (try_claim_for_eviction(bcb)) {
+      return frame_idx;
+    }
+  }
+  return INVALID_FRAME;
+}
+
+static frame_idx_t clock_victim(buf_partition_t* partition,
+                                victim_scan_t* scan) {
+  return clock_pick_victim(partition, scan, false);
+}
+
+static const replacement_ops_t clock_ops = {
+    "clock",        clock_init,      clock_destroy, clock_on_load,
+    clock_on_access, clock_on_evict, clock_victim};
+
+/**
+ * 2Q----------------------------------------------------------------
+ * A1in: 처음 읽힌 페이지의 FIFO, A1out: A1in에서 쫓겨난 페이지 key (ghost)
+ * Am: A1out에 있던 페이지가 다시 읽히면 들어가는 main queue
+ * Am의 LRU는 hit에 latch를 잡지 않도록 clock으로 근사
+ */
+
+static int two_q_init(buf_partition_t* partition) {
+  int slice_size = partition->frame_end - partition->frame_begin;
+  int a1out_capacity = slice_size * TWO_Q_A1OUT_PERCENT / 100;
+  if (a1out_capacity < 1) {
+    a1out_capacity = 1;
+  }
+
+  partition->load_seq = 0;
+  partition->a1in_capacity = slice_size * 2;
+  partition->a1in_head = 0;
+  partition->a1in_len = 0;
+  partition->a1in_size = 0;
+  partition->a1in =
+      (a1in_entry_t*)malloc(partition->a1in_capacity * sizeof(a1in_entry_t));
+
+  partition->a1out_capacity = a1out_capacity;
+  partition->a1out_head = 0;
+  partition->a1out_len = 0;
+  partition->a1out = (page_key_t*)malloc(a1out_capacity * sizeof(page_key_t));
+
+  if (partition->a1in == NULL || partition->a1out == NULL ||
+      page_table_init(&partition->a1out_table, a1out_capacity) != SUCCESS) {
+    free(partition->a1in);
+    free(partition->a1out);
+    partition->a1in = NULL;
+    partition->a1out = NULL;
+    return FAILURE;
+  }
+  return SUCCESS;
+}
+
+static void two_q_destroy(buf_partition_t* partition) {
+  free(partition->a1in);
+  free(partition->a1out);
+  partition->a1in = NULL;
+  partition->a1out = NULL;
+  page_table_destroy(&partition->a1out_table);
+}
+
+/**
+ * helper function for two_q
+ * ring의 entry가 아직 A1in에 있는 그 프레임을 가리키는지
+ */
+static inline bool a1in_entry_valid(const a1in_entry_t* entry) {
+  buf_ctl_block_t* bcb = &buf_mgr.frames[entry->frame_idx];
+  return bcb->repl_queue == REPL_QUEUE_A1IN &&
+         bcb->load_seq == entry->load_seq;
+}
+
+/**
+ * helper function for two_q_on_load
+ * ring이 꽉 차면 stale entry를 버리고 앞으로 모음
+ * (유효한 entry는 프레임 수 이하이므로 capacity의 절반 이하만 남음)
+ */
+static void a1in_compact(buf_partition_t* partition) {
+  std::vector<a1in_entry_t> kept;
+  for (int i = 0; i < partition->a1in_len; i++) {
+    const a1in_entry_t* entry =
+        &partition->a1in[(partition->a1in_head + i) % partition->a1in_capacity];
+    if (a1in_entry_valid(entry)) {
+      kept.push_back(*entry);
+    }
+  }
+  std::copy(kept.begin(), kept.end(), partition->a1in);
+  partition->a1in_head = 0;
+  partition->a1in_len = (int)kept.size();
+}
+
+/**
+ * helper function for two_q_on_evict
+ * A1in에서 나간 페이지 key를 ghost에 기록, 가득 차면 가장 오래된 key를 버림
+ */
+static void a1out_push(buf_partition_t* partition, page_key_t key) {
+  if (partition->a1out_len == partition->a1out_capacity) {
+    int oldest = partition->a1out_head;
+    page_key_t old_key = partition->a1out[oldest];
+    // 같은 key가 다시 들어왔으면 table은 더 최근 위치를 가리킴
+    if (page_table_find(&partition->a1out_table, old_key) == oldest) {
+      page_table_erase(&partition->a1out_table, old_key);
+    }
+    partition->a1out_head = (oldest + 1) % partition->a1out_capacity;
+    partition->a1out_len--;
+  }
+
+  int tail = (partition->a1out_head + partition->a1out_len) %
+             partition->a1out_capacity;
+  partition->a1out[tail] = key;
+  partition->a1out_len++;
+  page_table_insert(&partition->a1out_table, key, tail);
+}
+
+static void two_q_on_load(buf_partition_t* partition, buf_ctl_block_t* bcb,
+                          bool prefetched) {
+  page_key_t key = make_page_key(bcb->table_id, bcb->page_num);
+
+  // 헤더 페이지는 clock과 같이 ref_bit로 eviction에서 빠지도록 Am에 둠
+  if (bcb->page_num == HEADER_PAGE_POS) {
+    bcb->repl_queue = REPL_QUEUE_AM;
+    bcb->ref_bit.store(true, std::memory_order_relaxed);
+    return;
+  }
+
+  // ghost에 있으면 최근에 A1in을 거쳐간 페이지, 다시 읽혔으니 hot
+  if (page_table_erase(&partition->a1out_table, key)) {
+    bcb->repl_queue = REPL_QUEUE_AM;
+    bcb->ref_bit.store(true, std::memory_order_relaxed);
+    return;
+  }
+
+  if (partition->a1in_len == partition->a1in_capacity) {
+    a1in_compact(partition);
+  }
+  bcb->repl_queue = REPL_QUEUE_A1IN;
+  bcb->load_seq = ++partition->load_seq;
+  bcb->ref_bit.store(false, std::memory_order_relaxed);
+
+  int tail = (partition->a1in_head + partition->a1in_len) %
+             partition->a1in_capacity;
+  partition->a1in[tail].frame_idx = (frame_idx_t)(bcb - buf_mgr.frames);
+  partition->a1in[tail].load_seq = bcb->load_seq;
+  partition->a1in_len++;
+  partition->a1in_size++;
+}
+
+/**
+ * A1in 페이지의 hit은 순서를 바꾸지 않음 (FIFO), Am은 clock의 ref_bit
+ */
+static void two_q_on_access(buf_partition_t* partition, buf_ctl_block_t* bcb) {
+  if (bcb->repl_queue == REPL_QUEUE_AM) {
+    set_ref_bit(bcb);
+  }
+}
+
+static void two_q_on_evict(buf_partition_t* partition, buf_ctl_block_t* bcb) {
+  if (bcb->repl_queue == REPL_QUEUE_A1IN) {
+    partition->a1in_size--;
+    if (bcb->table_id >= 1 && bcb->table_id <= MAX_TABLE_COUNT) {
+      a1out_push(partition, make_page_key(bcb->table_id, bcb->page_num));
+    }
+  }
+  bcb->repl_queue = REPL_QUEUE_NONE;
+}
+
+/**
+ * helper function for two_q_victim
+ * A1in을 오래된 순서로 보면서 처음으로 claim되는 프레임
+ * 맨 앞의 stale entry는 버리고, 중간의 stale entry는 앞으로 올때 버림
+ */
+static frame_idx_t a1in_pick_victim(buf_partition_t* partition,
+                                    victim_scan_t* scan) {
+  while (partition->a1in_len > 0 &&
+         !a1in_entry_valid(&partition->a1in[partition->a1in_head])) {
+    partition->a1in_head = (partition->a1in_head + 1) % partition->a1in_capacity;
+    partition->a1in_len--;
+  }
+
+  for (int i = 0; i < partition->a1in_len; i++) {
+    const a1in_entry_t* entry =
+        &partition->a1in[(partition->a1in_head + i) % partition->a1in_capacity];
+    if (!a1in_entry_valid(entry)) {
+      continue;
+    }
+    buf_ctl_block_t* bcb = &buf_mgr.frames[entry->frame_idx];
+    if (is_victim_candidate(bcb, scan) && try_claim_for_eviction(bcb)) {
+      return entry->frame_idx;
+    }
+  }
+  return INVALID_FRAME;
+}
+
+/**
+ * A1in이 자기 몫보다 크면 A1in에서, 아니면 Am(clock)에서
+ * 한쪽에서 못 찾으면 다른 쪽에서
+ */
+static frame_idx_t two_q_victim(buf_partition_t* partition,
+                                victim_scan_t* scan) {
+  int slice_size = partition->frame_end - partition->frame_begin;
+  int a1in_target = slice_size * TWO_Q_A1IN_PERCENT / 100;
+  frame_idx_t victim = INVALID_FRAME;
+
+  if (partition->a1in_size > a1in_target) {
+    victim = a1in_pick_victim(partition, scan);
+    if (victim != INVALID_FRAME) {
+      return victim;
+    }
+  }
+  victim = clock_pick_victim(partition, scan, true);
+  if (victim != INVALID_FRAME) {
+    return victim;
+  }
+  return a1in_pick_victim(partition, scan);
+}
+
+static const replacement_ops_t two_q_ops = {
+    "2Q",           two_q_init,      two_q_destroy, two_q_on_load,
+    two_q_on_access, two_q_on_evict, two_q_victim};
+
+/**
+ * LRU-K------------------------------------------------------------
+ * 프레임마다 최근 LRU_K번의 참조 시각(partition의 논리 시계)을 기억하고
+ * K번째 참조가 가장 오래된 프레임을 evict, 참조가 K번 미만이면 먼저 evict
+ * LRU_K_CORRELATED_PERIOD 안의 연속 참조(한 연산 안에서 같은 페이지를 다시
+ * 읽는 경우)는 한번으로 셈
+ */
+
+static int lru_k_init(buf_partition_t* partition) {
+  partition->access_clock = 0;
+  return SUCCESS;
+}
+
+static void lru_k_destroy(buf_partition_t* partition) {}
+
+/**
+ * prefetch된 페이지는 아직 참조되지 않았으므로 history를 비워둠
+ */
+static void lru_k_on_load(buf_partition_t* partition, buf_ctl_block_t* bcb,
+                          bool prefetched) {
+  for (int k = 0; k < LRU_K; k++) {
+    bcb->access_history[k].store(0, std::memory_order_relaxed);
+  }
+  if (!prefetched) {
+    uint64_t now =
+        partition->access_clock.fetch_add(1, std::memory_order_relaxed) + 1;
+    bcb->access_history[0].store(now, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * hit마다 호출, latch 없이 relaxed로 갱신하므로 동시 hit끼리는 근사값
+ */
+static void lru_k_on_access(buf_partition_t* partition, buf_ctl_block_t* bcb) {
+  uint64_t now =
+      partition->access_clock.fetch_add(1, std::memory_order_relaxed) + 1;
+  uint64_t last = bcb->access_history[0].load(std::memory_order_relaxed);
+
+  if (last == 0 || now - last > LRU_K_CORRELATED_PERIOD) {
+    for (int k = LRU_K - 1; k > 0; k--) {
+      bcb->access_history[k].store(
+          bcb->access_history[k - 1].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+  }
+  bcb->access_history[0].store(now, std::memory_order_relaxed);
+}
+
+static void lru_k_on_evict(buf_partition_t* partition, buf_ctl_block_t* bcb) {}
+
+/**
+ * backward K-distance가 가장 큰 프레임 = K번째 참조 시각이 가장 작은 프레임
+ * 같으면 마지막 참조가 오래된 쪽, CAS에 지면 다시 훑음
+ * 후보가 하나도 없을 때만 INVALID_FRAME
+ */
+static frame_idx_t lru_k_victim(buf_partition_t* partition,
+                                victim_scan_t* scan) {
+  while (true) {
+    frame_idx_t best = INVALID_FRAME;
+    uint64_t best_kth = UINT64_MAX;
+    uint64_t best_last = UINT64_MAX;
+
+    for (frame_idx_t frame_idx = partition->frame_begin;
+         frame_idx < partition->frame_end; frame_idx++) {
+      buf_ctl_block_t* bcb = &buf_mgr.frames[frame_idx];
+      if (!is_victim_candidate(bcb, scan)) {
+        continue;
+      }
+      uint64_t kth =
+          bcb->access_history[LRU_K - 1].load(std::memory_order_relaxed);
+      uint64_t last = bcb->access_history[0].load(std::memory_order_relaxed);
+      if (kth < best_kth || (kth == best_kth && last < best_last)) {
+        best = frame_idx;
+        best_kth = kth;
+        best_last = last;
+      }
+    }
+
+    if (best == INVALID_FRAME) {
+      return INVALID_FRAME;
+    }
+    if (try_claim_for_eviction(&buf_mgr.frames[best])) {
+      return best;
+    }
+  }
+}
+
+static const replacement_ops_t lru_k_ops = {
+    "LRU-K",        lru_k_init,      lru_k_destroy, lru_k_on_load,
+    lru_k_on_access, lru_k_on_evict, lru_k_victim};
+
+const replacement_ops_t* get_replacement_ops(ReplacementPolicy policy) {
+  switch (policy) {
+    case REPLACE_2Q:
+      return &two_q_ops;
+    case REPLACE_LRU_K:
+      return &lru_k_ops;
+    case REPLACE_CLOCK:
+    default:
+      return &clock_ops;
+  }
+}
@@ -1,13 +1,25 @@
 #include "db_api.h"
 
 #include "bpt.h"
+#include <sys/mman.h>
+#include <time.h>
+#include <new>
+
 #include "buf_mgr.h"
+#include "file.h"
 #include "lock_table.h"
 #include "txn_mgr.h"
 
 table_info_t table_infos[MAX_TABLE_COUNT + 1] = {0};
 std::unordered_map<std::string, tableid_t> path_table_mapper;
 
+// background sync thread와 close_table 사이에서 table fd를 보호
+pthread_mutex_t table_sync_latch = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t sync_thread_cond = PTHREAD_COND_INITIALIZER;
+pthread_t sync_thread;
+bool sync_thread_running = false;
+int sync_thread_interval_ms = 0;
+
 int get_fd(tableid_t table_id) { return table_infos[table_id].fd; }
 
 /**
@@ -16,11 +28,53 @@ int get_fd(tableid_t table_id) { return table_infos[table_id].fd; }
  */
 void free_buffer_manager(int end) {
   for (int index = 0; index < end; index++) {
-    free(buf_mgr.frames[index].frame);
+    pthread_rwlock_destroy(&buf_mgr.frames[index].page_latch);
   }
+  if (buf_mgr.frame_arena != NULL) {
+    munmap(buf_mgr.frame_arena, buf_mgr.frame_arena_size);
+    buf_mgr.frame_arena = NULL;
+    buf_mgr.frame_arena_size = 0;
+  }
+  clear_buf_partitions();
   free(buf_mgr.frames);
 }
 
+/**
+ * helper function for init_buffer_manager
+ * 모든 프레임이 들어갈 하나의 연속된 메모리를 mmap으로 할당 (PAGE_SIZE 정렬)
+ * 2MB 이상이면 huge page를 사용: -DBPT_HUGETLB_ARENA면 예약된 hugetlb 페이지를
+ * 먼저 시도하고, 아니면 transparent huge page를 요청
+ */
+int alloc_frame_arena(int buf_num) {
+  size_t arena_size = (size_t)buf_num * PAGE_SIZE;
+  void* arena = MAP_FAILED;
+
+  if (arena_size >= HUGE_PAGE_SIZE) {
+    arena_size = (arena_size + HUGE_PAGE_SIZE - 1) &
+                 ~(size_t)(HUGE_PAGE_SIZE - 1);
+#if defined(BPT_HUGETLB_ARENA) && defined(MAP_HUGETLB)
+    arena = mmap(NULL, arena_size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+  }
+  if (arena == MAP_FAILED) {
+    arena = mmap(NULL, arena_size, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (arena == MAP_FAILED) {
+      return FAILURE;
+    }
+#ifdef MADV_HUGEPAGE
+    if (arena_size >= HUGE_PAGE_SIZE) {
+      madvise(arena, arena_size, MADV_HUGEPAGE);  // 실패해도 4KB 페이지로 동작
+    }
+#endif
+  }
+
+  buf_mgr.frame_arena = arena;
+  buf_mgr.frame_arena_size = arena_size;
+  return SUCCESS;
+}
+
 void init_table_infos() {
   for (int index = 1; index <= MAX_TABLE_COUNT; index++) {
     table_infos[index].fd = -1;
@@ -30,45 +84,185 @@ void init_table_infos() {
 /**
  * helper function for init_db
  */
-int init_buffer_manager(int buf_num) {
+int init_buffer_manager(int buf_num, ReplacementPolicy policy) {
   buf_mgr.frames = (buf_ctl_block_t*)malloc(buf_num * sizeof(buf_ctl_block_t));
   if (buf_mgr.frames == NULL) {
     return FAILURE;
   }
   buf_mgr.frames_size = buf_num;
-  buf_mgr.clock_hand = 0;
+  if (init_buf_partitions(buf_num, policy) != SUCCESS) {
+    free(buf_mgr.frames);
+    return FAILURE;
+  }
+
+  if (buf_num > 0 && alloc_frame_arena(buf_num) != SUCCESS) {
+    free_buffer_manager(0);
+    return FAILURE;
+  }
 
   // init buf ctl blocks array
   for (int index = 0; index < buf_num; index++) {
-    memset(&buf_mgr.frames[index], 0, sizeof(buf_ctl_block_t));
+    // atomic member가 있어 memset 대신 value-initialize
+    new (&buf_mgr.frames[index]) buf_ctl_block_t();
 
     // 페이지 래치 초기화
-    if (pthread_mutex_init(&buf_mgr.frames[index].page_latch, NULL) != 0) {
+    if (pthread_rwlock_init(&buf_mgr.frames[index].page_latch, NULL) != 0) {
       free_buffer_manager(index);
       return FAILURE;
     }
 
-    buf_mgr.frames[index].frame = malloc(PAGE_SIZE);
-    if (buf_mgr.frames[index].frame == NULL) {
-      free_buffer_manager(index);
+    buf_mgr.frames[index].frame =
+        (char*)buf_mgr.frame_arena + (size_t)index * PAGE_SIZE;
+  }
+  return SUCCESS;
+}
+
+/**
+ * helper function for sync_thread_func and shutdown_db
+ * 열려있는 모든 테이블 파일을 fsync, table_sync_latch를 잡고 호출
+ */
+void sync_all_tables_unlocked() {
+  for (int table_id = 1; table_id <= MAX_TABLE_COUNT; table_id++) {
+    int fd = table_infos[table_id].fd;
+    if (fd > 0) {
+      file_sync(fd);
+    }
+  }
+}
+
+/**
+ * background sync thread
+ * SYNC_DEFERRED 모드에서 page cache에만 쓰인 페이지들이
+ * 최대 sync_thread_interval_ms 안에 디스크에 반영되도록 주기적으로 fsync
+ */
+void* sync_thread_func(void* arg) {
+  pthread_mutex_lock(&table_sync_latch);
+
+  while (sync_thread_running) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += sync_thread_interval_ms / 1000;
+    deadline.tv_nsec += (long)(sync_thread_interval_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec += 1;
+      deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_cond_timedwait(&sync_thread_cond, &table_sync_latch, &deadline);
+    if (!sync_thread_running) {
+      break;
+    }
+    sync_all_tables_unlocked();
+  }
+
+  pthread_mutex_unlock(&table_sync_latch);
+  return NULL;
+}
+
+/**
+ * helper function for db_set_durability and shutdown_db
+ */
+void stop_sync_thread() {
+  pthread_mutex_lock(&table_sync_latch);
+  if (!sync_thread_running) {
+    pthread_mutex_unlock(&table_sync_latch);
+    return;
+  }
+  sync_thread_running = false;
+  pthread_cond_signal(&sync_thread_cond);
+  pthread_mutex_unlock(&table_sync_latch);
+
+  pthread_join(sync_thread, NULL);
+}
+
+/**
+ * @brief Choose when page writes become durable
+ * SYNC_EVERY_WRITE: fsync after every page write (default)
+ * SYNC_DEFERRED: page writes go to the page cache only and are synced at
+ * db_sync, close_table, shutdown_db and, if sync_interval_ms > 0, by a
+ * background thread every sync_interval_ms
+ * If success, return 0. Otherwise, return non-zero value
+ */
+int db_set_durability(SyncMode mode, int sync_interval_ms) {
+  if (sync_interval_ms < 0) {
+    return FAILURE;
+  }
+
+  stop_sync_thread();
+
+  // 모드를 바꾸기 전에 지금까지 쓰인 페이지는 durable하게 만듦
+  pthread_mutex_lock(&table_sync_latch);
+  sync_all_tables_unlocked();
+  pthread_mutex_unlock(&table_sync_latch);
+
+  file_set_sync_mode(mode);
+
+  if (mode == SYNC_DEFERRED && sync_interval_ms > 0) {
+    sync_thread_interval_ms = sync_interval_ms;
+    sync_thread_running = true;
+    if (pthread_create(&sync_thread, NULL, sync_thread_func, NULL) != 0) {
+      sync_thread_running = false;
       return FAILURE;
     }
   }
   return SUCCESS;
 }
 
+/**
+ * @brief Start, reconfigure or stop the background page cleaner
+ * clean_percent: share of each buffer partition kept clean and unpinned
+ * ahead of the clock hand, 0 stops the cleaner
+ * interval_ms: how often the cleaner checks when nobody wakes it
+ * (0 uses DEFAULT_CLEANER_INTERVAL_MS)
+ * If success, return 0. Otherwise, return non-zero value
+ */
+int db_set_page_cleaner(int clean_percent, int interval_ms) {
+  if (clean_percent < 0 || clean_percent > 100 || interval_ms < 0) {
+    return FAILURE;
+  }
+  if (clean_percent == 0) {
+    stop_page_cleaner();
+    return SUCCESS;
+  }
+  if (interval_ms == 0) {
+    interval_ms = DEFAULT_CLEANER_INTERVAL_MS;
+  }
+  return start_page_cleaner(clean_percent, interval_ms);
+}
+
+/**
+ * @brief Pages written by the cleaner and foreground evictions that
+ * had to write a dirty victim themselves
+ */
+void db_get_page_cleaner_stats(page_cleaner_stats_t* stats) {
+  get_page_cleaner_stats(stats);
+}
+
+/**
+ * @brief Buffer pool hits and demand misses since init_db
+ */
+void db_get_buffer_stats(buffer_stats_t* stats) { get_buffer_stats(stats); }
+
 /**
  * @brief Initialize buffer pool with given number and buffer manager
  * If success, return 0. Otherwise, return non-zero value
  */
-int init_db(int buf_num) {
+int init_db(int buf_num) { return init_db(buf_num, REPLACE_CLOCK); }
+
+/**
+ * @brief Initialize buffer pool with the given replacement policy
+ * If success, return 0. Otherwise, return non-zero value
+ */
+int init_db(int buf_num, ReplacementPolicy policy) {
   if (buf_num < 0) {
     return FAILURE;
   }
 
   init_table_infos();
   init_txn_table();
-  return init_buffer_manager(buf_num);
+  // 실패해도 동기 I/O로 동작하므로 결과는 무시
+  file_aio_init();
+  return init_buffer_manager(buf_num, policy);
 }
 
 /**
@@ -97,7 +291,27 @@ int find_free_table() {
  * which represents the own table in this database.
  * Otherwise, return negative value
  */
-int open_table(char* pathname) {
+int open_table(char* pathname) { return open_table(pathname, OPEN_BUFFERED); }
+
+/**
+ * helper function for open_table
+ * OPEN_DIRECT면 O_DIRECT로 열어 page cache를 거치지 않음
+ * (O_DIRECT를 지원하지 않는 파일시스템이면 open이 실패함)
+ */
+int open_table_file(char* pathname, TableOpenMode open_mode) {
+  int flags = O_RDWR | O_CREAT;
+  if (open_mode == OPEN_DIRECT) {
+    flags |= O_DIRECT;
+  }
+  mode_t mode = 0644;
+  return open(pathname, flags, mode);
+}
+
+/**
+ * open_table with open mode
+ * 프레임과 I/O 버퍼가 모두 PAGE_SIZE 정렬이므로 OPEN_DIRECT 사용 가능
+ */
+int open_table(char* pathname, TableOpenMode open_mode) {
   if (strlen(pathname) > PATH_NAME_MAX_LENGTH) {
     return FAILURE;
   }
@@ -113,13 +327,13 @@ int open_table(char* pathname) {
     }
 
     // 닫혀있으면 재오픈 (같은 table_id 재사용)
-    mode_t mode = 0644;
-    int fd = open(pathname, O_RDWR | O_CREAT, mode);
+    int fd = open_table_file(pathname, open_mode);
     if (fd == -1) {
       return FAILURE;
     }
 
     table_infos[table_id].fd = fd;
+    table_infos[table_id].open_mode = open_mode;
 
     return table_id;
   }
@@ -129,13 +343,13 @@ int open_table(char* pathname) {
   if (table_id == FAILURE) {
     return FAILURE;
   }
-  mode_t mode = 0644;
-  int fd = open(pathname, O_RDWR | O_CREAT, mode);
+  int fd = open_table_file(pathname, open_mode);
   if (fd == -1) {
     return FAILURE;
   }
 
   table_infos[table_id].fd = fd;
+  table_infos[table_id].open_mode = open_mode;
   strncpy(table_infos[table_id].path, pathname, PATH_NAME_MAX_LENGTH);
   table_infos[table_id].path[PATH_NAME_MAX_LENGTH] = '\0';
   path_table_mapper[pathname] = table_id;
@@ -166,6 +380,47 @@ int db_insert(int table_id, int64_t key, char* value) {
   return result;
 }
 
+/**
+ * db_insert with value length, value does not have to be a string
+ * LEAF_FORMAT_SLOTTED moves values longer than SLOTTED_MAX_VALUE_SIZE to
+ * overflow pages (up to OVERFLOW_MAX_VALUE_SIZE), fixed length formats fail
+ * on values longer than VALUE_SIZE
+ */
+int db_insert(tableid_t table_id, int64_t key, const char* value,
+              uint16_t length) {
+  return bpt_insert(get_fd(table_id), table_id, key, value, length);
+}
+
+/**
+ * @brief Insert n records with one call
+ * keys are sorted first, keys that fall in the same leaf share one descent
+ * and one page write, and a full leaf is split once for all of them
+ * Keys already in the table or repeated in the batch are skipped
+ * Return the number of inserted records, -1 for an invalid table
+ */
+int db_insert_batch(tableid_t table_id, const int64_t keys[], char* values[],
+                    int n) {
+  if (table_id < 1 || table_id > MAX_TABLE_COUNT ||
+      table_infos[table_id].fd <= 0) {
+    return FAILURE;
+  }
+  return bpt_insert_batch(get_fd(table_id), table_id, keys, values, n);
+}
+
+/**
+ * db_insert_batch with value lengths, values do not have to be strings
+ */
+int db_insert_batch(tableid_t table_id, const int64_t keys[],
+                    const char* const values[], const uint16_t lengths[],
+                    int n) {
+  if (table_id < 1 || table_id > MAX_TABLE_COUNT ||
+      table_infos[table_id].fd <= 0) {
+    return FAILURE;
+  }
+  return bpt_insert_batch(get_fd(table_id), table_id, keys, values, lengths,
+                          n);
+}
+
 /**
  * @brief Find the record containing input key
  * If found matching ‘key’, store matched ‘value’ string in ret_val and return 0
@@ -179,6 +434,180 @@ int db_find(int table_id, int64_t key, char* ret_val) {
   return FAILURE;
 }
 
+/**
+ * db_find with value length
+ * length: size of ret_val in, length of the value out
+ * If ret_val is too small, length is set to the needed size and -1 returned
+ */
+int db_find(tableid_t table_id, int64_t key, char* ret_val, uint16_t* length) {
+  return find(get_fd(table_id), table_id, key, ret_val, length);
+}
+
+/**
+ * db_find for the first prefix_length bytes of a value
+ * value_length is set to the length of the whole value
+ * Large values keep a prefix in the leaf, so a short prefix does not read
+ * their overflow pages
+ */
+int db_find_prefix(tableid_t table_id, int64_t key, char* ret_val,
+                   uint16_t prefix_length, uint16_t* value_length) {
+  return find_prefix(get_fd(table_id), table_id, key, ret_val, prefix_length,
+                     value_length);
+}
+
+/**
+ * @brief Find n keys at once, for fan-out lookups
+ * Keys are answered in key order, reading each leaf once and prefetching
+ * the next leaves. out_values[i] has VALUE_SIZE bytes
+ * out_status[i] is 0 if keys[i] was found, -1 otherwise
+ * Return the number of found keys, -1 for an invalid table
+ */
+int db_find_batch(tableid_t table_id, const int64_t keys[], int n,
+                  char* out_values[], int out_status[]) {
+  if (table_id < 1 || table_id > MAX_TABLE_COUNT ||
+      table_infos[table_id].fd <= 0) {
+    return FAILURE;
+  }
+  return find_batch(get_fd(table_id), table_id, keys, n, out_values,
+                    out_status);
+}
+
+/**
+ * db_find_batch with value lengths
+ * lengths[i]: size of out_values[i] in, length of the value out
+ */
+int db_find_batch(tableid_t table_id, const int64_t keys[], int n,
+                  char* out_values[], uint16_t lengths[], int out_status[]) {
+  if (table_id < 1 || table_id > MAX_TABLE_COUNT ||
+      table_infos[table_id].fd <= 0) {
+    return FAILURE;
+  }
+  return find_batch(get_fd(table_id), table_id, keys, n, out_values, lengths,
+                    out_status);
+}
+
+/**
+ * @brief Open a cursor for streaming range scans
+ * The cursor pins at most one leaf, so a scan of any length uses
+ * constant memory. Close it with db_cursor_close
+ * Return NULL for an invalid table
+ */
+cursor_t* db_cursor_open(tableid_t table_id) {
+  if (table_id < 1 || table_id > MAX_TABLE_COUNT ||
+      table_infos[table_id].fd <= 0) {
+    return NULL;
+  }
+  return cursor_open(get_fd(table_id), table_id);
+}
+
+/**
+ * Move the cursor to the first key >= key_start
+ * If there is such a record, return 0. Otherwise, return -1
+ */
+int db_cursor_seek(cursor_t* cursor, int64_t key_start) {
+  return cursor_seek(cursor, key_start);
+}
+
+/**
+ * db_cursor_seek that stops after key_end (inclusive)
+ */
+int db_cursor_seek(cursor_t* cursor, int64_t key_start, int64_t key_end) {
+  return cursor_seek(cursor, key_start, key_end);
+}
+
+/**
+ * Move the cursor to the last key <= key_start
+ * db_cursor_next then walks the keys in descending order
+ * If there is such a record, return 0. Otherwise, return -1
+ */
+int db_cursor_seek_reverse(cursor_t* cursor, int64_t key_start) {
+  return cursor_seek_reverse(cursor, key_start);
+}
+
+/**
+ * db_cursor_seek_reverse that stops below key_end (inclusive)
+ */
+int db_cursor_seek_reverse(cursor_t* cursor, int64_t key_start,
+                           int64_t key_end) {
+  return cursor_seek_reverse(cursor, key_start, key_end);
+}
+
+/**
+ * Give the current record and move to the next one,
+ * in the direction of the last seek
+ * value has VALUE_SIZE bytes, as in db_find
+ * Return 0, or -1 at the end of the range
+ */
+int db_cursor_next(cursor_t* cursor, int64_t* key, char* value) {
+  return cursor_next(cursor, key, value);
+}
+
+/**
+ * db_cursor_next with value length
+ * length: size of value in, length of the whole value out
+ * A longer value is cut to the buffer size
+ */
+int db_cursor_next(cursor_t* cursor, int64_t* key, char* value,
+                   uint16_t* length) {
+  return cursor_next(cursor, key, value, length);
+}
+
+/**
+ * Unpin the cursor's leaf and free the cursor
+ */
+void db_cursor_close(cursor_t* cursor) { cursor_close(cursor); }
+
+/**
+ * @brief Load key-sorted records into an empty table
+ * next gives records in increasing key order, leaves and internal pages are
+ * packed to BULK_LOAD_FILL_PERCENT and written without the buffer pool
+ * If success, return 0. Fails on a non-empty table, unsorted or duplicate
+ * keys, and values that do not fit in a leaf
+ */
+int db_bulk_load(tableid_t table_id, bulk_load_next_t next, void* ctx) {
+  return db_bulk_load(table_id, next, ctx, BULK_LOAD_FILL_PERCENT);
+}
+
+/**
+ * db_bulk_load with page fill factor (1~100 percent)
+ * lower fill leaves room for later inserts without splits
+ */
+int db_bulk_load(tableid_t table_id, bulk_load_next_t next, void* ctx,
+                 int fill_percent) {
+  if (table_id < 1 || table_id > MAX_TABLE_COUNT ||
+      table_infos[table_id].fd <= 0) {
+    return FAILURE;
+  }
+  return bulk_load(get_fd(table_id), table_id, next, ctx, fill_percent);
+}
+
+/**
+ * @brief Choose the leaf page format of an empty table
+ * LEAF_FORMAT_SLOTTED stores values by their real length
+ * If success, return 0. Fails once the table has records
+ */
+int db_set_leaf_format(tableid_t table_id, uint32_t format) {
+  if (table_id < 1 || table_id > MAX_TABLE_COUNT ||
+      table_infos[table_id].fd <= 0) {
+    return FAILURE;
+  }
+  return set_leaf_format(get_fd(table_id), table_id, format);
+}
+
+/**
+ * @brief Choose how an empty table finds parents on split and merge
+ * TREE_MODE_PATH keeps no parent pointers; insert and delete use the
+ * descent path, so splits and merges do not rewrite moved children
+ * If success, return 0. Fails once the table has records
+ */
+int db_set_tree_mode(tableid_t table_id, uint32_t mode) {
+  if (table_id < 1 || table_id > MAX_TABLE_COUNT ||
+      table_infos[table_id].fd <= 0) {
+    return FAILURE;
+  }
+  return set_tree_mode(get_fd(table_id), table_id, mode);
+}
+
 /**
  * db_find concurrency control version
  */
@@ -265,6 +694,71 @@ int db_delete(int table_id, int64_t key) {
   return FAILURE;
 }
 
+/**
+ * db_insert that other threads may call on the same table at the same time
+ * together with db_delete_concurrent, db_find_concurrent and db_find with a
+ * transaction. A record that fits its leaf takes only latches on the way
+ * down; a split retries with exclusive latches from the header
+ * Works on TREE_MODE_PATH tables only (see db_set_tree_mode)
+ * If success, return 0. Otherwise, return non-zero value
+ */
+int db_insert_concurrent(tableid_t table_id, int64_t key, const char* value,
+                         uint16_t length) {
+  if (table_id < 1 || table_id > MAX_TABLE_COUNT ||
+      table_infos[table_id].fd <= 0) {
+    return FAILURE;
+  }
+  return bpt_insert_concurrent(get_fd(table_id), table_id, key, value, length);
+}
+
+/**
+ * db_delete version of db_insert_concurrent
+ * If success, return 0. Otherwise, return non-zero value
+ */
+int db_delete_concurrent(tableid_t table_id, int64_t key) {
+  if (table_id < 1 || table_id > MAX_TABLE_COUNT ||
+      table_infos[table_id].fd <= 0) {
+    return FAILURE;
+  }
+  return bpt_delete_concurrent(get_fd(table_id), table_id, key);
+}
+
+/**
+ * db_find with value length that may run next to db_insert_concurrent and
+ * db_delete_concurrent, reads the leaf under a shared page latch
+ */
+int db_find_concurrent(tableid_t table_id, int64_t key, char* ret_val,
+                       uint16_t* length) {
+  if (table_id < 1 || table_id > MAX_TABLE_COUNT ||
+      table_infos[table_id].fd <= 0) {
+    return FAILURE;
+  }
+  return find_concurrent(get_fd(table_id), table_id, key, ret_val, length);
+}
+
+/**
+ * @brief Flush dirty pages of the table and make them durable
+ * If success, return 0. Otherwise, return non-zero value
+ */
+int db_sync(tableid_t table_id) {
+  if (table_id < 1 || table_id > MAX_TABLE_COUNT) {
+    return FAILURE;
+  }
+
+  pthread_mutex_lock(&table_sync_latch);
+  int fd = table_infos[table_id].fd;
+  if (fd <= 0) {
+    pthread_mutex_unlock(&table_sync_latch);
+    return FAILURE;
+  }
+
+  flush_table_buffer(fd, table_id);
+  file_sync(fd);
+  pthread_mutex_unlock(&table_sync_latch);
+
+  return SUCCESS;
+}
+
 int close_table(int table_id) {
   if (table_id < 1 || table_id > MAX_TABLE_COUNT) {
     printf("invalid table_id\n");
@@ -276,13 +770,18 @@ int close_table(int table_id) {
     return SUCCESS;
   }
 
+  pthread_mutex_lock(&table_sync_latch);
   flush_table_buffer(get_fd(table_id), table_id);
+  file_sync(get_fd(table_id));
+
   int result = SUCCESS;
   if (close(table_infos[table_id].fd) == -1) {
     perror("cannot close fd");
     result = FAILURE;
   }
   table_infos[table_id].fd = -1;
+  forget_rightmost_leaf(table_id);
+  pthread_mutex_unlock(&table_sync_latch);
 
   printf("table closed\n");
   return result;
@@ -292,15 +791,12 @@ int close_table(int table_id) {
  * helper function for shutdown_db
  */
 void clear_path_table_mapper() {
-  for (int i = 0; i <= MAX_TABLE_COUNT; ++i) {
-    buf_mgr.page_table[i].clear();
-  }
+  clear_buf_partitions();
   path_table_mapper.clear();
   memset(table_infos, 0, sizeof(table_infos));
 
   buf_mgr.frames = NULL;
   buf_mgr.frames_size = 0;
-  buf_mgr.clock_hand = 0;
 }
 
 /**
@@ -308,12 +804,19 @@ void clear_path_table_mapper() {
  • If success, return 0. Otherwise, return non-zero value
  */
 int shutdown_db(void) {
+  stop_sync_thread();
+  stop_page_cleaner();
+
   for (int table_id = 1; table_id <= MAX_TABLE_COUNT; table_id++) {
     int fd = table_infos[table_id].fd;
     if (fd > 0) {
       flush_table_buffer(fd, table_id);
     }
+    forget_rightmost_leaf(table_id);
   }
+  sync_all_tables_unlocked();
+  file_aio_shutdown();
+  file_set_sync_mode(SYNC_EVERY_WRITE);
 
   if (buf_mgr.frames != NULL) {
     free_buffer_manager(buf_mgr.frames_size);
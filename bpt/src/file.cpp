@@ -1,11 +1,34 @@
 #include "file.h"
 
+#include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <deque>
+
+// -DBPT_NO_IO_URING forces the thread pool backend
+#if defined(__linux__) && !defined(BPT_NO_IO_URING) && \
+    __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define HAVE_IO_URING
+#endif
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+// SYNC_DEFERRED이면 페이지 쓰기는 page cache까지만 가고 fsync는 file_sync에서
+// I/O thread와 page cleaner도 쓸 때마다 읽음
+static std::atomic<SyncMode> sync_mode{SYNC_EVERY_WRITE};
+
 off_t get_offset(pagenum_t pagenum) { return (off_t)pagenum * PAGE_SIZE; }
 
 uint32_t get_isleaf_flag(const page_t* page) {
@@ -32,7 +55,8 @@ pagenum_t file_alloc_page(int fd) {
  */
 void file_free_page(int fd, pagenum_t pagenum) {
   // 프리페이지 리스트에 추가하는 것은 버퍼 매니저에서 담당함
-  page_t empty_page;
+  // O_DIRECT로 열린 fd에도 쓸 수 있도록 PAGE_SIZE 정렬
+  alignas(PAGE_SIZE) page_t empty_page;
   memset(&empty_page, 0, PAGE_SIZE);
 
   file_write_page(fd, pagenum, &empty_page);
@@ -40,22 +64,50 @@ void file_free_page(int fd, pagenum_t pagenum) {
 
 /**
  * @brief Read an on-disk page into the in-memory page structure(dest)
+ * pread는 파일 오프셋을 공유하지 않으므로 같은 fd를 쓰는 스레드끼리 경합이 없음
  */
 void file_read_page(int fd, pagenum_t pagenum, page_t* dest) {
   off_t offset = get_offset(pagenum);
+  size_t done = 0;
+
+  while (done < PAGE_SIZE) {
+    ssize_t bytes_read =
+        pread(fd, (char*)dest + done, PAGE_SIZE - done, offset + done);
 
-  if (lseek(fd, offset, SEEK_SET) == (off_t)-1) {
-    handle_error("lseek error");
+    if (bytes_read == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      handle_error("pread error (I/O failure)");
+    }
+    if (bytes_read == 0) {
+      fprintf(stderr, "EOF reached or partial read (%zu bytes) for page %ld.\n",
+              done, pagenum);
+      exit(EXIT_FAILURE);
+    }
+    done += bytes_read;
   }
+}
 
-  ssize_t bytes_read = read(fd, dest, PAGE_SIZE);
+/**
+ * helper function for file_write_page and the async write path
+ * pwrite only, durability is decided by the caller
+ */
+static void write_page_at(int fd, pagenum_t pagenum, const page_t* src) {
+  off_t offset = get_offset(pagenum);
+  size_t done = 0;
 
-  if (bytes_read == -1) {
-    handle_error("read error (I/O failure)");
-  } else if (bytes_read < PAGE_SIZE) {
-    fprintf(stderr, "EOF reached or partial read (%zd bytes) for page %ld.\n",
-            bytes_read, pagenum);
-    exit(EXIT_FAILURE);
+  while (done < PAGE_SIZE) {
+    ssize_t bytes_written =
+        pwrite(fd, (const char*)src + done, PAGE_SIZE - done, offset + done);
+
+    if (bytes_written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      handle_error("pwrite error");
+    }
+    done += bytes_written;
   }
 }
 
@@ -63,17 +115,586 @@ void file_read_page(int fd, pagenum_t pagenum, page_t* dest) {
  * @brief Write an in-memory page(src) to the on-disk page
  */
 void file_write_page(int fd, pagenum_t pagenum, const page_t* src) {
-  off_t offset = get_offset(pagenum);
+  write_page_at(fd, pagenum, src);
 
-  if (lseek(fd, offset, SEEK_SET) == (off_t)-1) {
-    handle_error("lseek error");
+  if (sync_mode.load(std::memory_order_relaxed) == SYNC_EVERY_WRITE) {
+    file_sync(fd);
   }
+}
 
-  if (write(fd, src, PAGE_SIZE) != PAGE_SIZE) {
-    handle_error("write error");
+/**
+ * helper function for file_read_pages and file_write_pages
+ * 부분 전송이 일어났을 때 이미 처리된 바이트만큼 iovec을 앞으로 당긴다
+ */
+static void advance_iovecs(struct iovec** iov, int* iovcnt, size_t bytes) {
+  while (bytes > 0 && *iovcnt > 0) {
+    if (bytes >= (*iov)->iov_len) {
+      bytes -= (*iov)->iov_len;
+      (*iov)++;
+      (*iovcnt)--;
+    } else {
+      (*iov)->iov_base = (char*)(*iov)->iov_base + bytes;
+      (*iov)->iov_len -= bytes;
+      bytes = 0;
+    }
   }
+}
+
+/**
+ * @brief Read `count` adjacent on-disk pages starting at start_pagenum into
+ * dests[0..count) with preadv (dest frames do not have to be contiguous)
+ */
+void file_read_pages(int fd, pagenum_t start_pagenum, page_t* dests[],
+                     int count) {
+  struct iovec iovs[IOV_MAX];
+
+  while (count > 0) {
+    int batch = count < IOV_MAX ? count : IOV_MAX;
+    for (int i = 0; i < batch; i++) {
+      iovs[i].iov_base = dests[i];
+      iovs[i].iov_len = PAGE_SIZE;
+    }
+
+    struct iovec* iov = iovs;
+    int iovcnt = batch;
+    off_t offset = get_offset(start_pagenum);
+
+    while (iovcnt > 0) {
+      ssize_t bytes_read = preadv(fd, iov, iovcnt, offset);
+
+      if (bytes_read == -1) {
+        if (errno == EINTR) {
+          continue;
+        }
+        handle_error("preadv error (I/O failure)");
+      }
+      if (bytes_read == 0) {
+        fprintf(stderr, "EOF reached while reading pages %ld..%ld.\n",
+                start_pagenum, start_pagenum + batch - 1);
+        exit(EXIT_FAILURE);
+      }
+      offset += bytes_read;
+      advance_iovecs(&iov, &iovcnt, bytes_read);
+    }
 
+    start_pagenum += batch;
+    dests += batch;
+    count -= batch;
+  }
+}
+
+/**
+ * @brief Write `count` in-memory pages(srcs) to adjacent on-disk pages
+ * starting at start_pagenum with pwritev
+ */
+void file_write_pages(int fd, pagenum_t start_pagenum,
+                      const page_t* const srcs[], int count) {
+  struct iovec iovs[IOV_MAX];
+
+  while (count > 0) {
+    int batch = count < IOV_MAX ? count : IOV_MAX;
+    for (int i = 0; i < batch; i++) {
+      iovs[i].iov_base = (void*)srcs[i];
+      iovs[i].iov_len = PAGE_SIZE;
+    }
+
+    struct iovec* iov = iovs;
+    int iovcnt = batch;
+    off_t offset = get_offset(start_pagenum);
+
+    while (iovcnt > 0) {
+      ssize_t bytes_written = pwritev(fd, iov, iovcnt, offset);
+
+      if (bytes_written == -1) {
+        if (errno == EINTR) {
+          continue;
+        }
+        handle_error("pwritev error");
+      }
+      offset += bytes_written;
+      advance_iovecs(&iov, &iovcnt, bytes_written);
+    }
+
+    start_pagenum += batch;
+    srcs += batch;
+    count -= batch;
+  }
+
+  if (sync_mode.load(std::memory_order_relaxed) == SYNC_EVERY_WRITE) {
+    file_sync(fd);
+  }
+}
+
+void file_set_sync_mode(SyncMode mode) {
+  sync_mode.store(mode, std::memory_order_relaxed);
+}
+
+SyncMode file_get_sync_mode(void) {
+  return sync_mode.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Make every page write issued on fd so far durable
+ */
+void file_sync(int fd) {
   if (fsync(fd) != 0) {
     handle_error("fsync error");
   }
 }
+
+/**
+ * async I/O engine---------------------------------------------------
+ * io_uring이 가능하면 io_uring, 아니면 pread/pwrite 스레드 풀로 처리
+ * 완료되면 req->on_complete를 호출하거나(req 소유권이 콜백으로 넘어감)
+ * 콜백이 없으면 done을 세팅해 file_aio_wait를 깨운다
+ */
+
+static AioBackend aio_backend = AIO_SYNC;
+
+// 동시에 진행중인 요청 수를 AIO_QUEUE_DEPTH로 제한
+static pthread_mutex_t aio_submit_latch = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t aio_slot_cond = PTHREAD_COND_INITIALIZER;
+static int aio_in_flight = 0;
+
+// on_complete가 없는 요청의 완료 대기
+static pthread_mutex_t aio_done_latch = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t aio_done_cond = PTHREAD_COND_INITIALIZER;
+
+// thread pool backend
+static pthread_t aio_workers[AIO_WORKER_COUNT];
+static std::deque<aio_req_t*> aio_queue;
+static pthread_mutex_t aio_queue_latch = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t aio_queue_cond = PTHREAD_COND_INITIALIZER;
+static bool aio_pool_stop = false;
+
+/**
+ * slot count개를 한번에 잡음 (count <= AIO_QUEUE_DEPTH)
+ * 하나씩 잡으면 두 batch가 slot을 나눠 가진 채 아무것도 제출하지 못하고
+ * 서로 기다릴 수 있음, aio_submit_latch를 잡고 return
+ */
+static void acquire_aio_slots(int count) {
+  pthread_mutex_lock(&aio_submit_latch);
+  while (aio_in_flight + count > AIO_QUEUE_DEPTH) {
+    pthread_cond_wait(&aio_slot_cond, &aio_submit_latch);
+  }
+  aio_in_flight += count;
+}
+
+/**
+ * acquire_aio_slots와 같지만 slot이 모자라면 기다리지 않고 false
+ * true면 aio_submit_latch를 잡고 return
+ */
+static bool try_acquire_aio_slots(int count) {
+  pthread_mutex_lock(&aio_submit_latch);
+  if (aio_in_flight + count > AIO_QUEUE_DEPTH) {
+    pthread_mutex_unlock(&aio_submit_latch);
+    return false;
+  }
+  aio_in_flight += count;
+  return true;
+}
+
+static void release_aio_slot() {
+  pthread_mutex_lock(&aio_submit_latch);
+  aio_in_flight--;
+  // 기다리는 batch마다 필요한 slot 수가 다르므로 모두 깨움
+  pthread_cond_broadcast(&aio_slot_cond);
+  pthread_mutex_unlock(&aio_submit_latch);
+}
+
+/**
+ * helper function for every backend
+ * 요청 하나를 동기적으로 처리 (thread pool, fallback, 짧은 전송 재시도)
+ */
+static void do_aio_request_sync(aio_req_t* req) {
+  if (req->is_write) {
+    write_page_at(req->fd, req->pagenum, req->buf);
+  } else {
+    file_read_page(req->fd, req->pagenum, req->buf);
+  }
+}
+
+static void complete_aio_request(aio_req_t* req) {
+  if (req->is_write &&
+      sync_mode.load(std::memory_order_relaxed) == SYNC_EVERY_WRITE) {
+    file_sync(req->fd);
+  }
+
+  if (req->on_complete != NULL) {
+    req->on_complete(req);
+    return;
+  }
+
+  pthread_mutex_lock(&aio_done_latch);
+  req->done = true;
+  pthread_cond_broadcast(&aio_done_cond);
+  pthread_mutex_unlock(&aio_done_latch);
+}
+
+#ifdef HAVE_IO_URING
+
+typedef struct {
+  int ring_fd;
+  unsigned sq_entries;
+  unsigned* sq_tail;
+  unsigned* sq_mask;
+  unsigned* sq_array;
+  struct io_uring_sqe* sqes;
+  unsigned* cq_head;
+  unsigned* cq_tail;
+  unsigned* cq_mask;
+  struct io_uring_cqe* cqes;
+  void* sq_ptr;
+  size_t sq_size;
+  void* cq_ptr;
+  size_t cq_size;
+  size_t sqes_size;
+} uring_t;
+
+static uring_t uring;
+static pthread_t uring_reaper;
+
+static int sys_io_uring_enter(int ring_fd, unsigned to_submit,
+                              unsigned min_complete, unsigned flags) {
+  return (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete,
+                      flags, NULL, 0);
+}
+
+static void unmap_uring() {
+  if (uring.sqes != NULL && uring.sqes != MAP_FAILED) {
+    munmap(uring.sqes, uring.sqes_size);
+  }
+  if (uring.cq_ptr != NULL && uring.cq_ptr != MAP_FAILED &&
+      uring.cq_ptr != uring.sq_ptr) {
+    munmap(uring.cq_ptr, uring.cq_size);
+  }
+  if (uring.sq_ptr != NULL && uring.sq_ptr != MAP_FAILED) {
+    munmap(uring.sq_ptr, uring.sq_size);
+  }
+  close(uring.ring_fd);
+  memset(&uring, 0, sizeof(uring));
+}
+
+/**
+ * helper function for file_aio_init
+ * ring을 만들고 SQ/CQ/SQE 영역을 mmap, 커널이 막고 있으면 FAILURE
+ */
+static int setup_uring() {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  memset(&uring, 0, sizeof(uring));
+
+  uring.ring_fd =
+      (int)syscall(__NR_io_uring_setup, AIO_QUEUE_DEPTH, &params);
+  if (uring.ring_fd < 0) {
+    return FAILURE;
+  }
+
+  uring.sq_entries = params.sq_entries;
+  uring.sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  uring.cq_size =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap && uring.cq_size > uring.sq_size) {
+    uring.sq_size = uring.cq_size;
+  }
+
+  uring.sq_ptr = mmap(NULL, uring.sq_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, uring.ring_fd,
+                      IORING_OFF_SQ_RING);
+  if (uring.sq_ptr == MAP_FAILED) {
+    unmap_uring();
+    return FAILURE;
+  }
+  uring.cq_ptr = single_mmap
+                     ? uring.sq_ptr
+                     : mmap(NULL, uring.cq_size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, uring.ring_fd,
+                            IORING_OFF_CQ_RING);
+  uring.sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+  uring.sqes = (struct io_uring_sqe*)mmap(
+      NULL, uring.sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+      uring.ring_fd, IORING_OFF_SQES);
+  if (uring.cq_ptr == MAP_FAILED || uring.sqes == MAP_FAILED) {
+    unmap_uring();
+    return FAILURE;
+  }
+
+  char* sq = (char*)uring.sq_ptr;
+  uring.sq_tail = (unsigned*)(sq + params.sq_off.tail);
+  uring.sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+  uring.sq_array = (unsigned*)(sq + params.sq_off.array);
+
+  char* cq = (char*)uring.cq_ptr;
+  uring.cq_head = (unsigned*)(cq + params.cq_off.head);
+  uring.cq_tail = (unsigned*)(cq + params.cq_off.tail);
+  uring.cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+  uring.cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+  return SUCCESS;
+}
+
+/**
+ * helper function for file_aio_submit and file_aio_shutdown
+ * SQE 하나를 채움, aio_submit_latch와 slot을 잡은 상태에서 호출
+ */
+static void uring_push(uint8_t opcode, aio_req_t* req) {
+  unsigned tail = *uring.sq_tail;
+  unsigned index = tail & *uring.sq_mask;
+  struct io_uring_sqe* sqe = &uring.sqes[index];
+
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  if (req != NULL) {
+    sqe->fd = req->fd;
+    sqe->off = get_offset(req->pagenum);
+    sqe->addr = (unsigned long)req->buf;
+    sqe->len = PAGE_SIZE;
+  } else {
+    sqe->fd = -1;
+  }
+  sqe->user_data = (unsigned long)req;
+
+  uring.sq_array[index] = index;
+  __atomic_store_n(uring.sq_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * helper function for file_aio_submit and file_aio_shutdown
+ * 쌓인 SQE들을 io_uring_enter 한번으로 제출
+ */
+static void uring_enter_submit(unsigned count) {
+  while (count > 0) {
+    int submitted = sys_io_uring_enter(uring.ring_fd, count, 0, 0);
+    if (submitted < 0) {
+      if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+        handle_error("io_uring_enter submit error");
+      }
+      continue;
+    }
+    count -= submitted;
+  }
+}
+
+/**
+ * io_uring completion thread
+ * CQE를 꺼내서 요청을 완료 처리, 짧은 전송이나 에러는 동기 I/O로 다시 처리
+ */
+static void* uring_reaper_func(void* arg) {
+  bool stop = false;
+
+  while (!stop) {
+    if (sys_io_uring_enter(uring.ring_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 &&
+        errno != EINTR) {
+      handle_error("io_uring_enter wait error");
+    }
+
+    unsigned head = *uring.cq_head;
+    unsigned tail = __atomic_load_n(uring.cq_tail, __ATOMIC_ACQUIRE);
+
+    while (head != tail) {
+      struct io_uring_cqe* cqe = &uring.cqes[head & *uring.cq_mask];
+      aio_req_t* req = (aio_req_t*)cqe->user_data;
+      int res = cqe->res;
+      head++;
+      __atomic_store_n(uring.cq_head, head, __ATOMIC_RELEASE);
+
+      release_aio_slot();
+      if (req == NULL) {  // shutdown NOP
+        stop = true;
+        continue;
+      }
+      if (res != PAGE_SIZE) {
+        do_aio_request_sync(req);
+      }
+      complete_aio_request(req);
+    }
+  }
+  return NULL;
+}
+
+#endif
+
+/**
+ * thread pool worker: 큐에서 요청을 꺼내 pread/pwrite로 처리
+ */
+static void* aio_worker_func(void* arg) {
+  while (true) {
+    pthread_mutex_lock(&aio_queue_latch);
+    while (aio_queue.empty() && !aio_pool_stop) {
+      pthread_cond_wait(&aio_queue_cond, &aio_queue_latch);
+    }
+    if (aio_queue.empty()) {
+      pthread_mutex_unlock(&aio_queue_latch);
+      break;
+    }
+    aio_req_t* req = aio_queue.front();
+    aio_queue.pop_front();
+    pthread_mutex_unlock(&aio_queue_latch);
+
+    do_aio_request_sync(req);
+    release_aio_slot();
+    complete_aio_request(req);
+  }
+  return NULL;
+}
+
+static int start_aio_thread_pool() {
+  aio_pool_stop = false;
+  for (int i = 0; i < AIO_WORKER_COUNT; i++) {
+    if (pthread_create(&aio_workers[i], NULL, aio_worker_func, NULL) != 0) {
+      pthread_mutex_lock(&aio_queue_latch);
+      aio_pool_stop = true;
+      pthread_cond_broadcast(&aio_queue_cond);
+      pthread_mutex_unlock(&aio_queue_latch);
+      for (int j = 0; j < i; j++) {
+        pthread_join(aio_workers[j], NULL);
+      }
+      return FAILURE;
+    }
+  }
+  return SUCCESS;
+}
+
+/**
+ * @brief Start the async I/O engine: io_uring if the kernel allows it,
+ * otherwise a pread/pwrite thread pool. Without an engine every request is
+ * served synchronously by the submitting thread
+ */
+int file_aio_init(void) {
+  if (aio_backend != AIO_SYNC) {
+    return SUCCESS;
+  }
+
+#ifdef HAVE_IO_URING
+  if (setup_uring() == SUCCESS) {
+    if (pthread_create(&uring_reaper, NULL, uring_reaper_func, NULL) == 0) {
+      aio_backend = AIO_IO_URING;
+      return SUCCESS;
+    }
+    unmap_uring();
+  }
+#endif
+
+  if (start_aio_thread_pool() == SUCCESS) {
+    aio_backend = AIO_THREAD_POOL;
+    return SUCCESS;
+  }
+  return FAILURE;
+}
+
+/**
+ * @brief Wait for every submitted request and stop the engine
+ */
+void file_aio_shutdown(void) {
+  switch (aio_backend) {
+#ifdef HAVE_IO_URING
+    case AIO_IO_URING:
+      // NOP은 앞선 요청들의 CQE 뒤에 도착하지 않을 수 있으므로
+      // 먼저 모든 slot이 반환될 때까지 기다림
+      pthread_mutex_lock(&aio_submit_latch);
+      while (aio_in_flight > 0) {
+        pthread_cond_wait(&aio_slot_cond, &aio_submit_latch);
+      }
+      pthread_mutex_unlock(&aio_submit_latch);
+
+      acquire_aio_slots(1);
+      uring_push(IORING_OP_NOP, NULL);
+      uring_enter_submit(1);
+      pthread_mutex_unlock(&aio_submit_latch);
+      pthread_join(uring_reaper, NULL);
+      unmap_uring();
+      break;
+#endif
+    case AIO_THREAD_POOL:
+      pthread_mutex_lock(&aio_queue_latch);
+      aio_pool_stop = true;
+      pthread_cond_broadcast(&aio_queue_cond);
+      pthread_mutex_unlock(&aio_queue_latch);
+      for (int i = 0; i < AIO_WORKER_COUNT; i++) {
+        pthread_join(aio_workers[i], NULL);
+      }
+      break;
+    default:
+      break;
+  }
+  aio_backend = AIO_SYNC;
+}
+
+AioBackend file_aio_backend(void) { return aio_backend; }
+
+/**
+ * helper function for file_aio_submit and file_aio_submit_nowait
+ * slot count개와 aio_submit_latch를 잡은 상태에서 요청을 넘기고 latch를 놓음
+ */
+static void push_aio_requests(aio_req_t* reqs[], int count) {
+#ifdef HAVE_IO_URING
+  if (aio_backend == AIO_IO_URING) {
+    for (int i = 0; i < count; i++) {
+      uring_push(reqs[i]->is_write ? IORING_OP_WRITE : IORING_OP_READ,
+                 reqs[i]);
+    }
+    uring_enter_submit(count);
+    pthread_mutex_unlock(&aio_submit_latch);
+    return;
+  }
+#endif
+  pthread_mutex_unlock(&aio_submit_latch);
+
+  pthread_mutex_lock(&aio_queue_latch);
+  for (int i = 0; i < count; i++) {
+    aio_queue.push_back(reqs[i]);
+  }
+  pthread_cond_broadcast(&aio_queue_cond);
+  pthread_mutex_unlock(&aio_queue_latch);
+}
+
+/**
+ * @brief Submit requests prepared with file_aio_prep_read/write
+ * io_uring backend hands the whole batch to the kernel in one syscall
+ * AIO_QUEUE_DEPTH개씩 끊어서 slot을 한번에 잡고 바로 제출
+ */
+void file_aio_submit(aio_req_t* reqs[], int count) {
+  if (aio_backend == AIO_SYNC) {
+    for (int i = 0; i < count; i++) {
+      do_aio_request_sync(reqs[i]);
+      complete_aio_request(reqs[i]);
+    }
+    return;
+  }
+
+  for (int start = 0; start < count; start += AIO_QUEUE_DEPTH) {
+    int chunk = count - start < AIO_QUEUE_DEPTH ? count - start
+                                                : AIO_QUEUE_DEPTH;
+    acquire_aio_slots(chunk);
+    push_aio_requests(reqs + start, chunk);
+  }
+}
+
+/**
+ * @brief file_aio_submit without waiting for queue slots
+ * slot이 모자라면 호출한 스레드에서 동기로 처리하고 완료 처리까지 함
+ * partition latch처럼 다른 스레드가 기다릴 수 있는 latch를 잡고 부를 때
+ */
+void file_aio_submit_nowait(aio_req_t* reqs[], int count) {
+  if (aio_backend != AIO_SYNC && count <= AIO_QUEUE_DEPTH &&
+      try_acquire_aio_slots(count)) {
+    push_aio_requests(reqs, count);
+    return;
+  }
+  for (int i = 0; i < count; i++) {
+    do_aio_request_sync(reqs[i]);
+    complete_aio_request(reqs[i]);
+  }
+}
+
+/**
+ * @brief Block until a request submitted without on_complete is done
+ */
+void file_aio_wait(aio_req_t* req) {
+  pthread_mutex_lock(&aio_done_latch);
+  while (!req->done) {
+    pthread_cond_wait(&aio_done_cond, &aio_done_latch);
+  }
+  pthread_mutex_unlock(&aio_done_latch);
+}
@@ -0,0 +1,162 @@
+#include "page_table.h"
+
+#include <cstdlib>
+
+uint64_t hash_page_key(page_key_t key) { return key * 0x9E3779B97F4A7C15ULL; }
+
+/**
+ * helper function for page_table_find, insert and erase
+ */
+static inline uint64_t home_slot(const page_table_t* table, page_key_t key) {
+  return hash_page_key(key) >> table->shift;
+}
+
+/**
+ * slot 읽기/쓰기 helper
+ * writer는 partition latch 아래에서만 쓰지만 unlatched reader가 동시에 읽을
+ * 수 있으므로 relaxed atomic으로 접근 (x86에서는 일반 load/store와 같음)
+ */
+static inline page_key_t load_key(const page_table_slot_t* slot) {
+  return __atomic_load_n(&slot->key, __ATOMIC_RELAXED);
+}
+
+static inline frame_idx_t load_frame(const page_table_slot_t* slot) {
+  return __atomic_load_n(&slot->frame_idx, __ATOMIC_RELAXED);
+}
+
+static inline void store_slot(page_table_slot_t* slot, page_key_t key,
+                              frame_idx_t frame_idx) {
+  __atomic_store_n(&slot->frame_idx, frame_idx, __ATOMIC_RELAXED);
+  __atomic_store_n(&slot->key, key, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Allocate slots for up to max_entries keys
+ * If success, return 0. Otherwise, return non-zero value
+ */
+int page_table_init(page_table_t* table, int max_entries) {
+  uint64_t capacity = 2;
+  int log2_capacity = 1;
+  while (capacity < (uint64_t)max_entries * 2) {
+    capacity <<= 1;
+    log2_capacity++;
+  }
+
+  table->slots =
+      (page_table_slot_t*)malloc(capacity * sizeof(page_table_slot_t));
+  if (table->slots == NULL) {
+    return FAILURE;
+  }
+  table->mask = capacity - 1;
+  table->shift = 64 - log2_capacity;
+  page_table_clear(table);
+
+  return SUCCESS;
+}
+
+void page_table_destroy(page_table_t* table) {
+  free(table->slots);
+  table->slots = NULL;
+  table->mask = 0;
+  table->size = 0;
+}
+
+void page_table_clear(page_table_t* table) {
+  for (uint64_t index = 0; index <= table->mask; index++) {
+    store_slot(&table->slots[index], PAGE_KEY_EMPTY, INVALID_FRAME);
+  }
+  table->size = 0;
+}
+
+/**
+ * @return frame index of key, INVALID_FRAME if not resident
+ */
+frame_idx_t page_table_find(const page_table_t* table, page_key_t key) {
+  uint64_t index = home_slot(table, key);
+
+  while (true) {
+    const page_table_slot_t* slot = &table->slots[index];
+    page_key_t slot_key = load_key(slot);
+    if (slot_key == key) {
+      return load_frame(slot);
+    }
+    if (slot_key == PAGE_KEY_EMPTY) {
+      return INVALID_FRAME;
+    }
+    index = (index + 1) & table->mask;
+  }
+}
+
+/**
+ * partition latch 없이 찾기
+ * insert/erase와 겹치면 틀린 frame을 주거나 있는 key를 놓칠 수 있으므로
+ * 호출한 쪽이 pin을 잡은 뒤 bcb의 (table_id, page_num)으로 검증해야 함
+ * 동시 backward shift로 체인이 계속 밀려도 끝나도록 capacity만큼만 탐색
+ */
+frame_idx_t page_table_find_unlatched(const page_table_t* table,
+                                      page_key_t key) {
+  uint64_t index = home_slot(table, key);
+
+  for (uint64_t probes = 0; probes <= table->mask; probes++) {
+    const page_table_slot_t* slot = &table->slots[index];
+    page_key_t slot_key = load_key(slot);
+    if (slot_key == key) {
+      return load_frame(slot);
+    }
+    if (slot_key == PAGE_KEY_EMPTY) {
+      return INVALID_FRAME;
+    }
+    index = (index + 1) & table->mask;
+  }
+  return INVALID_FRAME;
+}
+
+/**
+ * key가 이미 있으면 frame index만 갱신
+ * 크기는 init에서 정한 max_entries를 넘지 않는다고 가정 (프레임 수로 제한됨)
+ */
+void page_table_insert(page_table_t* table, page_key_t key,
+                       frame_idx_t frame_idx) {
+  uint64_t index = home_slot(table, key);
+
+  while (table->slots[index].key != PAGE_KEY_EMPTY &&
+         table->slots[index].key != key) {
+    index = (index + 1) & table->mask;
+  }
+  if (table->slots[index].key == PAGE_KEY_EMPTY) {
+    table->size++;
+  }
+  store_slot(&table->slots[index], key, frame_idx);
+}
+
+/**
+ * tombstone 없이 뒤따르는 slot들을 당겨와서 probe 체인을 유지 (backward shift)
+ * @return true if key was present
+ */
+bool page_table_erase(page_table_t* table, page_key_t key) {
+  uint64_t index = home_slot(table, key);
+
+  while (table->slots[index].key != key) {
+    if (table->slots[index].key == PAGE_KEY_EMPTY) {
+      return false;
+    }
+    index = (index + 1) & table->mask;
+  }
+
+  uint64_t hole = index;
+  uint64_t next = (hole + 1) & table->mask;
+  while (table->slots[next].key != PAGE_KEY_EMPTY) {
+    // next의 원래 위치에서 hole까지의 거리가 next까지의 거리 이하면 당겨옴
+    uint64_t home = home_slot(table, table->slots[next].key);
+    if (((hole - home) & table->mask) < ((next - home) & table->mask)) {
+      store_slot(&table->slots[hole], table->slots[next].key,
+                 table->slots[next].frame_idx);
+      hole = next;
+    }
+    next = (next + 1) & table->mask;
+  }
+  store_slot(&table->slots[hole], PAGE_KEY_EMPTY, INVALID_FRAME);
+  table->size--;
+
+  return true;
+}
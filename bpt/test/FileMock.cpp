@@ -7,11 +7,17 @@
 page_t FileMock::MOCK_PAGES[MAX_MOCK_PAGES];
 int FileMock::current_fd = 100;
 pagenum_t FileMock::mock_next_page_num = HEADER_PAGE_POS + 1;
+int FileMock::read_call_count = 0;
+int FileMock::write_call_count = 0;
+int FileMock::sync_call_count = 0;
 
 void FileMock::setup_data_store() {
   std::memset(MOCK_PAGES, 0, sizeof(page_t) * MAX_MOCK_PAGES);
 
   mock_next_page_num = HEADER_PAGE_POS + 1;
+  read_call_count = 0;
+  write_call_count = 0;
+  sync_call_count = 0;
 }
 
 void FileMock::init_header_page_for_mock() {
@@ -65,6 +71,7 @@ void file_read_page(int fd, pagenum_t pagenum, page_t* dest) {
       pagenum >= MAX_MOCK_PAGES) {
     return;
   }
+  FileMock::read_call_count++;
   std::memcpy(dest, &FileMock::MOCK_PAGES[pagenum], PAGE_SIZE);
 }
 
@@ -73,7 +80,81 @@ void file_write_page(int fd, pagenum_t pagenum, const page_t* src) {
       pagenum >= MAX_MOCK_PAGES) {
     return;
   }
+  FileMock::write_call_count++;
   std::memcpy(&FileMock::MOCK_PAGES[pagenum], src, PAGE_SIZE);
 }
 
+void file_read_pages(int fd, pagenum_t start_pagenum, page_t* dests[],
+                     int count) {
+  if (fd != FileMock::current_fd || start_pagenum + count > MAX_MOCK_PAGES) {
+    return;
+  }
+  FileMock::read_call_count++;
+  for (int i = 0; i < count; i++) {
+    std::memcpy(dests[i], &FileMock::MOCK_PAGES[start_pagenum + i], PAGE_SIZE);
+  }
+}
+
+void file_write_pages(int fd, pagenum_t start_pagenum,
+                      const page_t* const srcs[], int count) {
+  if (fd != FileMock::current_fd || start_pagenum + count > MAX_MOCK_PAGES) {
+    return;
+  }
+  FileMock::write_call_count++;
+  for (int i = 0; i < count; i++) {
+    std::memcpy(&FileMock::MOCK_PAGES[start_pagenum + i], srcs[i], PAGE_SIZE);
+  }
+}
+
+void file_set_sync_mode(SyncMode mode) {}
+
+SyncMode file_get_sync_mode(void) { return SYNC_DEFERRED; }
+
+void file_sync(int fd) {
+  if (fd != FileMock::current_fd) {
+    return;
+  }
+  FileMock::sync_call_count++;
+}
+
+// async requests complete inline, one submit counts as one read/write call
+int file_aio_init(void) { return SUCCESS; }
+
+void file_aio_shutdown(void) {}
+
+AioBackend file_aio_backend(void) { return AIO_SYNC; }
+
+void file_aio_submit(aio_req_t* reqs[], int count) {
+  bool has_read = false;
+  bool has_write = false;
+
+  for (int i = 0; i < count; i++) {
+    aio_req_t* req = reqs[i];
+    if (req->fd == FileMock::current_fd && req->pagenum < MAX_MOCK_PAGES) {
+      if (req->is_write) {
+        std::memcpy(&FileMock::MOCK_PAGES[req->pagenum], req->buf, PAGE_SIZE);
+        has_write = true;
+      } else {
+        std::memcpy(req->buf, &FileMock::MOCK_PAGES[req->pagenum], PAGE_SIZE);
+        has_read = true;
+      }
+    }
+
+    if (req->on_complete != NULL) {
+      req->on_complete(req);
+    } else {
+      req->done = true;
+    }
+  }
+
+  FileMock::read_call_count += has_read;
+  FileMock::write_call_count += has_write;
+}
+
+void file_aio_submit_nowait(aio_req_t* reqs[], int count) {
+  file_aio_submit(reqs, count);
+}
+
+void file_aio_wait(aio_req_t* req) {}
+
 #endif
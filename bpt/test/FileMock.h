@@ -19,6 +19,9 @@ class FileMock {
   static page_t MOCK_PAGES[MAX_MOCK_PAGES];
   static int current_fd;
   static pagenum_t mock_next_page_num;
+  static int read_call_count;   // file_read_page(s) calls, aio submits
+  static int write_call_count;  // file_write_page(s) calls, aio submits
+  static int sync_call_count;   // file_sync calls
 
   static void setup_data_store();
   static void init_header_page_for_mock();
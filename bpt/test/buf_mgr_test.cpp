@@ -2,17 +2,19 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <random>
+#include <unordered_map>
 
 #include "FileMock.h"
+#include "db_api.h"
 #include "gtest/gtest.h"
 
 extern buffer_manager_t buf_mgr;
 
-static void init_buffer_manager(int buf_size) {
+static void init_buffer_manager(int buf_size, ReplacementPolicy policy) {
   buf_mgr.frames_size = buf_size;
   buf_mgr.frames =
       (buf_ctl_block_t*)std::calloc(buf_size, sizeof(buf_ctl_block_t));
-  buf_mgr.clock_hand = 0;
 
   for (int i = 0; i < buf_size; ++i) {
     buf_mgr.frames[i].frame = std::calloc(1, PAGE_SIZE);
@@ -23,10 +25,11 @@ static void init_buffer_manager(int buf_size) {
     buf_mgr.frames[i].ref_bit = false;
   }
 
-  constexpr int MAX_TABLES = MAX_TABLE_COUNT + 1;
-  for (int i = 0; i < MAX_TABLES; ++i) {
-    buf_mgr.page_table[i].clear();
-  }
+  init_buf_partitions(buf_size, policy);
+}
+
+static void init_buffer_manager(int buf_size) {
+  init_buffer_manager(buf_size, REPLACE_CLOCK);
 }
 
 static void shutdown_buffer_manager() {
@@ -35,10 +38,7 @@ static void shutdown_buffer_manager() {
   }
   std::free(buf_mgr.frames);
 
-  constexpr int MAX_TABLES = 11;
-  for (int i = 0; i < MAX_TABLES; ++i) {
-    buf_mgr.page_table[i].clear();
-  }
+  clear_buf_partitions();
 }
 
 // GTest Fixture 정의
@@ -103,7 +103,7 @@ TEST_F(BufferManagerTest, LoadPageIntoBufferAndEviction) {
     buf_mgr.frames[i].ref_bit = false;
   }
 
-  buf_mgr.clock_hand = 0;
+  buf_mgr.partitions[0].clock_hand = 0;
 
   pagenum_t dirty_page_num = allocated_pages[0];
   frame_idx_t dirty_fidx = get_frame_index_by_page(TEST_TID, dirty_page_num);
@@ -138,3 +138,448 @@ TEST_F(BufferManagerTest, FreePageInBufferAndDisk) {
 
   ASSERT_EQ(std::memcmp(&FileMock::MOCK_PAGES[pnum], &zero_page, PAGE_SIZE), 0);
 }
+
+static void make_mock_leaf(pagenum_t page_num, pagenum_t right_sibling) {
+  leaf_page_t* leaf = (leaf_page_t*)&FileMock::MOCK_PAGES[page_num];
+  leaf->is_leaf = 1;
+  leaf->right_sibling_page_num = right_sibling;
+}
+
+TEST_F(BufferManagerTest, SequentialMissesStartAndGrowReadAhead) {
+  shutdown_buffer_manager();
+  init_buffer_manager(64);
+  header_page_t* mock_header = (header_page_t*)&FileMock::MOCK_PAGES[0];
+  mock_header->num_of_pages = 40;
+  for (pagenum_t pnum = 1; pnum < 40; pnum++) {
+    *(pagenum_t*)FileMock::MOCK_PAGES[pnum].data = pnum;
+  }
+
+  read_header_page(FileMock::current_fd, TEST_TID);
+  unpin(TEST_TID, HEADER_PAGE_POS);
+  ASSERT_EQ(FileMock::read_call_count, 1);  // no read-ahead after the header
+
+  read_buffer(FileMock::current_fd, TEST_TID, 1);
+  unpin(TEST_TID, 1);
+  ASSERT_EQ(FileMock::read_call_count, 2);  // one miss is not a stream yet
+
+  // second sequential miss reads pages 3..6 with a single vectored read
+  read_buffer(FileMock::current_fd, TEST_TID, 2);
+  unpin(TEST_TID, 2);
+  ASSERT_EQ(FileMock::read_call_count, 4);
+  for (pagenum_t pnum = 3; pnum < 3 + READAHEAD_INIT_WINDOW; pnum++) {
+    frame_idx_t fidx = get_frame_index_by_page(TEST_TID, pnum);
+    ASSERT_NE(fidx, INVALID_FRAME);
+    ASSERT_EQ(buf_mgr.frames[fidx].pin_count, 0);
+    ASSERT_EQ(*(pagenum_t*)((page_t*)buf_mgr.frames[fidx].frame)->data, pnum);
+  }
+
+  // using the read-ahead pages keeps the stream going with a doubled window
+  for (pagenum_t pnum = 3; pnum <= 4; pnum++) {
+    read_buffer(FileMock::current_fd, TEST_TID, pnum);
+    unpin(TEST_TID, pnum);
+  }
+  ASSERT_EQ(FileMock::read_call_count, 5);
+  ASSERT_NE(get_frame_index_by_page(TEST_TID, 4 + 2 * READAHEAD_INIT_WINDOW),
+            INVALID_FRAME);
+  ASSERT_EQ(get_frame_index_by_page(TEST_TID, 5 + 2 * READAHEAD_INIT_WINDOW),
+            INVALID_FRAME);
+
+  buffer_stats_t stats;
+  get_buffer_stats(&stats);
+  ASSERT_EQ(stats.misses, 3);  // header, 1, 2
+  ASSERT_EQ(stats.prefetched, 2 + 2 * READAHEAD_INIT_WINDOW);  // pages 3..12
+  ASSERT_EQ(stats.prefetch_hits, 2);
+  ASSERT_EQ(stats.prefetch_wasted, 0);
+}
+
+TEST_F(BufferManagerTest, RandomMissesDoNotReadAhead) {
+  shutdown_buffer_manager();
+  init_buffer_manager(64);
+  header_page_t* mock_header = (header_page_t*)&FileMock::MOCK_PAGES[0];
+  mock_header->num_of_pages = 40;
+
+  read_header_page(FileMock::current_fd, TEST_TID);
+  unpin(TEST_TID, HEADER_PAGE_POS);
+
+  pagenum_t pages[] = {10, 3, 25, 17, 30, 5};
+  for (pagenum_t pnum : pages) {
+    read_buffer(FileMock::current_fd, TEST_TID, pnum);
+    unpin(TEST_TID, pnum);
+  }
+
+  ASSERT_EQ(FileMock::read_call_count, 1 + 6);
+  buffer_stats_t stats;
+  get_buffer_stats(&stats);
+  ASSERT_EQ(stats.prefetched, 0);
+}
+
+TEST_F(BufferManagerTest, LeafChainReadAheadFollowsRightSiblings) {
+  shutdown_buffer_manager();
+  init_buffer_manager(64);
+  header_page_t* mock_header = (header_page_t*)&FileMock::MOCK_PAGES[0];
+  mock_header->num_of_pages = 40;
+  // leaves 5 -> 20 -> 11 -> 30, not adjacent on disk
+  make_mock_leaf(5, 20);
+  make_mock_leaf(20, 11);
+  make_mock_leaf(11, 30);
+  make_mock_leaf(30, PAGE_NULL);
+
+  read_header_page(FileMock::current_fd, TEST_TID);
+  unpin(TEST_TID, HEADER_PAGE_POS);
+  read_buffer(FileMock::current_fd, TEST_TID, 5);
+  unpin(TEST_TID, 5);
+  ASSERT_EQ(get_frame_index_by_page(TEST_TID, 20), INVALID_FRAME);
+
+  // 20 is the right sibling of 5, so the next leaf is read ahead
+  read_buffer(FileMock::current_fd, TEST_TID, 20);
+  unpin(TEST_TID, 20);
+  ASSERT_NE(get_frame_index_by_page(TEST_TID, 11), INVALID_FRAME);
+  ASSERT_EQ(get_frame_index_by_page(TEST_TID, 12), INVALID_FRAME);
+
+  read_buffer(FileMock::current_fd, TEST_TID, 11);
+  unpin(TEST_TID, 11);
+  frame_idx_t fidx = get_frame_index_by_page(TEST_TID, 30);
+  ASSERT_NE(fidx, INVALID_FRAME);
+
+  // 30 leaves the buffer without being used
+  clear_frame_and_page_table(TEST_TID, 30, fidx);
+
+  buffer_stats_t stats;
+  get_buffer_stats(&stats);
+  ASSERT_EQ(stats.prefetched, 2);
+  ASSERT_EQ(stats.prefetch_hits, 1);
+  ASSERT_EQ(stats.prefetch_wasted, 1);
+}
+
+TEST_F(BufferManagerTest, FlushTableBufferCoalescesAdjacentDirtyFrames) {
+  std::vector<pagenum_t> pages;
+  for (int i = 0; i < 4; ++i) {
+    allocated_page_info_t info =
+        make_and_pin_page(FileMock::current_fd, TEST_TID);
+    memset(info.page_ptr, 'a' + i, PAGE_SIZE);
+    mark_dirty(TEST_TID, info.page_num);
+    unpin(TEST_TID, info.page_num);
+    pages.push_back(info.page_num);
+  }
+
+  FileMock::write_call_count = 0;
+  flush_table_buffer(FileMock::current_fd, TEST_TID);
+
+  // header page(0) and pages 1..4 are adjacent
+  ASSERT_EQ(FileMock::write_call_count, 1);
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(FileMock::MOCK_PAGES[pages[i]].data[0], 'a' + i);
+    frame_idx_t fidx = get_frame_index_by_page(TEST_TID, pages[i]);
+    ASSERT_FALSE(buf_mgr.frames[fidx].is_dirty);
+  }
+}
+
+TEST_F(BufferManagerTest, DbSyncFlushesDirtyPagesAndSyncsFile) {
+  table_infos[TEST_TID].fd = FileMock::current_fd;
+
+  allocated_page_info_t info =
+      make_and_pin_page(FileMock::current_fd, TEST_TID);
+  memset(info.page_ptr, 'z', PAGE_SIZE);
+  mark_dirty(TEST_TID, info.page_num);
+  unpin(TEST_TID, info.page_num);
+
+  ASSERT_EQ(db_sync(TEST_TID), SUCCESS);
+
+  ASSERT_EQ(FileMock::MOCK_PAGES[info.page_num].data[0], 'z');
+  ASSERT_EQ(FileMock::sync_call_count, 1);
+
+  table_infos[TEST_TID].fd = -1;
+  ASSERT_NE(db_sync(TEST_TID), SUCCESS);
+}
+
+// 다른 스레드가 pin 중인 frame은 건너뛰고 dirty로 남겨 둠
+TEST_F(BufferManagerTest, FlushSkipsPinnedFramesAndKeepsThemDirty) {
+  table_infos[TEST_TID].fd = FileMock::current_fd;
+
+  allocated_page_info_t info =
+      make_and_pin_page(FileMock::current_fd, TEST_TID);
+  memset(info.page_ptr, 'p', PAGE_SIZE);
+  mark_dirty(TEST_TID, info.page_num);
+
+  flush_table_buffer(FileMock::current_fd, TEST_TID);
+  int frame_index = get_frame_index_by_page(TEST_TID, info.page_num);
+  ASSERT_TRUE(buf_mgr.frames[frame_index].is_dirty);
+  ASSERT_NE(FileMock::MOCK_PAGES[info.page_num].data[0], 'p');
+
+  unpin(TEST_TID, info.page_num);
+  flush_table_buffer(FileMock::current_fd, TEST_TID);
+  ASSERT_FALSE(buf_mgr.frames[frame_index].is_dirty);
+  ASSERT_EQ(buf_mgr.frames[frame_index].pin_count, 0);
+  ASSERT_EQ(FileMock::MOCK_PAGES[info.page_num].data[0], 'p');
+
+  table_infos[TEST_TID].fd = -1;
+}
+
+TEST_F(BufferManagerTest, EvictedDirtyPageIsWrittenBackBeforeReload) {
+  table_infos[TEST_TID].fd = FileMock::current_fd;
+  read_header_page(FileMock::current_fd, TEST_TID);
+  unpin(TEST_TID, HEADER_PAGE_POS);
+
+  allocated_page_info_t info =
+      make_and_pin_page(FileMock::current_fd, TEST_TID);
+  info.page_ptr->data[0] = 'w';
+  mark_dirty(TEST_TID, info.page_num);
+  unpin(TEST_TID, info.page_num);
+
+  // 나머지 프레임을 채워서 dirty 페이지를 쫓아냄
+  reset_page_cleaner_stats();
+  for (int i = 0; i < BUFFER_SIZE; ++i) {
+    buf_mgr.frames[i].ref_bit = false;
+  }
+  buf_mgr.partitions[0].clock_hand = get_frame_index_by_page(TEST_TID, info.page_num);
+  pagenum_t new_page_num = info.page_num + 1;
+  load_page_into_buffer(FileMock::current_fd, TEST_TID, new_page_num);
+  unpin(TEST_TID, new_page_num);
+
+  ASSERT_EQ(get_frame_index_by_page(TEST_TID, info.page_num), INVALID_FRAME);
+  ASSERT_FALSE(is_write_back_pending(TEST_TID, info.page_num));
+  page_cleaner_stats_t stats;
+  get_page_cleaner_stats(&stats);
+  ASSERT_EQ(stats.stalls, 1u);  // foreground가 직접 write-back
+  ASSERT_EQ(FileMock::MOCK_PAGES[info.page_num].data[0], 'w');
+
+  page_t* reloaded = read_buffer(FileMock::current_fd, TEST_TID, info.page_num);
+  ASSERT_EQ(reloaded->data[0], 'w');
+  unpin(TEST_TID, info.page_num);
+
+  table_infos[TEST_TID].fd = -1;
+}
+
+TEST_F(BufferManagerTest, UnlatchedPinRejectsEvictingAndRemappedFrames) {
+  allocated_page_info_t info =
+      make_and_pin_page(FileMock::current_fd, TEST_TID);
+  frame_idx_t fidx = get_frame_index_by_page(TEST_TID, info.page_num);
+  buf_ctl_block_t* bcb = &buf_mgr.frames[fidx];
+  unpin(TEST_TID, info.page_num);
+
+  // hit은 latch 없이 pin
+  ASSERT_EQ(pin_resident_page(TEST_TID, info.page_num), bcb);
+  ASSERT_EQ(bcb->pin_count, 1);
+
+  // pin된 프레임은 clock이 가져가지 못함
+  ASSERT_FALSE(try_claim_for_eviction(bcb));
+  unpin_bcb(bcb);
+  unpin_bcb(bcb);  // 0 아래로 내려가지 않음
+  ASSERT_EQ(bcb->pin_count, 0);
+
+  // clock 소유인 프레임은 pin 실패
+  ASSERT_TRUE(try_claim_for_eviction(bcb));
+  ASSERT_EQ(pin_resident_page(TEST_TID, info.page_num), nullptr);
+  ASSERT_EQ(bcb->pin_count, PIN_EVICTING);
+
+  // 매핑이 남아있어도 프레임이 다른 페이지로 바뀌었으면 pin을 되돌림
+  set_new_bcb(TEST_TID, info.page_num + 1, fidx, (page_t*)bcb->frame);
+  unpin_bcb(bcb);
+  ASSERT_EQ(pin_resident_page(TEST_TID, info.page_num), nullptr);
+  ASSERT_EQ(bcb->pin_count, 0);
+}
+
+TEST_F(BufferManagerTest, OptimisticReadFailsAfterExclusiveLatchOrEviction) {
+  allocated_page_info_t info =
+      make_and_pin_page(FileMock::current_fd, TEST_TID);
+  frame_idx_t fidx = get_frame_index_by_page(TEST_TID, info.page_num);
+  buf_ctl_block_t* bcb = &buf_mgr.frames[fidx];
+  unpin(TEST_TID, info.page_num);
+
+  // hit은 pin도 latch도 잡지 않음
+  uint64_t version;
+  ASSERT_EQ(read_buffer_optimistic(FileMock::current_fd, TEST_TID,
+                                   info.page_num, &version),
+            bcb);
+  ASSERT_EQ(bcb->pin_count, 0);
+  ASSERT_EQ(version % 2, 0u);
+
+  // shared latch는 version을 바꾸지 않음
+  read_buffer_with_txn(FileMock::current_fd, TEST_TID, info.page_num,
+                       LATCH_SHARED);
+  ASSERT_TRUE(validate_page_version(bcb, version));
+  unlatch_and_unpin(bcb, TEST_TID, info.page_num);
+
+  // exclusive latch는 잡은 동안에도 놓은 뒤에도 검증 실패
+  read_buffer_with_txn(FileMock::current_fd, TEST_TID, info.page_num,
+                       LATCH_EXCLUSIVE);
+  ASSERT_FALSE(validate_page_version(bcb, version));
+  unlatch_and_unpin(bcb, TEST_TID, info.page_num);
+  ASSERT_FALSE(validate_page_version(bcb, version));
+  ASSERT_EQ(read_buffer_optimistic(FileMock::current_fd, TEST_TID,
+                                   info.page_num, &version),
+            bcb);
+  ASSERT_EQ(version % 2, 0u);
+
+  // clock이 프레임을 가져가면 검증 실패, 다시 읽으면 다른 프레임에 올림
+  ASSERT_TRUE(try_claim_for_eviction(bcb));
+  evict_frame(get_partition(TEST_TID, info.page_num), fidx);
+  set_new_bcb(TEST_TID, info.page_num + 1, fidx, (page_t*)bcb->frame);
+  unpin_bcb(bcb);
+  ASSERT_FALSE(validate_page_version(bcb, version));
+  buf_ctl_block_t* reloaded = read_buffer_optimistic(
+      FileMock::current_fd, TEST_TID, info.page_num, &version);
+  ASSERT_NE(reloaded, bcb);
+  ASSERT_EQ(reloaded->page_num, info.page_num);
+  ASSERT_TRUE(validate_page_version(reloaded, version));
+}
+
+TEST_F(BufferManagerTest, PageCleanerWritesUnpinnedDirtyFramesInOneBatch) {
+  table_infos[TEST_TID].fd = FileMock::current_fd;
+  read_header_page(FileMock::current_fd, TEST_TID);
+  unpin(TEST_TID, HEADER_PAGE_POS);
+  reset_page_cleaner_stats();
+
+  pagenum_t pages[3];
+  for (int i = 0; i < 3; ++i) {
+    allocated_page_info_t info =
+        make_and_pin_page(FileMock::current_fd, TEST_TID);
+    info.page_ptr->data[0] = 'a' + i;
+    mark_dirty(TEST_TID, info.page_num);
+    pages[i] = info.page_num;
+  }
+  // 마지막 페이지는 pin된 채로 두면 건너뜀
+  unpin(TEST_TID, pages[0]);
+  unpin(TEST_TID, pages[1]);
+
+  int write_calls_before = FileMock::write_call_count;
+  ASSERT_EQ(clean_partition(&buf_mgr.partitions[0], 100), 3);  // header 포함
+
+  ASSERT_EQ(FileMock::write_call_count, write_calls_before + 1);
+  for (int i = 0; i < 2; ++i) {
+    frame_idx_t fidx = get_frame_index_by_page(TEST_TID, pages[i]);
+    ASSERT_FALSE(buf_mgr.frames[fidx].is_dirty);
+    ASSERT_EQ(buf_mgr.frames[fidx].pin_count, 0);
+    ASSERT_EQ(FileMock::MOCK_PAGES[pages[i]].data[0], 'a' + i);
+  }
+  frame_idx_t pinned_fidx = get_frame_index_by_page(TEST_TID, pages[2]);
+  ASSERT_TRUE(buf_mgr.frames[pinned_fidx].is_dirty);
+  ASSERT_EQ(buf_mgr.frames[pinned_fidx].pin_count, 1);
+
+  page_cleaner_stats_t stats;
+  get_page_cleaner_stats(&stats);
+  ASSERT_EQ(stats.pages_written, 3u);
+  ASSERT_EQ(stats.stalls, 0u);
+
+  unpin(TEST_TID, pages[2]);
+  table_infos[TEST_TID].fd = -1;
+}
+
+TEST(BufferManagerArenaTest, InitDbPlacesFramesInOneAlignedArena) {
+  const int frame_count = 8;
+  ASSERT_EQ(init_db(frame_count), SUCCESS);
+
+  char* arena = (char*)buf_mgr.frame_arena;
+  ASSERT_NE(arena, nullptr);
+  ASSERT_EQ((uintptr_t)arena % PAGE_SIZE, 0u);
+  for (int i = 0; i < frame_count; ++i) {
+    ASSERT_EQ(buf_mgr.frames[i].frame, arena + (size_t)i * PAGE_SIZE);
+  }
+
+  ASSERT_EQ(shutdown_db(), SUCCESS);
+  ASSERT_EQ(buf_mgr.frame_arena, nullptr);
+}
+
+TEST(BufferPartitionTest, PagesAreCachedInTheirPartitionSlice) {
+  FileMock::init_header_page_for_mock();
+  init_buffer_manager(MIN_FRAMES_PER_PARTITION * 4);
+  ASSERT_EQ(buf_mgr.partition_count, 4);
+
+  for (pagenum_t pnum = 1; pnum < 100; ++pnum) {
+    frame_idx_t fidx = load_page_into_buffer(FileMock::current_fd, 1, pnum);
+    unpin(1, pnum);
+
+    buf_partition_t* partition = get_partition(1, pnum);
+    ASSERT_GE(fidx, partition->frame_begin);
+    ASSERT_LT(fidx, partition->frame_end);
+    ASSERT_EQ(get_frame_index_by_page(1, pnum), fidx);
+  }
+
+  shutdown_buffer_manager();
+}
+
+TEST(PageTableTest, RandomChurnMatchesUnorderedMap) {
+  const int max_entries = 64;
+  page_table_t table;
+  ASSERT_EQ(page_table_init(&table, max_entries), SUCCESS);
+
+  std::unordered_map<page_key_t, frame_idx_t> expected;
+  std::mt19937 rng(7);
+  for (int step = 0; step < 20000; ++step) {
+    page_key_t key = make_page_key(1 + rng() % 2, rng() % 200);
+    if (expected.count(key)) {
+      ASSERT_TRUE(page_table_erase(&table, key));
+      expected.erase(key);
+    } else if ((int)expected.size() < max_entries) {
+      frame_idx_t frame_idx = step % max_entries;
+      page_table_insert(&table, key, frame_idx);
+      expected[key] = frame_idx;
+    }
+
+    ASSERT_EQ(table.size, (int)expected.size());
+    page_key_t probe = make_page_key(1 + rng() % 2, rng() % 200);
+    auto it = expected.find(probe);
+    ASSERT_EQ(page_table_find(&table, probe),
+              it == expected.end() ? INVALID_FRAME : it->second);
+  }
+
+  for (auto& entry : expected) {
+    ASSERT_EQ(page_table_find(&table, entry.first), entry.second);
+  }
+  page_table_destroy(&table);
+}
+
+/**
+ * helper function for ReplacementPolicyTest
+ * 페이지를 한번 읽고 unpin, 읽기 전에 버퍼에 있었으면 true
+ */
+static bool touch_page(tableid_t table_id, pagenum_t page_num) {
+  bool hit = get_frame_index_by_page(table_id, page_num) != INVALID_FRAME;
+  read_buffer(FileMock::current_fd, table_id, page_num);
+  unpin(table_id, page_num);
+  return hit;
+}
+
+TEST(ReplacementPolicyTest, HotPagesSurviveLongScansUnder2QAndLruK) {
+  const tableid_t table_id = 1;
+  const int frame_count = 64;
+  const int hot_count = 8;
+  ReplacementPolicy policies[] = {REPLACE_CLOCK, REPLACE_2Q, REPLACE_LRU_K};
+  int hot_misses[3] = {0};
+
+  for (int p = 0; p < 3; ++p) {
+    FileMock::setup_data_store();
+    FileMock::init_header_page_for_mock();
+    init_buffer_manager(frame_count, policies[p]);
+
+    pagenum_t next_cold = 1 + hot_count;
+    // 짧은 scan 사이에 hot 페이지를 반복해서 읽어 hot으로 만듦
+    for (int round = 0; round < 3; ++round) {
+      for (pagenum_t hot = 1; hot <= hot_count; ++hot) {
+        touch_page(table_id, hot);
+      }
+      for (int i = 0; i < 20; ++i) {
+        touch_page(table_id, next_cold++);
+      }
+    }
+
+    // 버퍼보다 긴 scan 뒤에도 hot 페이지가 남아있는지
+    for (int round = 0; round < 2; ++round) {
+      for (int i = 0; i < frame_count + 36; ++i) {
+        touch_page(table_id, next_cold++);
+      }
+      for (pagenum_t hot = 1; hot <= hot_count; ++hot) {
+        if (!touch_page(table_id, hot)) {
+          hot_misses[p]++;
+        }
+      }
+    }
+    ASSERT_LT(next_cold, (pagenum_t)MAX_MOCK_PAGES);
+
+    shutdown_buffer_manager();
+  }
+
+  ASSERT_GT(hot_misses[0], 0);  // clock은 scan에 hot 페이지를 잃음
+  ASSERT_EQ(hot_misses[1], 0);
+  ASSERT_EQ(hot_misses[2], 0);
+}
@@ -4,8 +4,12 @@
 #define ENTRY_ORDER 17
 #define NON_HEADER_PAGE_RESERVED 3816
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <cstring>
+#include <random>
+#include <thread>
 
 #include "FileMock.h"
 #include "bpt.h"
@@ -18,7 +22,6 @@ static void init_buffer_manager(int buf_size) {
   buf_mgr.frames_size = buf_size;
   buf_mgr.frames =
       (buf_ctl_block_t*)std::calloc(buf_size, sizeof(buf_ctl_block_t));
-  buf_mgr.clock_hand = 0;
 
   for (int i = 0; i < buf_size; ++i) {
     buf_mgr.frames[i].frame = std::calloc(1, PAGE_SIZE);
@@ -29,10 +32,7 @@ static void init_buffer_manager(int buf_size) {
     buf_mgr.frames[i].ref_bit = false;
   }
 
-  constexpr int MAX_TABLES = MAX_TABLE_COUNT + 1;
-  for (int i = 0; i < MAX_TABLES; ++i) {
-    buf_mgr.page_table[i].clear();
-  }
+  init_buf_partitions(buf_size);
 }
 
 static void shutdown_buffer_manager() {
@@ -41,10 +41,7 @@ static void shutdown_buffer_manager() {
   }
   std::free(buf_mgr.frames);
 
-  constexpr int MAX_TABLES = 11;
-  for (int i = 0; i < MAX_TABLES; ++i) {
-    buf_mgr.page_table[i].clear();
-  }
+  clear_buf_partitions();
 }
 
 static leaf_page_t get_leaf_page(tableid_t table_id, pagenum_t pagenum) {
@@ -108,6 +105,68 @@ class DeleteTest : public ::testing::Test {
     char result_buf[VALUE_SIZE];
     return find(FileMock::current_fd, TEST_TID, key, result_buf) == SUCCESS;
   }
+
+  // 가장 왼쪽 leaf부터 right link를 따라가며 left link가 앞 leaf인지 확인
+  void expect_leaf_links() {
+    pagenum_t leaf_num = find_leaf(FileMock::current_fd, TEST_TID, INT64_MIN);
+    pagenum_t prev_num = PAGE_NULL;
+    int64_t prev_key = INT64_MIN;
+    while (leaf_num != PAGE_NULL) {
+      leaf_page_t leaf = get_leaf_page(TEST_TID, leaf_num);
+      ASSERT_EQ(prev_num, leaf.left_sibling_page_num) << leaf_num;
+      for (uint32_t i = 0; i < leaf.num_of_keys; i++) {
+        ASSERT_LT(prev_key, leaf_key(&leaf, i));
+        prev_key = leaf_key(&leaf, i);
+      }
+      prev_num = leaf_num;
+      leaf_num = leaf.right_sibling_page_num;
+    }
+  }
+
+  // level마다 right link가 다음 page를 가리키고 high key가 부모의 구분 key인지
+  void expect_high_keys() {
+    header_page_t header = get_header_page(TEST_TID);
+    ASSERT_EQ(1u, header.high_keys);
+    std::vector<std::vector<std::pair<pagenum_t, int64_t>>> levels;
+    if (header.root_page_num != PAGE_NULL) {
+      collect_level(header.root_page_num, 0, INT64_MAX, &levels);
+    }
+    for (auto& level : levels) {
+      for (size_t i = 0; i < level.size(); i++) {
+        internal_page_t node = get_internal_page(TEST_TID, level[i].first);
+        pagenum_t right =
+            node.is_leaf == LEAF
+                ? ((leaf_page_t*)&node)->right_sibling_page_num
+                : node.right_sibling_page_num;
+        if (i + 1 == level.size()) {
+          ASSERT_EQ(PAGE_NULL, right) << level[i].first;
+        } else {
+          ASSERT_EQ(level[i + 1].first, right) << level[i].first;
+          ASSERT_EQ(level[i].second, node.high_key) << level[i].first;
+        }
+      }
+    }
+  }
+
+  // page와 그 page의 위쪽 경계 key를 level별로 왼쪽부터
+  void collect_level(
+      pagenum_t page_num, size_t depth, int64_t upper,
+      std::vector<std::vector<std::pair<pagenum_t, int64_t>>>* levels) {
+    if (levels->size() <= depth) {
+      levels->resize(depth + 1);
+    }
+    (*levels)[depth].push_back({page_num, upper});
+    internal_page_t node = get_internal_page(TEST_TID, page_num);
+    if (node.is_leaf == LEAF) {
+      return;
+    }
+    for (int i = 0; i <= node.num_of_keys; i++) {
+      pagenum_t child_num =
+          i == 0 ? node.one_more_page_num : node.entries[i - 1].page_num;
+      int64_t child_upper = i < node.num_of_keys ? node.entries[i].key : upper;
+      collect_level(child_num, depth + 1, child_upper, levels);
+    }
+  }
 };
 
 /**
@@ -355,3 +414,373 @@ TEST_F(DeleteTest, StressTestManyDeletes) {
   header_page_t header = get_header_page(TEST_TID);
   ASSERT_EQ(header.root_page_num, PAGE_NULL);
 }
+
+static int next_sequential_record(void* ctx, int64_t* key, const char** value,
+                                  uint16_t* length) {
+  int64_t* remaining = (int64_t*)ctx;
+  static char buf[VALUE_SIZE];
+  if (remaining[0] == remaining[1]) {
+    return FAILURE;
+  }
+  *key = remaining[0]++;
+  snprintf(buf, VALUE_SIZE, "val%ld", *key);
+  *value = buf;
+  *length = strlen(buf) + 1;
+  return SUCCESS;
+}
+
+TEST_F(DeleteTest, BulkLoadedTreeDeletesAllKeys) {
+  const int NUM_KEYS = 300;
+  int64_t range[2] = {0, NUM_KEYS};
+  ASSERT_EQ(SUCCESS, bulk_load(FileMock::current_fd, TEST_TID,
+                               next_sequential_record, range, 100));
+
+  // leaf 150개, internal 10개, root: 3 level, 모든 internal page는 key가 있음
+  header_page_t header = get_header_page(TEST_TID);
+  internal_page_t root = get_internal_page(TEST_TID, header.root_page_num);
+  ASSERT_EQ(9, root.num_of_keys);
+  for (int i = 0; i <= root.num_of_keys; i++) {
+    pagenum_t child_num =
+        i == 0 ? root.one_more_page_num : root.entries[i - 1].page_num;
+    internal_page_t child = get_internal_page(TEST_TID, child_num);
+    ASSERT_EQ(INTERNAL, child.is_leaf);
+    ASSERT_EQ(header.root_page_num, child.parent_page_num);
+    ASSERT_GE(child.num_of_keys, MIN_KEYS);
+  }
+
+  std::vector<int64_t> keys;
+  for (int i = 0; i < NUM_KEYS; i++) {
+    keys.push_back(i);
+  }
+  std::mt19937 rng(3);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (int i = 0; i < NUM_KEYS; i++) {
+    ASSERT_EQ(SUCCESS, bpt_delete(FileMock::current_fd, TEST_TID, keys[i]));
+    if (i % 50 == 0) {
+      for (int j = i + 1; j < NUM_KEYS; j++) {
+        ASSERT_TRUE(key_exists(keys[j])) << keys[j];
+      }
+    }
+  }
+  header = get_header_page(TEST_TID);
+  ASSERT_EQ(header.root_page_num, PAGE_NULL);
+}
+
+TEST_F(DeleteTest, InsertBatchSplitsParentsAndDeletes) {
+  // 작은 tree의 한 leaf 범위에 key 100개, leaf 하나가 여러개로 나뉘며
+  // 부모도 여러번 split
+  insert_keys({0, 1000, 2000});
+  std::vector<int64_t> keys;
+  for (int64_t key = 1100; key > 1000; key--) {
+    keys.push_back(key);
+  }
+  std::vector<std::string> values;
+  std::vector<char*> value_ptrs;
+  for (int64_t key : keys) {
+    values.push_back("val" + std::to_string(key));
+  }
+  for (std::string& v : values) {
+    value_ptrs.push_back(&v[0]);
+  }
+  ASSERT_EQ(100, bpt_insert_batch(FileMock::current_fd, TEST_TID, keys.data(),
+                                  value_ptrs.data(), keys.size()));
+  keys.insert(keys.end(), {0, 1000, 2000});
+
+  std::mt19937 rng(4);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (size_t i = 0; i < keys.size(); i++) {
+    ASSERT_EQ(SUCCESS, bpt_delete(FileMock::current_fd, TEST_TID, keys[i]));
+    for (size_t j = i + 1; j < keys.size(); j++) {
+      ASSERT_TRUE(key_exists(keys[j])) << keys[j];
+    }
+  }
+  header_page_t header = get_header_page(TEST_TID);
+  ASSERT_EQ(header.root_page_num, PAGE_NULL);
+}
+
+TEST_F(DeleteTest, LeafLeftLinksFollowSplitsAndMerges) {
+  int64_t range[2] = {0, 100};
+  ASSERT_EQ(SUCCESS, bulk_load(FileMock::current_fd, TEST_TID,
+                               next_sequential_record, range, 100));
+  expect_leaf_links();
+  expect_high_keys();
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 100; key < 200; key++) {
+    keys.push_back(key);
+  }
+  std::mt19937 rng(6);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  insert_keys(keys);
+  expect_leaf_links();
+  expect_high_keys();
+
+  // batch split: 한 leaf 범위에 여러 leaf
+  std::vector<int64_t> batch_keys;
+  std::vector<std::string> values;
+  for (int64_t key = 1000; key < 1040; key++) {
+    batch_keys.push_back(key);
+    values.push_back("val" + std::to_string(key));
+  }
+  std::vector<char*> value_ptrs;
+  for (std::string& v : values) {
+    value_ptrs.push_back(&v[0]);
+  }
+  ASSERT_EQ(40, bpt_insert_batch(FileMock::current_fd, TEST_TID,
+                                 batch_keys.data(), value_ptrs.data(),
+                                 batch_keys.size()));
+  expect_leaf_links();
+  expect_high_keys();
+
+  for (int64_t key = 0; key < 100; key++) {
+    keys.push_back(key);
+  }
+  keys.insert(keys.end(), batch_keys.begin(), batch_keys.end());
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (size_t i = 0; i < keys.size(); i++) {
+    ASSERT_EQ(SUCCESS, bpt_delete(FileMock::current_fd, TEST_TID, keys[i]));
+    if (i % 10 == 0) {
+      expect_leaf_links();
+      expect_high_keys();
+    }
+  }
+}
+
+// page 아래 모든 page의 parent_page_num이 비어있는지, return leaf 수
+static int count_leaves_without_parents(tableid_t table_id, pagenum_t page_num) {
+  page_t* page = read_buffer(FileMock::current_fd, table_id, page_num);
+  internal_page_t node;
+  std::memcpy(&node, page, PAGE_SIZE);
+  unpin(table_id, page_num);
+  EXPECT_EQ(PAGE_NULL, node.parent_page_num) << page_num;
+  if (node.is_leaf == LEAF) {
+    return 1;
+  }
+  int leaves = count_leaves_without_parents(table_id, node.one_more_page_num);
+  for (int i = 0; i < node.num_of_keys; i++) {
+    leaves += count_leaves_without_parents(table_id, node.entries[i].page_num);
+  }
+  return leaves;
+}
+
+TEST_F(DeleteTest, AppendSplitKeepsLegacyInternalNodesHalfFull) {
+  // high key가 없던 예전 파일은 internal page의 right link가 항상 0이므로
+  // 가장 오른쪽인지 알 수 없어 internal page는 반씩 나눔
+  header_page_t* header_page =
+      read_header_page(FileMock::current_fd, TEST_TID);
+  header_page->high_keys = 0;
+  write_buffer(TEST_TID, HEADER_PAGE_POS, (page_t*)header_page);
+  unpin(TEST_TID, HEADER_PAGE_POS);
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < 40; key++) {
+    keys.push_back(key);
+  }
+  insert_keys(keys);
+  header_page_t header = get_header_page(TEST_TID);
+  internal_page_t root = get_internal_page(TEST_TID, header.root_page_num);
+  ASSERT_EQ(1, root.num_of_keys);
+  internal_page_t left = get_internal_page(TEST_TID, root.one_more_page_num);
+  ASSERT_EQ(INTERNAL, left.is_leaf);
+  ASSERT_EQ(cut(INTERNAL_ORDER) - 1, left.num_of_keys);
+  // leaf의 right link는 예전 파일에도 있으므로 leaf는 꽉 참
+  leaf_page_t leaf = get_leaf_page(TEST_TID, left.one_more_page_num);
+  ASSERT_EQ((uint32_t)RECORD_CNT, leaf.num_of_keys);
+
+  for (int64_t key : keys) {
+    ASSERT_EQ(SUCCESS, bpt_delete(FileMock::current_fd, TEST_TID, key));
+  }
+  ASSERT_EQ(PAGE_NULL, get_header_page(TEST_TID).root_page_num);
+
+  // high key가 있으면 가장 오른쪽 internal page도 왼쪽을 채움
+  header_page = read_header_page(FileMock::current_fd, TEST_TID);
+  header_page->high_keys = 1;
+  write_buffer(TEST_TID, HEADER_PAGE_POS, (page_t*)header_page);
+  unpin(TEST_TID, HEADER_PAGE_POS);
+  insert_keys(keys);
+  header = get_header_page(TEST_TID);
+  root = get_internal_page(TEST_TID, header.root_page_num);
+  ASSERT_EQ(1, root.num_of_keys);
+  left = get_internal_page(TEST_TID, root.one_more_page_num);
+  ASSERT_EQ(ENTRY_CNT - 1, left.num_of_keys);
+  expect_high_keys();
+}
+
+TEST_F(DeleteTest, PathModeKeepsNoParentPointers) {
+  ASSERT_EQ(SUCCESS,
+            set_tree_mode(FileMock::current_fd, TEST_TID, TREE_MODE_PATH));
+  int64_t range[2] = {0, 100};
+  ASSERT_EQ(SUCCESS, bulk_load(FileMock::current_fd, TEST_TID,
+                               next_sequential_record, range, 100));
+  // tree가 있으면 mode는 못 바꿈
+  ASSERT_EQ(FAILURE, set_tree_mode(FileMock::current_fd, TEST_TID,
+                                   TREE_MODE_PARENT_POINTERS));
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 100; key < 200; key++) {
+    keys.push_back(key);
+  }
+  std::mt19937 rng(7);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  insert_keys(keys);
+
+  std::vector<int64_t> batch_keys;
+  std::vector<std::string> values;
+  for (int64_t key = 1000; key < 1040; key++) {
+    batch_keys.push_back(key);
+    values.push_back("val" + std::to_string(key));
+  }
+  std::vector<char*> value_ptrs;
+  for (std::string& v : values) {
+    value_ptrs.push_back(&v[0]);
+  }
+  ASSERT_EQ(40, bpt_insert_batch(FileMock::current_fd, TEST_TID,
+                                 batch_keys.data(), value_ptrs.data(),
+                                 batch_keys.size()));
+
+  // internal page도 나뉠 만큼 커졌지만 parent_page_num은 하나도 없음
+  header_page_t header = get_header_page(TEST_TID);
+  ASSERT_GE(height(FileMock::current_fd, TEST_TID, HEADER_PAGE_POS), 2);
+  ASSERT_LT(0, count_leaves_without_parents(TEST_TID, header.root_page_num));
+  expect_leaf_links();
+  expect_high_keys();
+
+  for (int64_t key = 0; key < 100; key++) {
+    keys.push_back(key);
+  }
+  keys.insert(keys.end(), batch_keys.begin(), batch_keys.end());
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (size_t i = 0; i < keys.size(); i++) {
+    ASSERT_EQ(SUCCESS, bpt_delete(FileMock::current_fd, TEST_TID, keys[i]));
+    if (i % 10 == 0) {
+      for (size_t j = i + 1; j < keys.size(); j++) {
+        ASSERT_TRUE(key_exists(keys[j])) << keys[j];
+      }
+      header = get_header_page(TEST_TID);
+      count_leaves_without_parents(TEST_TID, header.root_page_num);
+      expect_leaf_links();
+      expect_high_keys();
+    }
+  }
+  header = get_header_page(TEST_TID);
+  ASSERT_EQ(PAGE_NULL, header.root_page_num);
+}
+
+TEST_F(DeleteTest, ConcurrentInsertAndDeleteKeepTree) {
+  // parent pointer mode는 child를 latch 없이 고치므로 받지 않음
+  char value[VALUE_SIZE] = "val";
+  ASSERT_EQ(FAILURE, bpt_insert_concurrent(FileMock::current_fd, TEST_TID, 1,
+                                           value, 4));
+  ASSERT_EQ(SUCCESS,
+            set_tree_mode(FileMock::current_fd, TEST_TID, TREE_MODE_PATH));
+
+  // 스레드마다 key % 4가 다른 key를 넣고 그중 짝수 번째를 지움
+  // leaf에 2개뿐이라 split/merge가 계속 겹침, 버퍼보다 작게 유지
+  const int thread_count = 4;
+  const int keys_per_thread = 25;
+  std::vector<std::thread> threads;
+  std::vector<int> failures(thread_count, 0);
+  for (int t = 0; t < thread_count; t++) {
+    threads.emplace_back([this, t, &failures]() {
+      std::vector<int64_t> keys;
+      for (int i = 0; i < keys_per_thread; i++) {
+        keys.push_back((int64_t)i * thread_count + t);
+      }
+      std::mt19937 rng(t);
+      std::shuffle(keys.begin(), keys.end(), rng);
+      for (int64_t key : keys) {
+        char value[VALUE_SIZE];
+        snprintf(value, VALUE_SIZE, "val%ld", key);
+        if (bpt_insert_concurrent(FileMock::current_fd, TEST_TID, key, value,
+                                  strlen(value) + 1) != SUCCESS) {
+          failures[t]++;
+        }
+        uint16_t length = VALUE_SIZE;
+        if (find_concurrent(FileMock::current_fd, TEST_TID, key, value,
+                            &length) != SUCCESS) {
+          failures[t]++;
+        }
+      }
+      for (int64_t key : keys) {
+        if (key / thread_count % 2 == 0 &&
+            bpt_delete_concurrent(FileMock::current_fd, TEST_TID, key) !=
+                SUCCESS) {
+          failures[t]++;
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (int t = 0; t < thread_count; t++) {
+    EXPECT_EQ(0, failures[t]) << "thread " << t;
+  }
+  for (int64_t key = 0; key < thread_count * keys_per_thread; key++) {
+    EXPECT_EQ(key / thread_count % 2 == 1, key_exists(key)) << key;
+  }
+  expect_leaf_links();
+  expect_high_keys();
+}
+
+TEST_F(DeleteTest, FlushDuringConcurrentWritesKeepsData) {
+  ASSERT_EQ(SUCCESS,
+            set_tree_mode(FileMock::current_fd, TEST_TID, TREE_MODE_PATH));
+
+  // writer가 고치는 동안 다른 스레드가 계속 flush, 다 끝난 뒤 버퍼를 버리고
+  // 파일에서 다시 읽어도 남아야 함
+  const int thread_count = 4;
+  const int keys_per_thread = 25;
+  std::vector<std::thread> threads;
+  std::vector<int> failures(thread_count, 0);
+  std::atomic<int> running(thread_count);
+  for (int t = 0; t < thread_count; t++) {
+    threads.emplace_back([this, t, &failures, &running]() {
+      std::vector<int64_t> keys;
+      for (int i = 0; i < keys_per_thread; i++) {
+        keys.push_back((int64_t)i * thread_count + t);
+      }
+      std::mt19937 rng(t);
+      std::shuffle(keys.begin(), keys.end(), rng);
+      for (int64_t key : keys) {
+        char value[VALUE_SIZE];
+        snprintf(value, VALUE_SIZE, "val%ld", key);
+        if (bpt_insert_concurrent(FileMock::current_fd, TEST_TID, key, value,
+                                  strlen(value) + 1) != SUCCESS) {
+          failures[t]++;
+        }
+      }
+      for (int64_t key : keys) {
+        if (key / thread_count % 2 == 0 &&
+            bpt_delete_concurrent(FileMock::current_fd, TEST_TID, key) !=
+                SUCCESS) {
+          failures[t]++;
+        }
+      }
+      running--;
+    });
+  }
+  std::thread flusher([this, &running]() {
+    while (running > 0) {
+      flush_table_buffer(FileMock::current_fd, TEST_TID);
+    }
+  });
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  flusher.join();
+
+  for (int t = 0; t < thread_count; t++) {
+    EXPECT_EQ(0, failures[t]) << "thread " << t;
+  }
+  flush_table_buffer(FileMock::current_fd, TEST_TID);
+  shutdown_buffer_manager();
+  forget_rightmost_leaf(TEST_TID);
+  init_buffer_manager(BUFFER_SIZE);
+  for (int64_t key = 0; key < thread_count * keys_per_thread; key++) {
+    EXPECT_EQ(key / thread_count % 2 == 1, key_exists(key)) << key;
+  }
+  expect_leaf_links();
+  expect_high_keys();
+}
@@ -0,0 +1,95 @@
+#include "file.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+// 실제 file.cpp의 async I/O engine, 임시 파일에 씀
+class FileAioTest : public ::testing::Test {
+ protected:
+  char path[32] = "/tmp/file_test_XXXXXX";
+  int fd = -1;
+
+  void SetUp() override {
+    fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    file_set_sync_mode(SYNC_DEFERRED);
+    ASSERT_EQ(SUCCESS, file_aio_init());
+  }
+
+  void TearDown() override {
+    file_aio_shutdown();
+    file_set_sync_mode(SYNC_EVERY_WRITE);
+    close(fd);
+    unlink(path);
+  }
+};
+
+static void fill_page(page_t* page, int round, int writer, int index) {
+  std::memset(page, 0, PAGE_SIZE);
+  snprintf((char*)page, PAGE_SIZE, "%d/%d/%d", round, writer, index);
+}
+
+/**
+ * 스레드 둘이 AIO_QUEUE_DEPTH개짜리 batch를 동시에 계속 제출
+ * slot을 하나씩 잡으면 둘이 나눠 가진 채 서로 기다려 멈춤
+ * 다른 스레드는 slot을 기다리지 않는 file_aio_submit_nowait로 하나씩
+ */
+TEST_F(FileAioTest, ConcurrentFullDepthBatchesDoNotDeadlock) {
+  const int rounds = 200;
+  const int batch_writers = 2;
+  const int writers = batch_writers + 1;
+  std::vector<page_t*> pages(writers * AIO_QUEUE_DEPTH);
+  for (page_t*& page : pages) {
+    ASSERT_EQ(0, posix_memalign((void**)&page, PAGE_SIZE, PAGE_SIZE));
+  }
+
+  std::vector<std::thread> threads;
+  for (int w = 0; w < writers; w++) {
+    threads.emplace_back([this, w, &pages]() {
+      aio_req_t reqs[AIO_QUEUE_DEPTH];
+      aio_req_t* req_ptrs[AIO_QUEUE_DEPTH];
+      for (int round = 0; round < rounds; round++) {
+        for (int i = 0; i < AIO_QUEUE_DEPTH; i++) {
+          page_t* page = pages[w * AIO_QUEUE_DEPTH + i];
+          fill_page(page, round, w, i);
+          file_aio_prep_write(&reqs[i], fd, w * AIO_QUEUE_DEPTH + i, page,
+                              NULL, NULL);
+          req_ptrs[i] = &reqs[i];
+        }
+        if (w < batch_writers) {
+          file_aio_submit(req_ptrs, AIO_QUEUE_DEPTH);
+        } else {
+          for (int i = 0; i < AIO_QUEUE_DEPTH; i++) {
+            file_aio_submit_nowait(&req_ptrs[i], 1);
+          }
+        }
+        for (int i = 0; i < AIO_QUEUE_DEPTH; i++) {
+          file_aio_wait(&reqs[i]);
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  alignas(PAGE_SIZE) page_t expected;
+  alignas(PAGE_SIZE) page_t actual;
+  for (int w = 0; w < writers; w++) {
+    for (int i = 0; i < AIO_QUEUE_DEPTH; i++) {
+      fill_page(&expected, rounds - 1, w, i);
+      file_read_page(fd, w * AIO_QUEUE_DEPTH + i, &actual);
+      ASSERT_EQ(0, std::memcmp(&expected, &actual, PAGE_SIZE)) << w << " " << i;
+    }
+  }
+  for (page_t* page : pages) {
+    free(page);
+  }
+}
@@ -5,8 +5,11 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <algorithm>
 #include <iostream>
+#include <random>
 #include <sstream>
+#include <string>
 #include <vector>
 
 #include "FileMock.h"
@@ -23,7 +26,6 @@ static void init_buffer_manager(int buf_size) {
   buf_mgr.frames_size = buf_size;
   buf_mgr.frames =
       (buf_ctl_block_t*)std::calloc(buf_size, sizeof(buf_ctl_block_t));
-  buf_mgr.clock_hand = 0;
 
   for (int i = 0; i < buf_size; ++i) {
     buf_mgr.frames[i].frame = std::calloc(1, PAGE_SIZE);
@@ -34,10 +36,7 @@ static void init_buffer_manager(int buf_size) {
     buf_mgr.frames[i].ref_bit = false;
   }
 
-  constexpr int MAX_TABLES = MAX_TABLE_COUNT + 1;
-  for (int i = 0; i < MAX_TABLES; ++i) {
-    buf_mgr.page_table[i].clear();
-  }
+  init_buf_partitions(buf_size);
 }
 
 static void shutdown_buffer_manager() {
@@ -209,6 +208,396 @@ TEST_F(FindTest, FindRangeSingleLeaf) {
   ASSERT_EQ(2, idx[1]);
 }
 
+TEST_F(FindTest, FindRangeReadsSiblingLeavesAheadInBatches) {
+  // random insert order so sibling leaves are not adjacent on disk
+  std::vector<int64_t> order;
+  for (int64_t key = 1; key <= 1000; key++) {
+    order.push_back(key);
+  }
+  std::mt19937 rng(3);
+  std::shuffle(order.begin(), order.end(), rng);
+  for (int64_t key : order) {
+    std::string value = "v" + std::to_string(key);
+    ASSERT_EQ(SUCCESS, bpt_insert(FileMock::current_fd, TEST_TID, key,
+                                  (char*)value.c_str()));
+  }
+
+  // cold buffer
+  flush_table_buffer(FileMock::current_fd, TEST_TID);
+  shutdown_buffer_manager();
+  init_buffer_manager(BUFFER_SIZE);
+  FileMock::read_call_count = 0;
+
+  std::vector<int64_t> keys(1000);
+  std::vector<pagenum_t> pages(1000);
+  std::vector<int> idx(1000);
+  int n = find_range(FileMock::current_fd, TEST_TID, 1, 1000, keys.data(),
+                     pages.data(), idx.data());
+
+  ASSERT_EQ(1000, n);
+  int leaf_count = 1;
+  for (int i = 0; i < n; i++) {
+    ASSERT_EQ(i + 1, keys[i]);
+    if (i > 0 && pages[i] != pages[i - 1]) {
+      leaf_count++;
+    }
+  }
+  // header, root and the first leaf are demand reads, the rest of the
+  // leaves arrive a few vectored reads at a time
+  ASSERT_GT(leaf_count, 2 * SCAN_PREFETCH_DEPTH);
+  ASSERT_LT(FileMock::read_call_count, leaf_count / 2);
+
+  buffer_stats_t stats;
+  get_buffer_stats(&stats);
+  ASSERT_EQ(stats.prefetch_hits, leaf_count - 1);
+  ASSERT_EQ(stats.prefetch_wasted, 0);
+
+  // a range inside one leaf reads nothing ahead
+  shutdown_buffer_manager();
+  init_buffer_manager(BUFFER_SIZE);
+  n = find_range(FileMock::current_fd, TEST_TID, 1, 3, keys.data(),
+                 pages.data(), idx.data());
+  ASSERT_EQ(3, n);
+  get_buffer_stats(&stats);
+  ASSERT_EQ(stats.prefetched, 0);
+}
+
+TEST_F(FindTest, FindBatchReadsEachLeafOnce) {
+  std::vector<int64_t> order;
+  for (int64_t key = 1; key <= 1000; key++) {
+    order.push_back(key);
+  }
+  std::mt19937 rng(5);
+  std::shuffle(order.begin(), order.end(), rng);
+  for (int64_t key : order) {
+    std::string value = "v" + std::to_string(key);
+    ASSERT_EQ(SUCCESS, bpt_insert(FileMock::current_fd, TEST_TID, key,
+                                  (char*)value.c_str()));
+  }
+
+  // unsorted probes, some missing and one repeated
+  std::vector<int64_t> keys;
+  for (int i = 0; i < 300; i++) {
+    keys.push_back(rng() % 1200 + 1);
+  }
+  keys.push_back(keys[0]);
+  int n = (int)keys.size();
+
+  flush_table_buffer(FileMock::current_fd, TEST_TID);
+  shutdown_buffer_manager();
+  init_buffer_manager(BUFFER_SIZE);
+  FileMock::read_call_count = 0;
+
+  std::vector<std::vector<char>> buffers(n, std::vector<char>(VALUE_SIZE));
+  std::vector<char*> values(n);
+  for (int i = 0; i < n; i++) {
+    values[i] = buffers[i].data();
+  }
+  std::vector<int> status(n);
+  int found = find_batch(FileMock::current_fd, TEST_TID, keys.data(), n,
+                         values.data(), status.data());
+
+  int expected_found = 0;
+  for (int i = 0; i < n; i++) {
+    if (keys[i] <= 1000) {
+      ASSERT_EQ(SUCCESS, status[i]) << keys[i];
+      ASSERT_STREQ(("v" + std::to_string(keys[i])).c_str(), values[i]);
+      expected_found++;
+    } else {
+      ASSERT_EQ(FAILURE, status[i]) << keys[i];
+    }
+  }
+  ASSERT_EQ(expected_found, found);
+
+  // header, root and the leaves, leaves mostly come in vectored reads
+  header_page_t header = get_header_page_from_buffer(FileMock::current_fd,
+                                                     TEST_TID);
+  ASSERT_LT(FileMock::read_call_count, (int)header.num_of_pages / 2);
+  buffer_stats_t stats;
+  get_buffer_stats(&stats);
+  ASSERT_GT(stats.prefetch_hits, 0);
+  ASSERT_EQ(stats.prefetch_wasted, 0);
+
+  // length overload reports the needed size for a small buffer
+  int64_t probe[2] = {7, 7};
+  char small[2];
+  char big[VALUE_SIZE];
+  char* probe_values[2] = {small, big};
+  uint16_t lengths[2] = {sizeof(small), VALUE_SIZE};
+  int probe_status[2];
+  ASSERT_EQ(1, find_batch(FileMock::current_fd, TEST_TID, probe, 2,
+                          probe_values, lengths, probe_status));
+  ASSERT_EQ(FAILURE, probe_status[0]);
+  ASSERT_EQ(VALUE_SIZE, lengths[0]);
+  ASSERT_EQ(SUCCESS, probe_status[1]);
+  ASSERT_STREQ("v7", big);
+
+  // nothing stays pinned, so the leftmost path dirtied below is flushed
+  for (int i = 0; i < BUFFER_SIZE; i++) {
+    ASSERT_EQ(0, buf_mgr.frames[i].pin_count) << i;
+  }
+  for (int64_t key = 0; key > -200; key--) {
+    std::string value = "v" + std::to_string(key);
+    ASSERT_EQ(SUCCESS, bpt_insert(FileMock::current_fd, TEST_TID, key,
+                                  (char*)value.c_str()));
+  }
+  flush_table_buffer(FileMock::current_fd, TEST_TID);
+  shutdown_buffer_manager();
+  init_buffer_manager(BUFFER_SIZE);
+  char result[VALUE_SIZE];
+  for (int64_t key = -199; key <= 1000; key++) {
+    ASSERT_EQ(SUCCESS, find(FileMock::current_fd, TEST_TID, key, result))
+        << key;
+    ASSERT_STREQ(("v" + std::to_string(key)).c_str(), result);
+  }
+}
+
+TEST_F(FindTest, CursorStreamsRangePinningOneLeaf) {
+  std::vector<int64_t> order;
+  for (int64_t key = 1; key <= 1000; key++) {
+    order.push_back(key * 2);
+  }
+  std::shuffle(order.begin(), order.end(), std::mt19937(9));
+  for (int64_t key : order) {
+    std::string value = "v" + std::to_string(key);
+    ASSERT_EQ(SUCCESS, bpt_insert(FileMock::current_fd, TEST_TID, key,
+                                  (char*)value.c_str()));
+  }
+
+  auto pinned_frames = [this]() {
+    int pinned = 0;
+    for (int i = 0; i < BUFFER_SIZE; i++) {
+      pinned += buf_mgr.frames[i].pin_count > 0;
+    }
+    return pinned;
+  };
+
+  // unbounded, every key in order
+  cursor_t* cursor = cursor_open(FileMock::current_fd, TEST_TID);
+  ASSERT_EQ(SUCCESS, cursor_seek(cursor, INT64_MIN));
+  int64_t key;
+  char value[VALUE_SIZE];
+  int64_t expected = 2;
+  while (cursor_next(cursor, &key, value) == SUCCESS) {
+    ASSERT_EQ(expected, key);
+    ASSERT_STREQ(("v" + std::to_string(key)).c_str(), value);
+    ASSERT_LE(pinned_frames(), 1);
+    expected += 2;
+  }
+  ASSERT_EQ(2002, expected);
+  ASSERT_EQ(0, pinned_frames());
+
+  // bounded, starting between keys
+  ASSERT_EQ(SUCCESS, cursor_seek(cursor, 101, 200));
+  int count = 0;
+  uint16_t length = 2;
+  while (cursor_next(cursor, &key, value, &length) == SUCCESS) {
+    ASSERT_EQ(102 + count * 2, key);
+    ASSERT_EQ(VALUE_SIZE, length);
+    ASSERT_EQ('v', value[0]);
+    count++;
+    length = 2;
+  }
+  ASSERT_EQ(50, count);
+  ASSERT_EQ(0, pinned_frames());
+
+  // reverse, every key in descending order
+  ASSERT_EQ(SUCCESS, cursor_seek_reverse(cursor, INT64_MAX));
+  expected = 2000;
+  while (cursor_next(cursor, &key, value) == SUCCESS) {
+    ASSERT_EQ(expected, key);
+    ASSERT_STREQ(("v" + std::to_string(key)).c_str(), value);
+    ASSERT_LE(pinned_frames(), 1);
+    expected -= 2;
+  }
+  ASSERT_EQ(0, expected);
+  ASSERT_EQ(0, pinned_frames());
+
+  // reverse and bounded, starting on a key and between keys
+  for (int64_t from : {200, 201}) {
+    ASSERT_EQ(SUCCESS, cursor_seek_reverse(cursor, from, 101));
+    count = 0;
+    while (cursor_next(cursor, &key, value) == SUCCESS) {
+      ASSERT_EQ(200 - count * 2, key);
+      count++;
+    }
+    ASSERT_EQ(50, count);
+  }
+  ASSERT_EQ(FAILURE, cursor_seek_reverse(cursor, 1));
+
+  // leaves written before left links (0) are found through the parent
+  pagenum_t leaf_num = find_leaf(FileMock::current_fd, TEST_TID, INT64_MIN);
+  while (leaf_num != PAGE_NULL) {
+    leaf_page_t* leaf =
+        (leaf_page_t*)read_buffer(FileMock::current_fd, TEST_TID, leaf_num);
+    leaf->left_sibling_page_num = PAGE_NULL;
+    pagenum_t next_num = leaf->right_sibling_page_num;
+    mark_dirty(TEST_TID, leaf_num);
+    unpin(TEST_TID, leaf_num);
+    leaf_num = next_num;
+  }
+  ASSERT_EQ(SUCCESS, cursor_seek_reverse(cursor, INT64_MAX));
+  count = 0;
+  while (cursor_next(cursor, &key, value) == SUCCESS) {
+    ASSERT_EQ(2000 - count * 2, key);
+    count++;
+  }
+  ASSERT_EQ(1000, count);
+
+  // past the last key, and closing in the middle of a range
+  ASSERT_EQ(FAILURE, cursor_seek(cursor, 2001));
+  ASSERT_EQ(FAILURE, cursor_next(cursor, &key, value));
+  ASSERT_EQ(SUCCESS, cursor_seek(cursor, 500));
+  ASSERT_EQ(SUCCESS, cursor_next(cursor, &key, value));
+  ASSERT_EQ(500, key);
+  cursor_close(cursor);
+  ASSERT_EQ(0, pinned_frames());
+}
+
+TEST_F(FindTest, SearchKernelsMatchLinearScan) {
+  std::mt19937 rng(11);
+  internal_page_t* internal_page =
+      (internal_page_t*)std::calloc(1, sizeof(page_t));
+  leaf_page_t* leaf_page = (leaf_page_t*)std::calloc(1, sizeof(page_t));
+  SearchKernel default_kernel = get_search_kernel();
+
+  for (int n = 0; n <= ENTRY_CNT; n++) {
+    // 정렬된 짝수 key, 홀수 probe는 항상 key 사이에 떨어짐
+    int64_t key = -100;
+    for (int i = 0; i < n; i++) {
+      key += 2 * (1 + rng() % 5);
+      internal_page->entries[i].key = key;
+      internal_page->entries[i].page_num = rng();  // 비교에 섞이면 안됨
+    }
+    internal_page->num_of_keys = n;
+
+    for (SearchKernel kernel : {SEARCH_LINEAR, SEARCH_BINARY, SEARCH_AVX2}) {
+      if (set_search_kernel(kernel) != SUCCESS) {
+        continue;  // no AVX2 on this CPU
+      }
+      for (int64_t probe = -102; probe <= key + 2; probe++) {
+        int expected = 0;
+        while (expected < n && internal_page->entries[expected].key <= probe) {
+          expected++;
+        }
+        ASSERT_EQ(expected, internal_child_index(internal_page, probe))
+            << "kernel " << kernel << " n " << n << " probe " << probe;
+      }
+    }
+  }
+
+  for (uint32_t format : {LEAF_FORMAT_RECORDS, LEAF_FORMAT_KEY_ARRAY}) {
+    leaf_page->format = format;
+    for (SearchKernel kernel : {SEARCH_LINEAR, SEARCH_BINARY, SEARCH_AVX2}) {
+      if (set_search_kernel(kernel) != SUCCESS) {
+        continue;
+      }
+      for (int n = 0; n <= RECORD_CNT; n++) {
+        for (int i = 0; i < n; i++) {
+          leaf_set_key(leaf_page, i, 10 * i);
+        }
+        leaf_page->num_of_keys = n;
+        for (int64_t probe = -5; probe <= 10 * n + 5; probe += 5) {
+          int expected = 0;
+          while (expected < n && leaf_key(leaf_page, expected) < probe) {
+            expected++;
+          }
+          ASSERT_EQ(expected, leaf_lower_bound(leaf_page, probe))
+              << "format " << format << " kernel " << kernel << " n " << n;
+          ASSERT_EQ(
+              probe % 10 == 0 && probe >= 0 && probe < 10 * n ? expected : -1,
+              leaf_find_index(leaf_page, probe));
+        }
+      }
+    }
+  }
+  set_search_kernel(default_kernel);
+
+  std::free(internal_page);
+  std::free(leaf_page);
+}
+
+/**
+ * 새 파일은 key 배열 leaf, header의 leaf_format이 0인 예전 파일은 record
+ * leaf로 계속 읽고 쓸 수 있어야 함
+ */
+TEST_F(FindTest, LeafFormatFollowsHeaderAndOldFormatStaysReadable) {
+  for (uint32_t format : {LEAF_FORMAT_KEY_ARRAY, LEAF_FORMAT_RECORDS}) {
+    FileMock::setup_data_store();
+    FileMock::init_header_page_for_mock();
+    shutdown_buffer_manager();
+    init_buffer_manager(BUFFER_SIZE);
+    init_header_page(FileMock::current_fd, TEST_TID);
+    ASSERT_EQ(LEAF_FORMAT_KEY_ARRAY,
+              get_leaf_format(FileMock::current_fd, TEST_TID));
+    ASSERT_EQ(SUCCESS, set_leaf_format(FileMock::current_fd, TEST_TID, format));
+
+    const int NUM_KEYS = RECORD_CNT * 6;
+    std::vector<int64_t> order;
+    for (int i = 0; i < NUM_KEYS; i++) {
+      order.push_back(i * 2);
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(5));
+    for (int64_t key : order) {
+      std::string value = "v" + std::to_string(key);
+      ASSERT_EQ(SUCCESS, bpt_insert(FileMock::current_fd, TEST_TID, key,
+                                    (char*)value.c_str()));
+    }
+    // tree가 있으면 format을 바꿀 수 없음
+    ASSERT_EQ(FAILURE, set_leaf_format(FileMock::current_fd, TEST_TID,
+                                       LEAF_FORMAT_KEY_ARRAY));
+
+    // 모든 leaf가 header의 format이고 그 layout으로 정렬되어 있음
+    pagenum_t leaf_num = find_leaf(FileMock::current_fd, TEST_TID, 0);
+    int64_t expected = 0;
+    while (leaf_num != PAGE_NULL) {
+      leaf_page_t leaf =
+          get_leaf_page(FileMock::current_fd, TEST_TID, leaf_num);
+      ASSERT_EQ(format, leaf.format);
+      for (int i = 0; i < (int)leaf.num_of_keys; i++, expected += 2) {
+        int64_t raw_key = format == LEAF_FORMAT_RECORDS
+                              ? leaf.records[i].key
+                              : as_key_array(&leaf)->keys[i];
+        ASSERT_EQ(expected, raw_key);
+        ASSERT_EQ("v" + std::to_string(expected),
+                  std::string(leaf_value(&leaf, i)));
+      }
+      leaf_num = leaf.right_sibling_page_num;
+    }
+    ASSERT_EQ(2 * NUM_KEYS, expected);
+
+    // update, delete 후에도 find와 find_range가 맞아야 함
+    char value[VALUE_SIZE];
+    ASSERT_EQ(SUCCESS, bpt_update(FileMock::current_fd, TEST_TID, 10,
+                                  (char*)"updated"));
+    for (int64_t key = 0; key < 2 * NUM_KEYS; key += 8) {
+      ASSERT_EQ(SUCCESS, bpt_delete(FileMock::current_fd, TEST_TID, key));
+    }
+    int remaining = 0;
+    for (int64_t key = 0; key < 2 * NUM_KEYS; key += 2) {
+      int result = find(FileMock::current_fd, TEST_TID, key, value);
+      if (key % 8 == 0) {
+        ASSERT_EQ(FAILURE, result) << key;
+      } else {
+        remaining++;
+        ASSERT_EQ(SUCCESS, result) << key;
+        ASSERT_STREQ(key == 10 ? "updated" : ("v" + std::to_string(key)).c_str(),
+                     value);
+      }
+    }
+    std::vector<int64_t> keys(NUM_KEYS);
+    std::vector<pagenum_t> pages(NUM_KEYS);
+    std::vector<int> idx(NUM_KEYS);
+    int n = find_range(FileMock::current_fd, TEST_TID, 0, 2 * NUM_KEYS,
+                       keys.data(), pages.data(), idx.data());
+    ASSERT_EQ(remaining, n);
+    for (int i = 1; i < n; i++) {
+      ASSERT_LT(keys[i - 1], keys[i]);
+      ASSERT_NE(0, keys[i] % 8);
+    }
+  }
+}
+
 TEST_F(FindTest, FindAndPrintRangeOutput) {
   insert_data({{100, "AAA"}, {150, "BBB"}, {50, "CCC"}});
 
@@ -2,6 +2,9 @@
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <random>
+#include <string>
+#include <vector>
 
 #include "FileMock.h"
 #include "bpt.h"
@@ -14,7 +17,6 @@ static void init_buffer_manager(int buf_size) {
   buf_mgr.frames_size = buf_size;
   buf_mgr.frames =
       (buf_ctl_block_t*)std::calloc(buf_size, sizeof(buf_ctl_block_t));
-  buf_mgr.clock_hand = 0;
 
   for (int i = 0; i < buf_size; ++i) {
     buf_mgr.frames[i].frame = std::calloc(1, PAGE_SIZE);
@@ -25,10 +27,7 @@ static void init_buffer_manager(int buf_size) {
     buf_mgr.frames[i].ref_bit = false;
   }
 
-  constexpr int MAX_TABLES = MAX_TABLE_COUNT + 1;
-  for (int i = 0; i < MAX_TABLES; ++i) {
-    buf_mgr.page_table[i].clear();
-  }
+  init_buf_partitions(buf_size);
 }
 
 static void shutdown_buffer_manager() {
@@ -37,10 +36,7 @@ static void shutdown_buffer_manager() {
   }
   std::free(buf_mgr.frames);
 
-  constexpr int MAX_TABLES = 11;
-  for (int i = 0; i < MAX_TABLES; ++i) {
-    buf_mgr.page_table[i].clear();
-  }
+  clear_buf_partitions();
 }
 
 static leaf_page_t get_leaf_page(int fd, tableid_t table_id,
@@ -69,6 +65,26 @@ static header_page_t get_header_page(int fd, tableid_t table_id) {
   return header;
 }
 
+// bulk_load 입력, keys 순서대로 values를 넘겨줌
+typedef struct {
+  std::vector<int64_t> keys;
+  std::vector<std::string> values;
+  size_t next;
+} bulk_input_t;
+
+static int next_bulk_record(void* ctx, int64_t* key, const char** value,
+                            uint16_t* length) {
+  bulk_input_t* input = (bulk_input_t*)ctx;
+  if (input->next == input->keys.size()) {
+    return FAILURE;
+  }
+  *key = input->keys[input->next];
+  *value = input->values[input->next].data();
+  *length = input->values[input->next].size();
+  input->next++;
+  return SUCCESS;
+}
+
 // GTest Fixture 정의
 class HardInsertTest : public ::testing::Test {
  protected:
@@ -107,8 +123,8 @@ TEST_F(HardInsertTest, StartNewTree) {
       get_leaf_page(FileMock::current_fd, TEST_TID, header.root_page_num);
   ASSERT_EQ(root.is_leaf, LEAF);
   ASSERT_EQ(root.num_of_keys, 1);
-  ASSERT_EQ(root.records[0].key, key);
-  ASSERT_STREQ(root.records[0].value, value);
+  ASSERT_EQ(leaf_key(&root, 0), key);
+  ASSERT_STREQ(leaf_value(&root, 0), value);
 }
 
 TEST_F(HardInsertTest, InsertIntoLeafWithRoom) {
@@ -129,8 +145,8 @@ TEST_F(HardInsertTest, InsertIntoLeafWithRoom) {
 
   ASSERT_EQ(root.is_leaf, LEAF);
   ASSERT_EQ(root.num_of_keys, 2);
-  ASSERT_EQ(root.records[0].key, key1);
-  ASSERT_EQ(root.records[1].key, key2);
+  ASSERT_EQ(leaf_key(&root, 0), key1);
+  ASSERT_EQ(leaf_key(&root, 1), key2);
 }
 
 TEST_F(HardInsertTest, InsertDuplicateKey) {
@@ -303,3 +319,416 @@ TEST_F(HardInsertTest, TreeStructureAfterMultipleSplits) {
     ASSERT_EQ(find_result, SUCCESS);
   }
 }
+
+/**
+ * slotted leaf: value를 실제 길이로 저장하고, split/update/delete 후에도
+ * 길이와 내용이 그대로여야 함
+ */
+TEST_F(HardInsertTest, SlottedLeavesStoreValuesByLength) {
+  ASSERT_EQ(SUCCESS, set_leaf_format(FileMock::current_fd, TEST_TID,
+                                     LEAF_FORMAT_SLOTTED));
+
+  const int NUM_KEYS = 600;
+  std::mt19937 rng(3);
+  std::vector<std::string> values(NUM_KEYS);
+  std::vector<int64_t> order(NUM_KEYS);
+  for (int i = 0; i < NUM_KEYS; i++) {
+    // 짧은 value가 대부분, '\0'이 섞인 binary도 있음
+    int length = i % 10 == 0 ? 200 + rng() % 300 : 1 + rng() % 12;
+    for (int j = 0; j < length; j++) {
+      values[i].push_back((char)(rng() % 256));
+    }
+    order[i] = i;
+  }
+  std::shuffle(order.begin(), order.end(), rng);
+  for (int64_t key : order) {
+    ASSERT_EQ(SUCCESS, bpt_insert(FileMock::current_fd, TEST_TID, key,
+                                  values[key].data(), values[key].size()));
+  }
+
+  // 고정 길이 leaf였다면 NUM_KEYS / RECORD_CNT 보다 많은 leaf가 필요함
+  int leaf_count = 0;
+  pagenum_t leaf_num = find_leaf(FileMock::current_fd, TEST_TID, 0);
+  while (leaf_num != PAGE_NULL) {
+    leaf_page_t leaf = get_leaf_page(FileMock::current_fd, TEST_TID, leaf_num);
+    ASSERT_EQ(LEAF_FORMAT_SLOTTED, leaf.format);
+    leaf_count++;
+    leaf_num = leaf.right_sibling_page_num;
+  }
+  ASSERT_LT(leaf_count, NUM_KEYS / RECORD_CNT);
+
+  // 짧아지고 길어지는 update, 길어져서 leaf에 자리가 없으면 다시 넣음
+  for (int i = 0; i < NUM_KEYS; i += 3) {
+    values[i] = i % 2 ? std::string(400, 'x') : std::string("s");
+    ASSERT_EQ(SUCCESS, bpt_update(FileMock::current_fd, TEST_TID, i,
+                                  values[i].data(), values[i].size()));
+  }
+  for (int i = 0; i < NUM_KEYS; i += 4) {
+    ASSERT_EQ(SUCCESS, bpt_delete(FileMock::current_fd, TEST_TID, i));
+  }
+
+  char buf[SLOTTED_MAX_VALUE_SIZE];
+  for (int i = 0; i < NUM_KEYS; i++) {
+    uint16_t length = sizeof(buf);
+    int result = find(FileMock::current_fd, TEST_TID, i, buf, &length);
+    if (i % 4 == 0) {
+      ASSERT_EQ(FAILURE, result) << i;
+      continue;
+    }
+    ASSERT_EQ(SUCCESS, result) << i;
+    ASSERT_EQ(values[i], std::string(buf, length)) << i;
+  }
+
+  // 작은 버퍼면 필요한 길이를 알려줌
+  uint16_t length = 1;
+  ASSERT_EQ(FAILURE, find(FileMock::current_fd, TEST_TID, 3, buf, &length));
+  ASSERT_EQ(400, length);
+
+  // 고정 길이 API는 slotted leaf에서도 문자열로 동작
+  char value[VALUE_SIZE];
+  ASSERT_EQ(SUCCESS, bpt_update(FileMock::current_fd, TEST_TID, 1,
+                                (char*)"fixed"));
+  ASSERT_EQ(SUCCESS, find(FileMock::current_fd, TEST_TID, 1, value));
+  ASSERT_STREQ("fixed", value);
+  length = sizeof(buf);
+  ASSERT_EQ(SUCCESS, find(FileMock::current_fd, TEST_TID, 1, buf, &length));
+  ASSERT_EQ(6, length);
+}
+
+TEST_F(HardInsertTest, OverflowChainsHoldLargeValues) {
+  int fd = FileMock::current_fd;
+  ASSERT_EQ(SUCCESS, set_leaf_format(fd, TEST_TID, LEAF_FORMAT_SLOTTED));
+
+  const int NUM_KEYS = 40;
+  std::mt19937 rng(11);
+  std::vector<std::string> values(NUM_KEYS);
+  std::vector<int64_t> order(NUM_KEYS);
+  for (int i = 0; i < NUM_KEYS; i++) {
+    // 4개 중 하나는 수 KB ~ 60KB
+    int length = i % 4 == 0 ? 1000 + rng() % 59000 : 1 + rng() % 100;
+    for (int j = 0; j < length; j++) {
+      values[i].push_back((char)(rng() % 256));
+    }
+    order[i] = i;
+  }
+  std::shuffle(order.begin(), order.end(), rng);
+  for (int64_t key : order) {
+    ASSERT_EQ(SUCCESS, bpt_insert(fd, TEST_TID, key, values[key].data(),
+                                  values[key].size()));
+  }
+
+  std::vector<char> buf(OVERFLOW_MAX_VALUE_SIZE);
+  for (int i = 0; i < NUM_KEYS; i++) {
+    uint16_t length = buf.size();
+    ASSERT_EQ(SUCCESS, find(fd, TEST_TID, i, buf.data(), &length)) << i;
+    ASSERT_EQ(values[i], std::string(buf.data(), length)) << i;
+  }
+
+  // 버퍼를 비우고 다시 읽음, chain은 버퍼에 올라오지 않음
+  flush_table_buffer(fd, TEST_TID);
+  shutdown_buffer_manager();
+  init_buffer_manager(BUFFER_SIZE);
+  auto overflow_frames = [&]() {
+    int count = 0;
+    for (int i = 0; i < buf_mgr.frames_size; i++) {
+      buf_ctl_block_t* bcb = &buf_mgr.frames[i];
+      if (bcb->page_num != PAGE_NULL &&
+          ((overflow_page_t*)bcb->frame)->is_leaf == OVERFLOW) {
+        count++;
+      }
+    }
+    return count;
+  };
+
+  // prefix만 필요하면 leaf에서 끝나서 tree 밖의 read가 없음
+  char prefix[16];
+  uint16_t value_length = 0;
+  ASSERT_EQ(SUCCESS, find_prefix(fd, TEST_TID, 8, prefix, sizeof(prefix),
+                                 &value_length));
+  ASSERT_EQ(values[8].size(), value_length);
+  ASSERT_EQ(values[8].substr(0, sizeof(prefix)),
+            std::string(prefix, sizeof(prefix)));
+  int reads_after_prefix = FileMock::read_call_count;
+  ASSERT_EQ(SUCCESS, find_key(fd, TEST_TID, 8));
+  ASSERT_EQ(reads_after_prefix, FileMock::read_call_count);
+
+  // 이어진 page로 쓴 chain은 OVERFLOW_READ_BATCH page씩 한번에 읽힘
+  uint16_t length = buf.size();
+  ASSERT_EQ(SUCCESS, find(fd, TEST_TID, 8, buf.data(), &length));
+  ASSERT_EQ(values[8], std::string(buf.data(), length));
+  int pages = (values[8].size() - OVERFLOW_PREFIX_SIZE + OVERFLOW_DATA_SIZE -
+               1) / OVERFLOW_DATA_SIZE;
+  ASSERT_LE(FileMock::read_call_count - reads_after_prefix,
+            (pages + OVERFLOW_READ_BATCH - 1) / OVERFLOW_READ_BATCH);
+  ASSERT_EQ(0, overflow_frames());
+
+  // 작아지고 커지는 update와 delete, 지운 chain의 page는 다시 쓰임
+  header_page_t before = get_header_page(fd, TEST_TID);
+  values[4] = "small";
+  ASSERT_EQ(SUCCESS, bpt_update(fd, TEST_TID, 4, values[4].data(),
+                                values[4].size()));
+  ASSERT_EQ(SUCCESS, bpt_delete(fd, TEST_TID, 0));
+  ASSERT_EQ(FAILURE, find_key(fd, TEST_TID, 0));
+  values[5] = std::string(values[0].size(), 'b');
+  ASSERT_EQ(SUCCESS, bpt_update(fd, TEST_TID, 5, values[5].data(),
+                                values[5].size()));
+  header_page_t after = get_header_page(fd, TEST_TID);
+  ASSERT_EQ(before.num_of_pages, after.num_of_pages);
+
+  for (int i = 1; i < NUM_KEYS; i++) {
+    length = buf.size();
+    ASSERT_EQ(SUCCESS, find(fd, TEST_TID, i, buf.data(), &length)) << i;
+    ASSERT_EQ(values[i], std::string(buf.data(), length)) << i;
+  }
+
+  // 고정 길이 API는 앞 VALUE_SIZE - 1 byte
+  char fixed[VALUE_SIZE];
+  ASSERT_EQ(SUCCESS, find(fd, TEST_TID, 8, fixed));
+  ASSERT_EQ(0, std::memcmp(fixed, values[8].data(),
+                           strnlen(fixed, VALUE_SIZE - 1)));
+}
+
+TEST_F(HardInsertTest, BulkLoadPacksLeavesBottomUp) {
+  int fd = FileMock::current_fd;
+  const int NUM_KEYS = 3000;
+  bulk_input_t input;
+  for (int i = 0; i < NUM_KEYS; i++) {
+    input.keys.push_back(i * 2);
+    input.values.push_back("val" + std::to_string(i * 2));
+  }
+
+  // 정렬되지 않은 입력은 실패하고 tree는 그대로
+  bulk_input_t unsorted = input;
+  std::swap(unsorted.keys[100], unsorted.keys[101]);
+  unsorted.next = 0;
+  ASSERT_EQ(FAILURE, bulk_load(fd, TEST_TID, next_bulk_record, &unsorted, 100));
+  header_page_t header = get_header_page(fd, TEST_TID);
+  ASSERT_EQ(PAGE_NULL, header.root_page_num);
+  ASSERT_EQ(HEADER_PAGE_POS + 1, header.num_of_pages);
+
+  input.next = 0;
+  FileMock::write_call_count = 0;
+  ASSERT_EQ(SUCCESS, bulk_load(fd, TEST_TID, next_bulk_record, &input, 100));
+  // leaf 97개와 root가 이어진 번호로 한번에 쓰임
+  const int NUM_LEAVES = (NUM_KEYS + RECORD_CNT - 1) / RECORD_CNT;
+  ASSERT_EQ(1, FileMock::write_call_count);
+
+  header = get_header_page(fd, TEST_TID);
+  ASSERT_EQ((pagenum_t)(HEADER_PAGE_POS + 1 + NUM_LEAVES + 1),
+            header.num_of_pages);
+  internal_page_t root = get_internal_page(fd, TEST_TID, header.root_page_num);
+  ASSERT_EQ(INTERNAL, root.is_leaf);
+  ASSERT_EQ(PAGE_NULL, root.parent_page_num);
+  ASSERT_EQ(NUM_LEAVES - 1, root.num_of_keys);
+
+  // leaf는 가득 차 있고 sibling 순서대로 key가 이어짐
+  pagenum_t leaf_num = root.one_more_page_num;
+  int64_t expected_key = 0;
+  for (int i = 0; i < NUM_LEAVES; i++) {
+    leaf_page_t leaf = get_leaf_page(fd, TEST_TID, leaf_num);
+    ASSERT_EQ(header.root_page_num, leaf.parent_page_num);
+    if (i > 0) {
+      ASSERT_EQ(leaf_key(&leaf, 0), root.entries[i - 1].key);
+    }
+    int expected_count =
+        i < NUM_LEAVES - 1 ? RECORD_CNT : NUM_KEYS - i * RECORD_CNT;
+    ASSERT_EQ(expected_count, leaf.num_of_keys);
+    for (int j = 0; j < expected_count; j++) {
+      ASSERT_EQ(expected_key, leaf_key(&leaf, j));
+      expected_key += 2;
+    }
+    leaf_num = leaf.right_sibling_page_num;
+  }
+  ASSERT_EQ(PAGE_NULL, leaf_num);
+
+  char buf[VALUE_SIZE];
+  for (int i = 0; i < NUM_KEYS; i++) {
+    ASSERT_EQ(SUCCESS, find(fd, TEST_TID, i * 2, buf));
+    ASSERT_STREQ(input.values[i].c_str(), buf);
+  }
+
+  // 비어있지 않은 table에는 안 됨
+  input.next = 0;
+  ASSERT_EQ(FAILURE, bulk_load(fd, TEST_TID, next_bulk_record, &input, 100));
+}
+
+TEST_F(HardInsertTest, BulkLoadLeavesRoomByFillFactor) {
+  int fd = FileMock::current_fd;
+  ASSERT_EQ(SUCCESS, set_leaf_format(fd, TEST_TID, LEAF_FORMAT_SLOTTED));
+
+  const int NUM_KEYS = 2000;
+  std::mt19937 rng(5);
+  bulk_input_t input;
+  for (int i = 0; i < NUM_KEYS; i++) {
+    input.keys.push_back(i * 2);
+    input.values.push_back(std::string(1 + rng() % 200, 'a' + i % 26));
+  }
+  input.next = 0;
+  ASSERT_EQ(SUCCESS, bulk_load(fd, TEST_TID, next_bulk_record, &input, 50));
+
+  header_page_t header = get_header_page(fd, TEST_TID);
+  internal_page_t root = get_internal_page(fd, TEST_TID, header.root_page_num);
+  pagenum_t leaf_num = root.one_more_page_num;
+  while (leaf_num != PAGE_NULL) {
+    leaf_page_t leaf = get_leaf_page(fd, TEST_TID, leaf_num);
+    int bytes = 0;
+    for (int j = 0; j < (int)leaf.num_of_keys; j++) {
+      bytes += leaf_record_size(&leaf, leaf_value_length(&leaf, j));
+    }
+    ASSERT_LE(bytes, LEAF_BODY_SIZE / 2);
+    leaf_num = leaf.right_sibling_page_num;
+  }
+
+  // 남겨둔 자리에 split 없이 들어감
+  pagenum_t num_of_pages = header.num_of_pages;
+  for (int i = 0; i < NUM_KEYS; i += 8) {
+    ASSERT_EQ(SUCCESS, bpt_insert(fd, TEST_TID, i * 2 + 1, "odd", 3));
+  }
+  ASSERT_EQ(num_of_pages, get_header_page(fd, TEST_TID).num_of_pages);
+
+  std::vector<char> buf(SLOTTED_MAX_VALUE_SIZE);
+  for (int i = 0; i < NUM_KEYS; i++) {
+    uint16_t length = buf.size();
+    ASSERT_EQ(SUCCESS, find(fd, TEST_TID, i * 2, buf.data(), &length));
+    ASSERT_EQ(input.values[i], std::string(buf.data(), length));
+  }
+}
+
+TEST_F(HardInsertTest, InsertBatchSharesLeafDescents) {
+  int fd = FileMock::current_fd;
+  char value[VALUE_SIZE];
+  for (int64_t key = 0; key < 1000; key++) {
+    snprintf(value, VALUE_SIZE, "v%ld", key * 1000);
+    ASSERT_EQ(SUCCESS, bpt_insert(fd, TEST_TID, key * 1000, value));
+  }
+
+  // 한 leaf에 들어가는 key 10개는 탐색 한번
+  // (올라가며 넣은 leaf는 append split으로 꽉 차므로 자리가 남는 마지막 leaf)
+  std::vector<int64_t> keys;
+  std::vector<std::string> values;
+  for (int i = 10; i >= 1; i--) {
+    keys.push_back(998000 + i);
+    values.push_back("b" + std::to_string(998000 + i));
+  }
+  std::vector<char*> value_ptrs;
+  for (std::string& v : values) {
+    value_ptrs.push_back(&v[0]);
+  }
+  reset_buffer_stats();
+  ASSERT_EQ(10, bpt_insert_batch(fd, TEST_TID, keys.data(), value_ptrs.data(),
+                                 keys.size()));
+  buffer_stats_t stats;
+  get_buffer_stats(&stats);
+  ASSERT_LE(stats.hits + stats.misses, 6u);
+
+  // 한 leaf 범위에 넘치는 key: split 한번에 leaf 여러개, 이미 있는 key와
+  // batch 안에서 반복된 key는 건너뜀
+  keys.clear();
+  values.clear();
+  std::mt19937 rng(9);
+  for (int i = 0; i < 200; i++) {
+    keys.push_back(7000 + rng() % 150);
+  }
+  keys.push_back(7000);  // 이미 있음
+  for (int64_t key : keys) {
+    values.push_back("c" + std::to_string(key));
+  }
+  value_ptrs.clear();
+  for (std::string& v : values) {
+    value_ptrs.push_back(&v[0]);
+  }
+  std::vector<int64_t> unique_keys(keys.begin(), keys.end() - 1);
+  std::sort(unique_keys.begin(), unique_keys.end());
+  unique_keys.erase(std::unique(unique_keys.begin(), unique_keys.end()),
+                    unique_keys.end());
+  unique_keys.erase(
+      std::remove(unique_keys.begin(), unique_keys.end(), 7000),
+      unique_keys.end());
+  ASSERT_EQ((int)unique_keys.size(),
+            bpt_insert_batch(fd, TEST_TID, keys.data(), value_ptrs.data(),
+                             keys.size()));
+
+  char buf[VALUE_SIZE];
+  ASSERT_EQ(SUCCESS, find(fd, TEST_TID, 7000, buf));
+  ASSERT_STREQ("v7000", buf);
+  for (int64_t key : unique_keys) {
+    ASSERT_EQ(SUCCESS, find(fd, TEST_TID, key, buf)) << key;
+    ASSERT_EQ("c" + std::to_string(key), std::string(buf));
+  }
+  for (int i = 1; i <= 10; i++) {
+    ASSERT_EQ(SUCCESS, find(fd, TEST_TID, 998000 + i, buf));
+  }
+
+  // leaf는 sibling 순서대로 key가 오르고 모두 root 아래
+  header_page_t header = get_header_page(fd, TEST_TID);
+  internal_page_t root = get_internal_page(fd, TEST_TID, header.root_page_num);
+  pagenum_t leaf_num = root.one_more_page_num;
+  int total = 0;
+  int64_t prev_key = -1;
+  while (leaf_num != PAGE_NULL) {
+    leaf_page_t leaf = get_leaf_page(fd, TEST_TID, leaf_num);
+    ASSERT_EQ(header.root_page_num, leaf.parent_page_num);
+    for (int j = 0; j < (int)leaf.num_of_keys; j++) {
+      ASSERT_LT(prev_key, leaf_key(&leaf, j));
+      prev_key = leaf_key(&leaf, j);
+    }
+    total += leaf.num_of_keys;
+    leaf_num = leaf.right_sibling_page_num;
+  }
+  ASSERT_EQ(1000 + 10 + (int)unique_keys.size(), total);
+}
+
+TEST_F(HardInsertTest, AppendSplitFillsLeftLeaves) {
+  int fd = FileMock::current_fd;
+  char value[VALUE_SIZE];
+  const int NUM_KEYS = RECORD_CNT * 20 + 5;
+  for (int64_t key = 0; key < NUM_KEYS; key++) {
+    snprintf(value, VALUE_SIZE, "v%ld", key);
+    ASSERT_EQ(SUCCESS, bpt_insert(fd, TEST_TID, key * 10, value));
+  }
+
+  // key가 계속 커지면 마지막 leaf만 빼고 꽉 참
+  header_page_t header = get_header_page(fd, TEST_TID);
+  internal_page_t root = get_internal_page(fd, TEST_TID, header.root_page_num);
+  ASSERT_EQ(INTERNAL, root.is_leaf);
+  ASSERT_EQ(20, root.num_of_keys);
+  pagenum_t leaf_num = root.one_more_page_num;
+  while (leaf_num != PAGE_NULL) {
+    leaf_page_t leaf = get_leaf_page(fd, TEST_TID, leaf_num);
+    if (leaf.right_sibling_page_num == PAGE_NULL) {
+      ASSERT_EQ(5u, leaf.num_of_keys);
+    } else {
+      ASSERT_EQ((uint32_t)RECORD_CNT, leaf.num_of_keys);
+    }
+    leaf_num = leaf.right_sibling_page_num;
+  }
+
+  // append는 기억해 둔 마지막 leaf에 바로 넣음, header와 root를 읽지 않음
+  reset_buffer_stats();
+  ASSERT_EQ(SUCCESS, bpt_insert(fd, TEST_TID, NUM_KEYS * 10, value));
+  buffer_stats_t stats;
+  get_buffer_stats(&stats);
+  ASSERT_LE(stats.hits + stats.misses, 2u);
+
+  // 닫은 table의 leaf는 기억하지 않음, 다시 내려감
+  forget_rightmost_leaf(TEST_TID);
+  reset_buffer_stats();
+  ASSERT_EQ(SUCCESS, bpt_insert(fd, TEST_TID, NUM_KEYS * 10 + 1, value));
+  get_buffer_stats(&stats);
+  ASSERT_GT(stats.hits + stats.misses, 2u);
+  ASSERT_EQ(FAILURE, bpt_insert(fd, TEST_TID, NUM_KEYS * 10, value));
+
+  // 가운데 꽉 찬 leaf는 전처럼 반씩 나눔
+  ASSERT_EQ(SUCCESS, bpt_insert(fd, TEST_TID, 5, value));
+  leaf_page_t first = get_leaf_page(fd, TEST_TID, root.one_more_page_num);
+  ASSERT_EQ((uint32_t)cut(RECORD_CNT), first.num_of_keys);
+  leaf_page_t second =
+      get_leaf_page(fd, TEST_TID, first.right_sibling_page_num);
+  ASSERT_EQ((uint32_t)(RECORD_CNT + 1 - cut(RECORD_CNT)), second.num_of_keys);
+
+  for (int64_t key = 0; key <= NUM_KEYS; key++) {
+    char buf[VALUE_SIZE];
+    ASSERT_EQ(SUCCESS, find(fd, TEST_TID, key * 10, buf)) << key;
+  }
+  ASSERT_EQ(SUCCESS, find(fd, TEST_TID, NUM_KEYS * 10 + 1, value));
+}
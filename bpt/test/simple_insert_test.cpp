@@ -12,7 +12,6 @@ static void init_buffer_manager(int buf_size) {
   buf_mgr.frames_size = buf_size;
   buf_mgr.frames =
       (buf_ctl_block_t*)std::calloc(buf_size, sizeof(buf_ctl_block_t));
-  buf_mgr.clock_hand = 0;
 
   for (int i = 0; i < buf_size; ++i) {
     buf_mgr.frames[i].frame = std::calloc(1, PAGE_SIZE);
@@ -23,10 +22,7 @@ static void init_buffer_manager(int buf_size) {
     buf_mgr.frames[i].ref_bit = false;
   }
 
-  constexpr int MAX_TABLES = MAX_TABLE_COUNT + 1;
-  for (int i = 0; i < MAX_TABLES; ++i) {
-    buf_mgr.page_table[i].clear();
-  }
+  init_buf_partitions(buf_size);
 }
 
 static void shutdown_buffer_manager() {
@@ -35,10 +31,7 @@ static void shutdown_buffer_manager() {
   }
   std::free(buf_mgr.frames);
 
-  constexpr int MAX_TABLES = 11;
-  for (int i = 0; i < MAX_TABLES; ++i) {
-    buf_mgr.page_table[i].clear();
-  }
+  clear_buf_partitions();
 }
 
 static leaf_page_t get_leaf_page(int fd, tableid_t table_id,
@@ -174,11 +167,11 @@ TEST_F(SimpleInsertTest, Step5_StartNewTreeDirect) {
       get_leaf_page(FileMock::current_fd, TEST_TID, header.root_page_num);
   std::cout << "Root - is_leaf: " << root.is_leaf << std::endl;
   std::cout << "Root - num_of_keys: " << root.num_of_keys << std::endl;
-  std::cout << "Root - records[0].key: " << root.records[0].key << std::endl;
+  std::cout << "Root - key[0]: " << leaf_key(&root, 0) << std::endl;
 
   ASSERT_EQ(root.is_leaf, LEAF);
   ASSERT_EQ(root.num_of_keys, 1);
-  ASSERT_EQ(root.records[0].key, key);
+  ASSERT_EQ(leaf_key(&root, 0), key);
 
   std::cout << "=== Step 5 PASSED ===" << std::endl;
 }
@@ -192,7 +185,7 @@ TEST_F(SimpleInsertTest, Step6_FullInsert) {
 
   std::cout << "Before bpt_insert - checking buffer state..." << std::endl;
   std::cout << "Buffer frames_size: " << buf_mgr.frames_size << std::endl;
-  std::cout << "Clock hand: " << buf_mgr.clock_hand << std::endl;
+  std::cout << "Clock hand: " << buf_mgr.partitions[0].clock_hand << std::endl;
 
   std::cout << "Calling bpt_insert..." << std::endl;
   int result = bpt_insert(FileMock::current_fd, TEST_TID, key, value);
@@ -209,11 +202,11 @@ TEST_F(SimpleInsertTest, Step6_FullInsert) {
       get_leaf_page(FileMock::current_fd, TEST_TID, header.root_page_num);
   std::cout << "Root - is_leaf: " << root.is_leaf << std::endl;
   std::cout << "Root - num_of_keys: " << root.num_of_keys << std::endl;
-  std::cout << "Root - key[0]: " << root.records[0].key << std::endl;
+  std::cout << "Root - key[0]: " << leaf_key(&root, 0) << std::endl;
 
   ASSERT_EQ(root.is_leaf, LEAF);
   ASSERT_EQ(root.num_of_keys, 1);
-  ASSERT_EQ(root.records[0].key, 10);
+  ASSERT_EQ(leaf_key(&root, 0), 10);
 
   std::cout << "=== Step 6 PASSED ===" << std::endl;
 }
@@ -0,0 +1,106 @@
+/*
+g++ -O2 -I../include -o bench_aio bench_aio.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+
+thread pool backend: add -DBPT_NO_IO_URING
+*/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "db_api.h"
+#include "file.h"
+#include "txn_mgr.h"
+
+#define BENCH_DB_PATH "bench_aio.db"
+#define BUFFER_FRAMES (64)  // 작은 버퍼로 eviction write, miss read를 유도
+#define INSERT_COUNT (20000)
+#define FIND_THREADS (4)
+#define FINDS_PER_THREAD (20000)
+
+int table_id;
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * 트랜잭션 하나에 랜덤 키 하나를 찾는 worker
+ */
+void* find_worker(void* arg) {
+  unsigned int seed = (unsigned int)(long)arg;
+  char value[VALUE_SIZE];
+
+  for (int i = 0; i < FINDS_PER_THREAD; i++) {
+    int64_t key = rand_r(&seed) % INSERT_COUNT;
+    int txn_id = txn_begin();
+    if (db_find(table_id, key, value, txn_id) != SUCCESS) {
+      fprintf(stderr, "find failed: %ld\n", key);
+      exit(EXIT_FAILURE);
+    }
+    txn_commit(txn_id);
+  }
+  return NULL;
+}
+
+int main() {
+  const char* backend_names[] = {"sync", "io_uring", "thread pool"};
+  std::vector<int64_t> keys(INSERT_COUNT);
+  for (int i = 0; i < INSERT_COUNT; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+
+  unlink(BENCH_DB_PATH);
+  init_db(BUFFER_FRAMES);
+  char path[] = BENCH_DB_PATH;
+  table_id = open_table(path);
+  char value[VALUE_SIZE];
+
+  // SYNC_EVERY_WRITE: eviction write의 pwrite + fsync가 I/O 스레드로 넘어감
+  double start = now_sec();
+  for (int64_t key : keys) {
+    snprintf(value, VALUE_SIZE, "%ld_value", key);
+    if (db_insert(table_id, key, value) != SUCCESS) {
+      fprintf(stderr, "insert failed: %ld\n", key);
+      exit(EXIT_FAILURE);
+    }
+  }
+  close_table(table_id);
+  double insert_rate = INSERT_COUNT / (now_sec() - start);
+  shutdown_db();
+
+  // 캐시가 비어있는 상태에서 동시 조회, miss read는 buffer latch 밖에서
+  init_db(BUFFER_FRAMES);
+  table_id = open_table(path);
+  pthread_t threads[FIND_THREADS];
+  start = now_sec();
+  for (long i = 0; i < FIND_THREADS; i++) {
+    pthread_create(&threads[i], NULL, find_worker, (void*)(i + 1));
+  }
+  for (int i = 0; i < FIND_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  double find_rate = FIND_THREADS * FINDS_PER_THREAD / (now_sec() - start);
+  AioBackend backend = file_aio_backend();
+  close_table(table_id);
+  shutdown_db();
+  unlink(BENCH_DB_PATH);
+
+  printf("\nbackend: %s, %d buffer frames\n", backend_names[backend],
+         BUFFER_FRAMES);
+  printf("%-32s %12.0f ops/sec\n", "random insert (EVERY_WRITE)",
+         insert_rate);
+  printf("%-32s %12.0f ops/sec\n", "txn find (4 threads)", find_rate);
+  return 0;
+}
@@ -0,0 +1,72 @@
+/*
+g++ -O2 -I../include -o bench_append bench_append.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bpt.h"
+#include "buf_mgr.h"
+#include "db_api.h"
+
+#define BENCH_DB_PATH "bench_append.db"
+#define KEY_COUNT (1000000)
+#define BUFFER_FRAMES (2048)  // 8MB, tree 전체보다 작음
+#define VALUE_LENGTH (32)
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * 빈 table에 timestamp처럼 계속 커지는 key를 하나씩 넣음
+ * 시간, key당 buffer lookup, 닫은 뒤 파일의 page 수
+ */
+int main() {
+  unlink(BENCH_DB_PATH);
+  init_db(BUFFER_FRAMES);
+  db_set_durability(SYNC_DEFERRED, 0);
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path);
+  if (table_id < 0 || db_set_tree_mode(table_id, TREE_MODE_PATH) != SUCCESS) {
+    fprintf(stderr, "failed to open %s\n", BENCH_DB_PATH);
+    exit(EXIT_FAILURE);
+  }
+  char value[VALUE_LENGTH];
+  memset(value, 'v', VALUE_LENGTH);
+
+  buffer_stats_t before;
+  db_get_buffer_stats(&before);
+  double start = now_sec();
+  for (int64_t key = 0; key < KEY_COUNT; key++) {
+    db_insert(table_id, key * 1000, value, VALUE_LENGTH);
+  }
+  double elapsed = now_sec() - start;
+  buffer_stats_t stats;
+  db_get_buffer_stats(&stats);
+
+  close_table(table_id);
+  shutdown_db();
+  struct stat st;
+  stat(BENCH_DB_PATH, &st);
+  unlink(BENCH_DB_PATH);
+
+  printf("%d increasing keys, value %d bytes, buffer %d frames, "
+         "APPEND_SPLIT_PERCENT %d\n",
+         KEY_COUNT, VALUE_LENGTH, BUFFER_FRAMES, APPEND_SPLIT_PERCENT);
+  printf("insert %6.0f ns/key  lookups %7.4f/key  misses %6.4f/key  "
+         "pages %ld\n",
+         elapsed * 1e9 / KEY_COUNT,
+         (double)(stats.hits + stats.misses - before.hits - before.misses) /
+             KEY_COUNT,
+         (double)(stats.misses - before.misses) / KEY_COUNT,
+         (long)(st.st_size / PAGE_SIZE));
+  return 0;
+}
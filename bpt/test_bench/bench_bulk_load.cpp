@@ -0,0 +1,134 @@
+/*
+g++ -O2 -I../include -o bench_bulk_load bench_bulk_load.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <random>
+
+#include "bpt.h"
+#include "buf_mgr.h"
+#include "db_api.h"
+
+#define BENCH_DB_PATH "bench_bulk.db"
+#define KEY_COUNT (5000000)
+#define BUFFER_FRAMES (4096)  // 16MB, tree 전체보다 작음
+#define READS (200000)
+
+typedef struct {
+  int64_t next_key;
+  char value[VALUE_SIZE];
+} sorted_input_t;
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int next_sorted_record(void* ctx, int64_t* key, const char** value,
+                       uint16_t* length) {
+  sorted_input_t* input = (sorted_input_t*)ctx;
+  if (input->next_key == KEY_COUNT) {
+    return FAILURE;
+  }
+  *key = input->next_key++;
+  *length = snprintf(input->value, VALUE_SIZE, "value%ld", *key) + 1;
+  *value = input->value;
+  return SUCCESS;
+}
+
+int open_bench_table() {
+  unlink(BENCH_DB_PATH);
+  init_db(BUFFER_FRAMES);
+  db_set_durability(SYNC_DEFERRED, 0);
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path);
+  if (table_id < 0) {
+    fprintf(stderr, "failed to open %s\n", BENCH_DB_PATH);
+    exit(EXIT_FAILURE);
+  }
+  return table_id;
+}
+
+/**
+ * db_sync까지의 시간을 재고, 임의의 key를 읽어 값이 맞는지 확인
+ */
+void finish_bench(const char* name, int table_id, double start) {
+  db_sync(table_id);
+  double elapsed = now_sec() - start;
+
+  std::mt19937_64 rng(7);
+  char buf[VALUE_SIZE];
+  char expected[VALUE_SIZE];
+  for (int i = 0; i < READS; i++) {
+    int64_t key = rng() % KEY_COUNT;
+    snprintf(expected, VALUE_SIZE, "value%ld", key);
+    if (db_find(table_id, key, buf) != SUCCESS || strcmp(buf, expected) != 0) {
+      fprintf(stderr, "%s: wrong value for %ld\n", name, key);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  header_page_t* header =
+      read_header_page(table_infos[table_id].fd, table_id);
+  pagenum_t num_of_pages = header->num_of_pages;
+  unpin(table_id, HEADER_PAGE_POS);
+  double mbytes = (double)num_of_pages * PAGE_SIZE / (1024 * 1024);
+  printf("%-10s %8.2f s  %9.0f keys/s  %8.1f MB  %7.1f MB/s\n", name, elapsed,
+         KEY_COUNT / elapsed, mbytes, mbytes / elapsed);
+
+  close_table(table_id);
+  shutdown_db();
+  unlink(BENCH_DB_PATH);
+}
+
+/**
+ * 지금까지의 방법, 정렬된 key를 하나씩 db_insert
+ */
+void bench_insert() {
+  int table_id = open_bench_table();
+  sorted_input_t input;
+  input.next_key = 0;
+  int64_t key;
+  const char* value;
+  uint16_t length;
+
+  double start = now_sec();
+  while (next_sorted_record(&input, &key, &value, &length) == SUCCESS) {
+    if (db_insert(table_id, key, value, length) != SUCCESS) {
+      fprintf(stderr, "insert failed\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+  finish_bench("db_insert", table_id, start);
+}
+
+void bench_bulk_load(int fill_percent) {
+  int table_id = open_bench_table();
+  sorted_input_t input;
+  input.next_key = 0;
+
+  double start = now_sec();
+  if (db_bulk_load(table_id, next_sorted_record, &input, fill_percent) !=
+      SUCCESS) {
+    fprintf(stderr, "bulk load failed\n");
+    exit(EXIT_FAILURE);
+  }
+  char name[32];
+  snprintf(name, sizeof(name), "bulk(%d%%)", fill_percent);
+  finish_bench(name, table_id, start);
+}
+
+int main() {
+  printf("%d sorted keys, buffer %d frames\n", KEY_COUNT, BUFFER_FRAMES);
+  bench_insert();
+  bench_bulk_load(100);
+  bench_bulk_load(BULK_LOAD_FILL_PERCENT);
+  return 0;
+}
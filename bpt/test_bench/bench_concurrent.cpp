@@ -0,0 +1,145 @@
+/*
+g++ -O2 -I../include -o bench_concurrent bench_concurrent.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+*/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bpt.h"
+#include "buf_mgr.h"
+#include "db_api.h"
+
+#define BENCH_DB_PATH "bench_concurrent.db"
+#define BUFFER_FRAMES (16384)  // 64MB, tree 전체가 버퍼에 올라감
+#define KEY_COUNT (500000)     // 처음에 넣는 key 수, key 범위는 두배
+#define OPS_PER_THREAD (200000)
+#define MAX_THREADS (8)
+#define VALUE_LENGTH (32)
+#define FIND_PERCENT (70)    // 나머지는 insert와 delete가 반씩
+#define INSERT_PERCENT (15)
+
+int table_id;
+pthread_mutex_t table_latch = PTHREAD_MUTEX_INITIALIZER;
+bool use_table_latch;
+int find_percent = FIND_PERCENT;
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * 지금까지의 방법, insert/delete가 latch를 잡지 않으므로 table 전체를
+ * mutex 하나로 막고 하나씩
+ */
+void run_locked_op(int op, int64_t key, const char* value, char* out) {
+  uint16_t length = VALUE_SIZE;
+  pthread_mutex_lock(&table_latch);
+  if (op < find_percent) {
+    db_find(table_id, key, out, &length);
+  } else if (op < find_percent + INSERT_PERCENT) {
+    db_insert(table_id, key, value, VALUE_LENGTH);
+  } else {
+    db_delete(table_id, key);
+  }
+  pthread_mutex_unlock(&table_latch);
+}
+
+void run_concurrent_op(int op, int64_t key, const char* value, char* out) {
+  uint16_t length = VALUE_SIZE;
+  if (op < find_percent) {
+    db_find_concurrent(table_id, key, out, &length);
+  } else if (op < find_percent + INSERT_PERCENT) {
+    db_insert_concurrent(table_id, key, value, VALUE_LENGTH);
+  } else {
+    db_delete_concurrent(table_id, key);
+  }
+}
+
+void* mixed_worker(void* arg) {
+  unsigned int seed = (unsigned int)(long)arg;
+  char value[VALUE_LENGTH];
+  char out[VALUE_SIZE];
+  memset(value, 'v', VALUE_LENGTH);
+
+  for (int i = 0; i < OPS_PER_THREAD; i++) {
+    int64_t key = rand_r(&seed) % (KEY_COUNT * 2);
+    int op = rand_r(&seed) % 100;
+    if (use_table_latch) {
+      run_locked_op(op, key, value, out);
+    } else {
+      run_concurrent_op(op, key, value, out);
+    }
+  }
+  return NULL;
+}
+
+double run_mixed(int thread_count) {
+  pthread_t threads[MAX_THREADS];
+
+  double start = now_sec();
+  for (long i = 0; i < thread_count; i++) {
+    pthread_create(&threads[i], NULL, mixed_worker, (void*)(i + 1));
+  }
+  for (int i = 0; i < thread_count; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  return (double)thread_count * OPS_PER_THREAD / (now_sec() - start);
+}
+
+/**
+ * 짝수 key만 들어있는 table을 만들고 스레드 수별 처리량을 잼
+ */
+void bench_mixed(bool table_latch_mode) {
+  unlink(BENCH_DB_PATH);
+  init_db(BUFFER_FRAMES);
+  db_set_durability(SYNC_DEFERRED, 0);
+  char path[] = BENCH_DB_PATH;
+  table_id = open_table(path);
+  if (table_id < 0 || db_set_tree_mode(table_id, TREE_MODE_PATH) != SUCCESS) {
+    fprintf(stderr, "failed to open %s\n", BENCH_DB_PATH);
+    exit(EXIT_FAILURE);
+  }
+  char value[VALUE_LENGTH];
+  memset(value, 'v', VALUE_LENGTH);
+  for (int64_t key = 0; key < KEY_COUNT * 2; key += 2) {
+    db_insert(table_id, key, value, VALUE_LENGTH);
+  }
+
+  use_table_latch = table_latch_mode;
+  run_mixed(1);  // warm up
+  printf("%s\n", table_latch_mode ? "table mutex + db_insert/db_delete"
+                                  : "db_*_concurrent");
+  for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+    printf("%2d threads %14.0f ops/sec\n", threads, run_mixed(threads));
+  }
+  if (!table_latch_mode) {
+    // point lookup만, internal page는 latch 없이 지나감
+    // -DOPTIMISTIC_MAX_RESTARTS=0으로 컴파일하면 shared latch crabbing
+    find_percent = 100;
+    printf("db_find_concurrent only\n");
+    for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+      printf("%2d threads %14.0f ops/sec\n", threads, run_mixed(threads));
+    }
+    find_percent = FIND_PERCENT;
+  }
+
+  close_table(table_id);
+  shutdown_db();
+  unlink(BENCH_DB_PATH);
+}
+
+int main() {
+  printf("%d keys, %d%% find / %d%% insert / %d%% delete, %d buffer frames\n",
+         KEY_COUNT, FIND_PERCENT, INSERT_PERCENT,
+         100 - FIND_PERCENT - INSERT_PERCENT, BUFFER_FRAMES);
+  bench_mixed(true);
+  bench_mixed(false);
+  return 0;
+}
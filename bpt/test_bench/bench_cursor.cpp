@@ -0,0 +1,190 @@
+/*
+g++ -O2 -I../include -o bench_cursor bench_cursor.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "bpt.h"
+#include "buf_mgr.h"
+#include "db_api.h"
+
+#define BENCH_DB_PATH "bench_cursor.db"
+#define KEY_COUNT (2000000)
+#define BUFFER_FRAMES (4096)  // 16MB, tree 전체보다 작음
+
+typedef struct {
+  int64_t next_key;
+  char value[VALUE_SIZE];
+} sorted_input_t;
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int next_sorted_record(void* ctx, int64_t* key, const char** value,
+                       uint16_t* length) {
+  sorted_input_t* input = (sorted_input_t*)ctx;
+  if (input->next_key == KEY_COUNT) {
+    return FAILURE;
+  }
+  *key = input->next_key++;
+  *length = snprintf(input->value, VALUE_SIZE, "value%ld", *key) + 1;
+  *value = input->value;
+  return SUCCESS;
+}
+
+TableOpenMode open_mode = OPEN_BUFFERED;
+
+int open_bench_table() {
+  init_db(BUFFER_FRAMES);
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path, open_mode);
+  if (table_id < 0) {
+    fprintf(stderr, "failed to open %s\n", BENCH_DB_PATH);
+    exit(EXIT_FAILURE);
+  }
+  return table_id;
+}
+
+void close_bench_table(int table_id) {
+  close_table(table_id);
+  shutdown_db();
+}
+
+void print_result(const char* name, double elapsed, uint64_t checksum) {
+  buffer_stats_t stats;
+  db_get_buffer_stats(&stats);
+  printf("%-28s %6.3f s  %6.1f ns/record  lookups %5.3f/record  (%lu)\n",
+         name, elapsed, elapsed * 1e9 / KEY_COUNT,
+         (double)(stats.hits + stats.misses) / KEY_COUNT, checksum);
+}
+
+/**
+ * 지금까지의 방법, MAX_RANGE_SIZE씩 find_range로 위치를 모은 뒤
+ * find_and_print_range처럼 record마다 leaf를 다시 읽어 value를 꺼냄
+ */
+void bench_find_range() {
+  int table_id = open_bench_table();
+  int fd = table_infos[table_id].fd;
+  std::vector<int64_t> keys(MAX_RANGE_SIZE);
+  std::vector<pagenum_t> pages(MAX_RANGE_SIZE);
+  std::vector<int> indices(MAX_RANGE_SIZE);
+  char value[VALUE_SIZE];
+  uint64_t checksum = 0;
+
+  double start = now_sec();
+  for (int64_t from = 0; from < KEY_COUNT; from += MAX_RANGE_SIZE) {
+    int found = find_range(fd, table_id, from, from + MAX_RANGE_SIZE - 1,
+                           keys.data(), pages.data(), indices.data());
+    for (int i = 0; i < found; i++) {
+      leaf_page_t* leaf = (leaf_page_t*)read_buffer(fd, table_id, pages[i]);
+      copy_leaf_value(value, leaf, indices[i]);
+      unpin(table_id, pages[i]);
+      checksum += keys[i] + value[5];
+    }
+  }
+  print_result("find_range + re-read", now_sec() - start, checksum);
+  close_bench_table(table_id);
+}
+
+void bench_cursor() {
+  int table_id = open_bench_table();
+  char value[VALUE_SIZE];
+  int64_t key;
+  uint64_t checksum = 0;
+
+  double start = now_sec();
+  cursor_t* cursor = db_cursor_open(table_id);
+  db_cursor_seek(cursor, 0);
+  while (db_cursor_next(cursor, &key, value) == SUCCESS) {
+    checksum += key + value[5];
+  }
+  db_cursor_close(cursor);
+  print_result("db_cursor", now_sec() - start, checksum);
+  close_bench_table(table_id);
+}
+
+/**
+ * left link 전의 방법, leaf마다 첫 key 바로 아래 key로 root부터 다시 내려감
+ */
+void bench_reverse_descent() {
+  int table_id = open_bench_table();
+  int fd = table_infos[table_id].fd;
+  char value[VALUE_SIZE];
+  uint64_t checksum = 0;
+
+  double start = now_sec();
+  int64_t key = INT64_MAX;
+  while (true) {
+    pagenum_t leaf_num = find_leaf(fd, table_id, key);
+    leaf_page_t* leaf = (leaf_page_t*)read_buffer(fd, table_id, leaf_num);
+    int index = leaf_lower_bound(leaf, key);
+    if (index == (int)leaf->num_of_keys || leaf_key(leaf, index) != key) {
+      index--;
+    }
+    for (; index >= 0; index--) {
+      copy_leaf_value(value, leaf, index);
+      checksum += leaf_key(leaf, index) + value[5];
+    }
+    bool leftmost = leaf->num_of_keys == 0 || leaf_key(leaf, 0) == 0;
+    key = leaf->num_of_keys == 0 ? key : leaf_key(leaf, 0) - 1;
+    unpin(table_id, leaf_num);
+    if (leftmost) {
+      break;
+    }
+  }
+  print_result("reverse, descent per leaf", now_sec() - start, checksum);
+  close_bench_table(table_id);
+}
+
+void bench_cursor_reverse() {
+  int table_id = open_bench_table();
+  char value[VALUE_SIZE];
+  int64_t key;
+  uint64_t checksum = 0;
+
+  double start = now_sec();
+  cursor_t* cursor = db_cursor_open(table_id);
+  db_cursor_seek_reverse(cursor, INT64_MAX);
+  while (db_cursor_next(cursor, &key, value) == SUCCESS) {
+    checksum += key + value[5];
+  }
+  db_cursor_close(cursor);
+  print_result("db_cursor, reverse", now_sec() - start, checksum);
+  close_bench_table(table_id);
+}
+
+int main() {
+  unlink(BENCH_DB_PATH);
+  int table_id = open_bench_table();
+  db_set_durability(SYNC_DEFERRED, 0);
+  sorted_input_t input;
+  input.next_key = 0;
+  if (db_bulk_load(table_id, next_sorted_record, &input) != SUCCESS) {
+    fprintf(stderr, "bulk load failed\n");
+    exit(EXIT_FAILURE);
+  }
+  close_bench_table(table_id);
+
+  printf("full scan of %d keys, buffer %d frames\n", KEY_COUNT, BUFFER_FRAMES);
+  TableOpenMode modes[2] = {OPEN_BUFFERED, OPEN_DIRECT};
+  for (TableOpenMode mode : modes) {
+    open_mode = mode;
+    printf("%s\n", mode == OPEN_DIRECT ? "O_DIRECT" : "buffered");
+    bench_find_range();
+    bench_cursor();
+    bench_reverse_descent();
+    bench_cursor_reverse();
+  }
+  unlink(BENCH_DB_PATH);
+  return 0;
+}
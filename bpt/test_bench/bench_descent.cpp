@@ -0,0 +1,133 @@
+/*
+g++ -O2 -I../include -o bench_descent bench_descent.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "bpt.h"
+#include "db_api.h"
+
+#define BENCH_DB_PATH "bench_descent.db"
+#define KEY_COUNT (300000)
+#define BUFFER_FRAMES (16384)  // 테이블 전체가 버퍼에 들어감
+#define KERNEL_SEARCHES (20000000)
+#define DESCENTS (3000000)
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+const char* kernel_name(SearchKernel kernel) {
+  switch (kernel) {
+    case SEARCH_LINEAR:
+      return "linear";
+    case SEARCH_BINARY:
+      return "binary";
+    case SEARCH_AVX2:
+      return "avx2";
+  }
+  return "?";
+}
+
+/*
+ * 꽉 찬 internal page 하나에서 kernel만 측정
+ */
+void bench_kernel(SearchKernel kernel, const std::vector<int64_t>& probes) {
+  internal_page_t* page = (internal_page_t*)calloc(1, sizeof(page_t));
+  for (int i = 0; i < ENTRY_CNT; i++) {
+    page->entries[i].key = (int64_t)i * 1000;
+    page->entries[i].page_num = i + 1;
+  }
+  page->num_of_keys = ENTRY_CNT;
+
+  uint64_t checksum = 0;
+  double start = now_sec();
+  for (int i = 0; i < KERNEL_SEARCHES; i++) {
+    checksum += internal_child_index(page, probes[i % probes.size()]);
+  }
+  double elapsed = now_sec() - start;
+  free(page);
+  printf("%-8s %d entries      %7.2f ns/search  (checksum %lu)\n",
+         kernel_name(kernel), ENTRY_CNT, elapsed * 1e9 / KERNEL_SEARCHES,
+         checksum);
+}
+
+/*
+ * 버퍼에 다 올라온 트리에서 root부터 leaf까지 내려가는 비용
+ */
+void bench_descent(SearchKernel kernel, int table_id,
+                   const std::vector<int64_t>& keys) {
+  int fd = table_infos[table_id].fd;
+  uint64_t checksum = 0;
+  double start = now_sec();
+  for (int i = 0; i < DESCENTS; i++) {
+    checksum += find_leaf(fd, table_id, keys[i % keys.size()]);
+  }
+  double elapsed = now_sec() - start;
+  printf("%-8s find_leaf         %7.2f ns/descent (checksum %lu)\n",
+         kernel_name(kernel), elapsed * 1e9 / DESCENTS, checksum);
+}
+
+int main() {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int64_t> dist(0, ENTRY_CNT * 1000);
+  std::vector<int64_t> probes(1 << 16);
+  for (int64_t& probe : probes) {
+    probe = dist(rng);
+  }
+
+  SearchKernel kernels[] = {SEARCH_LINEAR, SEARCH_BINARY, SEARCH_AVX2};
+  for (SearchKernel kernel : kernels) {
+    if (set_search_kernel(kernel) == SUCCESS) {
+      bench_kernel(kernel, probes);
+    }
+  }
+
+  unlink(BENCH_DB_PATH);
+  init_db(BUFFER_FRAMES);
+  db_set_durability(SYNC_DEFERRED, 0);
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path);
+  if (table_id < 0) {
+    fprintf(stderr, "failed to open %s\n", BENCH_DB_PATH);
+    exit(EXIT_FAILURE);
+  }
+  std::vector<int64_t> keys(KEY_COUNT);
+  for (int i = 0; i < KEY_COUNT; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), rng);
+  char value[VALUE_SIZE];
+  for (int64_t key : keys) {
+    snprintf(value, VALUE_SIZE, "%ld_value", key);
+    if (db_insert(table_id, key, value) != SUCCESS) {
+      fprintf(stderr, "insert failed: %ld\n", key);
+      exit(EXIT_FAILURE);
+    }
+  }
+  std::shuffle(keys.begin(), keys.end(), rng);
+
+  printf("\n%d keys, tree height %d\n", KEY_COUNT,
+         height(table_infos[table_id].fd, table_id, HEADER_PAGE_POS));
+  for (SearchKernel kernel : kernels) {
+    if (set_search_kernel(kernel) == SUCCESS) {
+      bench_descent(kernel, table_id, keys);
+    }
+  }
+
+  close_table(table_id);
+  shutdown_db();
+  unlink(BENCH_DB_PATH);
+  return 0;
+}
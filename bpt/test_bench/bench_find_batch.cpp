@@ -0,0 +1,139 @@
+/*
+g++ -O2 -I../include -o bench_find_batch bench_find_batch.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <random>
+#include <vector>
+
+#include "bpt.h"
+#include "buf_mgr.h"
+#include "db_api.h"
+
+#define BENCH_DB_PATH "bench_find_batch.db"
+#define KEY_COUNT (2000000)
+#define BUFFER_FRAMES (4096)  // 16MB, tree 전체보다 작음
+#define REQUEST_COUNT (400)
+#define BATCH_SIZES 3
+
+typedef struct {
+  int64_t next_key;
+  char value[VALUE_SIZE];
+} sorted_input_t;
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int next_sorted_record(void* ctx, int64_t* key, const char** value,
+                       uint16_t* length) {
+  sorted_input_t* input = (sorted_input_t*)ctx;
+  if (input->next_key == KEY_COUNT) {
+    return FAILURE;
+  }
+  *key = input->next_key++;
+  *length = snprintf(input->value, VALUE_SIZE, "value%ld", *key) + 1;
+  *value = input->value;
+  return SUCCESS;
+}
+
+void build_table() {
+  unlink(BENCH_DB_PATH);
+  init_db(BUFFER_FRAMES);
+  db_set_durability(SYNC_DEFERRED, 0);
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path);
+  sorted_input_t input;
+  input.next_key = 0;
+  if (table_id < 0 ||
+      db_bulk_load(table_id, next_sorted_record, &input) != SUCCESS) {
+    fprintf(stderr, "failed to build %s\n", BENCH_DB_PATH);
+    exit(EXIT_FAILURE);
+  }
+  close_table(table_id);
+  shutdown_db();
+}
+
+/**
+ * 빈 버퍼에서 batch_size개의 임의 key를 가진 요청을 REQUEST_COUNT번
+ * batch면 db_find_batch 한번, 아니면 key마다 db_find
+ */
+void run(const char* name, TableOpenMode open_mode, int batch_size,
+         bool batch) {
+  init_db(BUFFER_FRAMES);
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path, open_mode);
+  if (table_id < 0) {
+    printf("%-8s open failed\n", name);
+    shutdown_db();
+    return;
+  }
+
+  std::mt19937_64 rng(batch_size);
+  std::vector<int64_t> keys(batch_size);
+  std::vector<std::vector<char>> buffers(batch_size,
+                                         std::vector<char>(VALUE_SIZE));
+  std::vector<char*> values(batch_size);
+  for (int i = 0; i < batch_size; i++) {
+    values[i] = buffers[i].data();
+  }
+  std::vector<int> status(batch_size);
+
+  double elapsed = 0;
+  for (int r = 0; r < REQUEST_COUNT; r++) {
+    for (int64_t& key : keys) {
+      key = rng() % KEY_COUNT;
+    }
+    double start = now_sec();
+    int found = 0;
+    if (batch) {
+      found = db_find_batch(table_id, keys.data(), batch_size, values.data(),
+                            status.data());
+    } else {
+      for (int i = 0; i < batch_size; i++) {
+        found += db_find(table_id, keys[i], values[i]) == SUCCESS;
+      }
+    }
+    elapsed += now_sec() - start;
+    if (found != batch_size) {
+      fprintf(stderr, "%s: found %d of %d\n", name, found, batch_size);
+      exit(EXIT_FAILURE);
+    }
+  }
+  buffer_stats_t stats;
+  db_get_buffer_stats(&stats);
+  close_table(table_id);
+  shutdown_db();
+
+  double key_count = (double)REQUEST_COUNT * batch_size;
+  printf("%-10s %-9s batch %5d  %8.1f us/request  %6.2f us/key  "
+         "lookups %5.2f/key  misses %5.2f/key  prefetched %5.2f/key\n",
+         name, open_mode == OPEN_DIRECT ? "O_DIRECT" : "buffered", batch_size,
+         elapsed * 1e6 / REQUEST_COUNT, elapsed * 1e6 / key_count,
+         (stats.hits + stats.misses) / key_count, stats.misses / key_count,
+         stats.prefetched / key_count);
+}
+
+int main() {
+  build_table();
+  printf("%d keys, buffer %d frames, %d requests of random keys\n", KEY_COUNT,
+         BUFFER_FRAMES, REQUEST_COUNT);
+  int batch_sizes[BATCH_SIZES] = {100, 1000, 10000};
+  TableOpenMode modes[2] = {OPEN_BUFFERED, OPEN_DIRECT};
+  for (TableOpenMode mode : modes) {
+    for (int b = 0; b < BATCH_SIZES; b++) {
+      run("db_find", mode, batch_sizes[b], false);
+      run("find_batch", mode, batch_sizes[b], true);
+    }
+  }
+  unlink(BENCH_DB_PATH);
+  return 0;
+}
@@ -0,0 +1,148 @@
+/*
+g++ -O2 -I../include -o bench_insert_batch bench_insert_batch.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "bpt.h"
+#include "buf_mgr.h"
+#include "db_api.h"
+
+#define BENCH_DB_PATH "bench_batch.db"
+#define KEY_COUNT (1000000)
+#define BUFFER_FRAMES (65536)  // tree 전체가 버퍼에
+#define VALUE_LENGTH (32)
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int open_bench_table() {
+  unlink(BENCH_DB_PATH);
+  init_db(BUFFER_FRAMES);
+  db_set_durability(SYNC_DEFERRED, 0);
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path);
+  if (table_id < 0) {
+    fprintf(stderr, "failed to open %s\n", BENCH_DB_PATH);
+    exit(EXIT_FAILURE);
+  }
+  return table_id;
+}
+
+void close_bench_table(int table_id) {
+  close_table(table_id);
+  shutdown_db();
+  unlink(BENCH_DB_PATH);
+}
+
+void print_result(const char* name, int batch_size, double elapsed,
+                  const buffer_stats_t* stats) {
+  printf("%-10s batch %5d  %6.0f ns/key  buffer lookups %5.2f/key\n", name,
+         batch_size, elapsed * 1e9 / KEY_COUNT,
+         (double)(stats->hits + stats->misses) / KEY_COUNT);
+}
+
+/**
+ * 지금까지의 방법, key마다 db_insert
+ */
+void bench_single(const std::vector<int64_t>& keys, const char* value) {
+  int table_id = open_bench_table();
+  buffer_stats_t stats;
+  db_get_buffer_stats(&stats);
+  buffer_stats_t before = stats;
+
+  double start = now_sec();
+  for (int64_t key : keys) {
+    db_insert(table_id, key, value, VALUE_LENGTH);
+  }
+  double elapsed = now_sec() - start;
+  db_get_buffer_stats(&stats);
+  stats.hits -= before.hits;
+  stats.misses -= before.misses;
+  print_result("db_insert", 1, elapsed, &stats);
+  close_bench_table(table_id);
+}
+
+/**
+ * batch_size개씩 db_insert_batch
+ */
+void bench_batch(const char* name, const std::vector<int64_t>& keys,
+                 const char* value, int batch_size) {
+  int table_id = open_bench_table();
+  std::vector<const char*> values(batch_size, value);
+  std::vector<uint16_t> lengths(batch_size, VALUE_LENGTH);
+  buffer_stats_t stats;
+  db_get_buffer_stats(&stats);
+  buffer_stats_t before = stats;
+
+  double start = now_sec();
+  int inserted = 0;
+  for (int i = 0; i < KEY_COUNT; i += batch_size) {
+    int n = std::min(batch_size, KEY_COUNT - i);
+    inserted += db_insert_batch(table_id, &keys[i], values.data(),
+                                lengths.data(), n);
+  }
+  double elapsed = now_sec() - start;
+  if (inserted != KEY_COUNT) {
+    fprintf(stderr, "inserted %d of %d\n", inserted, KEY_COUNT);
+    exit(EXIT_FAILURE);
+  }
+  db_get_buffer_stats(&stats);
+  stats.hits -= before.hits;
+  stats.misses -= before.misses;
+  print_result(name, batch_size, elapsed, &stats);
+  close_bench_table(table_id);
+}
+
+/**
+ * batch 하나가 이어진 key 구간을 임의 순서로 가짐 (시간순 ingestion)
+ */
+std::vector<int64_t> clustered_keys(int batch_size, std::mt19937& rng) {
+  std::vector<int64_t> keys(KEY_COUNT);
+  std::vector<int> chunks;
+  for (int i = 0; i < KEY_COUNT; i += batch_size) {
+    chunks.push_back(i);
+  }
+  std::shuffle(chunks.begin(), chunks.end(), rng);
+  int pos = 0;
+  for (int chunk : chunks) {
+    int start = pos;
+    for (int key = chunk; key < chunk + batch_size && key < KEY_COUNT; key++) {
+      keys[pos++] = key;
+    }
+    std::shuffle(keys.begin() + start, keys.begin() + pos, rng);
+  }
+  return keys;
+}
+
+int main() {
+  printf("%d keys, value %d bytes, buffer %d frames\n", KEY_COUNT,
+         VALUE_LENGTH, BUFFER_FRAMES);
+  std::vector<int64_t> keys(KEY_COUNT);
+  for (int i = 0; i < KEY_COUNT; i++) {
+    keys[i] = i;
+  }
+  std::mt19937 rng(42);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  char value[VALUE_LENGTH];
+  memset(value, 'v', VALUE_LENGTH);
+
+  bench_single(keys, value);
+  bench_batch("random", keys, value, 100);
+  bench_batch("random", keys, value, 1000);
+  bench_batch("random", keys, value, 10000);
+  bench_batch("clustered", clustered_keys(1000, rng), value, 1000);
+  return 0;
+}
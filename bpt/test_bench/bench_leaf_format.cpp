@@ -0,0 +1,150 @@
+/*
+g++ -O2 -I../include -o bench_leaf_format bench_leaf_format.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "bpt.h"
+#include "db_api.h"
+
+#define BENCH_DB_PATH "bench_leaf_fmt.db"
+#define KEY_COUNT (300000)
+#define BUFFER_FRAMES (16384)  // 테이블 전체가 버퍼에 들어감
+#define LEAF_PAGES (16384)     // 64MB, cache에 들어가지 않는 leaf 묶음
+#define LEAF_SEARCHES (20000000)
+#define POINT_FINDS (3000000)
+#define SCAN_ROUNDS (20)
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+const char* format_name(uint32_t format) {
+  return format == LEAF_FORMAT_KEY_ARRAY ? "key_array" : "records";
+}
+
+/*
+ * 꽉 찬 leaf 여러개 중 임의의 leaf에서 leaf_find_index만 측정
+ * leaf들이 cache보다 커서 탐색이 건드리는 cache line 수가 드러남
+ */
+void bench_leaf_search(uint32_t format, SearchKernel kernel,
+                       const char* name) {
+  std::mt19937 rng(7);
+  leaf_page_t* leaves = (leaf_page_t*)calloc(LEAF_PAGES, sizeof(page_t));
+  for (int p = 0; p < LEAF_PAGES; p++) {
+    leaves[p].format = format;
+    leaves[p].is_leaf = LEAF;
+    leaves[p].num_of_keys = RECORD_CNT;
+    for (int i = 0; i < RECORD_CNT; i++) {
+      leaf_set_key(&leaves[p], i, (int64_t)i * 2);
+    }
+  }
+  std::vector<uint32_t> picks(1 << 16);
+  for (uint32_t& pick : picks) {
+    pick = rng();
+  }
+  set_search_kernel(kernel);
+
+  uint64_t checksum = 0;
+  double start = now_sec();
+  for (int i = 0; i < LEAF_SEARCHES; i++) {
+    uint32_t pick = picks[i & (picks.size() - 1)] + i;
+    checksum += leaf_find_index(&leaves[pick % LEAF_PAGES],
+                                (int64_t)(pick % RECORD_CNT) * 2);
+  }
+  double elapsed = now_sec() - start;
+  free(leaves);
+  set_search_kernel(SEARCH_BINARY);
+  printf("%-9s %-7s leaf_find_index %7.2f ns/search (checksum %lu)\n",
+         format_name(format), name, elapsed * 1e9 / LEAF_SEARCHES, checksum);
+}
+
+/*
+ * 같은 key로 format만 다른 table을 만들어 db_find와 key만 읽는 find_range
+ */
+void bench_table(uint32_t format) {
+  std::mt19937 rng(42);
+  unlink(BENCH_DB_PATH);
+  init_db(BUFFER_FRAMES);
+  db_set_durability(SYNC_DEFERRED, 0);
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path);
+  if (table_id < 0) {
+    fprintf(stderr, "failed to open %s\n", BENCH_DB_PATH);
+    exit(EXIT_FAILURE);
+  }
+  int fd = table_infos[table_id].fd;
+  if (set_leaf_format(fd, table_id, format) != SUCCESS) {
+    fprintf(stderr, "failed to set leaf format\n");
+    exit(EXIT_FAILURE);
+  }
+
+  std::vector<int64_t> keys(KEY_COUNT);
+  for (int i = 0; i < KEY_COUNT; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), rng);
+  char value[VALUE_SIZE];
+  for (int64_t key : keys) {
+    snprintf(value, VALUE_SIZE, "%ld_value", key);
+    if (db_insert(table_id, key, value) != SUCCESS) {
+      fprintf(stderr, "insert failed: %ld\n", key);
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  uint64_t checksum = 0;
+  double start = now_sec();
+  for (int i = 0; i < POINT_FINDS; i++) {
+    if (db_find(table_id, keys[i % KEY_COUNT], value) == SUCCESS) {
+      checksum += value[0];
+    }
+  }
+  double find_elapsed = now_sec() - start;
+
+  std::vector<int64_t> returned_keys(MAX_RANGE_SIZE);
+  std::vector<pagenum_t> returned_pages(MAX_RANGE_SIZE);
+  std::vector<int> returned_indices(MAX_RANGE_SIZE);
+  uint64_t scanned = 0;
+  start = now_sec();
+  for (int round = 0; round < SCAN_ROUNDS; round++) {
+    for (int64_t from = 0; from < KEY_COUNT; from += MAX_RANGE_SIZE) {
+      scanned += find_range(fd, table_id, from, from + MAX_RANGE_SIZE - 1,
+                            returned_keys.data(), returned_pages.data(),
+                            returned_indices.data());
+    }
+  }
+  double scan_elapsed = now_sec() - start;
+
+  printf("%-9s db_find    %7.2f ns/find  (checksum %lu)\n", format_name(format),
+         find_elapsed * 1e9 / POINT_FINDS, checksum);
+  printf("%-9s key scan   %7.2f ns/key   (%lu keys)\n", format_name(format),
+         scan_elapsed * 1e9 / scanned, scanned);
+
+  close_table(table_id);
+  shutdown_db();
+  unlink(BENCH_DB_PATH);
+}
+
+int main() {
+  bench_leaf_search(LEAF_FORMAT_RECORDS, SEARCH_BINARY, "binary");
+  bench_leaf_search(LEAF_FORMAT_KEY_ARRAY, SEARCH_BINARY, "binary");
+  if (set_search_kernel(SEARCH_AVX2) == SUCCESS) {
+    bench_leaf_search(LEAF_FORMAT_KEY_ARRAY, SEARCH_AVX2, "avx2");
+  }
+  printf("\n%d keys, buffer %d frames\n", KEY_COUNT, BUFFER_FRAMES);
+  bench_table(LEAF_FORMAT_RECORDS);
+  bench_table(LEAF_FORMAT_KEY_ARRAY);
+  return 0;
+}
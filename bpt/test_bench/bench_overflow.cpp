@@ -0,0 +1,167 @@
+/*
+g++ -O2 -I../include -o bench_overflow bench_overflow.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "bpt.h"
+#include "buf_mgr.h"
+#include "db_api.h"
+
+#define BENCH_DB_PATH "bench_overflow.db"
+#define BLOB_COUNT (4000)
+#define BLOB_SIZE (32 * 1024)
+#define CHUNK_SIZE (SLOTTED_MAX_VALUE_SIZE)  // application chunk, 한 key에
+#define CHUNKS_PER_BLOB ((BLOB_SIZE + CHUNK_SIZE - 1) / CHUNK_SIZE)
+#define BUFFER_FRAMES (4096)  // 16MB, blob 전체(128MB)보다 작음
+#define READS (20000)
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int open_bench_table() {
+  unlink(BENCH_DB_PATH);
+  init_db(BUFFER_FRAMES);
+  db_set_durability(SYNC_DEFERRED, 0);
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path);
+  if (table_id < 0 ||
+      db_set_leaf_format(table_id, LEAF_FORMAT_SLOTTED) != SUCCESS) {
+    fprintf(stderr, "failed to open %s\n", BENCH_DB_PATH);
+    exit(EXIT_FAILURE);
+  }
+  return table_id;
+}
+
+void close_bench_table(int table_id) {
+  close_table(table_id);
+  shutdown_db();
+  unlink(BENCH_DB_PATH);
+}
+
+void print_result(const char* name, const char* op, double elapsed, int count,
+                  const buffer_stats_t* before, const buffer_stats_t* after) {
+  printf("%-8s %-12s %8.2f us/blob  buffer misses %6.1f/blob\n", name, op,
+         elapsed * 1e6 / count,
+         (double)(after->misses - before->misses) / count);
+}
+
+/*
+ * blob을 CHUNK_SIZE씩 잘라 blob * CHUNKS_PER_BLOB + i key에 나눠 넣는 방식
+ * (overflow page 전에 application이 하던 방법)
+ */
+void bench_chunked(const std::vector<int64_t>& reads, const char* blob) {
+  int table_id = open_bench_table();
+  double start = now_sec();
+  for (int64_t b = 0; b < BLOB_COUNT; b++) {
+    for (int i = 0; i < CHUNKS_PER_BLOB; i++) {
+      int length = std::min(CHUNK_SIZE, BLOB_SIZE - i * CHUNK_SIZE);
+      if (db_insert(table_id, b * CHUNKS_PER_BLOB + i, blob + i * CHUNK_SIZE,
+                    length) != SUCCESS) {
+        fprintf(stderr, "insert failed\n");
+        exit(EXIT_FAILURE);
+      }
+    }
+  }
+  printf("%-8s %-12s %8.2f us/blob\n", "chunked", "insert",
+         (now_sec() - start) * 1e6 / BLOB_COUNT);
+
+  std::vector<char> buf(BLOB_SIZE);
+  buffer_stats_t before, after;
+  db_get_buffer_stats(&before);
+  start = now_sec();
+  for (int64_t b : reads) {
+    for (int i = 0; i < CHUNKS_PER_BLOB; i++) {
+      uint16_t length = CHUNK_SIZE;
+      db_find(table_id, b * CHUNKS_PER_BLOB + i, buf.data() + i * CHUNK_SIZE,
+              &length);
+    }
+  }
+  double elapsed = now_sec() - start;
+  db_get_buffer_stats(&after);
+  print_result("chunked", "read", elapsed, reads.size(), &before, &after);
+
+  // 앞부분만 필요해도 첫 chunk 하나는 통째로 읽음
+  db_get_buffer_stats(&before);
+  start = now_sec();
+  for (int64_t b : reads) {
+    uint16_t length = CHUNK_SIZE;
+    db_find(table_id, b * CHUNKS_PER_BLOB, buf.data(), &length);
+  }
+  elapsed = now_sec() - start;
+  db_get_buffer_stats(&after);
+  print_result("chunked", "prefix(16)", elapsed, reads.size(), &before, &after);
+
+  close_bench_table(table_id);
+}
+
+/*
+ * blob 하나를 key 하나에, 긴 value는 overflow page chain으로
+ */
+void bench_overflow(const std::vector<int64_t>& reads, const char* blob) {
+  int table_id = open_bench_table();
+  double start = now_sec();
+  for (int64_t b = 0; b < BLOB_COUNT; b++) {
+    if (db_insert(table_id, b, blob, BLOB_SIZE) != SUCCESS) {
+      fprintf(stderr, "insert failed\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+  printf("%-8s %-12s %8.2f us/blob\n", "overflow", "insert",
+         (now_sec() - start) * 1e6 / BLOB_COUNT);
+
+  std::vector<char> buf(BLOB_SIZE);
+  buffer_stats_t before, after;
+  db_get_buffer_stats(&before);
+  start = now_sec();
+  for (int64_t b : reads) {
+    uint16_t length = BLOB_SIZE;
+    db_find(table_id, b, buf.data(), &length);
+  }
+  double elapsed = now_sec() - start;
+  db_get_buffer_stats(&after);
+  print_result("overflow", "read", elapsed, reads.size(), &before, &after);
+
+  db_get_buffer_stats(&before);
+  start = now_sec();
+  for (int64_t b : reads) {
+    uint16_t value_length;
+    db_find_prefix(table_id, b, buf.data(), 16, &value_length);
+  }
+  elapsed = now_sec() - start;
+  db_get_buffer_stats(&after);
+  print_result("overflow", "prefix(16)", elapsed, reads.size(), &before,
+               &after);
+
+  close_bench_table(table_id);
+}
+
+int main() {
+  printf("%d blobs of %d bytes, buffer %d frames, %d random reads\n",
+         BLOB_COUNT, BLOB_SIZE, BUFFER_FRAMES, READS);
+  std::mt19937 rng(42);
+  std::vector<char> blob(BLOB_SIZE);
+  for (char& c : blob) {
+    c = 'a' + rng() % 26;
+  }
+  std::vector<int64_t> reads(READS);
+  for (int64_t& b : reads) {
+    b = rng() % BLOB_COUNT;
+  }
+
+  bench_chunked(reads, blob.data());
+  bench_overflow(reads, blob.data());
+  return 0;
+}
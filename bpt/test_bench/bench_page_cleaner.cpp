@@ -0,0 +1,85 @@
+/*
+g++ -O2 -I../include -o bench_page_cleaner bench_page_cleaner.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "db_api.h"
+
+#define BENCH_DB_PATH "bench_cleaner.db"
+#define BUFFER_FRAMES (256)  // 작은 버퍼로 dirty victim eviction을 유도
+#define INSERT_COUNT (50000)
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * clean_percent가 0이면 cleaner 없이, 아니면 cleaner를 켜고 랜덤 삽입
+ */
+void run(const char* name, int clean_percent,
+         const std::vector<int64_t>& keys) {
+  unlink(BENCH_DB_PATH);
+  init_db(BUFFER_FRAMES);
+  db_set_durability(SYNC_DEFERRED, 0);
+  if (db_set_page_cleaner(clean_percent, 5) != SUCCESS) {
+    fprintf(stderr, "failed to start page cleaner\n");
+    exit(EXIT_FAILURE);
+  }
+
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path);
+  if (table_id < 0) {
+    fprintf(stderr, "failed to open %s\n", BENCH_DB_PATH);
+    exit(EXIT_FAILURE);
+  }
+  char value[VALUE_SIZE];
+
+  page_cleaner_stats_t before;
+  db_get_page_cleaner_stats(&before);
+  double start = now_sec();
+  for (int64_t key : keys) {
+    snprintf(value, VALUE_SIZE, "%ld_value", key);
+    if (db_insert(table_id, key, value) != SUCCESS) {
+      fprintf(stderr, "insert failed: %ld\n", key);
+      exit(EXIT_FAILURE);
+    }
+  }
+  double elapsed = now_sec() - start;
+  page_cleaner_stats_t after;
+  db_get_page_cleaner_stats(&after);
+
+  close_table(table_id);
+  shutdown_db();
+  unlink(BENCH_DB_PATH);
+
+  printf("%-24s %10.0f inserts/sec  cleaner writes %8lu  stalls %8lu\n", name,
+         INSERT_COUNT / elapsed, after.pages_written - before.pages_written,
+         after.stalls - before.stalls);
+}
+
+int main() {
+  std::vector<int64_t> keys(INSERT_COUNT);
+  for (int i = 0; i < INSERT_COUNT; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+
+  printf("%d random inserts, %d buffer frames, SYNC_DEFERRED\n", INSERT_COUNT,
+         BUFFER_FRAMES);
+  run("no cleaner", 0, keys);
+  run("cleaner 10%", 10, keys);
+  run("cleaner 25%", 25, keys);
+  return 0;
+}
@@ -0,0 +1,82 @@
+/*
+g++ -O2 -I../include -o bench_page_table bench_page_table.cpp
+../src/page_table.cpp
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "page_table.h"
+
+#define RESIDENT_PAGES (4096)  // 버퍼 프레임 수만큼의 페이지가 올라와 있다고 가정
+#define LOOKUP_COUNT (20000000)
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main() {
+  std::mt19937_64 rng(42);
+  std::vector<pagenum_t> pages(RESIDENT_PAGES);
+  for (int i = 0; i < RESIDENT_PAGES; i++) {
+    pages[i] = rng() % 1000000;  // 흩어진 페이지 번호
+  }
+
+  std::unordered_map<pagenum_t, frame_idx_t> map;
+  page_table_t table;
+  page_table_init(&table, RESIDENT_PAGES);
+  for (int i = 0; i < RESIDENT_PAGES; i++) {
+    map[pages[i]] = i;
+    page_table_insert(&table, ((page_key_t)1 << 56) | pages[i], i);
+  }
+
+  // 모든 조회는 hit, 조회 순서는 미리 만들어둠
+  std::vector<pagenum_t> probes(LOOKUP_COUNT);
+  for (int i = 0; i < LOOKUP_COUNT; i++) {
+    probes[i] = pages[rng() % RESIDENT_PAGES];
+  }
+
+  long checksum = 0;
+
+  // 기존 read_buffer의 count + operator[] 패턴
+  double start = now_sec();
+  for (int i = 0; i < LOOKUP_COUNT; i++) {
+    if (map.count(probes[i])) {
+      checksum += map[probes[i]];
+    }
+  }
+  double map_two_probe = (now_sec() - start) * 1e9 / LOOKUP_COUNT;
+
+  start = now_sec();
+  for (int i = 0; i < LOOKUP_COUNT; i++) {
+    auto it = map.find(probes[i]);
+    if (it != map.end()) {
+      checksum += it->second;
+    }
+  }
+  double map_find = (now_sec() - start) * 1e9 / LOOKUP_COUNT;
+
+  start = now_sec();
+  for (int i = 0; i < LOOKUP_COUNT; i++) {
+    checksum += page_table_find(&table, ((page_key_t)1 << 56) | probes[i]);
+  }
+  double flat_find = (now_sec() - start) * 1e9 / LOOKUP_COUNT;
+
+  printf("\n%d resident pages, %d hit lookups (checksum %ld)\n",
+         RESIDENT_PAGES, LOOKUP_COUNT, checksum);
+  printf("%-36s %8.2f ns/lookup\n", "unordered_map count + operator[]",
+         map_two_probe);
+  printf("%-36s %8.2f ns/lookup\n", "unordered_map find", map_find);
+  printf("%-36s %8.2f ns/lookup\n", "page_table_find (open addressing)",
+         flat_find);
+
+  page_table_destroy(&table);
+  return 0;
+}
@@ -0,0 +1,92 @@
+/*
+g++ -O2 -I../include -o bench_point_lookup bench_point_lookup.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+
+single page table latch: add -DBUF_PARTITION_COUNT=1
+*/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "buf_mgr.h"
+#include "db_api.h"
+#include "txn_mgr.h"
+
+#define BENCH_DB_PATH "bench_lookup.db"
+#define BUFFER_FRAMES (4096)  // 모든 페이지가 버퍼에 올라가도록 (hit만 측정)
+#define KEY_COUNT (50000)
+#define LOOKUPS_PER_THREAD (200000)
+#define MAX_THREADS (8)
+
+int table_id;
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * 트랜잭션 하나에 랜덤 키 하나를 찾는 worker
+ */
+void* lookup_worker(void* arg) {
+  unsigned int seed = (unsigned int)(long)arg;
+  char value[VALUE_SIZE];
+
+  for (int i = 0; i < LOOKUPS_PER_THREAD; i++) {
+    int64_t key = rand_r(&seed) % KEY_COUNT;
+    int txn_id = txn_begin();
+    if (db_find(table_id, key, value, txn_id) != SUCCESS) {
+      fprintf(stderr, "find failed: %ld\n", key);
+      exit(EXIT_FAILURE);
+    }
+    txn_commit(txn_id);
+  }
+  return NULL;
+}
+
+double run_lookups(int thread_count) {
+  pthread_t threads[MAX_THREADS];
+
+  double start = now_sec();
+  for (long i = 0; i < thread_count; i++) {
+    pthread_create(&threads[i], NULL, lookup_worker, (void*)(i + 1));
+  }
+  for (int i = 0; i < thread_count; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  return (double)thread_count * LOOKUPS_PER_THREAD / (now_sec() - start);
+}
+
+int main() {
+  unlink(BENCH_DB_PATH);
+  init_db(BUFFER_FRAMES);
+  char path[] = BENCH_DB_PATH;
+  table_id = open_table(path);
+  if (table_id < 0) {
+    fprintf(stderr, "open_table failed\n");
+    return EXIT_FAILURE;
+  }
+
+  char value[VALUE_SIZE];
+  for (int64_t key = 0; key < KEY_COUNT; key++) {
+    snprintf(value, VALUE_SIZE, "%ld_value", key);
+    db_insert(table_id, key, value);
+  }
+  run_lookups(1);  // warm up
+
+  printf("\n%d keys, %d buffer frames, %d page table partitions\n", KEY_COUNT,
+         BUFFER_FRAMES, buf_mgr.partition_count);
+  for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+    printf("%2d threads %14.0f lookups/sec\n", threads, run_lookups(threads));
+  }
+
+  close_table(table_id);
+  shutdown_db();
+  unlink(BENCH_DB_PATH);
+  return 0;
+}
@@ -0,0 +1,130 @@
+/*
+g++ -O2 -I../include -o bench_readahead bench_readahead.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "bpt.h"
+#include "db_api.h"
+
+#define BENCH_DB_PATH "bench_ra.db"
+#define KEY_COUNT (100000)
+#define BUFFER_FRAMES (1024)
+#define LOOKUP_COUNT (20000)
+#define SCAN_CHUNK (1000)
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * shuffled면 랜덤 순서로 삽입해서 leaf chain이 페이지 번호와 어긋나게 만듦
+ */
+void build_table(bool shuffled) {
+  unlink(BENCH_DB_PATH);
+  init_db(8192);
+  db_set_durability(SYNC_DEFERRED, 0);
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path);
+  if (table_id < 0) {
+    fprintf(stderr, "failed to open %s\n", BENCH_DB_PATH);
+    exit(EXIT_FAILURE);
+  }
+  std::vector<int64_t> keys(KEY_COUNT);
+  for (int i = 0; i < KEY_COUNT; i++) {
+    keys[i] = i;
+  }
+  if (shuffled) {
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  }
+  char value[VALUE_SIZE];
+  for (int64_t key : keys) {
+    snprintf(value, VALUE_SIZE, "%ld_value", key);
+    if (db_insert(table_id, key, value) != SUCCESS) {
+      fprintf(stderr, "insert failed: %ld\n", key);
+      exit(EXIT_FAILURE);
+    }
+  }
+  close_table(table_id);
+  shutdown_db();
+}
+
+void random_lookups(int table_id) {
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int64_t> dist(0, KEY_COUNT - 1);
+  char value[VALUE_SIZE];
+  for (int i = 0; i < LOOKUP_COUNT; i++) {
+    if (db_find(table_id, dist(rng), value) != SUCCESS) {
+      fprintf(stderr, "lookup failed\n");
+      exit(EXIT_FAILURE);
+    }
+  }
+}
+
+void full_scan(int table_id) {
+  std::vector<int64_t> keys(SCAN_CHUNK);
+  std::vector<pagenum_t> pages(SCAN_CHUNK);
+  std::vector<int> indices(SCAN_CHUNK);
+  int fd = table_infos[table_id].fd;
+  for (int64_t start = 0; start < KEY_COUNT; start += SCAN_CHUNK) {
+    int found = find_range(fd, table_id, start, start + SCAN_CHUNK - 1,
+                           keys.data(), pages.data(), indices.data());
+    if (found != SCAN_CHUNK) {
+      fprintf(stderr, "scan returned %d keys from %ld\n", found, start);
+      exit(EXIT_FAILURE);
+    }
+  }
+}
+
+/*
+ * 빈 버퍼에서 workload를 한번 돌리고 read-ahead 통계를 출력
+ */
+void run(const char* name, void (*workload)(int)) {
+  init_db(BUFFER_FRAMES);
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path);
+  if (table_id < 0) {
+    fprintf(stderr, "failed to open %s\n", BENCH_DB_PATH);
+    exit(EXIT_FAILURE);
+  }
+
+  double start = now_sec();
+  workload(table_id);
+  double elapsed = now_sec() - start;
+  buffer_stats_t stats;
+  db_get_buffer_stats(&stats);
+
+  close_table(table_id);
+  shutdown_db();
+
+  printf("%-28s misses %7lu  prefetched %7lu  hits %7lu  wasted %7lu  %6.3f sec\n",
+         name, stats.misses, stats.prefetched, stats.prefetch_hits,
+         stats.prefetch_wasted, elapsed);
+}
+
+int main() {
+  printf("%d keys, %d buffer frames, cold buffer per run\n", KEY_COUNT,
+         BUFFER_FRAMES);
+
+  build_table(false);
+  run("sequential insert, lookups", random_lookups);
+  run("sequential insert, scan", full_scan);
+
+  build_table(true);
+  run("random insert, lookups", random_lookups);
+  run("random insert, scan", full_scan);
+
+  unlink(BENCH_DB_PATH);
+  return 0;
+}
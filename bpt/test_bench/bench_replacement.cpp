@@ -0,0 +1,134 @@
+/*
+g++ -O2 -I../include -o bench_replacement bench_replacement.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "bpt.h"
+#include "db_api.h"
+
+#define BENCH_DB_PATH "bench_repl.db"
+#define KEY_COUNT (100000)
+#define HOT_KEY_COUNT (5000)  // 앞쪽 연속 구간, 버퍼의 절반 정도
+#define BUFFER_FRAMES (512)
+#define ROUNDS (20)
+#define LOOKUPS_PER_ROUND (20000)
+#define SCAN_CHUNK (1000)
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void build_table() {
+  unlink(BENCH_DB_PATH);
+  init_db(8192);
+  db_set_durability(SYNC_DEFERRED, 0);
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path);
+  if (table_id < 0) {
+    fprintf(stderr, "failed to open %s\n", BENCH_DB_PATH);
+    exit(EXIT_FAILURE);
+  }
+  std::vector<int64_t> keys(KEY_COUNT);
+  for (int i = 0; i < KEY_COUNT; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  char value[VALUE_SIZE];
+  for (int64_t key : keys) {
+    snprintf(value, VALUE_SIZE, "%ld_value", key);
+    if (db_insert(table_id, key, value) != SUCCESS) {
+      fprintf(stderr, "insert failed: %ld\n", key);
+      exit(EXIT_FAILURE);
+    }
+  }
+  close_table(table_id);
+  shutdown_db();
+}
+
+/*
+ * helper function for run
+ * find_range를 SCAN_CHUNK 단위로 끊어서 테이블 전체를 훑는다
+ */
+void full_scan(int table_id) {
+  std::vector<int64_t> keys(SCAN_CHUNK);
+  std::vector<pagenum_t> pages(SCAN_CHUNK);
+  std::vector<int> indices(SCAN_CHUNK);
+  int fd = table_infos[table_id].fd;
+  for (int64_t start = 0; start < KEY_COUNT; start += SCAN_CHUNK) {
+    int found = find_range(fd, table_id, start, start + SCAN_CHUNK - 1,
+                           keys.data(), pages.data(), indices.data());
+    if (found != SCAN_CHUNK) {
+      fprintf(stderr, "scan returned %d keys from %ld\n", found, start);
+      exit(EXIT_FAILURE);
+    }
+  }
+}
+
+/*
+ * 매 라운드 hot 구간 point lookup 후 전체 scan 한번
+ * hit ratio는 warm-up 라운드 이후의 lookup과 scan을 합쳐서 계산
+ */
+void run(const char* name, ReplacementPolicy policy) {
+  init_db(BUFFER_FRAMES, policy);
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path);
+  if (table_id < 0) {
+    fprintf(stderr, "failed to open %s\n", BENCH_DB_PATH);
+    exit(EXIT_FAILURE);
+  }
+
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int64_t> hot(0, HOT_KEY_COUNT - 1);
+  char value[VALUE_SIZE];
+  buffer_stats_t before = {0, 0};
+  double start = 0;
+  for (int round = 0; round <= ROUNDS; round++) {
+    if (round == 1) {  // round 0은 warm-up
+      db_get_buffer_stats(&before);
+      start = now_sec();
+    }
+    for (int i = 0; i < LOOKUPS_PER_ROUND; i++) {
+      if (db_find(table_id, hot(rng), value) != SUCCESS) {
+        fprintf(stderr, "lookup failed\n");
+        exit(EXIT_FAILURE);
+      }
+    }
+    full_scan(table_id);
+  }
+  double elapsed = now_sec() - start;
+  buffer_stats_t after;
+  db_get_buffer_stats(&after);
+
+  close_table(table_id);
+  shutdown_db();
+
+  uint64_t hits = after.hits - before.hits;
+  uint64_t misses = after.misses - before.misses;
+  printf("%-8s hit ratio %6.2f%%  misses %9lu  %8.3f sec\n", name,
+         100.0 * hits / (hits + misses), misses, elapsed);
+}
+
+int main() {
+  build_table();
+  printf("%d keys, hot keys [0, %d), %d buffer frames\n", KEY_COUNT,
+         HOT_KEY_COUNT, BUFFER_FRAMES);
+  printf("%d rounds of %d hot lookups + full scan\n", ROUNDS,
+         LOOKUPS_PER_ROUND);
+  run("clock", REPLACE_CLOCK);
+  run("2Q", REPLACE_2Q);
+  run("LRU-2", REPLACE_LRU_K);
+  unlink(BENCH_DB_PATH);
+  return 0;
+}
@@ -0,0 +1,138 @@
+/*
+g++ -O2 -I../include -o bench_scan_prefetch bench_scan_prefetch.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+(-DSCAN_PREFETCH_DEPTH=1 로 빌드하면 leaf 하나씩만 앞서 읽음)
+*/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "bpt.h"
+#include "db_api.h"
+
+#define BENCH_DB_PATH "bench_scan.db"
+#define KEY_COUNT (200000)
+#define BUFFER_FRAMES (1024)
+#define SCAN_CHUNK (MAX_RANGE_SIZE)
+#define RAW_READ_PAGES (64)
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void build_table() {
+  unlink(BENCH_DB_PATH);
+  init_db(16384);
+  db_set_durability(SYNC_DEFERRED, 0);
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path);
+  if (table_id < 0) {
+    fprintf(stderr, "failed to open %s\n", BENCH_DB_PATH);
+    exit(EXIT_FAILURE);
+  }
+  std::vector<int64_t> keys(KEY_COUNT);
+  for (int i = 0; i < KEY_COUNT; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+  char value[VALUE_SIZE];
+  for (int64_t key : keys) {
+    snprintf(value, VALUE_SIZE, "%ld_value", key);
+    if (db_insert(table_id, key, value) != SUCCESS) {
+      fprintf(stderr, "insert failed: %ld\n", key);
+      exit(EXIT_FAILURE);
+    }
+  }
+  close_table(table_id);
+  shutdown_db();
+}
+
+/*
+ * 빈 버퍼에서 find_range로 테이블 전체를 훑음
+ */
+void scan(const char* name, TableOpenMode open_mode) {
+  init_db(BUFFER_FRAMES);
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path, open_mode);
+  if (table_id < 0) {
+    printf("%-24s open failed\n", name);
+    shutdown_db();
+    return;
+  }
+
+  std::vector<int64_t> keys(SCAN_CHUNK);
+  std::vector<pagenum_t> pages(SCAN_CHUNK);
+  std::vector<int> indices(SCAN_CHUNK);
+  int fd = table_infos[table_id].fd;
+  uint64_t leaves = 0;
+  double start = now_sec();
+  for (int64_t key = 0; key < KEY_COUNT; key += SCAN_CHUNK) {
+    int found = find_range(fd, table_id, key, key + SCAN_CHUNK - 1,
+                           keys.data(), pages.data(), indices.data());
+    if (found != SCAN_CHUNK) {
+      fprintf(stderr, "scan returned %d keys from %ld\n", found, key);
+      exit(EXIT_FAILURE);
+    }
+    for (int i = 1; i < found; i++) {
+      leaves += pages[i] != pages[i - 1];
+    }
+  }
+  double elapsed = now_sec() - start;
+  buffer_stats_t stats;
+  db_get_buffer_stats(&stats);
+
+  close_table(table_id);
+  shutdown_db();
+
+  printf("%-24s %8.1f MB/s  %9.0f leaves/sec  misses %6lu  prefetched %6lu\n",
+         name, leaves * PAGE_SIZE / elapsed / 1e6, leaves / elapsed,
+         stats.misses, stats.prefetched);
+}
+
+/*
+ * 비교용, 파일 전체를 RAW_READ_PAGES씩 순서대로 pread
+ */
+void raw_sequential_read(const char* name, int flags) {
+  int fd = open(BENCH_DB_PATH, O_RDONLY | flags);
+  if (fd < 0) {
+    printf("%-24s open failed\n", name);
+    return;
+  }
+  void* buf = NULL;
+  if (posix_memalign(&buf, PAGE_SIZE, RAW_READ_PAGES * PAGE_SIZE) != 0) {
+    exit(EXIT_FAILURE);
+  }
+  uint64_t bytes = 0;
+  double start = now_sec();
+  ssize_t n;
+  while ((n = pread(fd, buf, RAW_READ_PAGES * PAGE_SIZE, bytes)) > 0) {
+    bytes += n;
+  }
+  double elapsed = now_sec() - start;
+  close(fd);
+  free(buf);
+  printf("%-24s %8.1f MB/s\n", name, bytes / elapsed / 1e6);
+}
+
+int main() {
+  build_table();
+  printf("%d keys inserted in random order, %d buffer frames, "
+         "SCAN_PREFETCH_DEPTH %d\n",
+         KEY_COUNT, BUFFER_FRAMES, SCAN_PREFETCH_DEPTH);
+  scan("scan, buffered", OPEN_BUFFERED);
+  scan("scan, O_DIRECT", OPEN_DIRECT);
+  raw_sequential_read("raw pread, buffered", 0);
+  raw_sequential_read("raw pread, O_DIRECT", O_DIRECT);
+  unlink(BENCH_DB_PATH);
+  return 0;
+}
@@ -0,0 +1,104 @@
+/*
+g++ -O2 -I../include -o bench_slotted bench_slotted.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "bpt.h"
+#include "buf_mgr.h"
+#include "db_api.h"
+
+#define BENCH_DB_PATH "bench_slotted.db"
+#define KEY_COUNT (200000)
+#define BUFFER_FRAMES (1024)  // 4MB, 테이블 일부만 버퍼에 들어감
+#define FINDS (1000000)
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * value 길이가 value_length인 record로 table을 만들고
+ * 페이지 수와 버퍼가 작을때 임의 db_find의 hit ratio
+ */
+void bench_format(uint32_t format, int value_length) {
+  std::mt19937 rng(42);
+  unlink(BENCH_DB_PATH);
+  init_db(BUFFER_FRAMES);
+  db_set_durability(SYNC_DEFERRED, 0);
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path);
+  if (table_id < 0 || db_set_leaf_format(table_id, format) != SUCCESS) {
+    fprintf(stderr, "failed to open %s\n", BENCH_DB_PATH);
+    exit(EXIT_FAILURE);
+  }
+
+  std::vector<int64_t> keys(KEY_COUNT);
+  for (int i = 0; i < KEY_COUNT; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), rng);
+  char value[SLOTTED_MAX_VALUE_SIZE];
+  memset(value, 'v', sizeof(value));
+  double start = now_sec();
+  for (int64_t key : keys) {
+    if (db_insert(table_id, key, value, value_length) != SUCCESS) {
+      fprintf(stderr, "insert failed: %ld\n", key);
+      exit(EXIT_FAILURE);
+    }
+  }
+  double insert_elapsed = now_sec() - start;
+
+  header_page_t* header = read_header_page(table_infos[table_id].fd, table_id);
+  pagenum_t pages = header->num_of_pages;
+  unpin(table_id, HEADER_PAGE_POS);
+
+  buffer_stats_t before, after;
+  db_get_buffer_stats(&before);
+  uint64_t checksum = 0;
+  start = now_sec();
+  for (int i = 0; i < FINDS; i++) {
+    uint16_t length = sizeof(value);
+    if (db_find(table_id, keys[rng() % KEY_COUNT], value, &length) ==
+        SUCCESS) {
+      checksum += length;
+    }
+  }
+  double find_elapsed = now_sec() - start;
+  db_get_buffer_stats(&after);
+  uint64_t hits = after.hits - before.hits;
+  uint64_t misses = after.misses - before.misses;
+
+  printf("%-9s value %4d  pages %6lu  insert %7.0f ns  find %7.0f ns  "
+         "hit ratio %6.2f%%  (checksum %lu)\n",
+         format == LEAF_FORMAT_SLOTTED ? "slotted" : "key_array", value_length,
+         pages, insert_elapsed * 1e9 / KEY_COUNT, find_elapsed * 1e9 / FINDS,
+         100.0 * hits / (hits + misses), checksum);
+
+  close_table(table_id);
+  shutdown_db();
+  unlink(BENCH_DB_PATH);
+}
+
+int main() {
+  printf("%d keys, buffer %d frames, %d random db_find\n", KEY_COUNT,
+         BUFFER_FRAMES, FINDS);
+  int lengths[] = {8, 32, 120};
+  for (int length : lengths) {
+    bench_format(LEAF_FORMAT_KEY_ARRAY, length);
+    bench_format(LEAF_FORMAT_SLOTTED, length);
+  }
+  bench_format(LEAF_FORMAT_SLOTTED, 400);
+  return 0;
+}
@@ -0,0 +1,78 @@
+/*
+g++ -O2 -I../include -o bench_sync_insert bench_sync_insert.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "db_api.h"
+
+#define BENCH_DB_PATH "bench_sync.db"
+#define BUFFER_FRAMES (64)  // 작은 버퍼로 eviction write를 유도
+#define INSERT_COUNT (20000)
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * 랜덤 순서로 INSERT_COUNT개의 키를 삽입하고 close_table까지의
+ * 초당 삽입 수를 반환 (close_table의 마지막 sync 포함)
+ */
+double run_inserts(SyncMode mode, int sync_interval_ms,
+                   const std::vector<int64_t>& keys) {
+  unlink(BENCH_DB_PATH);
+
+  init_db(BUFFER_FRAMES);
+  db_set_durability(mode, sync_interval_ms);
+
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path);
+  char value[VALUE_SIZE];
+
+  double start = now_sec();
+  for (int64_t key : keys) {
+    snprintf(value, VALUE_SIZE, "%ld_value", key);
+    if (db_insert(table_id, key, value) != SUCCESS) {
+      fprintf(stderr, "insert failed: %ld\n", key);
+      exit(EXIT_FAILURE);
+    }
+  }
+  close_table(table_id);
+  double elapsed = now_sec() - start;
+
+  shutdown_db();
+  unlink(BENCH_DB_PATH);
+
+  return keys.size() / elapsed;
+}
+
+int main() {
+  std::vector<int64_t> keys(INSERT_COUNT);
+  for (int i = 0; i < INSERT_COUNT; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+
+  double every_write = run_inserts(SYNC_EVERY_WRITE, 0, keys);
+  double deferred = run_inserts(SYNC_DEFERRED, 0, keys);
+  double deferred_bg = run_inserts(SYNC_DEFERRED, 100, keys);
+
+  printf("\n%d random inserts, %d buffer frames\n", INSERT_COUNT,
+         BUFFER_FRAMES);
+  printf("%-32s %12.0f inserts/sec\n", "SYNC_EVERY_WRITE", every_write);
+  printf("%-32s %12.0f inserts/sec\n", "SYNC_DEFERRED", deferred);
+  printf("%-32s %12.0f inserts/sec\n", "SYNC_DEFERRED (100ms bg sync)",
+         deferred_bg);
+  return 0;
+}
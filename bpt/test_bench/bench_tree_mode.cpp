@@ -0,0 +1,93 @@
+/*
+g++ -O2 -I../include -o bench_tree_mode bench_tree_mode.cpp
+$(ls ../src/*.cpp | grep -v main.cpp) ../src/bptree/*.cpp
+../src/txn_mgr/*.cpp -lpthread
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "bpt.h"
+#include "buf_mgr.h"
+#include "db_api.h"
+
+#define BENCH_DB_PATH "bench_tree_mode.db"
+#define KEY_COUNT (1000000)
+#define BUFFER_FRAMES (2048)  // 8MB, tree 전체보다 작음
+#define VALUE_LENGTH (32)
+
+double now_sec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void print_result(const char* mode, const char* name, int count,
+                  double elapsed, const buffer_stats_t* before) {
+  buffer_stats_t stats;
+  db_get_buffer_stats(&stats);
+  printf("%-16s %-7s %6.0f ns/key  lookups %7.4f/key  misses %6.4f/key\n",
+         mode, name, elapsed * 1e9 / count,
+         (double)(stats.hits + stats.misses - before->hits - before->misses) /
+             count,
+         (double)(stats.misses - before->misses) / count);
+}
+
+/**
+ * 빈 table에 mode를 정하고 임의 순서 key를 하나씩 넣은 뒤 절반을 지움
+ */
+void bench_mode(uint32_t mode, const std::vector<int64_t>& keys) {
+  const char* name =
+      mode == TREE_MODE_PATH ? "TREE_MODE_PATH" : "PARENT_POINTERS";
+  unlink(BENCH_DB_PATH);
+  init_db(BUFFER_FRAMES);
+  db_set_durability(SYNC_DEFERRED, 0);
+  char path[] = BENCH_DB_PATH;
+  int table_id = open_table(path);
+  if (table_id < 0 || db_set_tree_mode(table_id, mode) != SUCCESS) {
+    fprintf(stderr, "failed to open %s\n", BENCH_DB_PATH);
+    exit(EXIT_FAILURE);
+  }
+  char value[VALUE_LENGTH];
+  memset(value, 'v', VALUE_LENGTH);
+
+  buffer_stats_t before;
+  db_get_buffer_stats(&before);
+  double start = now_sec();
+  for (int64_t key : keys) {
+    db_insert(table_id, key, value, VALUE_LENGTH);
+  }
+  print_result(name, "insert", KEY_COUNT, now_sec() - start, &before);
+
+  db_get_buffer_stats(&before);
+  start = now_sec();
+  for (int i = 0; i < KEY_COUNT / 2; i++) {
+    db_delete(table_id, keys[i]);
+  }
+  print_result(name, "delete", KEY_COUNT / 2, now_sec() - start, &before);
+
+  close_table(table_id);
+  shutdown_db();
+  unlink(BENCH_DB_PATH);
+}
+
+int main() {
+  std::vector<int64_t> keys(KEY_COUNT);
+  for (int i = 0; i < KEY_COUNT; i++) {
+    keys[i] = i;
+  }
+  std::mt19937_64 rng(21);
+  std::shuffle(keys.begin(), keys.end(), rng);
+
+  printf("%d random keys, value %d bytes, buffer %d frames\n", KEY_COUNT,
+         VALUE_LENGTH, BUFFER_FRAMES);
+  bench_mode(TREE_MODE_PARENT_POINTERS, keys);
+  bench_mode(TREE_MODE_PATH, keys);
+  return 0;
+}